@@ -24,14 +24,23 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <utility>
 #include <iterator>
+#include <future>
+#include <set>
+#include <thread>
 
 #include <wx/datetime.h>
 #include <wx/filename.h>
+#include <wx/intl.h>
 #include <wx/log.h>
 #include <wx/stdpaths.h>
 
@@ -47,6 +56,7 @@
 #include <glm/ext.hpp>
 
 #include "common.h"
+#include "reporter.h"
 #include "3d_cache.h"
 #include "3d_info.h"
 #include "sg/scenegraph.h"
@@ -57,6 +67,15 @@
 
 #define MASK_3D_CACHE "3D_CACHE"
 
+// file name of the index of model file hashes, in the cache directory
+static const wxChar cacheIndexName[] = wxT( "3d_cache_index.bin" );
+
+// tags and versions of the binary cache files
+static const char cacheIndexTag[8] = { 'K', 'I', '3', 'D', 'I', 'D', 'X', 0 };
+static const char modelCacheTag[8] = { 'K', 'I', '3', 'D', 'M', 'D', 'L', 0 };
+static const uint32_t cacheIndexVersion = 1;
+static const uint32_t modelCacheVersion = 1;
+
 static wxCriticalSection lock3D_cache;
 
 
@@ -115,6 +134,77 @@ static const wxString sha1ToWXString( const unsigned char* aSHA1Sum )
 }
 
 
+static FILE* openFile( const wxString& aFileName, bool aWrite )
+{
+    #ifdef _WIN32
+    return _wfopen( aFileName.wc_str(), aWrite ? L"wb" : L"rb" );
+    #else
+    return fopen( aFileName.ToUTF8(), aWrite ? "wb" : "rb" );
+    #endif
+}
+
+
+template <typename T>
+static bool writeArray( FILE* aFile, const T* aData, size_t aCount )
+{
+    return aCount == 0 || fwrite( aData, sizeof( T ), aCount, aFile ) == aCount;
+}
+
+
+template <typename T>
+static bool readArray( FILE* aFile, T* aData, size_t aCount )
+{
+    return aCount == 0 || fread( aData, sizeof( T ), aCount, aFile ) == aCount;
+}
+
+
+// returns the PluginName:Version tag stored in a scene graph cache file, which
+// starts with "(SG_VERSION_TAG)(PluginName:Version)"
+static std::string readPluginInfo( const wxString& aFileName )
+{
+    FILE* fp = openFile( aFileName, false );
+
+    if( NULL == fp )
+        return std::string();
+
+    char header[256];
+    size_t size = fread( header, 1, sizeof( header ), fp );
+    fclose( fp );
+
+    std::string tags( header, size );
+    size_t start = tags.find( ")(" );
+    size_t end = start == std::string::npos ? start : tags.find( ')', start + 2 );
+
+    if( end == std::string::npos )
+        return std::string();
+
+    return tags.substr( start + 2, end - start - 2 );
+}
+
+
+// returns the memory used by the render data of a model, in bytes
+static size_t modelMemorySize( const S3DMODEL* aModel )
+{
+    size_t size = sizeof( S3DMODEL ) + aModel->m_MaterialsSize * sizeof( SMATERIAL );
+
+    for( unsigned int i = 0; i < aModel->m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel->m_Meshes[i];
+
+        size += sizeof( SMESH ) + mesh.m_FaceIdxSize * sizeof( unsigned int );
+        size += mesh.m_VertexSize * 2 * sizeof( SFVEC3F );
+
+        if( mesh.m_Texcoords )
+            size += mesh.m_VertexSize * sizeof( SFVEC2F );
+
+        if( mesh.m_Color )
+            size += mesh.m_VertexSize * sizeof( SFVEC3F );
+    }
+
+    return size;
+}
+
+
 class S3D_CACHE_ENTRY
 {
 private:
@@ -131,11 +221,21 @@ public:
     void SetSHA1( const unsigned char* aSHA1Sum );
     const wxString GetCacheBaseName( void );
 
+    // releases the scene and render data; they can be loaded again from the cache files
+    void ReleaseData( void );
+
+    // releases the render data only, which is all memSize counts
+    void ReleaseModel( void );
+
     wxDateTime    modTime;      // file modification time
     unsigned char sha1sum[20];
     std::string   pluginInfo;   // PluginName:Version string
     SCENEGRAPH*   sceneData;
     S3DMODEL*     renderData;
+    size_t        memSize;      // memory used by renderData
+    bool          failed;       // set true if the model could not be loaded
+
+    std::list< S3D_CACHE_ENTRY* >::iterator listPos;   // position in the cache list
 };
 
 
@@ -143,6 +243,8 @@ S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
     sceneData = NULL;
     renderData = NULL;
+    memSize = 0;
+    failed = false;
     memset( sha1sum, 0, 20 );
 }
 
@@ -157,6 +259,30 @@ S3D_CACHE_ENTRY::~S3D_CACHE_ENTRY()
 }
 
 
+void S3D_CACHE_ENTRY::ReleaseData( void )
+{
+    if( NULL != sceneData )
+    {
+        S3D::DestroyNode( sceneData );
+        sceneData = NULL;
+    }
+
+    if( NULL != renderData )
+        S3D::Destroy3DModel( &renderData );
+
+    memSize = 0;
+}
+
+
+void S3D_CACHE_ENTRY::ReleaseModel( void )
+{
+    if( NULL != renderData )
+        S3D::Destroy3DModel( &renderData );
+
+    memSize = 0;
+}
+
+
 void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
 {
     if( NULL == aSHA1Sum )
@@ -168,6 +294,7 @@ void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
     }
 
     memcpy( sha1sum, aSHA1Sum, 20 );
+    m_CacheBaseName.clear();
     return;
 }
 
@@ -183,7 +310,10 @@ const wxString S3D_CACHE_ENTRY::GetCacheBaseName( void )
 
 S3D_CACHE::S3D_CACHE()
 {
+    m_FileIndexLoaded = false;
     m_DirtyCache = false;
+    m_MemoryUsage = 0;
+    m_MemoryBudget = 0;
     m_FNResolver = new FILENAME_RESOLVER;
     m_Plugins = new S3D_PLUGIN_MANAGER;
 
@@ -205,7 +335,8 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr,
+                             bool aModelOnly )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -227,6 +358,7 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
 
     if( mi != m_CacheMap.end() )
     {
+        S3D_CACHE_ENTRY* ep = mi->second;
         wxFileName fname( full3Dpath );
 
         if( fname.FileExists() )    // Only check if file exists. If not, it will
@@ -234,42 +366,42 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
             bool reload = false;
             wxDateTime fmdate = fname.GetModificationTime();
 
-            if( fmdate != mi->second->modTime )
+            if( fmdate != ep->modTime )
             {
                 unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
-                mi->second->modTime = fmdate;
+                getFileSHA1( full3Dpath, hashSum );
+                ep->modTime = fmdate;
 
-                if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
+                if( !isSHA1Same( hashSum, ep->sha1sum ) )
                 {
-                    mi->second->SetSHA1( hashSum );
+                    ep->SetSHA1( hashSum );
                     reload = true;
                 }
             }
 
             if( reload )
             {
-                if( NULL != mi->second->sceneData )
-                {
-                    S3D::DestroyNode( mi->second->sceneData );
-                    mi->second->sceneData = NULL;
-                }
-
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
-
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
+                m_MemoryUsage -= ep->memSize;
+                ep->ReleaseData();
+                loadEntryData( ep, full3Dpath, aModelOnly );
             }
         }
 
+        // the data may have been released to stay within the memory budget
+        if( !ep->failed && NULL == ep->sceneData && ( !aModelOnly || NULL == ep->renderData ) )
+            loadEntryData( ep, full3Dpath, aModelOnly );
+
+        // this is now the most recently used entry
+        m_CacheList.splice( m_CacheList.end(), m_CacheList, ep->listPos );
+
         if( NULL != aCachePtr )
-            *aCachePtr = mi->second;
+            *aCachePtr = ep;
 
-        return mi->second->sceneData;
+        return ep->sceneData;
     }
 
     // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    return checkCache( full3Dpath, aCachePtr, aModelOnly );
 }
 
 
@@ -279,44 +411,18 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr,
+                                   bool aModelOnly )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
 
     unsigned char sha1sum[20];
-
-    if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
-    {
-        // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-        m_CacheList.push_back( ep );
-        wxFileName fname( aFileName );
-        ep->modTime = fname.GetModificationTime();
-
-        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-            ( aFileName, ep ) ).second == false )
-        {
-            wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                        __FILE__, __FUNCTION__, __LINE__, aFileName );
-
-            m_CacheList.pop_back();
-            delete ep;
-        }
-        else
-        {
-            if( aCachePtr )
-                *aCachePtr = ep;
-
-        }
-
-        return NULL;
-    }
+    bool hashed = !m_CacheDir.empty() && getFileSHA1( aFileName, sha1sum );
 
     S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
     m_CacheList.push_back( ep );
+    ep->listPos = std::prev( m_CacheList.end() );
     wxFileName fname( aFileName );
     ep->modTime = fname.GetModificationTime();
 
@@ -334,20 +440,187 @@ SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY**
     if( aCachePtr )
         *aCachePtr = ep;
 
+    if( !hashed )
+    {
+        // just in case we can't get a hash digest (for example, on access issues)
+        // or we do not have a configured cache file directory, the entry is kept
+        // to prevent further attempts at loading the file
+        ep->failed = true;
+        return NULL;
+    }
+
     ep->SetSHA1( sha1sum );
+    loadEntryData( ep, aFileName, aModelOnly );
 
-    wxString bname = ep->GetCacheBaseName();
-    wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
+    return ep->sceneData;
+}
 
-    if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+void S3D_CACHE::loadEntryData( S3D_CACHE_ENTRY* aCacheItem, const wxString& aFileName,
+                               bool aModelOnly )
+{
+    // the render data alone is much faster to read than the scene graph, and
+    // it spares converting the scene graph
+    if( aModelOnly && NULL == aCacheItem->renderData && loadModelData( aCacheItem ) )
+    {
+        aCacheItem->failed = false;
+        return;
+    }
+
+    wxString cachename = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dc" );
 
-    if( NULL != ep->sceneData )
-        saveCacheData( ep );
+    if( !wxFileName::FileExists( cachename ) || !loadCacheData( aCacheItem ) )
+    {
+        aCacheItem->sceneData = m_Plugins->Load3DModel( aFileName, aCacheItem->pluginInfo );
 
-    return ep->sceneData;
+        if( NULL != aCacheItem->sceneData )
+            saveCacheData( aCacheItem );
+    }
+
+    aCacheItem->failed = ( NULL == aCacheItem->sceneData && NULL == aCacheItem->renderData );
+}
+
+
+bool S3D_CACHE::getFileSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
+{
+    wxFileName fname( aFileName );
+
+    if( !fname.FileExists() )
+        return getSHA1( aFileName, aSHA1Sum );
+
+    wxULongLong fileSize = fname.GetSize();
+    wxLongLong  modTime = fname.GetModificationTime().GetValue();
+
+    loadFileIndex();
+
+    std::map< wxString, S3D_FILE_INFO, rsort_wxString >::iterator mi;
+    mi = m_FileIndex.find( aFileName );
+
+    if( mi != m_FileIndex.end() && mi->second.fileSize == fileSize
+            && mi->second.modTime == modTime )
+    {
+        memcpy( aSHA1Sum, mi->second.sha1sum, 20 );
+        return true;
+    }
+
+    if( !getSHA1( aFileName, aSHA1Sum ) )
+        return false;
+
+    S3D_FILE_INFO& info = m_FileIndex[aFileName];
+    info.fileSize = fileSize;
+    info.modTime = modTime;
+    memcpy( info.sha1sum, aSHA1Sum, 20 );
+    m_DirtyCache = true;
+
+    return true;
+}
+
+
+void S3D_CACHE::loadFileIndex()
+{
+    if( m_FileIndexLoaded || m_CacheDir.empty() )
+        return;
+
+    m_FileIndexLoaded = true;
+
+    wxString fname = m_CacheDir + cacheIndexName;
+
+    if( !wxFileName::FileExists( fname ) )
+        return;
+
+    FILE* fp = openFile( fname, false );
+
+    if( NULL == fp )
+        return;
+
+    char     tag[8];
+    uint32_t version = 0;
+    uint32_t count = 0;
+
+    bool ok = readArray( fp, tag, 8 ) && !memcmp( tag, cacheIndexTag, 8 )
+              && readArray( fp, &version, 1 ) && version == cacheIndexVersion
+              && readArray( fp, &count, 1 );
+
+    for( uint32_t i = 0; ok && i < count; ++i )
+    {
+        uint32_t       pathSize = 0;
+        std::string    path;
+        wxULongLong_t  fileSize = 0;
+        wxLongLong_t   modTime = 0;
+        S3D_FILE_INFO  info;
+
+        ok = readArray( fp, &pathSize, 1 ) && pathSize <= 65536;
+
+        if( ok )
+        {
+            path.resize( pathSize );
+            ok = readArray( fp, &path[0], pathSize ) && readArray( fp, &fileSize, 1 )
+                 && readArray( fp, &modTime, 1 ) && readArray( fp, info.sha1sum, 20 );
+        }
+
+        if( ok )
+        {
+            info.fileSize = fileSize;
+            info.modTime = modTime;
+            m_FileIndex[ wxString::FromUTF8( path.data(), path.size() ) ] = info;
+        }
+    }
+
+    fclose( fp );
+
+    if( !ok )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] discarding invalid cache index '%s'", fname );
+        m_FileIndex.clear();
+    }
+}
+
+
+void S3D_CACHE::saveFileIndex()
+{
+    if( !m_DirtyCache || m_CacheDir.empty() )
+        return;
+
+    wxString fname = m_CacheDir + cacheIndexName;
+    wxString tmpname = fname + wxT( ".tmp" );
+    FILE* fp = openFile( tmpname, true );
+
+    if( NULL == fp )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write cache index '%s'", tmpname );
+        return;
+    }
+
+    uint32_t count = m_FileIndex.size();
+
+    bool ok = writeArray( fp, cacheIndexTag, 8 ) && writeArray( fp, &cacheIndexVersion, 1 )
+              && writeArray( fp, &count, 1 );
+
+    for( auto mi = m_FileIndex.begin(); ok && mi != m_FileIndex.end(); ++mi )
+    {
+        wxScopedCharBuffer path = mi->first.ToUTF8();
+        uint32_t           pathSize = path.length();
+        wxULongLong_t      fileSize = mi->second.fileSize.GetValue();
+        wxLongLong_t       modTime = mi->second.modTime.GetValue();
+
+        ok = writeArray( fp, &pathSize, 1 ) && writeArray( fp, path.data(), pathSize )
+             && writeArray( fp, &fileSize, 1 ) && writeArray( fp, &modTime, 1 )
+             && writeArray( fp, mi->second.sha1sum, 20 );
+    }
+
+    ok = ( fclose( fp ) == 0 ) && ok;
+
+    if( ok )
+        ok = wxRenameFile( tmpname, fname, true );
+
+    if( !ok )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write cache index '%s'", fname );
+        wxRemoveFile( tmpname );
+        return;
+    }
+
+    m_DirtyCache = false;
 }
 
 
@@ -444,6 +717,10 @@ bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
     if( NULL == aCacheItem->sceneData )
         return false;
 
+    // the plugin tag is needed to validate the binary model cache written from this data
+    if( aCacheItem->pluginInfo.empty() )
+        aCacheItem->pluginInfo = readPluginInfo( fname );
+
     return true;
 }
 
@@ -502,6 +779,223 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
 }
 
 
+// Reads a binary model cache file; this only uses its arguments so it may be
+// called from worker threads.  The plugin tag is returned in aPluginInfo and
+// must be checked by the caller.
+static S3DMODEL* readModelFile( const wxString& aFileName, std::string& aPluginInfo )
+{
+    if( !wxFileName::FileExists( aFileName ) )
+        return NULL;
+
+    // array sizes are checked against the file size so a damaged file cannot
+    // cause huge allocations
+    wxULongLong_t fileSize = wxFileName::GetSize( aFileName ).GetValue();
+    FILE* fp = openFile( aFileName, false );
+
+    if( NULL == fp )
+        return NULL;
+
+    auto fits = [&]( uint32_t aCount, size_t aItemSize ) -> bool
+    {
+        return (wxULongLong_t) aCount * aItemSize <= fileSize;
+    };
+
+    char        tag[8];
+    uint32_t    version = 0;
+    uint32_t    layout[3];
+    uint32_t    pluginInfoSize = 0;
+    std::string pluginInfo;
+
+    bool ok = readArray( fp, tag, 8 ) && !memcmp( tag, modelCacheTag, 8 )
+              && readArray( fp, &version, 1 ) && version == modelCacheVersion
+              && readArray( fp, layout, 3 ) && layout[0] == sizeof( SMATERIAL )
+              && layout[1] == sizeof( SFVEC3F ) && layout[2] == sizeof( SFVEC2F )
+              && readArray( fp, &pluginInfoSize, 1 ) && fits( pluginInfoSize, 1 );
+
+    if( ok )
+    {
+        pluginInfo.resize( pluginInfoSize );
+        ok = readArray( fp, &pluginInfo[0], pluginInfoSize );
+    }
+
+    S3DMODEL* model = S3D::New3DModel();
+    uint32_t  count = 0;
+
+    if( ok && readArray( fp, &count, 1 ) && fits( count, sizeof( SMATERIAL ) ) )
+    {
+        model->m_Materials = new SMATERIAL[count];
+        model->m_MaterialsSize = count;
+        ok = readArray( fp, model->m_Materials, count );
+    }
+    else
+    {
+        ok = false;
+    }
+
+    if( ok && readArray( fp, &count, 1 ) && fits( count, sizeof( SMESH ) ) )
+    {
+        model->m_Meshes = new SMESH[count];
+        model->m_MeshesSize = count;
+
+        for( uint32_t i = 0; i < count; ++i )
+            S3D::Init3DMesh( model->m_Meshes[i] );
+    }
+    else
+    {
+        ok = false;
+    }
+
+    for( unsigned int i = 0; ok && i < model->m_MeshesSize; ++i )
+    {
+        SMESH&   mesh = model->m_Meshes[i];
+        uint32_t header[6];
+
+        // vertex count, index count, material index and flags for the optional arrays
+        ok = readArray( fp, header, 6 ) && fits( header[0], sizeof( SFVEC3F ) )
+             && fits( header[1], sizeof( unsigned int ) ) && header[2] < model->m_MaterialsSize;
+
+        if( !ok )
+            break;
+
+        mesh.m_VertexSize = header[0];
+        mesh.m_FaceIdxSize = header[1];
+        mesh.m_MaterialIdx = header[2];
+
+        mesh.m_Positions = new SFVEC3F[mesh.m_VertexSize];
+        ok = readArray( fp, mesh.m_Positions, mesh.m_VertexSize );
+
+        if( ok && header[3] )
+        {
+            mesh.m_Normals = new SFVEC3F[mesh.m_VertexSize];
+            ok = readArray( fp, mesh.m_Normals, mesh.m_VertexSize );
+        }
+
+        if( ok && header[4] )
+        {
+            mesh.m_Texcoords = new SFVEC2F[mesh.m_VertexSize];
+            ok = readArray( fp, mesh.m_Texcoords, mesh.m_VertexSize );
+        }
+
+        if( ok && header[5] )
+        {
+            mesh.m_Color = new SFVEC3F[mesh.m_VertexSize];
+            ok = readArray( fp, mesh.m_Color, mesh.m_VertexSize );
+        }
+
+        if( ok )
+        {
+            mesh.m_FaceIdx = new unsigned int[mesh.m_FaceIdxSize];
+            ok = readArray( fp, mesh.m_FaceIdx, mesh.m_FaceIdxSize );
+        }
+    }
+
+    fclose( fp );
+
+    if( !ok )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] ignoring invalid model cache '%s'", aFileName );
+        S3D::Destroy3DModel( &model );
+        return NULL;
+    }
+
+    aPluginInfo = pluginInfo;
+    return model;
+}
+
+
+bool S3D_CACHE::loadModelData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( m_CacheDir.empty() )
+        return false;
+
+    std::string pluginInfo;
+    S3DMODEL*   model = readModelFile( m_CacheDir + aCacheItem->GetCacheBaseName()
+                                       + wxT( ".3dm" ), pluginInfo );
+
+    if( NULL == model )
+        return false;
+
+    // the model must be converted again if the plugin which read it has changed
+    if( !m_Plugins->CheckTag( pluginInfo.c_str() ) )
+    {
+        S3D::Destroy3DModel( &model );
+        return false;
+    }
+
+    if( NULL != aCacheItem->renderData )
+    {
+        m_MemoryUsage -= aCacheItem->memSize;
+        S3D::Destroy3DModel( &aCacheItem->renderData );
+    }
+
+    aCacheItem->renderData = model;
+    aCacheItem->pluginInfo = pluginInfo;
+    aCacheItem->memSize = modelMemorySize( model );
+    m_MemoryUsage += aCacheItem->memSize;
+
+    return true;
+}
+
+
+bool S3D_CACHE::saveModelData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( NULL == aCacheItem->renderData || aCacheItem->pluginInfo.empty() || m_CacheDir.empty() )
+        return false;
+
+    // The file is a header followed by the raw arrays of the model, so it is
+    // read back with one call per array and no parsing.  It is written to a
+    // temporary file first so a partly written file is never used.
+    wxString fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dm" );
+    wxString tmpname = fname + wxT( ".tmp" );
+    FILE* fp = openFile( tmpname, true );
+
+    if( NULL == fp )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write model cache '%s'", tmpname );
+        return false;
+    }
+
+    const S3DMODEL* model = aCacheItem->renderData;
+    uint32_t layout[3] = { sizeof( SMATERIAL ), sizeof( SFVEC3F ), sizeof( SFVEC2F ) };
+    uint32_t pluginInfoSize = aCacheItem->pluginInfo.size();
+
+    bool ok = writeArray( fp, modelCacheTag, 8 ) && writeArray( fp, &modelCacheVersion, 1 )
+              && writeArray( fp, layout, 3 ) && writeArray( fp, &pluginInfoSize, 1 )
+              && writeArray( fp, aCacheItem->pluginInfo.data(), pluginInfoSize )
+              && writeArray( fp, &model->m_MaterialsSize, 1 )
+              && writeArray( fp, model->m_Materials, model->m_MaterialsSize )
+              && writeArray( fp, &model->m_MeshesSize, 1 );
+
+    for( unsigned int i = 0; ok && i < model->m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = model->m_Meshes[i];
+        uint32_t header[6] = { mesh.m_VertexSize, mesh.m_FaceIdxSize, mesh.m_MaterialIdx,
+                               mesh.m_Normals != NULL, mesh.m_Texcoords != NULL,
+                               mesh.m_Color != NULL };
+
+        ok = writeArray( fp, header, 6 )
+             && writeArray( fp, mesh.m_Positions, mesh.m_VertexSize )
+             && ( !mesh.m_Normals || writeArray( fp, mesh.m_Normals, mesh.m_VertexSize ) )
+             && ( !mesh.m_Texcoords || writeArray( fp, mesh.m_Texcoords, mesh.m_VertexSize ) )
+             && ( !mesh.m_Color || writeArray( fp, mesh.m_Color, mesh.m_VertexSize ) )
+             && writeArray( fp, mesh.m_FaceIdx, mesh.m_FaceIdxSize );
+    }
+
+    ok = ( fclose( fp ) == 0 ) && ok;
+
+    if( ok )
+        ok = wxRenameFile( tmpname, fname, true );
+
+    if( !ok )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write model cache '%s'", fname );
+        wxRemoveFile( tmpname );
+    }
+
+    return ok;
+}
+
+
 bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
 {
     if( !m_ConfigDir.empty() )
@@ -659,6 +1153,7 @@ bool S3D_CACHE::SetProjectDir( const wxString& aProjDir )
         }
 
         m_CacheList.clear();
+        m_MemoryUsage = 0;
 
         return true;
     }
@@ -705,6 +1200,9 @@ void S3D_CACHE::FlushCache( bool closePlugins )
 
     m_CacheList.clear();
     m_CacheMap.clear();
+    m_MemoryUsage = 0;
+
+    saveFileIndex();
 
     if( closePlugins )
         ClosePlugins();
@@ -713,6 +1211,40 @@ void S3D_CACHE::FlushCache( bool closePlugins )
 }
 
 
+void S3D_CACHE::SetMemoryBudget( size_t aBytes )
+{
+    m_MemoryBudget = aBytes;
+    trimCache( NULL );
+}
+
+
+void S3D_CACHE::trimCache( S3D_CACHE_ENTRY* aKeep )
+{
+    if( 0 == m_MemoryBudget )
+        return;
+
+    std::list< S3D_CACHE_ENTRY* >::iterator sL = m_CacheList.begin();
+    std::list< S3D_CACHE_ENTRY* >::iterator eL = m_CacheList.end();
+
+    while( m_MemoryUsage > m_MemoryBudget && sL != eL )
+    {
+        S3D_CACHE_ENTRY* ep = *sL;
+        ++sL;
+
+        if( ep == aKeep || 0 == ep->memSize )
+            continue;
+
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] releasing '%s' (%lu bytes)",
+                    ep->GetCacheBaseName(), ep->memSize );
+
+        // the scene graph is not counted, so it is kept; the render data is read back
+        // from the disk cache, or converted again from the scene graph
+        m_MemoryUsage -= ep->memSize;
+        ep->ReleaseModel();
+    }
+}
+
+
 void S3D_CACHE::ClosePlugins( void )
 {
     if( NULL != m_Plugins )
@@ -725,27 +1257,245 @@ void S3D_CACHE::ClosePlugins( void )
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
 {
     S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
-
-    if( !sp )
-        return NULL;
+    SCENEGRAPH* sp = load( aModelFileName, &cp, true );
 
     if( !cp )
     {
-        wxLogTrace( MASK_3D_CACHE,
-                    "%s:%s:%d\n  * [BUG] model loaded with no associated S3D_CACHE_ENTRY",
-                    __FILE__, __FUNCTION__, __LINE__ );
+        if( sp )
+        {
+            wxLogTrace( MASK_3D_CACHE,
+                        "%s:%s:%d\n  * [BUG] model loaded with no associated S3D_CACHE_ENTRY",
+                        __FILE__, __FUNCTION__, __LINE__ );
+        }
 
         return NULL;
     }
 
-    if( cp->renderData )
-        return cp->renderData;
+    if( !cp->renderData )
+    {
+        if( !sp )
+            return NULL;
+
+        cp->renderData = S3D::GetModel( sp );
+
+        if( !cp->renderData )
+            return NULL;
+
+        cp->memSize = modelMemorySize( cp->renderData );
+        m_MemoryUsage += cp->memSize;
+        saveModelData( cp );
+    }
+
+    trimCache( cp );
+
+    return cp->renderData;
+}
+
+
+/**
+ * Returns true if the plugin reading aFileName may be called by several threads at once.
+ * The VRML plugin parses numbers without switching the process wide locale (X3D files
+ * still do); the IDF plugin switches it, and the other plugins use libraries which are
+ * not known to be thread safe, so their models are only read by GetModel().
+ */
+static bool isConcurrentModel( const wxString& aFileName )
+{
+    return wxFileName( aFileName ).GetExt().Lower() == wxT( "wrl" );
+}
+
+
+void S3D_CACHE::PreloadModels( const std::vector<wxString>& aModelFiles, REPORTER* aReporter )
+{
+    // models are identified by the hash of their file, which names the cache files
+    if( m_CacheDir.empty() )
+        return;
+
+    struct PRELOAD_ITEM
+    {
+        wxString      fullPath;
+        wxDateTime    modTime;
+        wxULongLong   fileSize;
+        bool          hashed;
+        bool          indexed;
+        bool          parse;        ///< read by the plugin if there is no binary cache
+        unsigned char sha1sum[20];
+        std::string   pluginInfo;
+        SCENEGRAPH*   scene;        ///< set when the model was read by the plugin
+        S3DMODEL*     model;
+    };
+
+    wxCriticalSectionLocker   lock( lock3D_cache );
+    std::vector<PRELOAD_ITEM> items;
+    std::set<wxString>        fileSet;
+
+    loadFileIndex();
+
+    // Resolving the paths and looking up the index is quick and uses the shared
+    // state, so it is done here before starting the workers
+    for( const wxString& modelFile : aModelFiles )
+    {
+        wxString fullPath = m_FNResolver->ResolvePath( modelFile );
+
+        if( fullPath.empty() || !fileSet.insert( fullPath ).second
+                || m_CacheMap.find( fullPath ) != m_CacheMap.end() )
+            continue;
+
+        wxFileName fname( fullPath );
+
+        if( !fname.FileExists() )
+            continue;
+
+        PRELOAD_ITEM item;
+        item.fullPath = fullPath;
+        item.modTime = fname.GetModificationTime();
+        item.fileSize = fname.GetSize();
+        item.hashed = false;
+        item.indexed = false;
+        item.parse = isConcurrentModel( fullPath );
+        item.scene = NULL;
+        item.model = NULL;
+
+        auto fi = m_FileIndex.find( fullPath );
+
+        if( fi != m_FileIndex.end() && fi->second.fileSize == item.fileSize
+                && fi->second.modTime == item.modTime.GetValue() )
+        {
+            memcpy( item.sha1sum, fi->second.sha1sum, 20 );
+            item.hashed = true;
+            item.indexed = true;
+        }
+
+        items.push_back( item );
+    }
+
+    if( items.empty() )
+        return;
+
+    // The workers only touch their own items, and the plugin manager to parse the
+    // models of isConcurrentModel(); the memory used by the models they read is shared
+    // so they stop at the budget like trimCache() would
+    std::atomic<size_t> nextItem( 0 );
+    std::atomic<size_t> doneCount( 0 );
+    std::atomic<size_t> memoryUsage( m_MemoryUsage );
+    const wxString      cacheDir = m_CacheDir;
+    const size_t        memoryBudget = m_MemoryBudget;
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                   items.size() );
+    std::vector<std::future<size_t>> returns( std::max<size_t>( parallelThreadCount, 1 ) );
+
+    auto preload_lambda = [&]() -> size_t
+    {
+        size_t count = 0;
+
+        for( size_t i = nextItem.fetch_add( 1 ); i < items.size(); i = nextItem.fetch_add( 1 ) )
+        {
+            PRELOAD_ITEM& item = items[i];
+
+            if( !item.hashed )
+                item.hashed = getSHA1( item.fullPath, item.sha1sum );
+
+            if( item.hashed && ( 0 == memoryBudget || memoryUsage < memoryBudget ) )
+            {
+                item.model = readModelFile( cacheDir + sha1ToWXString( item.sha1sum )
+                                            + wxT( ".3dm" ), item.pluginInfo );
+
+                if( !item.model && item.parse )
+                {
+                    item.scene = m_Plugins->Load3DModel( item.fullPath, item.pluginInfo );
+
+                    if( item.scene )
+                        item.model = S3D::GetModel( item.scene );
+                }
+
+                if( item.model )
+                {
+                    memoryUsage += modelMemorySize( item.model );
+                    ++count;
+                }
+            }
+
+            doneCount++;
+        }
+
+        return count;
+    };
+
+    for( size_t ii = 0; ii < returns.size(); ++ii )
+        returns[ii] = std::async( std::launch::async, preload_lambda );
+
+    size_t loaded = 0;
+
+    for( auto& ret : returns )
+    {
+        std::future_status status;
+
+        do
+        {
+            status = ret.wait_for( std::chrono::milliseconds( 100 ) );
+
+            if( aReporter )
+            {
+                aReporter->Report( wxString::Format( _( "Loading 3D models %lu/%lu" ),
+                                                     (unsigned long) doneCount.load(),
+                                                     (unsigned long) items.size() ) );
+            }
+        } while( status != std::future_status::ready );
+
+        loaded += ret.get();
+    }
+
+    // Commit the results in the order of the list, so the least recently used
+    // order of the cache is the same as when loading the models one by one
+    for( PRELOAD_ITEM& item : items )
+    {
+        if( !item.hashed )
+            continue;
+
+        if( !item.indexed )
+        {
+            S3D_FILE_INFO& info = m_FileIndex[item.fullPath];
+            info.fileSize = item.fileSize;
+            info.modTime = item.modTime.GetValue();
+            memcpy( info.sha1sum, item.sha1sum, 20 );
+            m_DirtyCache = true;
+        }
+
+        if( NULL == item.model && NULL == item.scene )
+            continue;
 
-    S3DMODEL* mp = S3D::GetModel( sp );
-    cp->renderData = mp;
+        // the model must be converted again if the plugin which read it has changed
+        if( NULL == item.scene && !m_Plugins->CheckTag( item.pluginInfo.c_str() ) )
+        {
+            S3D::Destroy3DModel( &item.model );
+            continue;
+        }
+
+        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
+        m_CacheList.push_back( ep );
+        ep->listPos = std::prev( m_CacheList.end() );
+        ep->modTime = item.modTime;
+        ep->SetSHA1( item.sha1sum );
+        ep->pluginInfo = item.pluginInfo;
+        ep->sceneData = item.scene;
+        ep->renderData = item.model;
+        m_CacheMap[item.fullPath] = ep;
+
+        if( item.model )
+        {
+            ep->memSize = modelMemorySize( item.model );
+            m_MemoryUsage += ep->memSize;
+        }
+
+        // the cache files are written here, as GetModel() would write them
+        if( item.scene )
+        {
+            saveCacheData( ep );
+            saveModelData( ep );
+        }
+    }
 
-    return mp;
+    wxLogTrace( MASK_3D_CACHE, " * [3D model] preloaded %lu of %lu models",
+                (unsigned long) loaded, (unsigned long) items.size() );
 }
 
 
@@ -765,7 +1515,7 @@ wxString S3D_CACHE::GetModelHash( const wxString& aModelFileName )
 
     // a cache item does not exist; search the Filename->Cachename map
     S3D_CACHE_ENTRY* cp = NULL;
-    checkCache( full3Dpath, &cp );
+    checkCache( full3Dpath, &cp, true );
 
     if( NULL != cp )
         return cp->GetCacheBaseName();
@@ -31,6 +31,8 @@
 
 #include <list>
 #include <map>
+#include <vector>
+#include <wx/longlong.h>
 #include <wx/string.h>
 #include "kicad_string.h"
 #include "filename_resolver.h"
@@ -44,12 +46,25 @@ class  S3D_CACHE_ENTRY;
 class  SCENEGRAPH;
 class  FILENAME_RESOLVER;
 class  S3D_PLUGIN_MANAGER;
+class  REPORTER;
+
+
+/**
+ * Identification of a model file in the on-disk cache index; the SHA1 digest
+ * is trusted as long as the file size and modification time do not change.
+ */
+struct S3D_FILE_INFO
+{
+    wxLongLong    fileSize;
+    wxLongLong    modTime;      // modification time in ms since the epoch
+    unsigned char sha1sum[20];
+};
 
 
 class S3D_CACHE
 {
 private:
-    /// cache entries
+    /// cache entries, least recently used first
     std::list< S3D_CACHE_ENTRY* > m_CacheList;
 
     /// mapping of file names to cache names and data
@@ -61,9 +76,21 @@ private:
     /// plugin manager
     S3D_PLUGIN_MANAGER* m_Plugins;
 
-    /// set true if the cache needs to be updated
+    /// on-disk index of the model files already hashed
+    std::map< wxString, S3D_FILE_INFO, rsort_wxString > m_FileIndex;
+
+    /// set true once the on-disk index has been read
+    bool m_FileIndexLoaded;
+
+    /// set true if the on-disk index needs to be updated
     bool m_DirtyCache;
 
+    /// memory used by the render data of the cache entries, in bytes
+    size_t m_MemoryUsage;
+
+    /// maximum memory to use for render data before releasing unused models (0 = no limit)
+    size_t m_MemoryBudget;
+
     /// 3D cache directory
     wxString m_CacheDir;
 
@@ -81,10 +108,12 @@ private:
      *
      * @param[in]   aFileName   file name (full or partial path)
      * @param[out]  aCachePtr   optional return address for cache entry pointer
+     * @param[in]   aModelOnly  true if only the render data is needed
      * @return      SCENEGRAPH object associated with file name
-     * @retval      NULL    on error
+     * @retval      NULL    on error, or if only the render data was loaded
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                            bool aModelOnly = false );
 
     /**
      * Function getSHA1
@@ -97,14 +126,57 @@ private:
      */
     bool getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
 
+    /**
+     * Function getFileSHA1
+     * returns the SHA1 hash of the given file, from the on-disk index if the
+     * file size and modification time are unchanged, otherwise by hashing the
+     * file contents and updating the index
+     *
+     * @param[in]   aFileName   file name (full path)
+     * @param[out]  aSHA1Sum    a 20 byte character array to hold the SHA1 hash
+     * @retval      true        success
+     * @retval      false       failure
+     */
+    bool getFileSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
+
+    // load and save the on-disk index of model file hashes
+    void loadFileIndex();
+    void saveFileIndex();
+
     // load scene data from a cache file
     bool loadCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
+    // load render data from a binary model cache file
+    bool loadModelData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save render data to a binary model cache file
+    bool saveModelData( S3D_CACHE_ENTRY* aCacheItem );
+
+    /**
+     * Loads the data of a cache entry from the cache files or from the model file.
+     *
+     * @param aCacheItem is the entry to load
+     * @param aFileName is the full path of the model file
+     * @param aModelOnly is true if only the render data is needed, in which case
+     * the binary model cache is used when available and no scene graph is loaded
+     */
+    void loadEntryData( S3D_CACHE_ENTRY* aCacheItem, const wxString& aFileName,
+                        bool aModelOnly );
+
+    /**
+     * Releases the data of the least recently used entries until the memory
+     * used by render data is within the budget.
+     *
+     * @param aKeep is an entry which must not be released
+     */
+    void trimCache( S3D_CACHE_ENTRY* aKeep );
+
     // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                      bool aModelOnly = false );
 
 public:
     S3D_CACHE();
@@ -184,6 +256,35 @@ public:
      */
     void FlushCache( bool closePlugins = true );
 
+    /**
+     * Function SetMemoryBudget
+     * sets the memory which may be used by the render data of the cached
+     * models; when it is exceeded the render data of the least recently used
+     * models is released, and will be reloaded from the disk cache when needed
+     * again.  The scene graphs are neither counted nor released.
+     *
+     * @param aBytes is the budget in bytes, or 0 for no limit
+     */
+    void SetMemoryBudget( size_t aBytes );
+
+    /**
+     * Function PreloadModels
+     * loads the render data of a list of models into the cache, so the following
+     * calls to GetModel() for them do not read any file.  Hashing the model files
+     * and reading the binary model caches is shared between worker threads.
+     *
+     * VRML models without a binary cache are parsed by the workers too, and their cache
+     * files are written afterwards.  Other models without a binary cache are parsed by
+     * their plugin in GetModel(), on the calling thread: the IDF plugin switches the
+     * process wide numeric locale while parsing, and the other plugins are not known to
+     * be thread safe.
+     * Preloading stops when the memory budget is reached.
+     *
+     * @param aModelFiles is the list of model file names, duplicates are allowed
+     * @param aReporter is an optional reporter for the progress
+     */
+    void PreloadModels( const std::vector<wxString>& aModelFiles, REPORTER* aReporter = NULL );
+
     /**
      * Function ClosePlugins
      * unloads plugins to free memory
@@ -195,6 +296,11 @@ public:
      * attempts to load the scene data for a model and to translate it
      * into an S3D_MODEL structure for display by a renderer
      *
+     * The returned data remains owned by the cache.  It is only valid until the next
+     * call to GetModel(), Load(), SetMemoryBudget() or FlushCache(): they can release
+     * it to stay within the memory budget, or because the model file changed.  Callers
+     * must copy what they need before (as the renderers do), or call GetModel() again.
+     *
      * @param aModelFileName is the full path to the model to be loaded
      * @return is a pointer to the render data or NULL if not available
      */
@@ -22,6 +22,7 @@
  */
 
 
+#include <advanced_config.h>
 #include <common.h>
 #include <pgm_base.h>
 #include "3d_cache_wrapper.h"
@@ -65,6 +66,7 @@ S3D_CACHE* PROJECT::Get3DCacheManager( bool updateProjDir )
         cfgpath.AppendDir( wxT( "3d" ) );
         cache->SetProgramBase( &Pgm() );
         cache->Set3DConfigDir( cfgpath.GetFullPath() );
+        cache->SetMemoryBudget( (size_t) ADVANCED_CFG::GetCfg().m_3DModelCacheBudget * 1024 * 1024 );
         SetElem( ELEM_3DCACHE, cw );
         updateProjDir = true;
     }
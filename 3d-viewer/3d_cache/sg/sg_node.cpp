@@ -45,7 +45,9 @@ static const std::string node_names[S3D::SGTYPE_END + 1] = {
 };
 
 
-static unsigned int node_counts[S3D::SGTYPE_END] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+// Models are loaded by several threads (see S3D_CACHE::PreloadModels()), each names the
+// nodes of its own models
+static thread_local unsigned int node_counts[S3D::SGTYPE_END] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
 
 
 char const* S3D::GetNodeTypeName( S3D::SGTYPES aType )
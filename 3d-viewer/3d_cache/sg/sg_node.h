@@ -210,7 +210,7 @@ public:
 
     /**
      * Function ResetNodeIndex
-     * resets the global SG* node indices in preparation for
+     * resets the SG* node indices of the calling thread in preparation for
      * Write() operations
      */
     void ResetNodeIndex( void );
@@ -422,6 +422,16 @@ class CINFO3D_VISU
     void createLayers( REPORTER *aStatusTextReporter );
     void destroyLayers();
 
+    /**
+     * @brief layerSignature - Hash everything used to build the objects and
+     * the polygons of a layer, so an unchanged layer can be kept on reload
+     * @param aLayerId - the layer
+     * @param aTrackList - the tracks and vias of the enabled layers
+     * @return the signature of the layer
+     */
+    size_t layerSignature( PCB_LAYER_ID aLayerId,
+                           const std::vector< const TRACK *> &aTrackList ) const;
+
     // Helper functions to create the board
     COBJECT2D *createNewTrack( const TRACK* aTrack , int aClearanceValue ) const;
 
@@ -580,6 +590,9 @@ private:
     /// It contains the holes per each layer
     MAP_CONTAINER_2D  m_layers_holes2D;
 
+    /// Signature of each layer of m_layers_container2D when it was built
+    std::map< PCB_LAYER_ID, size_t > m_layers_signature;
+
     /// It contains the list of throughHoles of the board,
     /// the radius of the hole is inflated with the copper tickness
     CBVHCONTAINER2D   m_through_holes_outer;
@@ -53,6 +53,7 @@
 #include <gr_text.h>
 #include <utility>
 #include <vector>
+#include <mutex>
 
 
 
@@ -64,6 +65,10 @@ static CGENERICCONTAINER2D *s_dstcontainer = NULL;
 static float s_biuTo3Dunits;
 static const BOARD_ITEM *s_boardItem = NULL;
 
+// GRText draws using a single shared BASIC_GAL and the variables above, so texts
+// are converted one at a time even when the layers are built by several threads.
+static std::mutex s_textLock;
+
 // This is a call back function, used by GRText to draw the 3D text shape:
 void addTextSegmToContainer( int x0, int y0, int xf, int yf, void* aData )
 {
@@ -97,6 +102,8 @@ void CINFO3D_VISU::AddShapeWithClearanceToContainer( const TEXTE_PCB* aText,
     if( aText->IsMirrored() )
         size.x = -size.x;
 
+    std::lock_guard<std::mutex> lock( s_textLock );
+
     s_boardItem    = (const BOARD_ITEM *) &aText;
     s_dstcontainer = aDstContainer;
     s_textWidth    = aText->GetThickness() + ( 2 * aClearanceValue );
@@ -215,6 +222,11 @@ void CINFO3D_VISU::AddGraphicsShapesWithClearanceToContainer( const MODULE* aMod
     if( aModule->Value().GetLayer() == aLayerId && aModule->Value().IsVisible() )
         texts.push_back( &aModule->Value() );
 
+    if( texts.empty() )
+        return;
+
+    std::lock_guard<std::mutex> lock( s_textLock );
+
     s_boardItem    = (const BOARD_ITEM *)&aModule->Value();
     s_dstcontainer = aDstContainer;
     s_biuTo3Dunits = m_biuTo3Dunits;
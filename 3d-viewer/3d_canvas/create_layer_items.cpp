@@ -55,6 +55,9 @@
 #include <thread>
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 
 #include <profile.h>
 
@@ -135,13 +138,280 @@ void CINFO3D_VISU::destroyLayers()
 
     m_through_outer_holes_vias_poly.RemoveAllContours();
     m_through_inner_holes_vias_poly.RemoveAllContours();
+
+    m_layers_signature.clear();
 }
 
 
-void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
+/**
+ * Run aJob( i ) for each i in [0, aCount) on a pool of threads, each thread
+ * taking the next index to process, and wait until all of them are done.
+ */
+template<typename JOB>
+static void parallelForEach( size_t aCount, JOB aJob )
 {
-    destroyLayers();
+    if( aCount == 0 )
+        return;
+
+    std::atomic<size_t> nextItem( 0 );
+    std::atomic<size_t> threadsFinished( 0 );
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), aCount );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        std::thread t = std::thread( [&nextItem, &threadsFinished, &aJob, aCount]()
+        {
+            for( size_t i = nextItem.fetch_add( 1 ); i < aCount; i = nextItem.fetch_add( 1 ) )
+                aJob( i );
+
+            threadsFinished++;
+        } );
+
+        t.detach();
+    }
+
+    while( threadsFinished < parallelThreadCount )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+}
+
+
+// Helpers to compute the layer signatures, see boost::hash_combine
+static inline void hashCombine( size_t &aSeed, size_t aValue )
+{
+    aSeed ^= aValue + 0x9e3779b9 + ( aSeed << 6 ) + ( aSeed >> 2 );
+}
+
+
+static void hashPoint( size_t &aSeed, const wxPoint &aPoint )
+{
+    hashCombine( aSeed, std::hash<int>{}( aPoint.x ) );
+    hashCombine( aSeed, std::hash<int>{}( aPoint.y ) );
+}
+
+
+static void hashPolySet( size_t &aSeed, const SHAPE_POLY_SET &aPolySet )
+{
+    for( int ii = 0; ii < aPolySet.OutlineCount(); ++ii )
+    {
+        for( const SHAPE_LINE_CHAIN &contour : aPolySet.CPolygon( ii ) )
+        {
+            hashCombine( aSeed, std::hash<int>{}( contour.PointCount() ) );
+
+            for( int jj = 0; jj < contour.PointCount(); ++jj )
+            {
+                hashCombine( aSeed, std::hash<int>{}( contour.CPoint( jj ).x ) );
+                hashCombine( aSeed, std::hash<int>{}( contour.CPoint( jj ).y ) );
+            }
+        }
+    }
+}
+
+
+static void hashBoardItem( size_t &aSeed, const BOARD_ITEM *aItem )
+{
+    hashCombine( aSeed, std::hash<const void *>{}( aItem ) );
+    hashCombine( aSeed, std::hash<int>{}( aItem->Type() ) );
+    hashCombine( aSeed, std::hash<unsigned long long>{}( aItem->GetLayerSet().to_ullong() ) );
+}
+
+
+static void hashText( size_t &aSeed, const EDA_TEXT &aText )
+{
+    hashCombine( aSeed, std::hash<std::string>{}( aText.GetShownText().ToStdString() ) );
+    hashPoint( aSeed, aText.GetTextPos() );
+    hashCombine( aSeed, std::hash<int>{}( aText.GetTextWidth() ) );
+    hashCombine( aSeed, std::hash<int>{}( aText.GetTextHeight() ) );
+    hashCombine( aSeed, std::hash<int>{}( aText.GetThickness() ) );
+    hashCombine( aSeed, std::hash<double>{}( aText.GetTextAngle() ) );
+    hashCombine( aSeed, std::hash<int>{}( aText.GetHorizJustify() ) );
+    hashCombine( aSeed, std::hash<int>{}( aText.GetVertJustify() ) );
+    hashCombine( aSeed, std::hash<bool>{}( aText.IsMirrored() ) );
+    hashCombine( aSeed, std::hash<bool>{}( aText.IsItalic() ) );
+    hashCombine( aSeed, std::hash<bool>{}( aText.IsBold() ) );
+    hashCombine( aSeed, std::hash<bool>{}( aText.IsVisible() ) );
+    hashCombine( aSeed, std::hash<bool>{}( aText.IsMultilineAllowed() ) );
+}
+
+
+static void hashDrawSegment( size_t &aSeed, const DRAWSEGMENT *aSegment )
+{
+    hashCombine( aSeed, std::hash<int>{}( aSegment->GetShape() ) );
+    hashCombine( aSeed, std::hash<int>{}( aSegment->GetWidth() ) );
+    hashCombine( aSeed, std::hash<double>{}( aSegment->GetAngle() ) );
+    hashPoint( aSeed, aSegment->GetStart() );
+    hashPoint( aSeed, aSegment->GetEnd() );
+    hashPoint( aSeed, aSegment->GetBezControl1() );
+    hashPoint( aSeed, aSegment->GetBezControl2() );
+    hashPolySet( aSeed, aSegment->GetPolyShape() );
+}
+
+
+static void hashPad( size_t &aSeed, const D_PAD *aPad )
+{
+    hashPoint( aSeed, aPad->GetPosition() );
+    hashPoint( aSeed, aPad->GetOffset() );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetSize().x ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetSize().y ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetDelta().x ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetDelta().y ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetDrillSize().x ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetDrillSize().y ) );
+    hashCombine( aSeed, std::hash<double>{}( aPad->GetOrientation() ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetShape() ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetAnchorPadShape() ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetDrillShape() ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetAttribute() ) );
+    hashCombine( aSeed, std::hash<double>{}( aPad->GetRoundRectRadiusRatio() ) );
+    hashCombine( aSeed, std::hash<double>{}( aPad->GetChamferRectRatio() ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetChamferPositions() ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetSolderMaskMargin() ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetSolderPasteMargin().x ) );
+    hashCombine( aSeed, std::hash<int>{}( aPad->GetSolderPasteMargin().y ) );
+    hashPolySet( aSeed, aPad->GetCustomShapeAsPolygon() );
+}
+
+
+size_t CINFO3D_VISU::layerSignature( PCB_LAYER_ID aLayerId,
+                                     const std::vector< const TRACK *> &aTrackList ) const
+{
+    size_t ret = std::hash<int>{}( aLayerId );
+
+    // Settings used when building the layer
+    hashCombine( ret, std::hash<int>{}( m_render_engine ) );
+    hashCombine( ret, std::hash<bool>{}( GetFlag( FL_ZONE ) ) );
+    hashCombine( ret, std::hash<bool>{}( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) ) );
+    hashCombine( ret, std::hash<int>{}( GetCopperThicknessBIU() ) );
+    hashCombine( ret, std::hash<int>{}( g_DrawDefaultLineThickness ) );
+    hashCombine( ret, std::hash<float>{}( m_biuTo3Dunits ) );
+    hashCombine( ret, std::hash<float>{}( m_calc_seg_min_factor3DU ) );
+    hashCombine( ret, std::hash<float>{}( m_calc_seg_max_factor3DU ) );
+
+    // Tracks and vias
+    for( const TRACK *track : aTrackList )
+    {
+        if( !track->IsOnLayer( aLayerId ) )
+            continue;
+
+        hashBoardItem( ret, track );
+        hashPoint( ret, track->GetStart() );
+        hashPoint( ret, track->GetEnd() );
+        hashCombine( ret, std::hash<int>{}( track->GetWidth() ) );
+    }
+
+    // Pads and graphic items of the modules
+    for( auto module : m_board->Modules() )
+    {
+        size_t moduleSignature = 0;
+        bool   isOnLayer = false;
 
+        for( auto pad : module->Pads() )
+        {
+            if( !pad->IsOnLayer( aLayerId ) )
+                continue;
+
+            hashBoardItem( moduleSignature, pad );
+            hashPad( moduleSignature, pad );
+            isOnLayer = true;
+        }
+
+        for( auto item : module->GraphicalItems() )
+        {
+            if( item->GetLayer() != aLayerId )
+                continue;
+
+            hashBoardItem( moduleSignature, item );
+
+            if( item->Type() == PCB_MODULE_EDGE_T )
+                hashDrawSegment( moduleSignature, static_cast<const EDGE_MODULE *>( item ) );
+            else if( item->Type() == PCB_MODULE_TEXT_T )
+                hashText( moduleSignature, *static_cast<const TEXTE_MODULE *>( item ) );
+
+            isOnLayer = true;
+        }
+
+        for( const TEXTE_MODULE *text : { &module->Reference(), &module->Value() } )
+        {
+            if( text->GetLayer() != aLayerId )
+                continue;
+
+            hashBoardItem( moduleSignature, text );
+            hashText( moduleSignature, *text );
+            isOnLayer = true;
+        }
+
+        if( !isOnLayer )
+            continue;
+
+        // Edges and texts are placed from the module position and orientation
+        hashPoint( ret, module->GetPosition() );
+        hashCombine( ret, std::hash<double>{}( module->GetOrientation() ) );
+        hashCombine( ret, moduleSignature );
+    }
+
+    // Board graphic items
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        hashBoardItem( ret, item );
+
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+            hashDrawSegment( ret, static_cast<const DRAWSEGMENT *>( item ) );
+            break;
+
+        case PCB_TEXT_T:
+            hashText( ret, *static_cast<const TEXTE_PCB *>( item ) );
+            break;
+
+        case PCB_DIMENSION_T:
+        {
+            const DIMENSION *dimension = static_cast<const DIMENSION *>( item );
+
+            hashText( ret, dimension->Text() );
+            hashCombine( ret, std::hash<int>{}( dimension->GetWidth() ) );
+
+            for( const wxPoint *point : { &dimension->m_crossBarO, &dimension->m_crossBarF,
+                                          &dimension->m_featureLineGO, &dimension->m_featureLineGF,
+                                          &dimension->m_featureLineDO, &dimension->m_featureLineDF,
+                                          &dimension->m_arrowD1F, &dimension->m_arrowD2F,
+                                          &dimension->m_arrowG1F, &dimension->m_arrowG2F } )
+                hashPoint( ret, *point );
+        }
+        break;
+
+        default:
+            break;
+        }
+    }
+
+    // Filled areas of the zones
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
+        {
+            const ZONE_CONTAINER* zone = m_board->GetArea( ii );
+
+            if( !zone->IsOnLayer( aLayerId ) )
+                continue;
+
+            hashBoardItem( ret, zone );
+            hashCombine( ret, std::hash<int>{}( zone->GetMinThickness() ) );
+            hashCombine( ret, std::hash<bool>{}( zone->GetFilledPolysUseThickness() ) );
+            hashPolySet( ret, zone->GetFilledPolysList() );
+        }
+    }
+
+    return ret;
+}
+
+
+void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
+{
     // Build Copper layers
     // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L692
     // /////////////////////////////////////////////////////////////////////////
@@ -202,12 +472,81 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     start_Time = GetRunningMicroSecs();
 #endif
 
+    // Keep the objects and polygons of the layers that did not change since
+    // the last build. Holes are always built again.
+    // /////////////////////////////////////////////////////////////////////////
+    static const PCB_LAYER_ID teckLayerList[] = {
+            B_Adhes,
+            F_Adhes,
+            B_Paste,
+            F_Paste,
+            B_SilkS,
+            F_SilkS,
+            B_Mask,
+            F_Mask,
+
+            // Aux Layers
+            Dwgs_User,
+            Cmts_User,
+            Eco1_User,
+            Eco2_User,
+            Edge_Cuts,
+            Margin
+        };
+
+    const LSET tech_set = LSET::AllNonCuMask() & LSET( teckLayerList, arrayDim( teckLayerList ) );
+
+    std::map< PCB_LAYER_ID, size_t > signatures;
+    MAP_CONTAINER_2D reusedContainers;
+    MAP_POLY         reusedPolys;
+
+    for( LSEQ seq = LSET( cu_set | tech_set ).Seq(); seq; ++seq )
+    {
+        const PCB_LAYER_ID curr_layer_id = *seq;
+
+        if( !Is3DLayerEnabled( curr_layer_id ) )
+            continue;
+
+        const size_t signature = layerSignature( curr_layer_id, trackList );
+        signatures[curr_layer_id] = signature;
+
+        auto oldSignature = m_layers_signature.find( curr_layer_id );
+        auto layerContainer = m_layers_container2D.find( curr_layer_id );
+
+        if( oldSignature == m_layers_signature.end() || oldSignature->second != signature ||
+            layerContainer == m_layers_container2D.end() || !layerContainer->second )
+            continue;
+
+        reusedContainers[curr_layer_id] = layerContainer->second;
+        m_layers_container2D.erase( layerContainer );
+
+        auto layerPoly = m_layers_poly.find( curr_layer_id );
+
+        if( layerPoly != m_layers_poly.end() )
+        {
+            reusedPolys[curr_layer_id] = layerPoly->second;
+            m_layers_poly.erase( layerPoly );
+        }
+    }
+
+    destroyLayers();
+
+    m_layers_container2D = reusedContainers;
+    m_layers_poly = reusedPolys;
+    m_layers_signature = signatures;
+
     // Prepare copper layers index and containers
     // /////////////////////////////////////////////////////////////////////////
     std::vector< PCB_LAYER_ID > layer_id;
     layer_id.clear();
     layer_id.reserve( m_copperLayersCount );
 
+    // Layers to build, the other ones were kept from the last build
+    std::vector< PCB_LAYER_ID > build_layer_id;
+    build_layer_id.reserve( m_copperLayersCount );
+
+    LSET build_layers;
+
     for( unsigned i = 0; i < arrayDim( cu_seq ); ++i )
         cu_seq[i] = ToLAYER_ID( B_Cu - i );
 
@@ -220,6 +559,12 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
 
         layer_id.push_back( curr_layer_id );
 
+        if( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() )
+            continue;
+
+        build_layer_id.push_back( curr_layer_id );
+        build_layers.set( curr_layer_id );
+
         CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
         m_layers_container2D[curr_layer_id] = layerContainer;
 
@@ -239,15 +584,14 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     if( aStatusTextReporter )
         aStatusTextReporter->Report( _( "Create tracks and vias" ) );
 
-    // Create tracks as objects and add it to container
+    // Create tracks, pads and graphic items as objects and add them to the
+    // container of their layer. Each layer is built by a single thread.
     // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+    parallelForEach( build_layer_id.size(), [&]( size_t aLayerIdx )
     {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+        const PCB_LAYER_ID curr_layer_id = build_layer_id[aLayerIdx];
 
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
+        CBVHCONTAINER2D *layerContainer = m_layers_container2D.at( curr_layer_id );
 
         // ADD TRACKS
         unsigned int nTracks = trackList.size();
@@ -263,7 +607,64 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
             // Add object item to layer container
             layerContainer->Add( createNewTrack( track, 0.0f ) );
         }
-    }
+
+        // ADD PADS
+        for( auto module : m_board->Modules() )
+        {
+            // Note: NPTH pads are not drawn on copper layers when the pad
+            // has same shape as its hole
+            AddPadsShapesWithClearanceToContainer( module,
+                                                   layerContainer,
+                                                   curr_layer_id,
+                                                   0,
+                                                   true );
+
+            // Micro-wave modules may have items on copper layers
+            AddGraphicsShapesWithClearanceToContainer( module,
+                                                       layerContainer,
+                                                       curr_layer_id,
+                                                       0 );
+        }
+
+        // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
+        for( auto item : m_board->Drawings() )
+        {
+            if( !item->IsOnLayer( curr_layer_id ) )
+                continue;
+
+            switch( item->Type() )
+            {
+            case PCB_LINE_T:
+            {
+                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                                  layerContainer,
+                                                  curr_layer_id,
+                                                  0 );
+            }
+            break;
+
+            case PCB_TEXT_T:
+                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
+                                                  layerContainer,
+                                                  curr_layer_id,
+                                                  0 );
+            break;
+
+            case PCB_DIMENSION_T:
+                AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                                  layerContainer,
+                                                  curr_layer_id,
+                                                  0 );
+            break;
+
+            default:
+                wxLogTrace( m_logTrace,
+                            wxT( "createLayers: item type: %d not implemented" ),
+                            item->Type() );
+            break;
+            }
+        }
+    } );
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
     printf( "T03: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
@@ -457,9 +858,9 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
         (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
     {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+        for( unsigned int lIdx = 0; lIdx < build_layer_id.size(); ++lIdx )
         {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+            const PCB_LAYER_ID curr_layer_id = build_layer_id[lIdx];
 
             wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
 
@@ -551,48 +952,14 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     start_Time = GetRunningMicroSecs();
 #endif
 
-    // Add modules PADs objects to containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-    {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD PADS
-        for( auto module : m_board->Modules() )
-        {
-            // Note: NPTH pads are not drawn on copper layers when the pad
-            // has same shape as its hole
-            AddPadsShapesWithClearanceToContainer( module,
-                                                   layerContainer,
-                                                   curr_layer_id,
-                                                   0,
-                                                   true );
-
-            // Micro-wave modules may have items on copper layers
-            AddGraphicsShapesWithClearanceToContainer( module,
-                                                       layerContainer,
-                                                       curr_layer_id,
-                                                       0 );
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T09: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
     // Add modules PADs poly contourns
     // /////////////////////////////////////////////////////////////////////////
     if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
         (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
     {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+        for( unsigned int lIdx = 0; lIdx < build_layer_id.size(); ++lIdx )
         {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+            const PCB_LAYER_ID curr_layer_id = build_layer_id[lIdx];
 
             wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
 
@@ -626,69 +993,14 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     start_Time = GetRunningMicroSecs();
 #endif
 
-    // Add graphic item on copper layers to object containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-    {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-        for( auto item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-            {
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            }
-            break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
-
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
-
-            default:
-                wxLogTrace( m_logTrace,
-                            wxT( "createLayers: item type: %d not implemented" ),
-                            item->Type() );
-            break;
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T11: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
     // Add graphic item on copper layers to poly contourns
     // /////////////////////////////////////////////////////////////////////////
     if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
         (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
     {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+        for( unsigned int lIdx = 0; lIdx < build_layer_id.size(); ++lIdx )
         {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+            const PCB_LAYER_ID curr_layer_id = build_layer_id[lIdx];
 
             wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
 
@@ -729,41 +1041,31 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
         if( aStatusTextReporter )
             aStatusTextReporter->Report( _( "Create zones" ) );
 
-        // Add zones objects
+        // Add zones objects. Each zone is built in its own container, then the
+        // containers are moved to their layer in the zones order.
         // /////////////////////////////////////////////////////////////////////
-        std::atomic<size_t> nextZone( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
+        const size_t nZones = m_board->GetAreaCount();
+        std::vector< std::unique_ptr< CCONTAINER2D > > zoneContainers( nZones );
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        parallelForEach( nZones, [&]( size_t aAreaId )
         {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t areaId = nextZone.fetch_add( 1 );
-                            areaId < static_cast<size_t>( m_board->GetAreaCount() );
-                            areaId = nextZone.fetch_add( 1 ) )
-                {
-                    const ZONE_CONTAINER* zone = m_board->GetArea( areaId );
+            const ZONE_CONTAINER* zone = m_board->GetArea( aAreaId );
 
-                    if( zone == nullptr )
-                        break;
+            if( zone == nullptr || !IsCopperLayer( zone->GetLayer() ) ||
+                !build_layers[zone->GetLayer()] )
+                return;
 
-                    auto layerContainer = m_layers_container2D.find( zone->GetLayer() );
-
-                    if( layerContainer != m_layers_container2D.end() )
-                        AddSolidAreasShapesToContainer( zone, layerContainer->second,
-                                                        zone->GetLayer() );
-                }
+            zoneContainers[aAreaId].reset( new CCONTAINER2D );
+            AddSolidAreasShapesToContainer( zone, zoneContainers[aAreaId].get(),
+                                            zone->GetLayer() );
+        } );
 
-                threadsFinished++;
-            } );
-
-            t.detach();
+        for( size_t areaId = 0; areaId < nZones; ++areaId )
+        {
+            if( zoneContainers[areaId] )
+                m_layers_container2D.at( m_board->GetArea( areaId )->GetLayer() )->Splice(
+                        *zoneContainers[areaId] );
         }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
@@ -783,6 +1085,9 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
             if( zone == nullptr )
                 break;
 
+            if( !IsCopperLayer( zone->GetLayer() ) || !build_layers[zone->GetLayer()] )
+                continue;
+
             auto layerContainer = m_layers_poly.find( zone->GetLayer() );
 
             if( layerContainer != m_layers_poly.end() )
@@ -804,35 +1109,14 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
         (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
     {
-        std::atomic<size_t> nextItem( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::min<size_t>(
-                std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-                layer_id.size() );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        parallelForEach( build_layer_id.size(), [&]( size_t aLayerIdx )
         {
-            std::thread t = std::thread( [&nextItem, &threadsFinished, &layer_id, this]()
-            {
-                for( size_t i = nextItem.fetch_add( 1 );
-                            i < layer_id.size();
-                            i = nextItem.fetch_add( 1 ) )
-                {
-                    auto layerPoly = m_layers_poly.find( layer_id[i] );
-
-                    if( layerPoly != m_layers_poly.end() )
-                        // This will make a union of all added contours
-                        layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
-                }
+            auto layerPoly = m_layers_poly.find( build_layer_id[aLayerIdx] );
 
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+            if( layerPoly != m_layers_poly.end() )
+                // This will make a union of all added contours
+                layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
+        } );
     }
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
@@ -891,28 +1175,11 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     if( aStatusTextReporter )
         aStatusTextReporter->Report( _( "Build Tech layers" ) );
 
-    // draw graphic items, on technical layers
-    static const PCB_LAYER_ID teckLayerList[] = {
-            B_Adhes,
-            F_Adhes,
-            B_Paste,
-            F_Paste,
-            B_SilkS,
-            F_SilkS,
-            B_Mask,
-            F_Mask,
-
-            // Aux Layers
-            Dwgs_User,
-            Cmts_User,
-            Eco1_User,
-            Eco2_User,
-            Edge_Cuts,
-            Margin
-        };
-
     // User layers are not drawn here, only technical layers
+    std::vector< PCB_LAYER_ID > tech_layer_id;
 
+    // Contours are built first, one layer after the other
+    // /////////////////////////////////////////////////////////////////////////
     for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
          seq;
          ++seq )
@@ -922,13 +1189,18 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
         if( !Is3DLayerEnabled( curr_layer_id ) )
                     continue;
 
+        if( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() )
+            continue;
+
+        tech_layer_id.push_back( curr_layer_id );
+
         CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
         m_layers_container2D[curr_layer_id] = layerContainer;
 
         SHAPE_POLY_SET *layerPoly = new SHAPE_POLY_SET;
         m_layers_poly[curr_layer_id] = layerPoly;
 
-        // Add drawing objects
+        // Add drawing contours
         // /////////////////////////////////////////////////////////////////////
         for( auto item : m_board->Drawings() )
         {
@@ -938,24 +1210,11 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
             switch( item->Type() )
             {
             case PCB_LINE_T:
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
+                ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
                 break;
 
             case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
+                ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
                 break;
 
             default:
@@ -964,7 +1223,63 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
         }
 
 
-        // Add drawing contours
+        // Add modules tech layers - contours
+        // /////////////////////////////////////////////////////////////////////
+        for( auto module : m_board->Modules() )
+        {
+            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
+            {
+                const int linewidth = g_DrawDefaultLineThickness;
+
+                for( auto pad : module->Pads() )
+                {
+                    if( !pad->IsOnLayer( curr_layer_id ) )
+                        continue;
+
+                    buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
+                }
+            }
+            else
+            {
+                transformPadsShapesWithClearanceToPolygon(
+                        module->Pads(), curr_layer_id, *layerPoly, 0, false );
+            }
+
+            // On tech layers, use a poor circle approximation, only for texts (stroke font)
+            module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id, *layerPoly, 0 );
+
+            // Add the remaining things with dynamic seg count for circles
+            transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
+        }
+
+
+        // Draw non copper zones contours
+        // /////////////////////////////////////////////////////////////////////
+        if( GetFlag( FL_ZONE ) )
+        {
+            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
+            {
+                ZONE_CONTAINER* zone = m_board->GetArea( ii );
+
+                if( !zone->IsOnLayer( curr_layer_id ) )
+                    continue;
+
+                zone->TransformSolidAreasShapesToPolygonSet( *layerPoly );
+            }
+        }
+    }
+
+    // Then the objects of each layer are built and its contours are simplified
+    // by a single thread
+    // /////////////////////////////////////////////////////////////////////////
+    parallelForEach( tech_layer_id.size(), [&]( size_t aLayerIdx )
+    {
+        const PCB_LAYER_ID curr_layer_id = tech_layer_id[aLayerIdx];
+
+        CBVHCONTAINER2D *layerContainer = m_layers_container2D.at( curr_layer_id );
+        SHAPE_POLY_SET *layerPoly = m_layers_poly.at( curr_layer_id );
+
+        // Add drawing objects
         // /////////////////////////////////////////////////////////////////////
         for( auto item : m_board->Drawings() )
         {
@@ -974,11 +1289,24 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
             switch( item->Type() )
             {
             case PCB_LINE_T:
-                ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon( *layerPoly, 0 );
+                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                                  layerContainer,
+                                                  curr_layer_id,
+                                                  0 );
                 break;
 
             case PCB_TEXT_T:
-                ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0 );
+                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
+                                                  layerContainer,
+                                                  curr_layer_id,
+                                                  0 );
+                break;
+
+            case PCB_DIMENSION_T:
+                AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                                  layerContainer,
+                                                  curr_layer_id,
+                                                  0 );
                 break;
 
             default:
@@ -1013,36 +1341,6 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
         }
 
 
-        // Add modules tech layers - contours
-        // /////////////////////////////////////////////////////////////////////
-        for( auto module : m_board->Modules() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                const int linewidth = g_DrawDefaultLineThickness;
-
-                for( auto pad : module->Pads() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
-
-                    buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
-                }
-            }
-            else
-            {
-                transformPadsShapesWithClearanceToPolygon(
-                        module->Pads(), curr_layer_id, *layerPoly, 0, false );
-            }
-
-            // On tech layers, use a poor circle approximation, only for texts (stroke font)
-            module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id, *layerPoly, 0 );
-
-            // Add the remaining things with dynamic seg count for circles
-            transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-        }
-
-
         // Draw non copper zones
         // /////////////////////////////////////////////////////////////////////
         if( GetFlag( FL_ZONE ) )
@@ -1058,21 +1356,11 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
                                                 layerContainer,
                                                 curr_layer_id );
             }
-
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                ZONE_CONTAINER* zone = m_board->GetArea( ii );
-
-                if( !zone->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                zone->TransformSolidAreasShapesToPolygonSet( *layerPoly );
-            }
         }
 
         // This will make a union of all added contours
         layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
-    }
+    } );
     // End Build Tech layers
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
@@ -38,7 +38,7 @@
 
 
 // set the initial seed to whatever you like
-static int s_randSeed = 1;
+static thread_local int s_randSeed = 1;
 
 // fast rand float, using full 32bit precision
 // returns in the range [-1, 1] (not confirmed)
@@ -53,7 +53,7 @@ float Fast_RandFloat()
 // Fast rand, as described here:
 // http://wiki.osdev.org/Random_Number_Generator
 
-static unsigned long int s_nextRandSeed = 1;
+static thread_local unsigned long int s_nextRandSeed = 1;
 
 int Fast_rand( void ) // RAND_MAX assumed to be 32767
 {
@@ -65,4 +65,7 @@ int Fast_rand( void ) // RAND_MAX assumed to be 32767
 void Fast_srand( unsigned int seed )
 {
     s_nextRandSeed = seed;
+
+    // the multiplicative generator must not be seeded with 0
+    s_randSeed = (int)( seed | 1 );
 }
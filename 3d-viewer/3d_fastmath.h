@@ -49,7 +49,8 @@
 
 // Fast Float Random Numbers
 // a small and fast implementation for random float numbers in the range [-1,1]
-// This is not thread safe
+// The generators keep their state per thread; Fast_srand seeds both of them
+// for the calling thread, so a task can get the same numbers on any thread
 float Fast_RandFloat();
 
 int Fast_rand( void );
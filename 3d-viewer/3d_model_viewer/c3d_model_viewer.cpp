@@ -136,6 +136,7 @@ void C3D_MODEL_VIEWER::Set3DModel( const S3DMODEL &a3DModel )
     m_ogl_3dmodel = NULL;
 
     m_3d_model = NULL;
+    m_3d_model_file.Clear();
 
     if( (a3DModel.m_Materials != NULL) && (a3DModel.m_Meshes != NULL) &&
         (a3DModel.m_MaterialsSize > 0) && (a3DModel.m_MeshesSize > 0) )
@@ -157,9 +158,16 @@ void C3D_MODEL_VIEWER::Set3DModel(const wxString &aModelPathName)
         const S3DMODEL* model = m_cacheManager->GetModel( aModelPathName );
 
         if( model )
+        {
             Set3DModel( (const S3DMODEL &)*model );
+
+            if( m_3d_model )
+                m_3d_model_file = aModelPathName;
+        }
         else
+        {
             Clear3DModel();
+        }
     }
 }
 
@@ -173,6 +181,7 @@ void C3D_MODEL_VIEWER::Clear3DModel()
     m_ogl_3dmodel = NULL;
 
     m_3d_model = NULL;
+    m_3d_model_file.Clear();
 
     Refresh();
 }
@@ -264,13 +273,21 @@ void C3D_MODEL_VIEWER::OnPaint( wxPaintEvent &event )
         wxLogTrace( m_logTrace, wxT( "C3D_MODEL_VIEWER::OnPaint m_reload_is_needed" ) );
 
         m_reload_is_needed = false;
-        m_ogl_3dmodel = new C_OGL_3DMODEL( *m_3d_model, MATERIAL_MODE_NORMAL );
 
-        // It convert a model as it was a board, so get the max size dimension of the board
-        // and compute the conversion scale
-        m_BiuTo3Dunits = (double)RANGE_SCALE_3D /
-                         ( (double)m_ogl_3dmodel->GetBBox().GetMaxDimension() *
-                           UNITS3D_TO_UNITSPCB );
+        // The cache may have released the model since Set3DModel(), get it again
+        if( !m_3d_model_file.IsEmpty() )
+            m_3d_model = m_cacheManager->GetModel( m_3d_model_file );
+
+        if( m_3d_model )
+        {
+            m_ogl_3dmodel = new C_OGL_3DMODEL( *m_3d_model, MATERIAL_MODE_NORMAL );
+
+            // It convert a model as it was a board, so get the max size dimension of the board
+            // and compute the conversion scale
+            m_BiuTo3Dunits = (double)RANGE_SCALE_3D /
+                             ( (double)m_ogl_3dmodel->GetBBox().GetMaxDimension() *
+                               UNITS3D_TO_UNITSPCB );
+        }
     }
 
     glViewport( 0, 0, clientSize.x, clientSize.y );
@@ -118,6 +118,9 @@ private:
     /// Original 3d model data
     const S3DMODEL *m_3d_model;
 
+    /// File of the model when it comes from the cache manager, which owns m_3d_model
+    wxString m_3d_model_file;
+
     /// Class holder for 3d model to display on openGL
     C_OGL_3DMODEL  *m_ogl_3dmodel;
 
@@ -902,6 +902,22 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER *aStatusTextReporter )
         (!m_settings.GetFlag( FL_MODULE_ATTRIBUTES_VIRTUAL )) )
         return;
 
+    // Collect the models which are not loaded yet, so the cache can read them
+    // concurrently; the OpenGL models are then created here, one by one
+    std::vector<wxString> modelFiles;
+
+    for( auto module : m_settings.GetBoard()->Modules() )
+    {
+        for( const auto& model : module->Models() )
+        {
+            if( !model.m_Filename.empty()
+                    && m_3dmodel_map.find( model.m_Filename ) == m_3dmodel_map.end() )
+                modelFiles.push_back( model.m_Filename );
+        }
+    }
+
+    m_settings.Get3DCacheManager()->PreloadModels( modelFiles, aStatusTextReporter );
+
     // Go for all modules
     for( auto module : m_settings.GetBoard()->Modules() )
     {
@@ -0,0 +1,346 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cbvh_packet_rays.h
+ * @brief The rays of a packet, as tested against the BVH nodes by the packet traversal
+ */
+
+#ifndef _CBVH_PACKET_RAYS_H_
+#define _CBVH_PACKET_RAYS_H_
+
+#include "../raypacket.h"
+#include "../hitinfo.h"
+#include <cfloat>
+
+
+// The ranged traversal tests several rays of the packet against the node bounds
+// at once when the target has SIMD instructions, otherwise it tests the rays
+// one by one with CBBOX::Intersect
+#if defined( __AVX__ )
+#include <immintrin.h>
+#define BVH_SIMD_WIDTH 8
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define BVH_SIMD_WIDTH 4
+#endif
+
+
+#ifdef BVH_SIMD_WIDTH
+
+static_assert( RAYPACKET_RAYS_PER_PACKET % BVH_SIMD_WIDTH == 0,
+               "The ray packet must be made of whole SIMD groups" );
+
+// 1 + 2 * gamma( 3 ) of PBRT, the bound of the relative error of the slab distances
+static const float s_farDistanceScale = 1.0f + 2.0f * ( 3.0f * FLT_EPSILON * 0.5f ) /
+                                                      ( 1.0f - 3.0f * FLT_EPSILON * 0.5f );
+
+#if BVH_SIMD_WIDTH == 8
+
+typedef __m256 SIMD_FLOAT;
+
+static inline SIMD_FLOAT simd_load( const float* p ) { return _mm256_load_ps( p ); }
+static inline SIMD_FLOAT simd_set1( float v ) { return _mm256_set1_ps( v ); }
+static inline SIMD_FLOAT simd_sub( SIMD_FLOAT a, SIMD_FLOAT b ) { return _mm256_sub_ps( a, b ); }
+static inline SIMD_FLOAT simd_mul( SIMD_FLOAT a, SIMD_FLOAT b ) { return _mm256_mul_ps( a, b ); }
+static inline SIMD_FLOAT simd_min( SIMD_FLOAT a, SIMD_FLOAT b ) { return _mm256_min_ps( a, b ); }
+static inline SIMD_FLOAT simd_max( SIMD_FLOAT a, SIMD_FLOAT b ) { return _mm256_max_ps( a, b ); }
+static inline void simd_store( float* p, SIMD_FLOAT a ) { _mm256_storeu_ps( p, a ); }
+
+static inline unsigned int simd_hitMask( SIMD_FLOAT aNear, SIMD_FLOAT aFar, SIMD_FLOAT aHit )
+{
+    const __m256 hit = _mm256_and_ps(
+            _mm256_and_ps( _mm256_cmp_ps( aNear, aFar, _CMP_LE_OQ ),
+                           _mm256_cmp_ps( aFar, _mm256_setzero_ps(), _CMP_GE_OQ ) ),
+            _mm256_cmp_ps( aNear, aHit, _CMP_LT_OQ ) );
+
+    return (unsigned int) _mm256_movemask_ps( hit );
+}
+
+#else
+
+typedef __m128 SIMD_FLOAT;
+
+static inline SIMD_FLOAT simd_load( const float* p ) { return _mm_load_ps( p ); }
+static inline SIMD_FLOAT simd_set1( float v ) { return _mm_set1_ps( v ); }
+static inline SIMD_FLOAT simd_sub( SIMD_FLOAT a, SIMD_FLOAT b ) { return _mm_sub_ps( a, b ); }
+static inline SIMD_FLOAT simd_mul( SIMD_FLOAT a, SIMD_FLOAT b ) { return _mm_mul_ps( a, b ); }
+static inline SIMD_FLOAT simd_min( SIMD_FLOAT a, SIMD_FLOAT b ) { return _mm_min_ps( a, b ); }
+static inline SIMD_FLOAT simd_max( SIMD_FLOAT a, SIMD_FLOAT b ) { return _mm_max_ps( a, b ); }
+static inline void simd_store( float* p, SIMD_FLOAT a ) { _mm_storeu_ps( p, a ); }
+
+static inline unsigned int simd_hitMask( SIMD_FLOAT aNear, SIMD_FLOAT aFar, SIMD_FLOAT aHit )
+{
+    const __m128 hit = _mm_and_ps( _mm_and_ps( _mm_cmple_ps( aNear, aFar ),
+                                               _mm_cmpge_ps( aFar, _mm_setzero_ps() ) ),
+                                   _mm_cmplt_ps( aNear, aHit ) );
+
+    return (unsigned int) _mm_movemask_ps( hit );
+}
+
+#endif
+
+
+/**
+ * The rays of a packet in a structure of arrays layout, so a group of rays can
+ * be tested against a bounding box with a few SIMD instructions.  It also keeps
+ * the closest hit distance of each ray, which must be updated with UpdateHits()
+ * after the rays were intersected with primitives.
+ */
+struct PACKET_RAYS
+{
+    PACKET_RAYS( const RAY* aRays, const CFRUSTUM& aFrustum,
+                 const HITINFO_PACKET* aHitInfoPacket ) :
+            m_frustum( aFrustum ),
+            m_hitInfoPacket( aHitInfoPacket )
+    {
+        // Infinite inverse directions are clamped to large values, so a ray
+        // parallel to a slab never gives 0 * inf = NaN.  The result is the same
+        // since the distances are far beyond the size of the scene.
+        const float maxInvDir = 1e30f;
+
+        for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        {
+            const RAY& ray = aRays[i];
+
+            m_originX[i] = ray.m_Origin.x;
+            m_originY[i] = ray.m_Origin.y;
+            m_originZ[i] = ray.m_Origin.z;
+            m_invDirX[i] = glm::clamp( ray.m_InvDir.x, -maxInvDir, maxInvDir );
+            m_invDirY[i] = glm::clamp( ray.m_InvDir.y, -maxInvDir, maxInvDir );
+            m_invDirZ[i] = glm::clamp( ray.m_InvDir.z, -maxInvDir, maxInvDir );
+            m_tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+        }
+    }
+
+    /**
+     * @return the bit mask of the rays of the group starting at aFirst which
+     * enter aBBox before their closest hit
+     */
+    unsigned int GroupHits( const CBBOX& aBBox, unsigned int aFirst ) const
+    {
+        SIMD_FLOAT tNear;
+
+        return groupHits( aBBox, aFirst, tNear );
+    }
+
+    /**
+     * Same as GroupHits( aBBox, aFirst ), also storing in aNear the distances at which
+     * the rays of the group enter aBBox, as CBBOX::Intersect() gives them (negative for
+     * a ray starting inside the box)
+     */
+    unsigned int GroupHits( const CBBOX& aBBox, unsigned int aFirst, float* aNear ) const
+    {
+        SIMD_FLOAT         tNear;
+        const unsigned int mask = groupHits( aBBox, aFirst, tNear );
+
+        simd_store( aNear, tNear );
+
+        return mask;
+    }
+
+    unsigned int FirstHit( const CBBOX& aBBox, unsigned int ia ) const
+    {
+        unsigned int group = ia - ( ia % BVH_SIMD_WIDTH );
+        unsigned int mask = GroupHits( aBBox, group ) >> ( ia - group );
+
+        if( mask )
+            return ia + lowestBit( mask );
+
+        if( !m_frustum.Intersect( aBBox ) )
+            return RAYPACKET_RAYS_PER_PACKET;
+
+        for( group += BVH_SIMD_WIDTH; group < RAYPACKET_RAYS_PER_PACKET; group += BVH_SIMD_WIDTH )
+        {
+            mask = GroupHits( aBBox, group );
+
+            if( mask )
+                return group + lowestBit( mask );
+        }
+
+        return RAYPACKET_RAYS_PER_PACKET;
+    }
+
+    unsigned int LastHit( const CBBOX& aBBox, unsigned int ia ) const
+    {
+        const unsigned int firstGroup = ia - ( ia % BVH_SIMD_WIDTH );
+
+        for( unsigned int group = RAYPACKET_RAYS_PER_PACKET - BVH_SIMD_WIDTH; group > firstGroup;
+                group -= BVH_SIMD_WIDTH )
+        {
+            const unsigned int mask = GroupHits( aBBox, group );
+
+            if( mask )
+                return group + highestBit( mask ) + 1;
+        }
+
+        // only the rays after ia count in its own group
+        const unsigned int mask = GroupHits( aBBox, firstGroup ) >> ( ia - firstGroup );
+
+        if( mask > 1 )
+            return ia + highestBit( mask ) + 1;
+
+        return ia + 1;
+    }
+
+    void UpdateHits( unsigned int ia, unsigned int ie )
+    {
+        for( unsigned int i = ia; i < ie; ++i )
+            m_tHit[i] = m_hitInfoPacket[i].m_HitInfo.m_tHit;
+    }
+
+private:
+    unsigned int groupHits( const CBBOX& aBBox, unsigned int aFirst, SIMD_FLOAT& aNear ) const
+    {
+        const SFVEC3F& bmin = aBBox.Min();
+        const SFVEC3F& bmax = aBBox.Max();
+
+        const SIMD_FLOAT ox = simd_load( &m_originX[aFirst] );
+        const SIMD_FLOAT oy = simd_load( &m_originY[aFirst] );
+        const SIMD_FLOAT oz = simd_load( &m_originZ[aFirst] );
+        const SIMD_FLOAT ix = simd_load( &m_invDirX[aFirst] );
+        const SIMD_FLOAT iy = simd_load( &m_invDirY[aFirst] );
+        const SIMD_FLOAT iz = simd_load( &m_invDirZ[aFirst] );
+
+        const SIMD_FLOAT tx0 = simd_mul( simd_sub( simd_set1( bmin.x ), ox ), ix );
+        const SIMD_FLOAT tx1 = simd_mul( simd_sub( simd_set1( bmax.x ), ox ), ix );
+        const SIMD_FLOAT ty0 = simd_mul( simd_sub( simd_set1( bmin.y ), oy ), iy );
+        const SIMD_FLOAT ty1 = simd_mul( simd_sub( simd_set1( bmax.y ), oy ), iy );
+        const SIMD_FLOAT tz0 = simd_mul( simd_sub( simd_set1( bmin.z ), oz ), iz );
+        const SIMD_FLOAT tz1 = simd_mul( simd_sub( simd_set1( bmax.z ), oz ), iz );
+
+        aNear = simd_max( simd_max( simd_min( tx0, tx1 ), simd_min( ty0, ty1 ) ),
+                         simd_min( tz0, tz1 ) );
+
+        SIMD_FLOAT tFar = simd_min( simd_min( simd_max( tx0, tx1 ), simd_max( ty0, ty1 ) ),
+                                    simd_max( tz0, tz1 ) );
+
+        // Widen the far distance by the rounding error of the computation, as
+        // PBRT does, so a ray grazing the box is never rejected
+        tFar = simd_mul( tFar, simd_set1( s_farDistanceScale ) );
+
+        return simd_hitMask( aNear, tFar, simd_load( &m_tHit[aFirst] ) );
+    }
+
+    static unsigned int lowestBit( unsigned int aMask )
+    {
+        unsigned int bit = 0;
+
+        while( !( aMask & 1 ) )
+        {
+            aMask >>= 1;
+            ++bit;
+        }
+
+        return bit;
+    }
+
+    static unsigned int highestBit( unsigned int aMask )
+    {
+        unsigned int bit = 0;
+
+        while( aMask >>= 1 )
+            ++bit;
+
+        return bit;
+    }
+
+    const CFRUSTUM&       m_frustum;
+    const HITINFO_PACKET* m_hitInfoPacket;
+
+    alignas( 32 ) float m_originX[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_originY[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_originZ[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_invDirX[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_invDirY[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_invDirZ[RAYPACKET_RAYS_PER_PACKET];
+    alignas( 32 ) float m_tHit[RAYPACKET_RAYS_PER_PACKET];
+};
+
+#else
+
+/**
+ * The rays of a packet, tested one by one against the bounding boxes
+ */
+struct PACKET_RAYS
+{
+    PACKET_RAYS( const RAY* aRays, const CFRUSTUM& aFrustum,
+                 const HITINFO_PACKET* aHitInfoPacket ) :
+            m_rays( aRays ),
+            m_frustum( aFrustum ),
+            m_hitInfoPacket( aHitInfoPacket )
+    {
+    }
+
+    bool RayHits( const CBBOX& aBBox, unsigned int i ) const
+    {
+        float hitT;
+
+        return aBBox.Intersect( m_rays[i], &hitT )
+               && hitT < m_hitInfoPacket[i].m_HitInfo.m_tHit;
+    }
+
+    unsigned int FirstHit( const CBBOX& aBBox, unsigned int ia ) const
+    {
+        if( RayHits( aBBox, ia ) )
+            return ia;
+
+        if( !m_frustum.Intersect( aBBox ) )
+            return RAYPACKET_RAYS_PER_PACKET;
+
+        for( unsigned int i = ia + 1; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        {
+            if( RayHits( aBBox, i ) )
+                return i;
+        }
+
+        return RAYPACKET_RAYS_PER_PACKET;
+    }
+
+    unsigned int LastHit( const CBBOX& aBBox, unsigned int ia ) const
+    {
+        for( unsigned int ie = ( RAYPACKET_RAYS_PER_PACKET - 1 ); ie > ia; --ie )
+        {
+            if( RayHits( aBBox, ie ) )
+                return ie + 1;
+        }
+
+        return ia + 1;
+    }
+
+    void UpdateHits( unsigned int ia, unsigned int ie )
+    {
+        // the hit distances are read from the hit info packet
+        (void) ia;
+        (void) ie;
+    }
+
+private:
+    const RAY*            m_rays;
+    const CFRUSTUM&       m_frustum;
+    const HITINFO_PACKET* m_hitInfoPacket;
+};
+
+#endif // BVH_SIMD_WIDTH
+
+#endif // _CBVH_PACKET_RAYS_H_
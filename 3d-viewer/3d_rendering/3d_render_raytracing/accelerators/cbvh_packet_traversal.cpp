@@ -28,6 +28,7 @@
  */
 
 #include "cbvh_pbrt.h"
+#include "cbvh_packet_rays.h"
 #include <wx/debug.h>
 
 
@@ -45,51 +46,8 @@ struct StackNode
 };
 
 
-static inline unsigned int getFirstHit( const RAYPACKET &aRayPacket,
-                                        const CBBOX &aBBox,
-                                        unsigned int ia,
-                                        HITINFO_PACKET *aHitInfoPacket )
-{
-    float hitT;
-
-    if( aBBox.Intersect( aRayPacket.m_ray[ia], &hitT ) )
-        if( hitT < aHitInfoPacket[ia].m_HitInfo.m_tHit )
-            return ia;
-
-    if( !aRayPacket.m_Frustum.Intersect( aBBox ) )
-        return RAYPACKET_RAYS_PER_PACKET;
-
-    for( unsigned int i = ia + 1; i < RAYPACKET_RAYS_PER_PACKET; ++i )
-    {
-        if( aBBox.Intersect( aRayPacket.m_ray[i], &hitT ) )
-            if( hitT < aHitInfoPacket[i].m_HitInfo.m_tHit )
-                return i;
-    }
-
-    return RAYPACKET_RAYS_PER_PACKET;
-}
-
-
 #ifdef BVH_RANGED_TRAVERSAL
 
-static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
-                                       const CBBOX &aBBox,
-                                       unsigned int ia,
-                                       HITINFO_PACKET *aHitInfoPacket )
-{
-    for( unsigned int ie = (RAYPACKET_RAYS_PER_PACKET - 1); ie > ia; --ie )
-    {
-        float hitT;
-
-        if( aBBox.Intersect( aRayPacket.m_ray[ie], &hitT ) )
-            if( hitT < aHitInfoPacket[ie].m_HitInfo.m_tHit )
-                return ie + 1;
-    }
-
-    return ia + 1;
-}
-
-
 // "Large Ray Packets for Real-time Whitted Ray Tracing"
 // http://cseweb.ucsd.edu/~ravir/whitted.pdf
 
@@ -107,13 +65,15 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
     int todoOffset = 0, nodeNum = 0;
     StackNode todo[MAX_TODOS];
 
+    PACKET_RAYS rays( aRayPacket.m_ray, aRayPacket.m_Frustum, aHitInfoPacket );
+
     unsigned int ia = 0;
 
     while( true )
     {
         const LinearBVHNode *curCell = &m_nodes[nodeNum];
 
-        ia = getFirstHit( aRayPacket, curCell->bounds, ia, aHitInfoPacket );
+        ia = rays.FirstHit( curCell->bounds, ia );
 
         if( ia < RAYPACKET_RAYS_PER_PACKET )
         {
@@ -127,10 +87,7 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
             }
             else
             {
-                const unsigned int ie = getLastHit( aRayPacket,
-                                                    curCell->bounds,
-                                                    ia,
-                                                    aHitInfoPacket );
+                const unsigned int ie = rays.LastHit( curCell->bounds, ia );
 
                 for( int j = 0; j < curCell->nPrimitives; ++j )
                 {
@@ -152,6 +109,8 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
                         }
                     }
                 }
+
+                rays.UpdateHits( ia, ie );
             }
         }
 
@@ -29,7 +29,6 @@
 
 #include "ccontainer2d.h"
 #include <vector>
-#include <mutex>
 #include <boost/range/algorithm/partition.hpp>
 #include <boost/range/algorithm/nth_element.hpp>
 #include <wx/debug.h>
@@ -45,9 +44,19 @@ CGENERICCONTAINER2D::CGENERICCONTAINER2D( OBJECT2D_TYPE aObjType )
 }
 
 
+void CGENERICCONTAINER2D::Splice( CGENERICCONTAINER2D &aOther )
+{
+    if( aOther.m_objects.empty() )
+        return;
+
+    m_objects.splice( m_objects.end(), aOther.m_objects );
+    m_bbox.Union( aOther.m_bbox );
+    aOther.m_bbox.Reset();
+}
+
+
 void CGENERICCONTAINER2D::Clear()
 {
-    std::lock_guard<std::mutex> lock( m_lock );
     m_bbox.Reset();
 
     for( LIST_OBJECT2D::iterator ii = m_objects.begin();
@@ -32,7 +32,6 @@
 
 #include "../shapes2D/cobject2d.h"
 #include <list>
-#include <mutex>
 
 typedef std::list<COBJECT2D *> LIST_OBJECT2D;
 typedef std::list<const COBJECT2D *> CONST_LIST_OBJECT2D;
@@ -49,16 +48,28 @@ public:
 
     virtual ~CGENERICCONTAINER2D();
 
+    /**
+     * @brief Add - add an object to the container
+     * The container is not thread safe: each thread must fill its own container
+     * and merge it with Splice() once all of them are done.
+     * @param aObject - the object to add, the container takes the ownership
+     */
     void Add( COBJECT2D *aObject )
     {
         if( aObject ) // Only add if it is a valid pointer
         {
-            std::lock_guard<std::mutex> lock( m_lock );
             m_objects.push_back( aObject );
             m_bbox.Union( aObject->GetBBox() );
         }
     }
 
+    /**
+     * @brief Splice - move all the objects of an other container at the end of
+     * this one, without copying them
+     * @param aOther - the container to empty
+     */
+    void Splice( CGENERICCONTAINER2D &aOther );
+
     void Clear();
 
     const LIST_OBJECT2D &GetList() const { return m_objects; }
@@ -70,9 +81,6 @@ public:
      */
     virtual void GetListObjectsIntersects( const CBBOX2D & aBBox,
                                            CONST_LIST_OBJECT2D &aOutList ) const = 0;
-
-private:
-    std::mutex m_lock;
 };
 
 
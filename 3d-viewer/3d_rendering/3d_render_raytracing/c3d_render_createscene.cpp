@@ -263,10 +263,8 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER *aStatusTextReporter )
 
     m_settings.InitSettings( aStatusTextReporter );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endReloadTime = GetRunningMicroSecs();
     unsigned stats_startConvertTime = GetRunningMicroSecs();
- #endif
 
     SFVEC3F camera_pos = m_settings.GetBoardCenter3DU();
     m_settings.CameraGet().SetBoardLookAtPos( camera_pos );
@@ -771,18 +769,14 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER *aStatusTextReporter )
 
     add_3D_vias_and_pads_to_container();
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endConvertTime = GetRunningMicroSecs();
     unsigned stats_startLoad3DmodelsTime = stats_endConvertTime;
-#endif
 
 
     load_3D_models();
 
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endLoad3DmodelsTime = GetRunningMicroSecs();
-#endif
 
     // Add floor
     // /////////////////////////////////////////////////////////////////////////
@@ -908,9 +902,7 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER *aStatusTextReporter )
     // Create an accelerator
     // /////////////////////////////////////////////////////////////////////////
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_startAcceleratorTime = GetRunningMicroSecs();
-#endif
 
     if( m_accelerator )
     {
@@ -920,12 +912,16 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER *aStatusTextReporter )
 
     m_accelerator = new CBVH_PBRT( m_object_container );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endAcceleratorTime = GetRunningMicroSecs();
-#endif
 
     setupMaterials();
 
+    m_renderStats.m_boardTime = stats_endReloadTime - stats_startReloadTime;
+    m_renderStats.m_modelsTime = stats_endLoad3DmodelsTime - stats_startLoad3DmodelsTime;
+    m_renderStats.m_sceneTime = stats_startAcceleratorTime - stats_startConvertTime
+                                - m_renderStats.m_modelsTime;
+    m_renderStats.m_acceleratorTime = stats_endAcceleratorTime - stats_startAcceleratorTime;
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
     printf( "C3D_RENDER_RAYTRACING::reload times:\n" );
     printf( "  Reload board:             %.3f ms\n", (float)( stats_endReloadTime -
@@ -1194,6 +1190,10 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // an offscreen render may be set up without any 3D model cache
+    if( !m_settings.Get3DCacheManager() )
+        return;
+
     // Go for all modules
     for( auto module : m_settings.GetBoard()->Modules() )
     {
@@ -32,6 +32,7 @@
 #include <atomic>
 #include <chrono>
 #include <climits>
+#include <cstring>
 #include <thread>
 
 #include "c3d_render_raytracing.h"
@@ -72,6 +73,7 @@ C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING( CINFO3D_VISU &aSettings ) :
     m_rt_render_state = RT_RENDER_STATE_MAX; // Set to an initial invalid state
     m_stats_start_rendering_time = 0;
     m_nrBlocksRenderProgress = 0;
+    memset( &m_renderStats, 0, sizeof( m_renderStats ) );
 }
 
 
@@ -165,6 +167,7 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
         // revert to preview mode the first time the Redraw is called
         m_oldWindowsSize = m_windowSize;
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
     std::unique_ptr<BUSY_INDICATOR> busy = CreateBusyIndicator();
@@ -191,6 +194,7 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
         requestRedraw = true;
 
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
 
@@ -298,6 +302,92 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
 }
 
 
+wxImage C3D_RENDER_RAYTRACING::RenderToImage( const wxSize& aSize,
+                                              REPORTER* aStatusTextReporter )
+{
+    // The block positions need room for a few preview blocks in each direction
+    if( aSize.x < 8 * RAYPACKET_DIM || aSize.y < 8 * RAYPACKET_DIM )
+        return wxImage();
+
+    const wxSize oldWindowSize = m_windowSize;
+
+    m_windowSize = aSize;
+    m_settings.CameraGet().SetCurWindowSize( aSize );
+
+    if( m_reloadRequested )
+        reload( aStatusTextReporter );
+
+    initialize_block_positions();
+
+    if( m_camera_light )
+        m_camera_light->SetDirection( -m_settings.CameraGet().GetDir() );
+
+    // The render works on a RGBA buffer of the block area, which is centered
+    // in the image, with the bottom row first like the OpenGL buffer
+    std::vector<GLubyte> buffer( m_realBufferSize.x * m_realBufferSize.y * 4, 0 );
+
+    m_renderStats.m_tracingTime = 0;
+    m_renderStats.m_postProcessTime = 0;
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+
+    do
+    {
+        const bool isTracing = m_rt_render_state == RT_RENDER_STATE_TRACING
+                               || m_rt_render_state >= RT_RENDER_STATE_MAX;
+        const unsigned stepStartTime = GetRunningMicroSecs();
+
+        render( buffer.data(), aStatusTextReporter );
+
+        if( isTracing )
+            m_renderStats.m_tracingTime += GetRunningMicroSecs() - stepStartTime;
+        else
+            m_renderStats.m_postProcessTime += GetRunningMicroSecs() - stepStartTime;
+    } while( m_rt_render_state != RT_RENDER_STATE_FINISH );
+
+    wxImage image( aSize.x, aSize.y, false );
+    unsigned char* rgb = image.GetData();
+
+    for( int y = 0; y < aSize.y; ++y )
+    {
+        // the rows of the image start from the top
+        const int bufferY = aSize.y - 1 - y - (int) m_yoffset;
+        const bool rowInBuffer = bufferY >= 0 && bufferY < (int) m_realBufferSize.y;
+
+        // the border is filled with the background, as OGL_DrawBackground does
+        const float posYfactor = (float) ( aSize.y - 1 - y ) / (float) aSize.y;
+        const SFVEC3F bgColor = (SFVEC3F) m_settings.m_BgColorTop * posYfactor
+                                + (SFVEC3F) m_settings.m_BgColorBot * ( 1.0f - posYfactor );
+
+        for( int x = 0; x < aSize.x; ++x, rgb += 3 )
+        {
+            const int bufferX = x - (int) m_xoffset;
+
+            if( rowInBuffer && bufferX >= 0 && bufferX < (int) m_realBufferSize.x )
+            {
+                const GLubyte* pixel = &buffer[( bufferY * m_realBufferSize.x + bufferX ) * 4];
+
+                rgb[0] = pixel[0];
+                rgb[1] = pixel[1];
+                rgb[2] = pixel[2];
+            }
+            else
+            {
+                rgb[0] = (unsigned char) glm::clamp( (int) ( bgColor.r * 255 ), 0, 255 );
+                rgb[1] = (unsigned char) glm::clamp( (int) ( bgColor.g * 255 ), 0, 255 );
+                rgb[2] = (unsigned char) glm::clamp( (int) ( bgColor.b * 255 ), 0, 255 );
+            }
+        }
+    }
+
+    // an interactive render must set up its buffers again
+    m_windowSize = oldWindowSize;
+    m_oldWindowsSize = wxSize( 0, 0 );
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+
+    return image;
+}
+
+
 void C3D_RENDER_RAYTRACING::render( GLubyte *ptrPBO , REPORTER *aStatusTextReporter )
 {
     if( (m_rt_render_state == RT_RENDER_STATE_FINISH) ||
@@ -658,6 +748,10 @@ void C3D_RENDER_RAYTRACING::rt_trace_AA_packet( const SFVEC3F *aBgColorY,
 void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
                                                    signed int iBlock )
 {
+    // The block may be traced by any thread, so the random numbers are seeded
+    // from the block to always give the same result
+    Fast_srand( (unsigned int) iBlock * 2654435761u + 1 );
+
     // Initialize ray packets
     // /////////////////////////////////////////////////////////////////////////
     const SFVEC2UI &blockPos = m_blockPositions[iBlock];
@@ -934,6 +1028,8 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_shade( GLubyte *ptrPBO,
                             y < m_realBufferSize.y;
                             y = nextBlock.fetch_add( 1 ) )
                 {
+                    Fast_srand( (unsigned int) y * 2654435761u + 1 );
+
                     SFVEC3F *ptr = &m_shaderBuffer[ y * m_realBufferSize.x ];
 
                     for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
@@ -2153,6 +2249,4 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     // Create m_shader buffer
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
-
-    opengl_init_pbo();
 }
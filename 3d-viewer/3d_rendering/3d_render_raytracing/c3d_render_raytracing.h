@@ -40,6 +40,7 @@
 #include <plugins/3dapi/c3dmodel.h>
 
 #include <map>
+#include <wx/image.h>
 
 /// Vector of materials
 typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
@@ -56,6 +57,17 @@ typedef enum
     RT_RENDER_STATE_MAX
 }RT_RENDER_STATE;
 
+/// Times of the steps of the last reload and offscreen render, in microseconds
+struct RT_RENDER_STATS
+{
+    unsigned m_boardTime;       ///< reading the board items (CINFO3D_VISU::InitSettings)
+    unsigned m_sceneTime;       ///< creating the 3D objects, without the 3D models
+    unsigned m_modelsTime;      ///< loading and adding the 3D models
+    unsigned m_acceleratorTime; ///< building the BVH
+    unsigned m_tracingTime;     ///< tracing the blocks
+    unsigned m_postProcessTime; ///< post processing shader, blur and final color
+};
+
 class C3D_RENDER_RAYTRACING : public C3D_RENDER_BASE
 {
 public:
@@ -69,6 +81,22 @@ public:
 
     int GetWaitForEditingTimeOut() override;
 
+    /**
+     * Renders the board at the final quality into an image, without any OpenGL
+     * context.  The board is reloaded if a reload was requested, and the camera
+     * of the settings is used with the size of the image.  The pseudo random
+     * numbers used by the materials and the post processing are seeded for each
+     * block, so the same settings always give the same image.
+     *
+     * @param aSize is the size of the image in pixels
+     * @param aStatusTextReporter is an optional reporter for the progress
+     * @return the rendered image, or an invalid image if aSize is too small
+     */
+    wxImage RenderToImage( const wxSize& aSize, REPORTER* aStatusTextReporter = NULL );
+
+    /// @return the times of the last reload and of the last RenderToImage()
+    const RT_RENDER_STATS& GetRenderStats() const { return m_renderStats; }
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
@@ -130,6 +158,8 @@ private:
     /// Time that the render starts
     unsigned long int m_stats_start_rendering_time;
 
+    RT_RENDER_STATS m_renderStats;
+
     /// Save the number of blocks progress of the render
     size_t m_nrBlocksRenderProgress;
 
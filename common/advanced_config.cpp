@@ -77,6 +77,13 @@ static const wxChar EnableSvgImport[] = wxT( "EnableSvgImport" );
  */
 static const wxChar RealtimeConnectivity[] = wxT( "RealtimeConnectivity" );
 
+/**
+ * Debugging mode for the incremental connectivity update.  Setting this to on will cause
+ * each incremental recalculation to be followed by a full one, and the differences to be
+ * reported.  This is slow.
+ */
+static const wxChar VerifyIncrementalConnectivity[] = wxT( "VerifyIncrementalConnectivity" );
+
 /**
  * Allow legacy canvas to be shown in GTK3. Legacy canvas is generally pretty
  * broken, but this avoids code in an ifdef where it could become broken
@@ -90,6 +97,19 @@ static const wxChar AllowLegacyCanvasInGtk3[] = wxT( "AllowLegacyCanvasInGtk3" )
  */
 static const wxChar CoroutineStackSize[] = wxT( "CoroutineStackSize" );
 
+/**
+ * Memory budget in MB for the 3D models kept in memory.  When it is exceeded, the least
+ * recently used models are released and read back from the disk cache when needed.
+ * 0 means no limit.
+ */
+static const wxChar ModelCacheBudget3D[] = wxT( "3DModelCacheBudget" );
+
+/**
+ * Autoplace footprints with a coarse to fine search of their position, instead of scoring
+ * every grid position.  Much faster on large boards, but can miss the best position.
+ */
+static const wxChar AutoplaceCoarseToFine[] = wxT( "AutoplaceCoarseToFine" );
+
 } // namespace KEYS
 
 
@@ -170,7 +190,10 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_enableSvgImport = false;
     m_allowLegacyCanvasInGtk3 = false;
     m_realTimeConnectivity = true;
+    m_verifyIncrementalConnectivity = false;
     m_coroutineStackSize = AC_STACK::default_stack;
+    m_3DModelCacheBudget = 1024;
+    m_autoplaceCoarseToFine = false;
 
     loadFromConfigFile();
 }
@@ -213,10 +236,19 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back(
             new PARAM_CFG_BOOL( true, AC_KEYS::RealtimeConnectivity, &m_realTimeConnectivity, false ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::VerifyIncrementalConnectivity,
+            &m_verifyIncrementalConnectivity, false ) );
+
     configParams.push_back(
             new PARAM_CFG_INT( true, AC_KEYS::CoroutineStackSize, &m_coroutineStackSize,
                     AC_STACK::default_stack, AC_STACK::min_stack, AC_STACK::max_stack ) );
 
+    configParams.push_back( new PARAM_CFG_INT( true, AC_KEYS::ModelCacheBudget3D,
+            &m_3DModelCacheBudget, 1024, 0, 1024 * 1024 ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::AutoplaceCoarseToFine,
+            &m_autoplaceCoarseToFine, false ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     dumpCfg( configParams );
@@ -25,6 +25,7 @@
 #include <eda_pattern_match.h>
 #include <wx/log.h>
 #include <wx/tokenzr.h>
+#include <algorithm>
 #include <climits>
 
 bool EDA_PATTERN_MATCH_SUBSTR::SetPattern( const wxString& aPattern )
@@ -340,6 +341,12 @@ const std::map<wxString, double> EDA_PATTERN_MATCH_RELATIONAL::m_units = {
 EDA_COMBINED_MATCHER::EDA_COMBINED_MATCHER( const wxString& aPattern )
     : m_pattern( aPattern )
 {
+    // Characters with a meaning for the regex, wildcard or relational matchers
+    const wxString special = wxT( ".*+?^${}()|[]/\\<=>" );
+
+    m_literal = std::none_of( aPattern.begin(), aPattern.end(),
+                              [&]( wxUniChar c ) { return special.Find( c ) != wxNOT_FOUND; } );
+
     // Whatever syntax users prefer, it shall be matched.
     AddMatcher( aPattern, std::make_unique<EDA_PATTERN_MATCH_REGEX>() );
     AddMatcher( aPattern, std::make_unique<EDA_PATTERN_MATCH_WILDCARD>() );
@@ -355,6 +362,21 @@ bool EDA_COMBINED_MATCHER::Find( const wxString& aTerm, int& aMatchersTriggered,
     aPosition = EDA_PATTERN_NOT_FOUND;
     aMatchersTriggered = 0;
 
+    // A literal pattern is found at the same place by all the matchers, which have all
+    // compiled it; a single substring search is enough.
+    if( m_literal )
+    {
+        int loc = aTerm.Find( m_pattern );
+
+        if( loc != wxNOT_FOUND )
+        {
+            aMatchersTriggered = m_matchers.size();
+            aPosition = loc;
+        }
+
+        return aPosition != EDA_PATTERN_NOT_FOUND;
+    }
+
     for( auto const& matcher : m_matchers )
     {
         int local_find = matcher->Find( aTerm );
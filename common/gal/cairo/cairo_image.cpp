@@ -0,0 +1,94 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gal/cairo/cairo_image.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <wx/image.h>
+
+using namespace KIGFX;
+
+
+CAIRO_IMAGE_GAL::CAIRO_IMAGE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, int aWidth, int aHeight )
+    : CAIRO_GAL_BASE( aDisplayOptions )
+{
+    m_clearColor = COLOR4D( 1.0, 1.0, 1.0, 1.0 );
+    ResizeScreen( aWidth, aHeight );
+}
+
+
+void CAIRO_IMAGE_GAL::ResizeScreen( int aWidth, int aHeight )
+{
+    if( surface )
+        cairo_surface_destroy( surface );
+
+    if( context )
+        cairo_destroy( context );
+
+    screenSize = VECTOR2I( aWidth, aHeight );
+    surface = cairo_image_surface_create( GAL_FORMAT, aWidth, aHeight );
+    context = currentContext = cairo_create( surface );
+
+    if( cairo_surface_status( surface ) != CAIRO_STATUS_SUCCESS )
+        throw std::runtime_error( "Could not create Cairo image surface" );
+}
+
+
+void CAIRO_IMAGE_GAL::CopyToImage( wxImage& aImage, const VECTOR2I& aOrigin )
+{
+    cairo_surface_flush( surface );
+
+    const unsigned char* src = cairo_image_surface_get_data( surface );
+    const int stride = cairo_image_surface_get_stride( surface );
+    unsigned char* dst = aImage.GetData();
+
+    const int xStart = std::max( 0, -aOrigin.x );
+    const int xEnd = std::min( screenSize.x, aImage.GetWidth() - aOrigin.x );
+    const int yStart = std::max( 0, -aOrigin.y );
+    const int yEnd = std::min( screenSize.y, aImage.GetHeight() - aOrigin.y );
+
+    for( int y = yStart; y < yEnd; ++y )
+    {
+        // ARGB32 pixels are stored as native endian 32 bit words, with premultiplied alpha
+        const uint32_t* srcRow = reinterpret_cast<const uint32_t*>( src + y * stride );
+        unsigned char* dstPixel =
+                dst + 3 * ( (size_t) ( aOrigin.y + y ) * aImage.GetWidth() + aOrigin.x + xStart );
+
+        for( int x = xStart; x < xEnd; ++x )
+        {
+            uint32_t pixel = srcRow[x];
+            unsigned int alpha = pixel >> 24;
+            unsigned int r = ( pixel >> 16 ) & 0xff;
+            unsigned int g = ( pixel >> 8 ) & 0xff;
+            unsigned int b = pixel & 0xff;
+
+            if( alpha != 0xff && alpha != 0 )
+            {
+                r = r * 0xff / alpha;
+                g = g * 0xff / alpha;
+                b = b * 0xff / alpha;
+            }
+
+            *dstPixel++ = r;
+            *dstPixel++ = g;
+            *dstPixel++ = b;
+        }
+    }
+}
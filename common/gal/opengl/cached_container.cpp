@@ -34,21 +34,19 @@
 #include <gal/opengl/vertex_item.h>
 #include <gal/opengl/utils.h>
 
-#include <list>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstring>
 
-#ifdef __WXDEBUG__
 #include <wx/log.h>
-#include <profile.h>
-#endif /* __WXDEBUG__ */
 
 using namespace KIGFX;
 
 CACHED_CONTAINER::CACHED_CONTAINER( unsigned int aSize ) :
-    VERTEX_CONTAINER( aSize ), m_item( NULL ), m_chunkSize( 0 ), m_chunkOffset( 0 ), m_maxIndex( 0 )
+    VERTEX_CONTAINER( aSize ), m_item( NULL ), m_maxIndex( 0 ), m_fragmentedSpace( 0 ),
+    m_wastedSpace( 0 ), m_stats()
 {
-    // In the beginning there is only free space
-    m_freeChunks.insert( std::make_pair( aSize, 0 ) );
 }
 
 
@@ -56,15 +54,11 @@ void CACHED_CONTAINER::SetItem( VERTEX_ITEM* aItem )
 {
     assert( aItem != NULL );
 
-    unsigned int itemSize = aItem->GetSize();
-    m_item      = aItem;
-    m_chunkSize = itemSize;
-
-    // Get the previously set offset if the item was stored previously
-    m_chunkOffset = itemSize > 0 ? aItem->GetOffset() : -1;
+    m_item = aItem;
+    m_staging.clear();
 
 #if CACHED_CONTAINER_TEST > 1
-    wxLogDebug( wxT( "Adding/editing item 0x%08lx (size %d)" ), (long) m_item, itemSize );
+    wxLogDebug( wxT( "Adding/editing item 0x%08lx (size %d)" ), (long) m_item, aItem->GetSize() );
 #endif
 }
 
@@ -75,28 +69,68 @@ void CACHED_CONTAINER::FinishItem()
 
     unsigned int itemSize = m_item->GetSize();
 
-    // Finishing the previously edited item
-    if( itemSize < m_chunkSize )
+    // Move the staged vertices to the container, after the ones stored previously
+    if( !m_staging.empty() && !m_failed )
     {
-        // There is some not used but reserved memory left, so we should return it to the pool
-        int itemOffset = m_item->GetOffset();
+        unsigned int newSize = itemSize + m_staging.size();
 
-        // Add the not used memory back to the pool
-        addFreeChunk( itemOffset + itemSize, m_chunkSize - itemSize );
-        // mergeFreeChunks();   // veery slow and buggy
+        if( itemSize > 0 && newSize <= classSize( sizeClass( itemSize ) ) )
+        {
+            // There is still room in the chunk
+            m_wastedSpace -= newSize - itemSize;
+        }
+        else
+        {
+            unsigned int newOffset;
 
-        m_maxIndex = std::max( itemOffset + itemSize, m_maxIndex );
-    }
+            if( !allocateChunk( newSize, newOffset ) )
+            {
+                m_failed = true;
+            }
+            else if( itemSize > 0 )
+            {
+                // The chunk owning the item might have been moved while allocating
+                unsigned int oldOffset = m_item->GetOffset();
+
+#if CACHED_CONTAINER_TEST > 3
+                wxLogDebug( wxT( "Moving 0x%08lx from 0x%08x to 0x%08x" ),
+                            (long) m_item, oldOffset, newOffset );
+#endif
+                // The item was reallocated, so we have to copy all the old data to the new place
+                memcpy( &m_vertices[newOffset], &m_vertices[oldOffset], itemSize * VERTEX_SIZE );
+                freeChunk( oldOffset, itemSize );
+                ++m_stats.m_reallocations;
+            }
+
+            if( !m_failed )
+            {
+                m_wastedSpace += classSize( sizeClass( newSize ) ) - newSize;
+                m_item->setOffset( newOffset );
+            }
+        }
+
+        if( !m_failed )
+        {
+            memcpy( &m_vertices[m_item->GetOffset() + itemSize], m_staging.data(),
+                    m_staging.size() * VERTEX_SIZE );
+
+            // Now the item officially possesses the memory chunk
+            m_item->setSize( newSize );
+            itemSize = newSize;
 
-    if( itemSize > 0 )
-        m_items.insert( m_item );
+            // The content has to be updated
+            m_dirty = true;
+        }
+    }
 
+    m_staging.clear();
     m_item = NULL;
-    m_chunkSize = 0;
-    m_chunkOffset = 0;
+
+    if( !m_failed )
+        compactStep();
 
 #if CACHED_CONTAINER_TEST > 1
-    wxLogDebug( wxT( "Finishing item 0x%08lx (size %d)" ), (long) m_item, itemSize );
+    wxLogDebug( wxT( "Finishing item (size %d)" ), itemSize );
     test();
 #endif
 }
@@ -110,63 +144,39 @@ VERTEX* CACHED_CONTAINER::Allocate( unsigned int aSize )
     if( m_failed )
         return NULL;
 
-    unsigned int itemSize = m_item->GetSize();
-    unsigned int newSize = itemSize + aSize;
+    // The returned pointer is only used until the next call, so the staging buffer
+    // may be reallocated
+    size_t stagedSize = m_staging.size();
+    m_staging.resize( stagedSize + aSize );
 
-    if( newSize > m_chunkSize )
-    {
-        // There is not enough space in the currently reserved chunk, so we have to resize it
-        if( !reallocate( newSize ) )
-        {
-            m_failed = true;
-            return NULL;
-        }
-    }
-
-    VERTEX* reserved = &m_vertices[m_chunkOffset + itemSize];
-
-    // Now the item officially possesses the memory chunk
-    m_item->setSize( newSize );
-
-    // The content has to be updated
-    m_dirty = true;
-
-#if CACHED_CONTAINER_TEST > 0
-    test();
-#endif
-#if CACHED_CONTAINER_TEST > 2
-    showFreeChunks();
-    showUsedChunks();
-#endif
-
-    return reserved;
+    return &m_staging[stagedSize];
 }
 
 
 void CACHED_CONTAINER::Delete( VERTEX_ITEM* aItem )
 {
     assert( aItem != NULL );
-    assert( m_items.find( aItem ) != m_items.end() || aItem->GetSize() == 0 );
 
-    int size = aItem->GetSize();
+    unsigned int size = aItem->GetSize();
 
     if( size == 0 )
         return;     // Item is not stored here
 
-    int offset = aItem->GetOffset();
+    unsigned int offset = aItem->GetOffset();
+
+    assert( m_chunks.count( offset + classSize( sizeClass( size ) ) ) );
+    assert( m_chunks[offset + classSize( sizeClass( size ) )].m_item == aItem );
 
 #if CACHED_CONTAINER_TEST > 1
     wxLogDebug( wxT( "Removing 0x%08lx (size %d offset %d)" ), (long) aItem, size, offset );
 #endif
 
-    // Insert a free memory chunk entry in the place where item was stored
-    addFreeChunk( offset, size );
+    // Return the chunk where item was stored to the free space pool
+    freeChunk( offset, size );
 
     // Indicate that the item is not stored in the container anymore
     aItem->setSize( 0 );
 
-    m_items.erase( aItem );
-
 #if CACHED_CONTAINER_TEST > 0
     test();
 #endif
@@ -196,38 +206,84 @@ void CACHED_CONTAINER::Clear()
 
     // Set the size of all the stored VERTEX_ITEMs to 0, so it is clear that they are not held
     // in the container anymore
-    for( ITEMS::iterator it = m_items.begin(); it != m_items.end(); ++it )
-        ( *it )->setSize( 0 );
-
-    m_items.clear();
+    for( const auto& chunk : m_chunks )
+    {
+        if( chunk.second.m_item )
+            chunk.second.m_item->setSize( 0 );
+    }
 
     // Now there is only free space left
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, 0 ) );
+    m_chunks.clear();
+
+    for( auto& freeList : m_freeLists )
+        freeList.clear();
+
+    m_fragmentedSpace = 0;
+    m_wastedSpace = 0;
 }
 
 
-bool CACHED_CONTAINER::reallocate( unsigned int aSize )
+unsigned int CACHED_CONTAINER::sizeClass( unsigned int aSize )
+{
+    if( aSize <= 4 )
+        return 0;
+
+    // Find the class just below the size and take the next one
+    unsigned int value = aSize - 1;
+    unsigned int shift = 0;
+
+    while( ( value >> shift ) >= 8 )
+        ++shift;
+
+    return shift * 4 + ( value >> shift ) - 3;
+}
+
+
+bool CACHED_CONTAINER::allocateChunk( unsigned int aSize, unsigned int& aOffset )
 {
     assert( aSize > 0 );
     assert( IsMapped() );
 
-    unsigned int itemSize = m_item->GetSize();
+    unsigned int chunkClass = sizeClass( aSize );
+    unsigned int chunkSize  = classSize( chunkClass );
+    std::vector<unsigned int>& freeList = m_freeLists[chunkClass];
 
-#if CACHED_CONTAINER_TEST > 2
-    wxLogDebug( wxT( "Resize %p from %d to %d" ), m_item, itemSize, aSize );
-#endif
+    ++m_stats.m_allocations;
+
+    // Reuse a free chunk of the same class
+    while( !freeList.empty() )
+    {
+        unsigned int offset = freeList.back();
+        freeList.pop_back();
+
+        auto it = m_chunks.find( offset + chunkSize );
+
+        // The chunk may have been trimmed from the end of the used area in the meantime
+        if( it == m_chunks.end() || it->second.m_item || it->second.m_sizeClass != chunkClass )
+            continue;
 
-    // Find a free space chunk >= aSize
-    FREE_CHUNK_MAP::iterator newChunk = m_freeChunks.lower_bound( aSize );
+        // The owner is assigned by the caller
+        it->second.m_item = m_item;
+        m_fragmentedSpace -= chunkSize;
+        m_freeSpace -= chunkSize;
+        ++m_stats.m_reuses;
+        aOffset = offset;
 
-    // Is there enough space to store vertices?
-    if( newChunk == m_freeChunks.end() )
+        return true;
+    }
+
+    // Is there enough space at the end of the used area?
+    if( m_maxIndex + chunkSize > m_currentSize )
     {
         bool result;
 
+        if( usedSpace() + chunkSize <= m_currentSize / 2 )
+        {
+            // Plenty of space, it is just scattered
+            result = defragmentResize( m_currentSize );
+        }
         // Would it be enough to double the current space?
-        if( aSize < m_freeSpace + m_currentSize )
+        else if( chunkSize < m_freeSpace + m_currentSize )
         {
             // Yes: exponential growing
             result = defragmentResize( m_currentSize * 2 );
@@ -235,165 +291,187 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
         else
         {
             // No: grow to the nearest greater power of 2
-            result = defragmentResize( pow( 2, ceil( log2( m_currentSize * 2 + aSize ) ) ) );
+            result = defragmentResize( pow( 2, ceil( log2( m_currentSize * 2 + chunkSize ) ) ) );
         }
 
         if( !result )
             return false;
 
-        newChunk = m_freeChunks.lower_bound( aSize );
-        assert( newChunk != m_freeChunks.end() );
+        assert( m_maxIndex + chunkSize <= m_currentSize );
     }
 
-    // Parameters of the allocated chunk
-    unsigned int newChunkSize   = getChunkSize( *newChunk );
-    unsigned int newChunkOffset = getChunkOffset( *newChunk );
+    aOffset = m_maxIndex;
+    m_maxIndex += chunkSize;
+    m_chunks[m_maxIndex] = CHUNK{ m_item, chunkClass };
+    m_freeSpace -= chunkSize;
 
-    assert( newChunkSize >= aSize );
-    assert( newChunkOffset < m_currentSize );
+    return true;
+}
 
-    // Check if the item was previously stored in the container
-    if( itemSize > 0 )
-    {
-#if CACHED_CONTAINER_TEST > 3
-        wxLogDebug( wxT( "Moving 0x%08x from 0x%08x to 0x%08x" ),
-                    (int) m_item, oldChunkOffset, newChunkOffset );
-#endif
-        // The item was reallocated, so we have to copy all the old data to the new place
-        memcpy( &m_vertices[newChunkOffset], &m_vertices[m_chunkOffset], itemSize * VERTEX_SIZE );
 
-        // Free the space used by the previous chunk
-        addFreeChunk( m_chunkOffset, m_chunkSize );
+void CACHED_CONTAINER::freeChunk( unsigned int aOffset, unsigned int aSize )
+{
+    unsigned int chunkClass = sizeClass( aSize );
+    unsigned int chunkSize  = classSize( chunkClass );
+    unsigned int chunkEnd   = aOffset + chunkSize;
+
+    assert( chunkEnd <= m_maxIndex );
+
+    m_freeSpace += chunkSize;
+    m_wastedSpace -= chunkSize - aSize;
+
+    if( chunkEnd < m_maxIndex )
+    {
+        m_chunks[chunkEnd].m_item = NULL;
+        m_freeLists[chunkClass].push_back( aOffset );
+        m_fragmentedSpace += chunkSize;
+        return;
     }
 
-    // Remove the new allocated chunk from the free space pool
-    m_freeChunks.erase( newChunk );
-    m_freeSpace -= newChunkSize;
+    // The chunk ends the used area, so it is simply given back together with
+    // the free chunks placed right before it
+    m_chunks.erase( chunkEnd );
+    m_maxIndex = aOffset;
 
-    m_chunkSize = newChunkSize;
-    m_chunkOffset = newChunkOffset;
+    while( m_maxIndex > 0 )
+    {
+        auto it = m_chunks.find( m_maxIndex );
 
-    m_item->setOffset( m_chunkOffset );
+        if( it == m_chunks.end() || it->second.m_item )
+            break;
 
-    return true;
+        unsigned int freeSize = classSize( it->second.m_sizeClass );
+        m_chunks.erase( it );
+        m_maxIndex -= freeSize;
+        m_fragmentedSpace -= freeSize;
+    }
 }
 
 
-void CACHED_CONTAINER::defragment( VERTEX* aTarget )
+void CACHED_CONTAINER::compactStep()
 {
-    // Defragmentation
-    ITEMS::iterator it, it_end;
-    int newOffset = 0;
+    // Not worth moving data around when only a small part of the used area is wasted
+    if( m_fragmentedSpace <= m_maxIndex / 4 )
+        return;
 
-    for( VERTEX_ITEM* item : m_items )
+    for( unsigned int i = 0; i < COMPACTION_STEP && m_maxIndex > 0; ++i )
     {
-        int itemOffset    = item->GetOffset();
-        int itemSize      = item->GetSize();
+        auto last = m_chunks.find( m_maxIndex );
+        assert( last != m_chunks.end() );
 
-        // Move an item to the new container
-        memcpy( &aTarget[newOffset], &m_vertices[itemOffset], itemSize * VERTEX_SIZE );
+        // Free chunks are trimmed from the end of the used area as soon as they are released
+        VERTEX_ITEM* item       = last->second.m_item;
+        unsigned int chunkClass = last->second.m_sizeClass;
+        unsigned int chunkSize  = classSize( chunkClass );
+        assert( item );
 
-        // Update new offset
-        item->setOffset( newOffset );
+        // Look for a free chunk of the same class, it is always placed before the last one
+        std::vector<unsigned int>& freeList = m_freeLists[chunkClass];
+        CHUNK_MAP::iterator target = m_chunks.end();
+        unsigned int targetOffset = 0;
 
-        // Move to the next free space
-        newOffset += itemSize;
-    }
+        while( !freeList.empty() && target == m_chunks.end() )
+        {
+            targetOffset = freeList.back();
+            freeList.pop_back();
+            target = m_chunks.find( targetOffset + chunkSize );
+
+            if( target != m_chunks.end()
+                    && ( target->second.m_item || target->second.m_sizeClass != chunkClass ) )
+            {
+                target = m_chunks.end();
+            }
+        }
 
-    // Move the current item and place it at the end
-    if( m_item->GetSize() > 0 )
-    {
-        memcpy( &aTarget[newOffset], &m_vertices[m_item->GetOffset()],
-                m_item->GetSize() * VERTEX_SIZE );
-        m_item->setOffset( newOffset );
-        m_chunkOffset = newOffset;
+        if( target == m_chunks.end() )
+            break;
+
+        memcpy( &m_vertices[targetOffset], &m_vertices[item->GetOffset()],
+                item->GetSize() * VERTEX_SIZE );
+        item->setOffset( targetOffset );
+        target->second.m_item = item;
+        m_fragmentedSpace -= chunkSize;
+        ++m_stats.m_compactionMoves;
+
+        // The last chunk is not needed anymore, neither are the free chunks placed before it
+        freeChunk( m_maxIndex - chunkSize, item->GetSize() );
+        m_freeSpace -= chunkSize;
+        m_wastedSpace += chunkSize - item->GetSize();
+        m_dirty = true;
     }
-
-    m_maxIndex = usedSpace();
 }
 
 
-void CACHED_CONTAINER::mergeFreeChunks()
+void CACHED_CONTAINER::relocateChunks(
+        std::function<void( unsigned int, unsigned int, unsigned int )> aCopy )
 {
-    if( m_freeChunks.size() <= 1 ) // There are no chunks that can be merged
-        return;
+    std::vector<CHUNK> usedChunks;
+    usedChunks.reserve( m_chunks.size() );
 
-#ifdef __WXDEBUG__
-    PROF_COUNTER totalTime;
-#endif /* __WXDEBUG__ */
-
-    // Reversed free chunks map - this one stores chunk size with its offset as the key
-    std::list<CHUNK> freeChunks;
-
-    FREE_CHUNK_MAP::const_iterator it, it_end;
-
-    for( it = m_freeChunks.begin(), it_end = m_freeChunks.end(); it != it_end; ++it )
+    for( const auto& chunk : m_chunks )
     {
-        freeChunks.push_back( std::make_pair( it->second, it->first ) );
+        if( chunk.second.m_item )
+            usedChunks.push_back( chunk.second );
     }
 
-    m_freeChunks.clear();
-    freeChunks.sort();
+    // Keep the original order, so items drawn together stay close to each other
+    std::sort( usedChunks.begin(), usedChunks.end(), []( const CHUNK& aA, const CHUNK& aB ) {
+        return aA.m_item->GetOffset() < aB.m_item->GetOffset();
+    } );
+
+    m_chunks.clear();
 
-    std::list<CHUNK>::const_iterator itf, itf_end;
-    unsigned int offset = freeChunks.front().first;
-    unsigned int size   = freeChunks.front().second;
-    freeChunks.pop_front();
+    for( auto& freeList : m_freeLists )
+        freeList.clear();
 
-    for( itf = freeChunks.begin(), itf_end = freeChunks.end(); itf != itf_end; ++itf )
+    unsigned int newOffset = 0;
+
+    for( const CHUNK& chunk : usedChunks )
     {
-        if( itf->first == offset + size )
-        {
-            // These chunks can be merged, so just increase the current chunk size and go on
-            size += itf->second;
-        }
-        else
-        {
-            // These chunks cannot be merged
-            // So store the previous one
-            m_freeChunks.insert( std::make_pair( size, offset ) );
-            // and let's check the next chunk
-            offset = itf->first;
-            size   = itf->second;
+        VERTEX_ITEM* item = chunk.m_item;
 
-        }
+        // Move an item to the new place
+        aCopy( item->GetOffset(), newOffset, item->GetSize() );
+        item->setOffset( newOffset );
+
+        // Move to the next free space
+        newOffset += classSize( chunk.m_sizeClass );
+        m_chunks[newOffset] = chunk;
     }
 
-    // Add the last one
-    m_freeChunks.insert( std::make_pair( size, offset ) );
+    m_maxIndex = newOffset;
+    m_fragmentedSpace = 0;
+    ++m_stats.m_defragmentations;
 
-#ifdef __WXDEBUG__
-    totalTime.Stop();
-    wxLogDebug( "Merged free chunks / %.1f ms", totalTime.msecs() );
-#endif /* __WXDEBUG__ */
-#if CACHED_CONTAINER_TEST > 0
-    test();
-#endif
+    wxLogTrace( "GAL_CACHED_CONTAINER",
+                wxT( "Defragmented %u chunks: %u allocations (%u reused), %u reallocations, "
+                     "%u compaction moves, %u defragmentations, %u vertices wasted" ),
+                (unsigned int) usedChunks.size(), m_stats.m_allocations, m_stats.m_reuses,
+                m_stats.m_reallocations, m_stats.m_compactionMoves, m_stats.m_defragmentations,
+                m_wastedSpace );
 }
 
 
-void CACHED_CONTAINER::addFreeChunk( unsigned int aOffset, unsigned int aSize )
+void CACHED_CONTAINER::defragment( VERTEX* aTarget )
 {
-    assert( aOffset + aSize <= m_currentSize );
-    assert( aSize > 0 );
-
-    m_freeChunks.insert( std::make_pair( aSize, aOffset ) );
-    m_freeSpace += aSize;
+    relocateChunks( [&]( unsigned int aFrom, unsigned int aTo, unsigned int aSize ) {
+        memcpy( &aTarget[aTo], &m_vertices[aFrom], aSize * VERTEX_SIZE );
+    } );
 }
 
 
 void CACHED_CONTAINER::showFreeChunks()
 {
 #ifdef __WXDEBUG__
-    FREE_CHUNK_MAP::iterator it;
-
     wxLogDebug( wxT( "Free chunks:" ) );
 
-    for( it = m_freeChunks.begin(); it != m_freeChunks.end(); ++it )
+    for( const auto& chunk : m_chunks )
     {
-        unsigned int offset = getChunkOffset( *it );
-        unsigned int size   = getChunkSize( *it );
-        assert( size > 0 );
+        if( chunk.second.m_item )
+            continue;
+
+        unsigned int size   = classSize( chunk.second.m_sizeClass );
+        unsigned int offset = chunk.first - size;
 
         wxLogDebug( wxT( "[0x%08x-0x%08x] (size %d)" ),
                     offset, offset + size - 1, size );
@@ -405,13 +483,15 @@ void CACHED_CONTAINER::showFreeChunks()
 void CACHED_CONTAINER::showUsedChunks()
 {
 #ifdef __WXDEBUG__
-    ITEMS::iterator it;
-
     wxLogDebug( wxT( "Used chunks:" ) );
 
-    for( it = m_items.begin(); it != m_items.end(); ++it )
+    for( const auto& chunk : m_chunks )
     {
-        VERTEX_ITEM* item   = *it;
+        VERTEX_ITEM* item = chunk.second.m_item;
+
+        if( !item )
+            continue;
+
         unsigned int offset = item->GetOffset();
         unsigned int size   = item->GetSize();
         assert( size > 0 );
@@ -426,28 +506,36 @@ void CACHED_CONTAINER::showUsedChunks()
 void CACHED_CONTAINER::test()
 {
 #ifdef __WXDEBUG__
-    // Free space check
-    unsigned int freeSpace = 0;
-    FREE_CHUNK_MAP::iterator itf;
-
-    for( itf = m_freeChunks.begin(); itf != m_freeChunks.end(); ++itf )
-        freeSpace += getChunkSize( *itf );
-
-    assert( freeSpace == m_freeSpace );
+    unsigned int usedSpace = 0;
+    unsigned int fragmentedSpace = 0;
+    unsigned int wastedSpace = 0;
 
-    // Used space check
-    unsigned int used_space = 0;
-    ITEMS::iterator itr;
-    for( itr = m_items.begin(); itr != m_items.end(); ++itr )
-        used_space += ( *itr )->GetSize();
+    for( const auto& chunk : m_chunks )
+    {
+        unsigned int chunkSize = classSize( chunk.second.m_sizeClass );
+        VERTEX_ITEM* item = chunk.second.m_item;
 
-    // If we have a chunk assigned, then there must be an item edited
-    assert( m_chunkSize == 0 || m_item );
+        assert( chunk.first <= m_maxIndex );
 
-    // Currently reserved chunk is also counted as used
-    used_space += m_chunkSize;
+        if( item )
+        {
+            // Chunks are always of the size class matching their item
+            assert( chunk.second.m_sizeClass == sizeClass( item->GetSize() ) );
+            assert( item->GetOffset() + chunkSize == chunk.first );
+            usedSpace += chunkSize;
+            wastedSpace += chunkSize - item->GetSize();
+        }
+        else
+        {
+            fragmentedSpace += chunkSize;
+        }
+    }
 
-    assert( ( m_freeSpace + used_space ) == m_currentSize );
+    // Chunks cover the whole used area
+    assert( usedSpace + fragmentedSpace == m_maxIndex );
+    assert( fragmentedSpace == m_fragmentedSpace );
+    assert( wastedSpace == m_wastedSpace );
+    assert( ( m_freeSpace + usedSpace ) == m_currentSize );
 
     // Overlapping check TODO
 #endif /* __WXDEBUG__ */
@@ -132,37 +132,11 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, aNewSize * VERTEX_SIZE, NULL, GL_DYNAMIC_DRAW );
     checkGlError( "creating buffer during defragmentation" );
 
-    ITEMS::iterator it, it_end;
-    int newOffset = 0;
-
     // Defragmentation
-    for( it = m_items.begin(), it_end = m_items.end(); it != it_end; ++it )
-    {
-        VERTEX_ITEM* item = *it;
-        int itemOffset    = item->GetOffset();
-        int itemSize      = item->GetSize();
-
-        // Move an item to the new container
+    relocateChunks( []( unsigned int aFrom, unsigned int aTo, unsigned int aSize ) {
         glCopyBufferSubData( GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER,
-                itemOffset * VERTEX_SIZE, newOffset * VERTEX_SIZE, itemSize * VERTEX_SIZE );
-
-        // Update new offset
-        item->setOffset( newOffset );
-
-        // Move to the next free space
-        newOffset += itemSize;
-    }
-
-    // Move the current item and place it at the end
-    if( m_item->GetSize() > 0 )
-    {
-        glCopyBufferSubData( GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER,
-                m_item->GetOffset() * VERTEX_SIZE, newOffset * VERTEX_SIZE,
-                m_item->GetSize() * VERTEX_SIZE );
-
-        m_item->setOffset( newOffset );
-        m_chunkOffset = newOffset;
-    }
+                aFrom * VERTEX_SIZE, aTo * VERTEX_SIZE, aSize * VERTEX_SIZE );
+    } );
 
     // Cleanup
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
@@ -189,10 +163,6 @@ bool CACHED_CONTAINER_GPU::defragmentResize( unsigned int aNewSize )
     m_freeSpace += ( aNewSize - m_currentSize );
     m_currentSize = aNewSize;
 
-    // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
-
     return true;
 }
 
@@ -255,9 +225,5 @@ bool CACHED_CONTAINER_GPU::defragmentResizeMemcpy( unsigned int aNewSize )
     m_freeSpace += ( aNewSize - m_currentSize );
     m_currentSize = aNewSize;
 
-    // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
-
     return true;
 }
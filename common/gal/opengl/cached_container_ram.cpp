@@ -106,10 +106,6 @@ bool CACHED_CONTAINER_RAM::defragmentResize( unsigned int aNewSize )
 
     m_freeSpace += ( aNewSize - m_currentSize );
     m_currentSize = aNewSize;
-
-    // Now there is only one big chunk of free memory
-    m_freeChunks.clear();
-    m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
     m_dirty = true;
 
     return true;
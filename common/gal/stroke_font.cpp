@@ -31,6 +31,10 @@
 #include <text_utils.h>
 #include <wx/string.h>
 
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
 
 using namespace KIGFX;
 
@@ -39,23 +43,99 @@ const double STROKE_FONT::OVERBAR_POSITION_FACTOR = 1.22;
 const double STROKE_FONT::BOLD_FACTOR = 1.3;
 const double STROKE_FONT::STROKE_FONT_SCALE = 1.0 / 21.0;
 const double STROKE_FONT::ITALIC_TILT = 1.0 / 8;
+const size_t STROKE_FONT::MAX_CACHED_LINES = 65536;
+
+
+struct STROKE_FONT::LINE_GEOMETRY
+{
+    VECTOR2D                            m_size;         ///< Line size, see computeTextLineSize()
+    std::vector<std::deque<VECTOR2D>>   m_strokes;      ///< Strokes, in drawing order
+    std::vector<bool>                   m_isOverbar;    ///< Strokes drawn as an overbar segment
+};
+
+
+namespace
+{
+
+/// Everything the strokes of a line of text depend on
+struct LINE_KEY
+{
+    std::string m_text;
+    VECTOR2D    m_glyphSize;
+    double      m_lineWidth;
+    bool        m_italic;
+    bool        m_mirrored;
+
+    bool operator==( const LINE_KEY& aOther ) const
+    {
+        return m_text == aOther.m_text && m_glyphSize == aOther.m_glyphSize
+               && m_lineWidth == aOther.m_lineWidth && m_italic == aOther.m_italic
+               && m_mirrored == aOther.m_mirrored;
+    }
+};
+
+
+struct LINE_KEY_HASH
+{
+    size_t operator()( const LINE_KEY& aKey ) const
+    {
+        size_t seed = std::hash<std::string>()( aKey.m_text );
+
+        for( double value : { aKey.m_glyphSize.x, aKey.m_glyphSize.y, aKey.m_lineWidth } )
+            seed ^= std::hash<double>()( value ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+
+        return seed ^ ( aKey.m_italic ? 1 : 0 ) ^ ( aKey.m_mirrored ? 2 : 0 );
+    }
+};
+
+} // namespace
+
+
+struct STROKE_FONT::FONT_DATA
+{
+    GLYPH_LIST          m_glyphs;               ///< Glyph list
+    std::vector<BOX2D>  m_glyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+
+    ///> Lines of text drawn recently; fonts are used by several threads when rendering offscreen
+    std::unordered_map<LINE_KEY, std::shared_ptr<const LINE_GEOMETRY>, LINE_KEY_HASH> m_lineCache;
+    std::mutex          m_cacheMutex;
+};
+
 
 STROKE_FONT::STROKE_FONT( GAL* aGal ) :
-    m_gal( aGal )
+    m_gal( aGal ),
+    m_font( nullptr )
 {
 }
 
 
 bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
 {
-    m_glyphs.clear();
-    m_glyphBoundingBoxes.clear();
-    m_glyphs.resize( aNewStrokeFontSize );
-    m_glyphBoundingBoxes.resize( aNewStrokeFontSize );
+    // Fonts are never unloaded, every GAL instance uses the same few ones
+    static std::map<const char* const*, std::unique_ptr<FONT_DATA>> fonts;
+    static std::mutex fontsMutex;
+
+    std::lock_guard<std::mutex> lock( fontsMutex );
+    std::unique_ptr<FONT_DATA>& font = fonts[aNewStrokeFont];
+
+    if( font )
+    {
+        m_font = font.get();
+        return true;
+    }
+
+    font.reset( new FONT_DATA );
+    m_font = font.get();
+
+    GLYPH_LIST&         glyphs = font->m_glyphs;
+    std::vector<BOX2D>& boundingBoxes = font->m_glyphBoundingBoxes;
+
+    glyphs.resize( aNewStrokeFontSize );
+    boundingBoxes.resize( aNewStrokeFontSize );
 
     for( int j = 0; j < aNewStrokeFontSize; j++ )
     {
-        GLYPH&   glyph = m_glyphs[j];
+        GLYPH&   glyph = glyphs[j];
         double   glyphStartX = 0.0;
         double   glyphEndX = 0.0;
         VECTOR2D glyphBoundingX;
@@ -116,7 +196,7 @@ bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNe
         }
 
         // Compute the bounding box of the glyph
-        m_glyphBoundingBoxes[j] = computeBoundingBox( glyph, glyphBoundingX );
+        boundingBoxes[j] = computeBoundingBox( glyph, glyphBoundingX );
     }
 
     return true;
@@ -237,15 +317,8 @@ void STROKE_FONT::Draw( const UTF8& aText, const VECTOR2D& aPosition, double aRo
 
 void STROKE_FONT::drawSingleLineText( const UTF8& aText )
 {
-    double      xOffset;
-    VECTOR2D    glyphSize( m_gal->GetGlyphSize() );
-    double      overbar_italic_comp = computeOverbarVerticalPosition() * ITALIC_TILT;
-
-    if( m_gal->IsTextMirrored() )
-        overbar_italic_comp = -overbar_italic_comp;
-
-    // Compute the text size
-    VECTOR2D textSize = computeTextLineSize( aText );
+    std::shared_ptr<const LINE_GEOMETRY> geometry = getLineGeometry( aText );
+    const VECTOR2D& textSize = geometry->m_size;
     double half_thickness = m_gal->GetLineWidth()/2;
 
     // Context needs to be saved before any transformations
@@ -279,6 +352,46 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
         break;
     }
 
+    for( size_t i = 0; i < geometry->m_strokes.size(); ++i )
+    {
+        const std::deque<VECTOR2D>& stroke = geometry->m_strokes[i];
+
+        if( geometry->m_isOverbar[i] )
+            m_gal->DrawLine( stroke.front(), stroke.back() );
+        else
+            m_gal->DrawPolyline( stroke );
+    }
+
+    m_gal->Restore();
+}
+
+
+std::shared_ptr<const STROKE_FONT::LINE_GEOMETRY> STROKE_FONT::getLineGeometry(
+        const UTF8& aText ) const
+{
+    LINE_KEY key = { aText, m_gal->GetGlyphSize(), m_gal->GetLineWidth(),
+                     m_gal->IsFontItalic(), m_gal->IsTextMirrored() };
+
+    {
+        std::lock_guard<std::mutex> lock( m_font->m_cacheMutex );
+        auto it = m_font->m_lineCache.find( key );
+
+        if( it != m_font->m_lineCache.end() )
+            return it->second;
+    }
+
+    auto        geometry = std::make_shared<LINE_GEOMETRY>();
+    double      xOffset;
+    VECTOR2D    glyphSize( m_gal->GetGlyphSize() );
+    double      overbar_italic_comp = computeOverbarVerticalPosition() * ITALIC_TILT;
+
+    if( m_gal->IsTextMirrored() )
+        overbar_italic_comp = -overbar_italic_comp;
+
+    // Compute the text size
+    VECTOR2D textSize = computeTextLineSize( aText );
+    geometry->m_size = textSize;
+
     if( m_gal->IsTextMirrored() )
     {
         // In case of mirrored text invert the X scale of points and their X direction
@@ -292,6 +405,9 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
         xOffset = 0.0;
     }
 
+    const GLYPH_LIST&         glyphs = m_font->m_glyphs;
+    const std::vector<BOX2D>& boundingBoxes = m_font->m_glyphBoundingBoxes;
+
     // The overbar is indented inward at the beginning of an italicized section, but
     // must not be indented on subsequent letters to ensure that the bar segments
     // overlap.
@@ -309,7 +425,7 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
         // The choice of spaces is somewhat arbitrary but sufficient for aligning text
         if( *chIt == '\t' )
         {
-            double fourSpaces = 4.0 * glyphSize.x * m_glyphBoundingBoxes[0].GetEnd().x;
+            double fourSpaces = 4.0 * glyphSize.x * boundingBoxes[0].GetEnd().x;
             double addlSpace = fourSpaces - std::fmod( xOffset, fourSpaces );
 
             // Add the remaining space (between 0 and 3 spaces)
@@ -319,11 +435,11 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             dd = 0;
         }
 
-        if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
+        if( dd >= (int) boundingBoxes.size() || dd < 0 )
             dd = '?' - ' ';
 
-        GLYPH& glyph = m_glyphs[dd];
-        BOX2D& bbox  = m_glyphBoundingBoxes[dd];
+        const GLYPH& glyph = glyphs[dd];
+        const BOX2D& bbox  = boundingBoxes[dd];
 
         if( overbars[overbar_index] )
         {
@@ -343,7 +459,8 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             VECTOR2D startOverbar( overbar_start_x, overbar_start_y );
             VECTOR2D endOverbar( overbar_end_x, overbar_end_y );
 
-            m_gal->DrawLine( startOverbar, endOverbar );
+            geometry->m_strokes.push_back( { startOverbar, endOverbar } );
+            geometry->m_isOverbar.push_back( true );
         }
         else
         {
@@ -371,14 +488,23 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
                 pointListScaled.push_back( pointPos );
             }
 
-            m_gal->DrawPolyline( pointListScaled );
+            geometry->m_strokes.push_back( std::move( pointListScaled ) );
+            geometry->m_isOverbar.push_back( false );
         }
 
         xOffset += glyphSize.x * bbox.GetEnd().x;
         ++overbar_index;
     }
 
-    m_gal->Restore();
+    std::lock_guard<std::mutex> lock( m_font->m_cacheMutex );
+
+    // Keep the memory use bounded when many different texts are drawn
+    if( m_font->m_lineCache.size() >= MAX_CACHED_LINES )
+        m_font->m_lineCache.clear();
+
+    m_font->m_lineCache.emplace( std::move( key ), geometry );
+
+    return geometry;
 }
 
 
@@ -433,10 +559,10 @@ VECTOR2D STROKE_FONT::ComputeStringBoundaryLimits( const UTF8& aText, const VECT
         // Index in the bounding boxes table
         int dd = *it - ' ';
 
-        if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
+        if( dd >= (int) m_font->m_glyphBoundingBoxes.size() || dd < 0 )
             dd = '?' - ' ';
 
-        const BOX2D& box = m_glyphBoundingBoxes[dd];
+        const BOX2D& box = m_font->m_glyphBoundingBoxes[dd];
         curX += box.GetEnd().x;
     }
 
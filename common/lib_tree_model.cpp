@@ -23,6 +23,8 @@
 
 #include <eda_pattern_match.h>
 #include <lib_tree_item.h>
+#include <algorithm>
+#include <iterator>
 #include <utility>
 #include <pgm_base.h>
 #include <kicad_string.h>
@@ -118,6 +120,7 @@ LIB_TREE_NODE::LIB_TREE_NODE()
       IntrinsicRank( 0 ),
       Score( kLowestDefaultScore ),
       Normalized( false ),
+      Indexed( false ),
       Unit( 0 ),
       IsRoot( false )
 {}
@@ -164,6 +167,7 @@ LIB_TREE_NODE_LIB_ID::LIB_TREE_NODE_LIB_ID( LIB_TREE_NODE* aParent, LIB_TREE_ITE
     MatchName = aItem->GetName();
     SearchText = aItem->GetSearchText();
     Normalized = false;
+    Indexed = false;
 
     IsRoot = aItem->IsRoot();
 
@@ -193,6 +197,7 @@ void LIB_TREE_NODE_LIB_ID::Update( LIB_TREE_ITEM* aItem )
 
     SearchText = aItem->GetSearchText();
     Normalized = false;
+    Indexed = false;
 
     IsRoot = aItem->IsRoot();
     Children.clear();
@@ -277,6 +282,110 @@ LIB_TREE_NODE_LIB_ID& LIB_TREE_NODE_LIB::AddItem( LIB_TREE_ITEM* aItem )
 }
 
 
+// Packs the three characters of a trigram in a single key.
+static uint64_t trigramKey( const wchar_t* aText )
+{
+    return ( uint64_t( uint32_t( aText[0] ) & 0x1FFFFF ) << 42 )
+         | ( uint64_t( uint32_t( aText[1] ) & 0x1FFFFF ) << 21 )
+         | ( uint64_t( uint32_t( aText[2] ) & 0x1FFFFF ) );
+}
+
+
+void LIB_TREE_NODE_LIB::updateIndex()
+{
+    // Children are sorted by score after each search, so compare them as sets.
+    std::vector<LIB_TREE_NODE*> children;
+
+    children.reserve( Children.size() );
+
+    for( auto& child: Children )
+        children.push_back( child.get() );
+
+    std::sort( children.begin(), children.end() );
+
+    bool upToDate = children == m_indexedChildren;
+
+    // Normalized is also set by scoring without the index, so it does not tell whether
+    // the index holds the last MatchName and SearchText of a child; only Indexed does.
+    for( size_t i = 0; upToDate && i < children.size(); ++i )
+        upToDate = children[i]->Indexed;
+
+    if( upToDate )
+        return;
+
+    m_trigrams.clear();
+    m_indexedChildren = std::move( children );
+
+    for( int i = 0; i < (int) m_indexedChildren.size(); ++i )
+    {
+        LIB_TREE_NODE* child = m_indexedChildren[i];
+
+        if( !child->Normalized )
+        {
+            child->MatchName = child->MatchName.Lower();
+            child->SearchText = child->SearchText.Lower();
+            child->Normalized = true;
+        }
+
+        child->Indexed = true;
+
+        for( const wxString* text : { &child->MatchName, &child->SearchText } )
+        {
+            std::wstring str = text->ToStdWstring();
+
+            for( size_t j = 0; j + 3 <= str.length(); ++j )
+            {
+                std::vector<int>& children_with_trigram = m_trigrams[trigramKey( &str[j] )];
+
+                if( children_with_trigram.empty() || children_with_trigram.back() != i )
+                    children_with_trigram.push_back( i );
+            }
+        }
+    }
+}
+
+
+void LIB_TREE_NODE_LIB::findCandidates( const wxString& aTerm,
+                                        std::vector<LIB_TREE_NODE*>& aCandidates ) const
+{
+    std::wstring term = aTerm.ToStdWstring();
+    std::vector<const std::vector<int>*> lists;
+
+    for( size_t j = 0; j + 3 <= term.length(); ++j )
+    {
+        auto it = m_trigrams.find( trigramKey( &term[j] ) );
+
+        if( it == m_trigrams.end() )
+            return;
+
+        lists.push_back( &it->second );
+    }
+
+    // Intersect the shortest lists first
+    std::sort( lists.begin(), lists.end(),
+               []( const std::vector<int>* a, const std::vector<int>* b )
+               {
+                   return a->size() < b->size();
+               } );
+
+    std::vector<int> indices = *lists[0];
+
+    for( size_t j = 1; j < lists.size() && !indices.empty(); ++j )
+    {
+        std::vector<int> intersection;
+
+        std::set_intersection( indices.begin(), indices.end(),
+                               lists[j]->begin(), lists[j]->end(),
+                               std::back_inserter( intersection ) );
+
+        indices = std::move( intersection );
+    }
+
+    for( int i : indices )
+        aCandidates.push_back( m_indexedChildren[i] );
+}
+
+
 void LIB_TREE_NODE_LIB::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 {
     Score = 0;
@@ -285,9 +394,28 @@ void LIB_TREE_NODE_LIB::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
 
     if( Children.size() )
     {
+        int  found_pos = EDA_PATTERN_NOT_FOUND;
+        int  matchers_fired = 0;
+        bool indexed = false;
+        std::vector<LIB_TREE_NODE*> candidates;
+
+        // A literal term can only be found in children containing all its trigrams, unless
+        // it is in the library name, which all children match.
+        if( aMatcher.IsLiteral() && aMatcher.GetPattern().length() >= 3
+                && !aMatcher.Find( MatchName, matchers_fired, found_pos ) )
+        {
+            updateIndex();
+            findCandidates( aMatcher.GetPattern(), candidates );
+            indexed = true;
+        }
+
         for( auto& child: Children )
         {
-            child->UpdateScore( aMatcher );
+            if( !indexed || std::binary_search( candidates.begin(), candidates.end(), child.get() ) )
+                child->UpdateScore( aMatcher );
+            else if( child->Score > 0 )
+                child->Score = 0;   // what the matchers would have given it
+
             Score = std::max( Score, child->Score );
         }
     }
@@ -22,8 +22,10 @@
 #ifndef LIB_TREE_MODEL_H
 #define LIB_TREE_MODEL_H
 
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 #include <wx/string.h>
 #include <lib_tree_item.h>
 
@@ -99,6 +101,7 @@ public:
     wxString    MatchName;   ///< Normalized name for matching
     wxString    SearchText;  ///< Descriptive text to search
     bool        Normalized;  ///< Support for lazy normalization.
+    bool        Indexed;     ///< MatchName and SearchText are in the trigram index of the library
 
 
     LIB_ID      LibId;       ///< LIB_ID determined by the parent library nickname and alias name.
@@ -254,7 +257,32 @@ public:
      */
     LIB_TREE_NODE_LIB_ID& AddItem( LIB_TREE_ITEM* aItem );
 
+    /**
+     * Update the score of the children, only running the matchers on the ones containing
+     * all the trigrams of a literal search term.
+     */
     virtual void UpdateScore( EDA_COMBINED_MATCHER& aMatcher ) override;
+
+protected:
+    /**
+     * Rebuild the trigram index if children have been added, removed or updated since
+     * it was built.
+     */
+    void updateIndex();
+
+    /**
+     * Find the children whose name or search text may contain aTerm.
+     *
+     * @param aTerm is a normalized search term, at least 3 characters long.
+     * @param aCandidates receives these children, sorted by address.
+     */
+    void findCandidates( const wxString& aTerm, std::vector<LIB_TREE_NODE*>& aCandidates ) const;
+
+    /// Indices in m_indexedChildren of the children containing a trigram, in increasing order
+    std::unordered_map<uint64_t, std::vector<int>> m_trigrams;
+
+    /// Children when the index was built, sorted by address to find out when it is out of date
+    std::vector<LIB_TREE_NODE*>                    m_indexedChildren;
 };
 
 
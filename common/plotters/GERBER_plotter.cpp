@@ -98,11 +98,48 @@ void GERBER_PLOTTER::SetGerberCoordinatesFormat( int aResolution, bool aUseInche
 }
 
 
+/**
+ * Format a D-Code record in aBuffer, which must be at least 64 chars long.
+ * @return the number of chars written
+ */
+static int formatDcode( char* aBuffer, const DPOINT& pt, int dcode )
+{
+    return sprintf( aBuffer, "X%dY%dD%02d*\n", KiROUND( pt.x ), KiROUND( pt.y ), dcode );
+}
+
+
 void GERBER_PLOTTER::emitDcode( const DPOINT& pt, int dcode )
 {
+    char buffer[64];
 
-    fprintf( outputFile, "X%dY%dD%02d*\n",
-	    KiROUND( pt.x ), KiROUND( pt.y ), dcode );
+    fwrite( buffer, 1, formatDcode( buffer, pt, dcode ), outputFile );
+}
+
+
+void GERBER_PLOTTER::emitPolyline( const std::vector<wxPoint>& aCornerList, bool aClose )
+{
+    wxASSERT( outputFile );
+
+    // Large regions have many thousands of corners: one write instead of one per corner
+    std::string records;
+    char        buffer[64];
+
+    records.reserve( aCornerList.size() * 24 );
+
+    for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
+    {
+        int len = formatDcode( buffer, userToDeviceCoordinates( aCornerList[ii] ), 1 );
+        records.append( buffer, len );
+    }
+
+    if( aClose )
+    {
+        int len = formatDcode( buffer, userToDeviceCoordinates( aCornerList[0] ), 1 );
+        records.append( buffer, len );
+    }
+
+    fwrite( records.data(), 1, records.size(), outputFile );
+    penState = 'D';
 }
 
 void GERBER_PLOTTER::ClearAllAttributes()
@@ -309,29 +346,24 @@ void GERBER_PLOTTER::SetCurrentLineWidth( int width, void* aData )
 std::vector<APERTURE>::iterator GERBER_PLOTTER::getAperture( const wxSize& aSize,
                         APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
 {
-    int last_D_code = 9;
+    APERTURE_KEY key = { aType, aSize.x, aSize.y, aApertureAttribute };
 
     // Search an existing aperture
-    std::vector<APERTURE>::iterator tool = apertures.begin();
-
-    while( tool != apertures.end() )
-    {
-        last_D_code = tool->m_DCode;
+    auto index = m_apertureIndex.find( key );
 
-        if( (tool->m_Type == aType) && (tool->m_Size == aSize) &&
-            (tool->m_ApertureAttribute == aApertureAttribute) )
-            return tool;
-
-        ++tool;
-    }
+    if( index != m_apertureIndex.end() )
+        return apertures.begin() + index->second;
 
     // Allocate a new aperture
+    int last_D_code = apertures.empty() ? 9 : apertures.back().m_DCode;
+
     APERTURE new_tool;
     new_tool.m_Size  = aSize;
     new_tool.m_Type  = aType;
     new_tool.m_DCode = last_D_code + 1;
     new_tool.m_ApertureAttribute = aApertureAttribute;
 
+    m_apertureIndex[key] = apertures.size();
     apertures.push_back( new_tool );
 
     return apertures.end() - 1;
@@ -604,12 +636,13 @@ void GERBER_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
         MoveTo( aCornerList[0] );
         fputs( "G01*\n", outputFile );      // Set linear interpolation.
 
-        for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
-            LineTo( aCornerList[ii] );
-
         // If the polygon is not closed, close it:
-        if( aCornerList[0] != aCornerList[aCornerList.size()-1] )
-            FinishTo( aCornerList[0] );
+        bool close = aCornerList[0] != aCornerList[aCornerList.size()-1];
+
+        emitPolyline( aCornerList, close );
+
+        if( close )
+            PenFinish();
 
         fputs( "G37*\n", outputFile );
     }
@@ -620,13 +653,10 @@ void GERBER_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
 
         MoveTo( aCornerList[0] );
 
-        for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
-            LineTo( aCornerList[ii] );
-
         // Ensure the thick outline is closed for filled polygons
         // (if not filled, could be only a polyline)
-        if( aFill && ( aCornerList[aCornerList.size()-1] != aCornerList[0] ) )
-            LineTo( aCornerList[0] );
+        emitPolyline( aCornerList,
+                      aFill && ( aCornerList[aCornerList.size()-1] != aCornerList[0] ) );
 
         PenFinish();
     }
@@ -37,6 +37,10 @@
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #ifdef __WXDEBUG__
 #include <profile.h>
 #endif /* __WXDEBUG__  */
@@ -293,7 +297,8 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_aggregationThreshold( 1.0 )
 {
     // Set m_boundary to define the max area size. The default area size
     // is defined here as the max value of a int.
@@ -384,11 +389,14 @@ void VIEW::Remove( VIEW_ITEM* aItem )
         return;
 
     wxCHECK( viewData->m_view == this, /*void*/ );
-    auto item = std::find( m_allItems->begin(), m_allItems->end(), aItem );
 
-    if( item != m_allItems->end() )
+    // Look from the end, so removing all the items in the reverse order of their addition
+    // does not scan the whole list each time
+    auto item = std::find( m_allItems->rbegin(), m_allItems->rend(), aItem );
+
+    if( item != m_allItems->rend() )
     {
-        m_allItems->erase( item );
+        m_allItems->erase( std::next( item ).base() );
         viewData->clearUpdateFlags();
     }
 
@@ -472,6 +480,22 @@ int VIEW::Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) con
 }
 
 
+void VIEW::QueryAll( const BOX2I& aRect, std::vector<VIEW_ITEM*>& aResult ) const
+{
+    auto visitor = [&aResult]( VIEW_ITEM* aItem ) {
+        aResult.push_back( aItem );
+        return true;
+    };
+
+    for( const auto& layer : m_layers )
+    {
+        // ignore layers that do not contain actual items (i.e. the selection box, menus, floats)
+        if( !layer.second.displayOnly )
+            layer.second.items->Query( aRect, visitor );
+    }
+}
+
+
 VECTOR2D VIEW::ToWorld( const VECTOR2D& aCoord, bool aAbsolute ) const
 {
     const MATRIX3x3D& matrix = m_gal->GetScreenWorldMatrix();
@@ -969,11 +993,43 @@ struct VIEW::drawItem
     {
         wxCHECK( aItem->viewPrivData(), false );
 
+        drawVisible( aItem );
+
+        return true;
+    }
+
+    /**
+     * Draws an item of a group of items too small to be drawn separately. A single item
+     * stands for the group, but selected, brightened and highlighted items are always drawn,
+     * as their color differs from the other items.
+     * @param aStandInDrawn is true if an item was already drawn to stand for the group.
+     * @return true if aItem was drawn to stand for the group.
+     */
+    bool drawAggregate( VIEW_ITEM* aItem, bool aStandInDrawn )
+    {
+        EDA_ITEM* item = dynamic_cast<EDA_ITEM*>( aItem );
+        bool emphasized = item && ( item->IsSelected() || item->IsBrightened()
+                                    || item->IsHighlighted() );
+
+        if( aStandInDrawn && !emphasized )
+            return false;
+
+        return drawVisible( aItem ) && !emphasized;
+    }
+
+    /**
+     * Draws an item if it is visible, returns true if it was drawn.
+     */
+    bool drawVisible( VIEW_ITEM* aItem )
+    {
+        if( !aItem->viewPrivData() )
+            return false;
+
         // Conditions that have to be fulfilled for an item to be drawn
         bool drawCondition = aItem->viewPrivData()->isRenderable() &&
                              aItem->ViewGetLOD( layer, view ) < view->m_scale;
         if( !drawCondition )
-            return true;
+            return false;
 
         if( useDrawPriority )
             drawItems.push_back( aItem );
@@ -1009,6 +1065,13 @@ struct VIEW::drawItem
 
 void VIEW::redrawRect( const BOX2I& aRect )
 {
+    // Groups of items smaller than that are drawn as a single item. Not when printing, nor
+    // when a net is highlighted, as its items cannot be told from the others here.
+    double aggregateSize = 0.0;
+
+    if( m_printMode <= 0 && !m_painter->GetSettings()->IsHighlightEnabled() )
+        aggregateSize = ToWorld( m_aggregationThreshold );
+
     for( VIEW_LAYER* l : m_orderedLayers )
     {
         if( l->visible && IsTargetDirty( l->target ) && areRequiredLayersEnabled( l->id ) )
@@ -1017,7 +1080,11 @@ void VIEW::redrawRect( const BOX2I& aRect )
 
             m_gal->SetTarget( l->target );
             m_gal->SetLayerDepth( l->renderingOrder );
-            l->items->Query( aRect, drawFunc );
+
+            if( aggregateSize >= 1.0 )
+                l->items->QueryAggregated( aRect, aggregateSize, drawFunc );
+            else
+                l->items->Query( aRect, drawFunc );
 
             if( m_useDrawPriority )
                 drawFunc.deferredDraw();
@@ -1418,24 +1485,90 @@ void VIEW::RecacheAllItems()
 }
 
 
+void VIEW::prepareItems( const std::vector<VIEW_ITEM*>& aItems )
+{
+    // Below this count, starting the threads costs more than it saves
+    const size_t MIN_PARALLEL_ITEMS = 256;
+
+    std::vector<VIEW_ITEM*> toPrepare;
+
+    for( VIEW_ITEM* item : aItems )
+    {
+        auto viewData = item->viewPrivData();
+
+        // Color changes do not redraw the items
+        if( !( viewData->m_requiredUpdate & ( GEOMETRY | LAYERS | INITIAL_ADD | REPAINT ) ) )
+            continue;
+
+        int layers[VIEW_MAX_LAYERS], layers_count;
+        item->ViewGetLayers( layers, layers_count );
+
+        for( int i = 0; i < layers_count; ++i )
+        {
+            if( IsCached( layers[i] ) )
+            {
+                toPrepare.push_back( item );
+                break;
+            }
+        }
+    }
+
+    if( toPrepare.size() < MIN_PARALLEL_ITEMS )
+        return;
+
+    std::atomic<size_t> nextItem( 0 );
+    std::atomic<size_t> threadsFinished( 0 );
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
+            toPrepare.size() / MIN_PARALLEL_ITEMS );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        std::thread t = std::thread( [&]()
+        {
+            for( size_t i = nextItem.fetch_add( 1 ); i < toPrepare.size();
+                    i = nextItem.fetch_add( 1 ) )
+            {
+                m_painter->PrepareDraw( toPrepare[i] );
+            }
+
+            threadsFinished++;
+        } );
+
+        t.detach();
+    }
+
+    while( threadsFinished < parallelThreadCount )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+}
+
+
 void VIEW::UpdateItems()
 {
     if( m_gal->IsVisible() )
     {
-        GAL_UPDATE_CONTEXT ctx( m_gal );
+        std::vector<VIEW_ITEM*> toUpdate;
 
         for( VIEW_ITEM* item : *m_allItems )
         {
             auto viewData = item->viewPrivData();
 
-            if( !viewData )
-                continue;
+            if( viewData && viewData->m_requiredUpdate != NONE )
+                toUpdate.push_back( item );
+        }
 
-            if( viewData->m_requiredUpdate != NONE )
-            {
-                invalidateItem( item, viewData->m_requiredUpdate );
-                viewData->m_requiredUpdate = NONE;
-            }
+        // The GAL is only used by this thread, so the painter does the work which does not
+        // depend on it in parallel first
+        prepareItems( toUpdate );
+
+        GAL_UPDATE_CONTEXT ctx( m_gal );
+
+        for( VIEW_ITEM* item : toUpdate )
+        {
+            auto viewData = item->viewPrivData();
+
+            invalidateItem( item, viewData->m_requiredUpdate );
+            viewData->m_requiredUpdate = NONE;
         }
     }
 }
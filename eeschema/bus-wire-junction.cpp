@@ -63,9 +63,11 @@ bool SCH_EDIT_FRAME::TestDanglingEnds()
     for( SCH_ITEM* item = GetScreen()->GetDrawList().begin(); item; item = item->Next() )
         item->GetEndPoints( endPoints );
 
+    DANGLING_END_INDEX index( endPoints );
+
     for( SCH_ITEM* item = GetScreen()->GetDrawList().begin(); item; item = item->Next() )
     {
-        if( item->UpdateDanglingState( endPoints ) )
+        if( index.UpdateDanglingState( item ) )
         {
             GetCanvas()->GetView()->Update( item, KIGFX::REPAINT );
             hasStateChanged = true;
@@ -76,6 +78,20 @@ bool SCH_EDIT_FRAME::TestDanglingEnds()
 }
 
 
+bool SCH_EDIT_FRAME::TestDanglingEnds( const EDA_RECT& aChangedArea )
+{
+    std::vector<SCH_ITEM*> changedItems;
+
+    if( !GetScreen()->TestDanglingEnds( aChangedArea, &changedItems ) )
+        return false;
+
+    for( SCH_ITEM* item : changedItems )
+        GetCanvas()->GetView()->Update( item, KIGFX::REPAINT );
+
+    return true;
+}
+
+
 bool SCH_EDIT_FRAME::TrimWire( const wxPoint& aStart, const wxPoint& aEnd )
 {
     SCH_LINE* line;
@@ -133,7 +149,7 @@ bool SCH_EDIT_FRAME::TrimWire( const wxPoint& aStart, const wxPoint& aEnd )
 }
 
 
-bool SCH_EDIT_FRAME::SchematicCleanUp( SCH_SCREEN* aScreen )
+bool SCH_EDIT_FRAME::SchematicCleanUp( SCH_SCREEN* aScreen, EDA_RECT* aChangedArea )
 {
     SCH_ITEM*           item = NULL;
     SCH_ITEM*           secondItem = NULL;
@@ -149,7 +165,7 @@ bool SCH_EDIT_FRAME::SchematicCleanUp( SCH_SCREEN* aScreen )
         itemList.PushItem( ITEM_PICKER( aItem, UR_DELETED ) );
     };
 
-    BreakSegmentsOnJunctions( aScreen );
+    BreakSegmentsOnJunctions( aScreen, aChangedArea );
 
     for( item = aScreen->GetDrawItems(); item; item = item->Next() )
     {
@@ -231,6 +247,19 @@ bool SCH_EDIT_FRAME::SchematicCleanUp( SCH_SCREEN* aScreen )
         }
     }
 
+    // A merged line takes the dangling state of one of the lines it replaces, but its ends
+    // may be far from the changes
+    if( aChangedArea )
+    {
+        for( unsigned ii = 0; ii < itemList.GetCount(); ii++ )
+        {
+            SCH_ITEM* changed = static_cast<SCH_ITEM*>( itemList.GetPickedItem( ii ) );
+
+            if( changed->Type() == SCH_LINE_T )
+                aChangedArea->Merge( changed->GetBoundingBox() );
+        }
+    }
+
     for( item = aScreen->GetDrawItems(); item; item = secondItem )
     {
         secondItem = item->Next();
@@ -291,7 +320,8 @@ bool SCH_EDIT_FRAME::BreakSegment( SCH_LINE* aSegment, const wxPoint& aPoint,
 }
 
 
-bool SCH_EDIT_FRAME::BreakSegments( const wxPoint& aPoint, SCH_SCREEN* aScreen )
+bool SCH_EDIT_FRAME::BreakSegments( const wxPoint& aPoint, SCH_SCREEN* aScreen,
+                                    EDA_RECT* aChangedArea )
 {
     static KICAD_T wiresAndBusses[] = { SCH_LINE_LOCATE_WIRE_T, SCH_LINE_LOCATE_BUS_T, EOT };
 
@@ -302,15 +332,26 @@ bool SCH_EDIT_FRAME::BreakSegments( const wxPoint& aPoint, SCH_SCREEN* aScreen )
 
     for( SCH_ITEM* segment = aScreen->GetDrawItems(); segment; segment = segment->Next() )
     {
-        if( segment->IsType( wiresAndBusses ) )
-            brokenSegments |= BreakSegment( (SCH_LINE*) segment, aPoint, NULL, aScreen );
+        if( !segment->IsType( wiresAndBusses ) )
+            continue;
+
+        // Both parts of the broken segment are within its initial bounding box
+        EDA_RECT bbox = segment->GetBoundingBox();
+
+        if( BreakSegment( (SCH_LINE*) segment, aPoint, NULL, aScreen ) )
+        {
+            brokenSegments = true;
+
+            if( aChangedArea )
+                aChangedArea->Merge( bbox );
+        }
     }
 
     return brokenSegments;
 }
 
 
-bool SCH_EDIT_FRAME::BreakSegmentsOnJunctions( SCH_SCREEN* aScreen )
+bool SCH_EDIT_FRAME::BreakSegmentsOnJunctions( SCH_SCREEN* aScreen, EDA_RECT* aChangedArea )
 {
     if( aScreen == nullptr )
         aScreen = GetScreen();
@@ -323,14 +364,14 @@ bool SCH_EDIT_FRAME::BreakSegmentsOnJunctions( SCH_SCREEN* aScreen )
         {
             SCH_JUNCTION* junction = ( SCH_JUNCTION* ) item;
 
-            brokenSegments |= BreakSegments( junction->GetPosition(), aScreen );
+            brokenSegments |= BreakSegments( junction->GetPosition(), aScreen, aChangedArea );
         }
         else if( item->Type() == SCH_BUS_BUS_ENTRY_T || item->Type() == SCH_BUS_WIRE_ENTRY_T )
         {
             SCH_BUS_ENTRY_BASE* busEntry = (SCH_BUS_ENTRY_BASE*) item;
 
-            brokenSegments |= BreakSegments( busEntry->GetPosition(), aScreen );
-            brokenSegments |= BreakSegments( busEntry->m_End(), aScreen );
+            brokenSegments |= BreakSegments( busEntry->GetPosition(), aScreen, aChangedArea );
+            brokenSegments |= BreakSegments( busEntry->m_End(), aScreen, aChangedArea );
         }
     }
 
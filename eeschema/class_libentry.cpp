@@ -251,6 +251,8 @@ LIB_PART::LIB_PART( LIB_PART& aPart, PART_LIB* aLibrary ) :
     m_options             = aPart.m_options;
     m_libId               = aPart.m_libId;
 
+    aPart.loadDrawItems();
+
     for( LIB_ITEM& oldItem : aPart.m_drawings )
     {
         if( oldItem.HasFlag( IS_NEW ) || oldItem.HasFlag( STRUCT_DELETED ) )
@@ -284,6 +286,19 @@ LIB_PART::~LIB_PART()
 }
 
 
+void LIB_PART::loadDrawItems() const
+{
+    if( !m_drawItemsLoader )
+        return;
+
+    // The loader adds the items with AddDrawItem(), so it must not be pending anymore
+    std::function<void( LIB_PART& )> loader = std::move( m_drawItemsLoader );
+    m_drawItemsLoader = nullptr;
+
+    loader( const_cast<LIB_PART&>( *this ) );
+}
+
+
 const wxString LIB_PART::GetLibraryName()
 {
     if( m_library )
@@ -353,6 +368,8 @@ void LIB_PART::SetName( const wxString& aName )
 void LIB_PART::Print( wxDC* aDc, const wxPoint& aOffset, int aMulti, int aConvert,
                       const PART_DRAW_OPTIONS& aOpts )
 {
+    loadDrawItems();
+
     /* draw background for filled items using background option
      * Solid lines will be drawn after the background
      * Note also, background is not drawn when printing in black and white
@@ -423,6 +440,8 @@ void LIB_PART::Plot( PLOTTER* aPlotter, int aUnit, int aConvert,
     wxASSERT( aPlotter != NULL );
 
     aPlotter->SetColor( GetLayerColor( LAYER_DEVICE ) );
+    loadDrawItems();
+
     bool fill = aPlotter->GetColorMode();
 
     // draw background for filled items using background option
@@ -516,6 +535,8 @@ void LIB_PART::RemoveDrawItem( LIB_ITEM* aItem )
         }
     }
 
+    loadDrawItems();
+
     LIB_ITEMS& items = m_drawings[ aItem->Type() ];
 
     for( LIB_ITEMS::iterator i = items.begin(); i != items.end(); i++ )
@@ -535,12 +556,16 @@ void LIB_PART::AddDrawItem( LIB_ITEM* aItem )
     if( !aItem )
         return;
 
+    loadDrawItems();
+
     m_drawings.push_back( aItem );
 }
 
 
 LIB_ITEM* LIB_PART::GetNextDrawItem( LIB_ITEM* aItem, KICAD_T aType )
 {
+    loadDrawItems();
+
     if( m_drawings.empty( aType ) )
         return NULL;
 
@@ -569,6 +594,8 @@ LIB_ITEM* LIB_PART::GetNextDrawItem( LIB_ITEM* aItem, KICAD_T aType )
 
 void LIB_PART::GetPins( LIB_PINS& aList, int aUnit, int aConvert )
 {
+    loadDrawItems();
+
     if( m_drawings.empty( LIB_PIN_T ) )
         return;
 
@@ -669,6 +696,8 @@ bool LIB_PART::PinsConflictWith( LIB_PART& aOtherPart, bool aTestNums, bool aTes
 
 const EDA_RECT LIB_PART::GetUnitBoundingBox( int aUnit, int aConvert ) const
 {
+    loadDrawItems();
+
     EDA_RECT bBox;
     bool initialized = false;
 
@@ -708,6 +737,8 @@ void LIB_PART::ViewGetLayers( int aLayers[], int& aCount ) const
 
 const EDA_RECT LIB_PART::GetBodyBoundingBox( int aUnit, int aConvert ) const
 {
+    loadDrawItems();
+
     EDA_RECT bBox;
     bool initialized = false;
 
@@ -840,6 +871,8 @@ LIB_FIELD& LIB_PART::GetFootprintField()
 
 void LIB_PART::SetOffset( const wxPoint& aOffset )
 {
+    loadDrawItems();
+
     for( LIB_ITEM& item : m_drawings )
         item.Offset( aOffset );
 }
@@ -847,12 +880,16 @@ void LIB_PART::SetOffset( const wxPoint& aOffset )
 
 void LIB_PART::RemoveDuplicateDrawItems()
 {
+    loadDrawItems();
+
     m_drawings.unique();
 }
 
 
 bool LIB_PART::HasConversion() const
 {
+    loadDrawItems();
+
     for( const LIB_ITEM& item : m_drawings )
     {
         if( item.m_Convert > LIB_ITEM::LIB_CONVERT::BASE )
@@ -864,12 +901,16 @@ bool LIB_PART::HasConversion() const
 
 void LIB_PART::ClearTempFlags()
 {
+    loadDrawItems();
+
     for( LIB_ITEM& item : m_drawings )
         item.ClearTempFlags();
 }
 
 void LIB_PART::ClearEditFlags()
 {
+    loadDrawItems();
+
     for( LIB_ITEM& item : m_drawings )
         item.ClearEditFlags();
 }
@@ -877,6 +918,8 @@ void LIB_PART::ClearEditFlags()
 LIB_ITEM* LIB_PART::LocateDrawItem( int aUnit, int aConvert,
                                     KICAD_T aType, const wxPoint& aPoint )
 {
+    loadDrawItems();
+
     for( LIB_ITEM& item : m_drawings )
     {
         if( ( aUnit && item.m_Unit && ( aUnit != item.m_Unit) )
@@ -915,6 +958,8 @@ LIB_ITEM* LIB_PART::LocateDrawItem( int aUnit, int aConvert, KICAD_T aType,
 
 SEARCH_RESULT LIB_PART::Visit( INSPECTOR aInspector, void* aTestData, const KICAD_T aFilterTypes[] )
 {
+    loadDrawItems();
+
     // The part itself is never inspected, only its children
     for( LIB_ITEM& item : m_drawings )
     {
@@ -934,6 +979,8 @@ void LIB_PART::SetUnitCount( int aCount )
     if( m_unitCount == aCount )
         return;
 
+    loadDrawItems();
+
     if( aCount < m_unitCount )
     {
         LIB_ITEMS_CONTAINER::ITERATOR i = m_drawings.begin();
@@ -34,6 +34,7 @@
 #include <lib_tree_item.h>
 #include <lib_item.h>
 #include <lib_field.h>
+#include <functional>
 #include <vector>
 #include <multivector.h>
 
@@ -231,6 +232,8 @@ class LIB_PART : public EDA_ITEM
     LIBRENTRYOPTIONS    m_options;          ///< Special part features such as POWER or NORMAL.)
     int                 m_unitCount;        ///< Number of units (parts) per package.
     LIB_ITEMS_CONTAINER m_drawings;         ///< Drawing items of this part.
+    mutable std::function<void( LIB_PART& )> m_drawItemsLoader; ///< Loads the drawing items
+                                            ///< other than fields on first use, if set.
     wxArrayString       m_FootprintList;    /**< List of suitable footprint names for the
                                                  part (wild card names accepted). */
     LIB_ALIASES         m_aliases;          ///< List of alias object pointers associated with the
@@ -246,6 +249,9 @@ class LIB_PART : public EDA_ITEM
 private:
     void deleteAllFields();
 
+    /// Run the pending drawing items loader, if any.
+    void loadDrawItems() const;
+
 public:
 
     LIB_PART( const wxString& aName, PART_LIB* aLibrary = NULL );
@@ -581,9 +587,22 @@ public:
      */
     LIB_ITEMS_CONTAINER& GetDrawItems()
     {
+        loadDrawItems();
         return m_drawings;
     }
 
+    /**
+     * Defer the loading of the drawing items other than fields to their first use.
+     *
+     * The loader is called once, when the drawing items are first needed, and adds them
+     * with AddDrawItem().  Library plugins use it to only parse the graphics of the symbols
+     * actually displayed.
+     */
+    void SetDrawItemsLoader( const std::function<void( LIB_PART& aPart )>& aLoader )
+    {
+        m_drawItemsLoader = aLoader;
+    }
+
     SEARCH_RESULT Visit( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[] ) override;
 
     /**
@@ -18,12 +18,16 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <array>
+#include <atomic>
 #include <list>
+#include <set>
 #include <thread>
 #include <algorithm>
 #include <future>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <profile.h>
 
 #include <advanced_config.h>
@@ -42,7 +46,30 @@
 #include <connection_graph.h>
 
 
-bool CONNECTION_SUBGRAPH::ResolveDrivers( bool aCreateMarkers )
+/// Units of the ERC marker messages; the graph has no frame when used without a GUI
+static EDA_UNITS_T getUserUnits( SCH_EDIT_FRAME* aFrame )
+{
+    return aFrame ? aFrame->GetUserUnits() : INCHES;
+}
+
+
+/**
+ * Copy a connection with its bus members, and their members.  The copy constructor of
+ * SCH_CONNECTION shares the members with the original, which is updated by the next
+ * recalculations.
+ */
+static std::shared_ptr<SCH_CONNECTION> deepCopyConnection( const SCH_CONNECTION& aConnection )
+{
+    auto copy = std::make_shared<SCH_CONNECTION>( aConnection );
+
+    for( std::shared_ptr<SCH_CONNECTION>& member : copy->Members() )
+        member = deepCopyConnection( *member );
+
+    return copy;
+}
+
+
+bool CONNECTION_SUBGRAPH::ResolveDrivers( std::vector<SCH_MARKER*>* aMarkers )
 {
     int highest_priority = -1;
     std::vector<SCH_ITEM*> candidates;
@@ -134,7 +161,7 @@ bool CONNECTION_SUBGRAPH::ResolveDrivers( bool aCreateMarkers )
     else
         m_driver_connection = nullptr;
 
-    if( aCreateMarkers && m_multiple_drivers )
+    if( aMarkers && m_multiple_drivers )
     {
         // First check if all the candidates are actually the same
         bool same = true;
@@ -156,8 +183,8 @@ bool CONNECTION_SUBGRAPH::ResolveDrivers( bool aCreateMarkers )
             wxString msg;
             msg.Printf( _( "%s and %s are both attached to the same wires. "
                            "%s was picked as the label to use for netlisting." ),
-                        candidates[0]->GetSelectMenuText( m_frame->GetUserUnits() ),
-                        second_item->GetSelectMenuText( m_frame->GetUserUnits() ),
+                        candidates[0]->GetSelectMenuText( getUserUnits( m_frame ) ),
+                        second_item->GetSelectMenuText( getUserUnits( m_frame ) ),
                         candidates[0]->Connection( m_sheet )->Name() );
 
             wxASSERT( candidates[0] != second_item );
@@ -171,20 +198,19 @@ bool CONNECTION_SUBGRAPH::ResolveDrivers( bool aCreateMarkers )
                       second_item->GetPosition();
 
             auto marker = new SCH_MARKER();
-            marker->SetTimeStamp( GetNewTimeStamp() );
             marker->SetMarkerType( MARKER_BASE::MARKER_ERC );
             marker->SetErrorLevel( MARKER_BASE::MARKER_SEVERITY_WARNING );
             marker->SetData( ERCE_DRIVER_CONFLICT, p0, msg, p1 );
 
-            m_sheet.LastScreen()->Append( marker );
+            aMarkers->push_back( marker );
 
-            // If aCreateMarkers is true, then this is part of ERC check, so we
+            // If aMarkers is given, then this is part of ERC check, so we
             // should return false even if the driver was assigned
             return false;
         }
     }
 
-    return aCreateMarkers || ( m_driver != nullptr );
+    return aMarkers || ( m_driver != nullptr );
 }
 
 
@@ -369,6 +395,8 @@ void CONNECTION_GRAPH::Reset()
     m_net_name_to_subgraphs_map.clear();
     m_local_label_cache.clear();
     m_global_label_cache.clear();
+    m_sheet_connection_points.clear();
+    m_subgraph_names.clear();
     m_last_net_code = 1;
     m_last_bus_code = 1;
     m_last_subgraph_code = 1;
@@ -380,41 +408,113 @@ void CONNECTION_GRAPH::Recalculate( SCH_SHEET_LIST aSheetList, bool aUncondition
     PROF_COUNTER recalc_time;
     PROF_COUNTER update_items;
 
-    if( aUnconditional )
-        Reset();
+    // Connection points of the sheets at the last recalculation, to find the unchanged ones
+    std::unordered_map<SCH_SHEET_PATH, std::vector<CONNECTION_POINT>> previous_points;
+
+    if( !aUnconditional )
+        previous_points.swap( m_sheet_connection_points );
+
+    bool incremental = !previous_points.empty();
+
+    // The subgraphs are always rebuilt.  The item connectivity of the unchanged sheets is
+    // kept, as well as the names and net codes of the last recalculation, which are given
+    // back to the subgraphs not reachable from a changed sheet.
+    decltype( m_subgraph_names )      subgraph_names;
+    decltype( m_net_name_to_code_map ) net_codes;
+    decltype( m_bus_name_to_code_map ) bus_codes;
+    int                               last_net_code = m_last_net_code;
+    int                               last_bus_code = m_last_bus_code;
+
+    if( incremental )
+    {
+        subgraph_names.swap( m_subgraph_names );
+        net_codes.swap( m_net_name_to_code_map );
+        bus_codes.swap( m_bus_name_to_code_map );
+    }
+
+    Reset();
 
-    for( const auto& sheet : aSheetList )
+    if( incremental )
     {
-        std::vector<SCH_ITEM*> items;
+        m_subgraph_names.swap( subgraph_names );
+        m_net_name_to_code_map.swap( net_codes );
+        m_bus_name_to_code_map.swap( bus_codes );
+        m_last_net_code = last_net_code;
+        m_last_bus_code = last_bus_code;
+    }
+
+    std::vector<std::vector<SCH_ITEM*>> sheet_items( aSheetList.size() );
+    std::unordered_set<SCH_SCREEN*>     dirty_screens;
 
-        for( auto item = sheet.LastScreen()->GetDrawItems();
-             item; item = item->Next() )
+    for( size_t i = 0; i < aSheetList.size(); i++ )
+    {
+        const SCH_SHEET_PATH& sheet = aSheetList[i];
+        bool                  dirty = !incremental;
+
+        for( auto item = sheet.LastScreen()->GetDrawItems(); item; item = item->Next() )
         {
-            if( item->IsConnectable() &&
-                ( aUnconditional || item->IsConnectivityDirty() ) )
+            if( item->IsConnectable() )
             {
-                items.push_back( item );
+                sheet_items[i].push_back( item );
+                dirty |= item->IsConnectivityDirty();
             }
         }
 
-        updateItemConnectivity( sheet, items );
+        std::vector<CONNECTION_POINT> points = getConnectionPoints( sheet_items[i] );
+        auto previous = previous_points.find( sheet );
+
+        // New, moved or deleted items are found by comparing the connection points
+        if( previous == previous_points.end() || previous->second != points )
+            dirty = true;
+
+        if( dirty )
+            dirty_screens.insert( sheet.LastScreen() );
+
+        m_sheet_connection_points[sheet] = std::move( points );
     }
 
+    // A screen used by several sheets is updated for all of them: the dirty flags are
+    // cleared by the first update.
+    for( size_t i = 0; i < aSheetList.size(); i++ )
+    {
+        if( dirty_screens.count( aSheetList[i].LastScreen() ) )
+            updateItemConnectivity( aSheetList[i], sheet_items[i] );
+        else
+            resetItemConnections( aSheetList[i], sheet_items[i] );
+    }
+
+    wxLogTrace( "CONN_PROFILE", "%s recalculation, %lu of %lu sheets updated",
+                incremental ? "Incremental" : "Full",
+                (unsigned long) std::count_if( aSheetList.begin(), aSheetList.end(),
+                        [&]( const SCH_SHEET_PATH& aSheet ) {
+                            return dirty_screens.count( aSheet.LastScreen() ) > 0;
+                        } ),
+                (unsigned long) aSheetList.size() );
+
     update_items.Stop();
     wxLogTrace( "CONN_PROFILE", "UpdateItemConnectivity() %0.4f ms", update_items.msecs() );
 
     PROF_COUNTER tde;
 
     // IsDanglingStateChanged() also adds connected items for things like SCH_TEXT
-    SCH_SCREENS schematic;
-    schematic.TestDanglingEnds();
+    // Unchanged screens keep the connected items found by the previous recalculation.
+    if( incremental )
+    {
+        for( SCH_SCREEN* screen : dirty_screens )
+            screen->TestDanglingEnds();
+    }
+    else
+    {
+        SCH_SCREENS schematic;
+        schematic.TestDanglingEnds();
+    }
 
     tde.Stop();
     wxLogTrace( "CONN_PROFILE", "TestDanglingEnds() %0.4f ms", tde.msecs() );
 
     PROF_COUNTER build_graph;
 
-    buildConnectionGraph();
+    buildConnectionGraph( incremental ? &dirty_screens : nullptr );
 
     build_graph.Stop();
     wxLogTrace( "CONN_PROFILE", "BuildConnectionGraph() %0.4f ms", build_graph.msecs() );
@@ -432,60 +532,117 @@ void CONNECTION_GRAPH::Recalculate( SCH_SHEET_LIST aSheetList, bool aUncondition
         m_allowRealTime = false;
     }
 #endif
+
+    if( incremental && m_verify_incremental )
+    {
+        auto incremental_names = getConnectionNames();
+
+        Recalculate( aSheetList, true );
+
+        auto full_names = getConnectionNames();
+        int  mismatches = 0;
+
+        for( const auto& it : full_names )
+        {
+            auto other = incremental_names.find( it.first );
+
+            if( other == incremental_names.end() || other->second != it.second )
+            {
+                wxLogTrace( "CONN", "Incremental mismatch: %s on %s is %s, should be %s",
+                            it.first.first->GetSelectMenuText( MILLIMETRES ), it.first.second,
+                            other == incremental_names.end() ? wxString( "<none>" ) : other->second,
+                            it.second );
+                mismatches++;
+            }
+        }
+
+        if( incremental_names.size() != full_names.size() )
+            mismatches++;
+
+        wxLogTrace( "CONN", "Incremental recalculation verified: %d mismatches", mismatches );
+        wxASSERT_MSG( mismatches == 0, "Incremental connectivity differs from full rebuild" );
+    }
 }
 
 
-void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
-                                               std::vector<SCH_ITEM*> aItemList )
+std::vector<CONNECTION_GRAPH::CONNECTION_POINT> CONNECTION_GRAPH::getConnectionPoints(
+        const std::vector<SCH_ITEM*>& aItemList )
 {
-    std::unordered_map< wxPoint, std::vector<SCH_ITEM*> > connection_map;
+    std::vector<CONNECTION_POINT> points;
+    std::vector<wxPoint>          item_points;
 
     for( auto item : aItemList )
     {
-        std::vector< wxPoint > points;
-        item->GetConnectionPoints( points );
-        item->ConnectedItems().clear();
-
+        // Pins are referenced by the connected items, so a pin list change is a change
         if( item->Type() == SCH_SHEET_T )
         {
             for( auto& pin : static_cast<SCH_SHEET*>( item )->GetPins() )
-            {
-                if( !pin.Connection( aSheet ) )
-                {
-                    pin.InitializeConnection( aSheet );
-                }
+                points.emplace_back( &pin, wxEmptyString, pin.GetTextPos() );
+        }
+        else if( item->Type() == SCH_COMPONENT_T )
+        {
+            for( SCH_PIN& pin : static_cast<SCH_COMPONENT*>( item )->GetPins() )
+                points.emplace_back( item, pin.GetNumber(), pin.GetPosition() );
+        }
 
-                pin.ConnectedItems().clear();
-                pin.Connection( aSheet )->Reset();
+        item_points.clear();
+        item->GetConnectionPoints( item_points );
 
-                connection_map[ pin.GetTextPos() ].push_back( &pin );
+        for( const wxPoint& point : item_points )
+            points.emplace_back( item, wxEmptyString, point );
+
+        // Items without connection points (i.e. a sheet without pin) are still kept
+        if( item_points.empty() )
+            points.emplace_back( item, wxEmptyString, wxPoint() );
+    }
+
+    return points;
+}
+
+
+std::map<std::pair<SCH_ITEM*, wxString>, wxString> CONNECTION_GRAPH::getConnectionNames() const
+{
+    std::map<std::pair<SCH_ITEM*, wxString>, wxString> names;
+
+    for( SCH_ITEM* item : m_items )
+    {
+        for( const auto& it : item->m_connection_map )
+            names[ std::make_pair( item, it.first.Path() ) ] = it.second->Name();
+    }
+
+    return names;
+}
+
+
+void CONNECTION_GRAPH::resetItemConnections( const SCH_SHEET_PATH& aSheet,
+                                             const std::vector<SCH_ITEM*>& aItemList )
+{
+    for( auto item : aItemList )
+    {
+        if( item->Type() == SCH_SHEET_T )
+        {
+            for( auto& pin : static_cast<SCH_SHEET*>( item )->GetPins() )
+            {
+                pin.InitializeConnection( aSheet );
                 m_items.insert( &pin );
             }
         }
         else if( item->Type() == SCH_COMPONENT_T )
         {
             SCH_COMPONENT* component = static_cast<SCH_COMPONENT*>( item );
-            TRANSFORM t = component->GetTransform();
-
-            // Assumption: we don't need to call UpdatePins() here because anything
-            // that would change the pins of the component will have called it already
 
             for( SCH_PIN& pin : component->GetPins() )
             {
                 pin.InitializeConnection( aSheet );
 
-                wxPoint pos = t.TransformCoordinate( pin.GetPosition() ) + component->GetPosition();
-
                 // because calling the first time is not thread-safe
                 pin.GetDefaultNetName( aSheet );
-                pin.ConnectedItems().clear();
 
                 // Invisible power pins need to be post-processed later
 
                 if( pin.IsPowerConnection() && !pin.IsVisible() )
                     m_invisible_power_pins.emplace_back( std::make_pair( aSheet, &pin ) );
 
-                connection_map[ pos ].push_back( &pin );
                 m_items.insert( &pin );
             }
         }
@@ -513,7 +670,50 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
             default:
                 break;
             }
+        }
+    }
+}
 
+
+void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
+                                               std::vector<SCH_ITEM*> aItemList )
+{
+    std::unordered_map< wxPoint, std::vector<SCH_ITEM*> > connection_map;
+
+    resetItemConnections( aSheet, aItemList );
+
+    for( auto item : aItemList )
+    {
+        std::vector< wxPoint > points;
+        item->GetConnectionPoints( points );
+        item->ConnectedItems().clear();
+
+        if( item->Type() == SCH_SHEET_T )
+        {
+            for( auto& pin : static_cast<SCH_SHEET*>( item )->GetPins() )
+            {
+                pin.ConnectedItems().clear();
+                connection_map[ pin.GetTextPos() ].push_back( &pin );
+            }
+        }
+        else if( item->Type() == SCH_COMPONENT_T )
+        {
+            SCH_COMPONENT* component = static_cast<SCH_COMPONENT*>( item );
+            TRANSFORM t = component->GetTransform();
+
+            // Assumption: we don't need to call UpdatePins() here because anything
+            // that would change the pins of the component will have called it already
+
+            for( SCH_PIN& pin : component->GetPins() )
+            {
+                wxPoint pos = t.TransformCoordinate( pin.GetPosition() ) + component->GetPosition();
+
+                pin.ConnectedItems().clear();
+                connection_map[ pos ].push_back( &pin );
+            }
+        }
+        else
+        {
             for( auto point : points )
             {
                 connection_map[ point ].push_back( item );
@@ -635,7 +835,7 @@ void CONNECTION_GRAPH::updateItemConnectivity( SCH_SHEET_PATH aSheet,
 //     on some portion of the items.
 
 
-void CONNECTION_GRAPH::buildConnectionGraph()
+void CONNECTION_GRAPH::buildConnectionGraph( const std::unordered_set<SCH_SCREEN*>* aDirtyScreens )
 {
     // Recache all bus aliases for later use
 
@@ -904,6 +1104,9 @@ void CONNECTION_GRAPH::buildConnectionGraph()
 
     std::unordered_map<int, CONNECTION_SUBGRAPH*> invisible_pin_subgraphs;
 
+    // Invisible power pin subgraphs can hold pins of several sheets
+    std::unordered_set<CONNECTION_SUBGRAPH*> changed_pin_subgraphs;
+
     for( const auto& it : m_invisible_power_pins )
     {
         SCH_PIN* pin = it.second;
@@ -955,6 +1158,9 @@ void CONNECTION_GRAPH::buildConnectionGraph()
         }
 
         connection->SetSubgraphCode( subgraph->m_code );
+
+        if( aDirtyScreens && aDirtyScreens->count( sheet.LastScreen() ) )
+            changed_pin_subgraphs.insert( subgraph );
     }
 
     for( auto it : invisible_pin_subgraphs )
@@ -1273,6 +1479,50 @@ void CONNECTION_GRAPH::buildConnectionGraph()
     for( auto subgraph : m_driver_subgraphs )
         m_sheet_to_subgraphs_map[ subgraph->m_sheet ].emplace_back( subgraph );
 
+    // Keep the names before the propagation, to compare them on the next recalculation
+    std::unordered_map<CONNECTION_SUBGRAPH*, wxString> local_names;
+
+    for( auto subgraph : m_driver_subgraphs )
+        local_names[ subgraph ] = subgraph->m_driver_connection->Name();
+
+    // On an incremental recalculation, the subgraphs that cannot be reached from a changed
+    // sheet get their names back instead of being propagated again
+    std::unordered_set<CONNECTION_SUBGRAPH*> affected_subgraphs;
+
+    auto is_affected = [&]( CONNECTION_SUBGRAPH* aSubgraph ) -> bool {
+        return !aDirtyScreens || affected_subgraphs.count( aSubgraph );
+    };
+
+    if( aDirtyScreens )
+    {
+        affected_subgraphs = findAffectedSubgraphs( *aDirtyScreens, changed_pin_subgraphs,
+                                                    local_names );
+
+        for( auto subgraph : m_driver_subgraphs )
+        {
+            if( affected_subgraphs.count( subgraph ) )
+                continue;
+
+            // Unaffected subgraphs always have names from the last recalculation
+            const SUBGRAPH_NAMES& previous = m_subgraph_names.at(
+                    std::make_pair( subgraph->m_driver, subgraph->m_sheet.Path() ) );
+
+            wxString old_name = subgraph->m_driver_connection->Name();
+
+            // The kept connection must not share its members with the restored one
+            subgraph->m_driver_connection->Clone( *deepCopyConnection( *previous.m_connection ) );
+            subgraph->UpdateItemConnections();
+
+            recacheSubgraphName( subgraph, old_name );
+
+            subgraph->m_dirty = false;
+        }
+
+        wxLogTrace( "CONN_PROFILE", "Propagating %lu of %lu subgraphs",
+                    (unsigned long) affected_subgraphs.size(),
+                    (unsigned long) m_driver_subgraphs.size() );
+    }
+
     // Next time through the subgraphs, we do some post-processing to handle things like
     // connecting bus members to their neighboring subgraphs, and then propagate connections
     // through the hierarchy
@@ -1335,7 +1585,7 @@ void CONNECTION_GRAPH::buildConnectionGraph()
 
     for( CONNECTION_SUBGRAPH* subgraph : m_driver_subgraphs )
     {
-        if( subgraph->m_bus_parents.size() < 2 )
+        if( subgraph->m_bus_parents.size() < 2 || !is_affected( subgraph ) )
             continue;
 
         SCH_CONNECTION* conn = subgraph->m_driver_connection;
@@ -1408,6 +1658,198 @@ void CONNECTION_GRAPH::buildConnectionGraph()
                                  [&] ( const CONNECTION_SUBGRAPH* sg ) {
                                          return sg->m_absorbed;
                                      } ), m_subgraphs.end() );
+
+    m_subgraph_names.clear();
+
+    for( auto subgraph : m_driver_subgraphs )
+    {
+        SUBGRAPH_NAMES& names = m_subgraph_names[ std::make_pair( subgraph->m_driver,
+                                                                  subgraph->m_sheet.Path() ) ];
+
+        names.m_local_name = local_names.at( subgraph );
+        names.m_connection = deepCopyConnection( *subgraph->m_driver_connection );
+    }
+}
+
+
+std::unordered_set<CONNECTION_SUBGRAPH*> CONNECTION_GRAPH::findAffectedSubgraphs(
+        const std::unordered_set<SCH_SCREEN*>& aDirtyScreens,
+        const std::unordered_set<CONNECTION_SUBGRAPH*>& aSeeds,
+        const std::unordered_map<CONNECTION_SUBGRAPH*, wxString>& aLocalNames ) const
+{
+    std::unordered_set<CONNECTION_SUBGRAPH*> affected;
+    std::vector<CONNECTION_SUBGRAPH*>        search_list;
+    std::unordered_set<wxString>             affected_names;
+    std::vector<wxString>                    name_list;
+
+    // All the names a subgraph had or may get, to find the subgraphs sharing a net with it
+    std::unordered_map<CONNECTION_SUBGRAPH*, std::vector<wxString>>  subgraph_names;
+    std::unordered_map<wxString, std::vector<CONNECTION_SUBGRAPH*>>  name_to_subgraphs;
+    std::set<std::pair<SCH_ITEM*, wxString>>                         found_keys;
+
+    auto add_connection_names = []( const SCH_CONNECTION& aConnection,
+                                    std::vector<wxString>& aNames ) {
+        aNames.push_back( aConnection.Name() );
+
+        for( const auto& member : aConnection.Members() )
+        {
+            aNames.push_back( member->Name() );
+
+            for( const auto& sub_member : member->Members() )
+                aNames.push_back( sub_member->Name() );
+        }
+    };
+
+    auto add_subgraph = [&]( CONNECTION_SUBGRAPH* aSubgraph ) {
+        while( aSubgraph->m_absorbed )
+            aSubgraph = aSubgraph->m_absorbed_by;
+
+        if( affected.insert( aSubgraph ).second )
+            search_list.push_back( aSubgraph );
+    };
+
+    auto add_name = [&]( const wxString& aName ) {
+        if( !aName.IsEmpty() && affected_names.insert( aName ).second )
+            name_list.push_back( aName );
+    };
+
+    for( CONNECTION_SUBGRAPH* subgraph : m_driver_subgraphs )
+    {
+        std::vector<wxString>& names = subgraph_names[ subgraph ];
+        const wxString&        local_name = aLocalNames.at( subgraph );
+
+        add_connection_names( *subgraph->m_driver_connection, names );
+
+        // Secondary global drivers promote the subgraphs having their name
+        for( SCH_ITEM* driver : subgraph->m_drivers )
+        {
+            if( CONNECTION_SUBGRAPH::GetDriverPriority( driver ) >=
+                    CONNECTION_SUBGRAPH::PRIORITY_POWER_PIN )
+                names.push_back( subgraph->GetNameForDriver( driver ) );
+        }
+
+        auto key = std::make_pair( subgraph->m_driver, subgraph->m_sheet.Path() );
+        auto previous = m_subgraph_names.find( key );
+
+        found_keys.insert( key );
+
+        if( previous != m_subgraph_names.end() )
+        {
+            names.push_back( previous->second.m_local_name );
+            add_connection_names( *previous->second.m_connection, names );
+        }
+
+        for( const wxString& name : names )
+            name_to_subgraphs[ name ].push_back( subgraph );
+
+        if( aSeeds.count( subgraph ) || aDirtyScreens.count( subgraph->m_sheet.LastScreen() )
+                || previous == m_subgraph_names.end()
+                || previous->second.m_local_name != local_name )
+        {
+            add_subgraph( subgraph );
+        }
+    }
+
+    // Nets that lost a subgraph can be renamed too
+    for( const auto& it : m_subgraph_names )
+    {
+        if( found_keys.count( it.first ) )
+            continue;
+
+        std::vector<wxString> names( 1, it.second.m_local_name );
+        add_connection_names( *it.second.m_connection, names );
+
+        for( const wxString& name : names )
+            add_name( name );
+    }
+
+    size_t next_name = 0;
+    size_t next_subgraph = 0;
+
+    while( next_name < name_list.size() || next_subgraph < search_list.size() )
+    {
+        for( ; next_name < name_list.size(); next_name++ )
+        {
+            auto it = name_to_subgraphs.find( name_list[next_name] );
+
+            if( it == name_to_subgraphs.end() )
+                continue;
+
+            for( CONNECTION_SUBGRAPH* subgraph : it->second )
+                add_subgraph( subgraph );
+        }
+
+        for( ; next_subgraph < search_list.size(); next_subgraph++ )
+        {
+            CONNECTION_SUBGRAPH* subgraph = search_list[next_subgraph];
+            auto names = subgraph_names.find( subgraph );
+
+            if( names != subgraph_names.end() )
+            {
+                for( const wxString& name : names->second )
+                    add_name( name );
+            }
+
+            for( const auto& kv : subgraph->m_bus_neighbors )
+            {
+                for( CONNECTION_SUBGRAPH* neighbor : kv.second )
+                    add_subgraph( neighbor );
+            }
+
+            for( const auto& kv : subgraph->m_bus_parents )
+            {
+                for( CONNECTION_SUBGRAPH* parent : kv.second )
+                    add_subgraph( parent );
+            }
+
+            // Children connected by the sheet pins
+            for( SCH_SHEET_PIN* pin : subgraph->m_hier_pins )
+            {
+                SCH_SHEET_PATH path = subgraph->m_sheet;
+                path.push_back( pin->GetParent() );
+
+                auto children = m_sheet_to_subgraphs_map.find( path );
+
+                if( children == m_sheet_to_subgraphs_map.end() )
+                    continue;
+
+                for( CONNECTION_SUBGRAPH* child : children->second )
+                {
+                    if( !child->m_hier_ports.empty() )
+                        add_subgraph( child );
+                }
+            }
+
+            // Parents connected by the hierarchical labels
+            if( !subgraph->m_hier_ports.empty() )
+            {
+                SCH_SHEET_PATH path = subgraph->m_sheet;
+                path.pop_back();
+
+                auto parents = m_sheet_to_subgraphs_map.find( path );
+
+                if( parents == m_sheet_to_subgraphs_map.end() )
+                    continue;
+
+                for( CONNECTION_SUBGRAPH* parent : parents->second )
+                {
+                    for( SCH_SHEET_PIN* pin : parent->m_hier_pins )
+                    {
+                        SCH_SHEET_PATH pin_path = path;
+                        pin_path.push_back( pin->GetParent() );
+
+                        if( pin_path == subgraph->m_sheet )
+                        {
+                            add_subgraph( parent );
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return affected;
 }
 
 
@@ -1780,62 +2222,199 @@ std::vector<const CONNECTION_SUBGRAPH*> CONNECTION_GRAPH::GetBusesNeedingMigrati
 }
 
 
-int CONNECTION_GRAPH::RunERC( const ERC_SETTINGS& aSettings, bool aCreateMarkers )
+int CONNECTION_GRAPH::RunERC( const ERC_SETTINGS& aSettings, bool aCreateMarkers,
+                              std::vector<ERC_RULE_STATS>* aStats )
 {
-    int error_count = 0;
+    PROF_COUNTER erc_total;
 
-    for( auto&& subgraph : m_subgraphs )
+    enum ERC_RULE
     {
-        // Graph is supposed to be up-to-date before calling RunERC()
-        wxASSERT( !subgraph->m_dirty );
+        RULE_DRIVER_CONFLICTS,
+        RULE_BUS_TO_NET_CONFLICTS,
+        RULE_BUS_ENTRY_CONFLICTS,
+        RULE_BUS_TO_BUS_CONFLICTS,
+        RULE_NO_CONNECTS,
+        RULE_LABELS,
+        RULE_COUNT
+    };
+
+    static const char* ruleNames[RULE_COUNT] = {
+        "Driver conflicts",
+        "Bus to net conflicts",
+        "Bus entry conflicts",
+        "Bus to bus conflicts",
+        "No connects",
+        "Labels"
+    };
 
-        /**
-         * NOTE:
-         *
-         * We could check that labels attached to bus subgraphs follow the
-         * proper format (i.e. actually define a bus).
-         *
-         * This check doesn't need to be here right now because labels
-         * won't actually be connected to bus wires if they aren't in the right
-         * format due to their TestDanglingEnds() implementation.
-         */
+    // Error counts and time spent (in microseconds) for each rule, one set per thread
+    struct RULE_COUNTERS
+    {
+        std::array<int, RULE_COUNT>     errors {};
+        std::array<int64_t, RULE_COUNT> usecs {};
+    };
 
-        if( aSettings.check_bus_driver_conflicts &&
-            !subgraph->ResolveDrivers( aCreateMarkers ) )
-            error_count++;
+    // The checks of one subgraph only use the subgraph and the caches built by Recalculate(),
+    // so subgraphs can be checked in parallel.  Markers are kept per subgraph and added to the
+    // screens once all threads are done, so the screens get them in the same order as a serial
+    // run would have created them.
+    std::vector<std::vector<SCH_MARKER*>> markers( m_subgraphs.size() );
+    std::atomic<size_t> nextSubgraph( 0 );
 
-        if( aSettings.check_bus_to_net_conflicts &&
-            !ercCheckBusToNetConflicts( subgraph, aCreateMarkers ) )
-            error_count++;
+    size_t parallelThreadCount = std::max<size_t>(
+            std::min<size_t>( std::thread::hardware_concurrency(), m_subgraphs.size() ), 1 );
 
-        if( aSettings.check_bus_entry_conflicts &&
-            !ercCheckBusToBusEntryConflicts( subgraph, aCreateMarkers ) )
-            error_count++;
+    std::vector<RULE_COUNTERS> counters( parallelThreadCount );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
 
-        if( aSettings.check_bus_to_bus_conflicts &&
-            !ercCheckBusToBusConflicts( subgraph, aCreateMarkers ) )
-            error_count++;
+    auto erc_lambda = [&]( RULE_COUNTERS* aCounters ) -> size_t
+    {
+        for( size_t subgraphId = nextSubgraph++; subgraphId < m_subgraphs.size();
+             subgraphId = nextSubgraph++ )
+        {
+            auto subgraph = m_subgraphs[subgraphId];
+            auto subgraphMarkers = aCreateMarkers ? &markers[subgraphId] : nullptr;
+
+            // Graph is supposed to be up-to-date before calling RunERC()
+            wxASSERT( !subgraph->m_dirty );
+
+            /**
+             * NOTE:
+             *
+             * We could check that labels attached to bus subgraphs follow the
+             * proper format (i.e. actually define a bus).
+             *
+             * This check doesn't need to be here right now because labels
+             * won't actually be connected to bus wires if they aren't in the right
+             * format due to their TestDanglingEnds() implementation.
+             */
+
+            auto runRule = [&]( ERC_RULE aRule, auto aCheck )
+            {
+                PROF_COUNTER timer;
 
-        // The following checks are always performed since they don't currently
-        // have an option exposed to the user
+                if( !aCheck() )
+                    aCounters->errors[aRule]++;
 
-        if( !ercCheckNoConnects( subgraph, aCreateMarkers ) )
-            error_count++;
+                aCounters->usecs[aRule] += timer.SinceStart<std::chrono::microseconds>().count();
+            };
 
-        if( !ercCheckLabels( subgraph, aCreateMarkers, aSettings.check_unique_global_labels ) )
-            error_count++;
+            if( aSettings.check_bus_driver_conflicts )
+                runRule( RULE_DRIVER_CONFLICTS, [&]() {
+                    return subgraph->ResolveDrivers( subgraphMarkers );
+                } );
+
+            if( aSettings.check_bus_to_net_conflicts )
+                runRule( RULE_BUS_TO_NET_CONFLICTS, [&]() {
+                    return ercCheckBusToNetConflicts( subgraph, subgraphMarkers );
+                } );
+
+            if( aSettings.check_bus_entry_conflicts )
+                runRule( RULE_BUS_ENTRY_CONFLICTS, [&]() {
+                    return ercCheckBusToBusEntryConflicts( subgraph, subgraphMarkers );
+                } );
+
+            if( aSettings.check_bus_to_bus_conflicts )
+                runRule( RULE_BUS_TO_BUS_CONFLICTS, [&]() {
+                    return ercCheckBusToBusConflicts( subgraph, subgraphMarkers );
+                } );
+
+            // The following checks are always performed since they don't currently
+            // have an option exposed to the user
+
+            runRule( RULE_NO_CONNECTS, [&]() {
+                return ercCheckNoConnects( subgraph, subgraphMarkers );
+            } );
+
+            runRule( RULE_LABELS, [&]() {
+                return ercCheckLabels( subgraph, subgraphMarkers,
+                                       aSettings.check_unique_global_labels );
+            } );
+        }
+
+        return 1;
+    };
+
+    if( parallelThreadCount == 1 )
+        erc_lambda( &counters[0] );
+    else
+    {
+        // The marker messages give the references of the components.  SCH_COMPONENT::GetRef()
+        // stores the reference of a sheet path it does not know yet, so it is called here
+        // once for each pin, and only reads the stored references from the threads.
+        if( aCreateMarkers )
+        {
+            for( CONNECTION_SUBGRAPH* subgraph : m_subgraphs )
+            {
+                for( SCH_ITEM* item : subgraph->m_items )
+                {
+                    if( item->Type() == SCH_PIN_T )
+                    {
+                        SCH_PIN* pin = static_cast<SCH_PIN*>( item );
+                        pin->GetParentComponent()->GetRef( &subgraph->m_sheet );
+                    }
+                }
+            }
+        }
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, erc_lambda, &counters[ii] );
+
+        // Finalize the threads
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii].wait();
+    }
+
+    // Time stamps are given here since GetNewTimeStamp() is not thread safe
+    for( size_t ii = 0; ii < m_subgraphs.size(); ++ii )
+    {
+        SCH_SCREEN* screen = m_subgraphs[ii]->m_sheet.LastScreen();
+
+        for( auto marker : markers[ii] )
+        {
+            marker->SetTimeStamp( GetNewTimeStamp() );
+            screen->Append( marker );
+        }
+    }
+
+    int error_count = 0;
+
+    if( aStats )
+        aStats->clear();
+
+    for( int rule = 0; rule < RULE_COUNT; ++rule )
+    {
+        ERC_RULE_STATS stats;
+        stats.m_name = ruleNames[rule];
+        stats.m_error_count = 0;
+        stats.m_msecs = 0.0;
+
+        for( const auto& threadCounters : counters )
+        {
+            stats.m_error_count += threadCounters.errors[rule];
+            stats.m_msecs += threadCounters.usecs[rule] / 1000.0;
+        }
+
+        error_count += stats.m_error_count;
+
+        wxLogTrace( "CONN_PROFILE", "RunERC() %s: %d errors, %0.4f ms (summed over threads)",
+                    stats.m_name, stats.m_error_count, stats.m_msecs );
+
+        if( aStats )
+            aStats->push_back( stats );
     }
 
+    wxLogTrace( "CONN_PROFILE", "RunERC() %lu subgraphs checked with %lu threads in %0.4f ms",
+                m_subgraphs.size(), parallelThreadCount, erc_total.msecs() );
+
     return error_count;
 }
 
 
 bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
-                                                  bool aCreateMarkers )
+                                                  std::vector<SCH_MARKER*>* aMarkers )
 {
     wxString msg;
-    auto sheet = aSubgraph->m_sheet;
-    auto screen = sheet.LastScreen();
 
     SCH_ITEM* net_item = nullptr;
     SCH_ITEM* bus_item = nullptr;
@@ -1875,23 +2454,22 @@ bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSu
 
     if( net_item && bus_item )
     {
-        if( aCreateMarkers )
+        if( aMarkers )
         {
             msg.Printf( _( "%s and %s are graphically connected but cannot"
                            " electrically connect because one is a bus and"
                            " the other is a net." ),
-                        bus_item->GetSelectMenuText( m_frame->GetUserUnits() ),
-                        net_item->GetSelectMenuText( m_frame->GetUserUnits() ) );
+                        bus_item->GetSelectMenuText( getUserUnits( m_frame ) ),
+                        net_item->GetSelectMenuText( getUserUnits( m_frame ) ) );
 
             auto marker = new SCH_MARKER();
-            marker->SetTimeStamp( GetNewTimeStamp() );
             marker->SetMarkerType( MARKER_BASE::MARKER_ERC );
             marker->SetErrorLevel( MARKER_BASE::MARKER_SEVERITY_ERROR );
             marker->SetData( ERCE_BUS_TO_NET_CONFLICT,
                              net_item->GetPosition(), msg,
                              bus_item->GetPosition() );
 
-            screen->Append( marker );
+            aMarkers->push_back( marker );
         }
 
         return false;
@@ -1902,11 +2480,10 @@ bool CONNECTION_GRAPH::ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSu
 
 
 bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
-                                                  bool aCreateMarkers )
+                                                  std::vector<SCH_MARKER*>* aMarkers )
 {
     wxString msg;
     auto sheet = aSubgraph->m_sheet;
-    auto screen = sheet.LastScreen();
 
     SCH_ITEM* label = nullptr;
     SCH_ITEM* port = nullptr;
@@ -1957,22 +2534,21 @@ bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSu
 
         if( !match )
         {
-            if( aCreateMarkers )
+            if( aMarkers )
             {
                 msg.Printf( _( "%s and %s are graphically connected but do "
                                "not share any bus members" ),
-                            label->GetSelectMenuText( m_frame->GetUserUnits() ),
-                            port->GetSelectMenuText( m_frame->GetUserUnits() ) );
+                            label->GetSelectMenuText( getUserUnits( m_frame ) ),
+                            port->GetSelectMenuText( getUserUnits( m_frame ) ) );
 
                 auto marker = new SCH_MARKER();
-                marker->SetTimeStamp( GetNewTimeStamp() );
                 marker->SetMarkerType( MARKER_BASE::MARKER_ERC );
                 marker->SetErrorLevel( MARKER_BASE::MARKER_SEVERITY_ERROR );
                 marker->SetData( ERCE_BUS_TO_BUS_CONFLICT,
                                  label->GetPosition(), msg,
                                  port->GetPosition() );
 
-                screen->Append( marker );
+                aMarkers->push_back( marker );
             }
 
             return false;
@@ -1984,12 +2560,11 @@ bool CONNECTION_GRAPH::ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSu
 
 
 bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
-                                                       bool aCreateMarkers )
+                                                       std::vector<SCH_MARKER*>* aMarkers )
 {
     wxString msg;
     bool conflict = false;
     auto sheet = aSubgraph->m_sheet;
-    auto screen = sheet.LastScreen();
 
     SCH_BUS_WIRE_ENTRY* bus_entry = nullptr;
     SCH_ITEM* bus_wire = nullptr;
@@ -2034,23 +2609,22 @@ bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH
 
     if( conflict )
     {
-        if( aCreateMarkers )
+        if( aMarkers )
         {
             msg.Printf( _( "%s (%s) is connected to %s (%s) but is not a member of the bus" ),
-                        bus_entry->GetSelectMenuText( m_frame->GetUserUnits() ),
+                        bus_entry->GetSelectMenuText( getUserUnits( m_frame ) ),
                         bus_entry->Connection( sheet )->Name( true ),
-                        bus_wire->GetSelectMenuText( m_frame->GetUserUnits() ),
+                        bus_wire->GetSelectMenuText( getUserUnits( m_frame ) ),
                         bus_wire->Connection( sheet )->Name( true ) );
 
             auto marker = new SCH_MARKER();
-            marker->SetTimeStamp( GetNewTimeStamp() );
             marker->SetMarkerType( MARKER_BASE::MARKER_ERC );
             marker->SetErrorLevel( MARKER_BASE::MARKER_SEVERITY_WARNING );
             marker->SetData( ERCE_BUS_ENTRY_CONFLICT,
                              bus_entry->GetPosition(), msg,
                              bus_entry->GetPosition() );
 
-            screen->Append( marker );
+            aMarkers->push_back( marker );
         }
 
         return false;
@@ -2062,11 +2636,10 @@ bool CONNECTION_GRAPH::ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH
 
 // TODO(JE) Check sheet pins here too?
 bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
-                                           bool aCreateMarkers )
+                                           std::vector<SCH_MARKER*>* aMarkers )
 {
     wxString msg;
     auto sheet = aSubgraph->m_sheet;
-    auto screen = sheet.LastScreen();
 
     if( aSubgraph->m_no_connect != nullptr )
     {
@@ -2101,7 +2674,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
 
         if( pin && has_invalid_items )
         {
-            if( aCreateMarkers )
+            if( aMarkers )
             {
                 wxPoint pos = pin->GetTransformedPosition();
 
@@ -2110,12 +2683,11 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
                             pin->GetParentComponent()->GetRef( &aSubgraph->m_sheet ) );
 
                 auto marker = new SCH_MARKER();
-                marker->SetTimeStamp( GetNewTimeStamp() );
                 marker->SetMarkerType( MARKER_BASE::MARKER_ERC );
                 marker->SetErrorLevel( MARKER_BASE::MARKER_SEVERITY_WARNING );
                 marker->SetData( ERCE_NOCONNECT_CONNECTED, pos, msg, pos );
 
-                screen->Append( marker );
+                aMarkers->push_back( marker );
             }
 
             return false;
@@ -2123,19 +2695,18 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
 
         if( !has_other_items )
         {
-            if( aCreateMarkers )
+            if( aMarkers )
             {
                 wxPoint pos = aSubgraph->m_no_connect->GetPosition();
 
                 msg.Printf( _( "No-connect marker is not connected to anything" ) );
 
                 auto marker = new SCH_MARKER();
-                marker->SetTimeStamp( GetNewTimeStamp() );
                 marker->SetMarkerType( MARKER_BASE::MARKER_ERC );
                 marker->SetErrorLevel( MARKER_BASE::MARKER_SEVERITY_WARNING );
                 marker->SetData( ERCE_NOCONNECT_NOT_CONNECTED, pos, msg, pos );
 
-                screen->Append( marker );
+                aMarkers->push_back( marker );
             }
 
             return false;
@@ -2187,7 +2758,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
 
         if( pin && !has_other_connections && pin->GetType() != PIN_NC )
         {
-            if( aCreateMarkers )
+            if( aMarkers )
             {
                 wxPoint pos = pin->GetTransformedPosition();
 
@@ -2196,12 +2767,11 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
                             pin->GetParentComponent()->GetRef( &aSubgraph->m_sheet ) );
 
                 auto marker = new SCH_MARKER();
-                marker->SetTimeStamp( GetNewTimeStamp() );
                 marker->SetMarkerType( MARKER_BASE::MARKER_ERC );
                 marker->SetErrorLevel( MARKER_BASE::MARKER_SEVERITY_WARNING );
                 marker->SetData( ERCE_PIN_NOT_CONNECTED, pos, msg, pos );
 
-                screen->Append( marker );
+                aMarkers->push_back( marker );
             }
 
             return false;
@@ -2213,7 +2783,7 @@ bool CONNECTION_GRAPH::ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
 
 
 bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph,
-                                       bool aCreateMarkers, bool aCheckGlobalLabels )
+                                       std::vector<SCH_MARKER*>* aMarkers, bool aCheckGlobalLabels )
 {
     // Label connection rules:
     // Local labels are flagged if they don't connect to any pins and don't have a no-connect
@@ -2279,9 +2849,8 @@ bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph,
 
     if( !has_other_connections )
     {
-        if( aCreateMarkers )
+        if( aMarkers )
         {
-            SCH_SCREEN* screen = aSubgraph->m_sheet.LastScreen();
             wxPoint pos = text->GetPosition();
             auto marker = new SCH_MARKER();
 
@@ -2292,12 +2861,11 @@ bool CONNECTION_GRAPH::ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph,
             msg.Printf( _( "%s %s is not connected anywhere else in the schematic." ),
                         prefix, GetChars( text->ShortenedShownText() ) );
 
-            marker->SetTimeStamp( GetNewTimeStamp() );
             marker->SetMarkerType( MARKER_BASE::MARKER_ERC );
             marker->SetErrorLevel( MARKER_BASE::MARKER_SEVERITY_WARNING );
             marker->SetData( type, pos, msg, pos );
 
-            screen->Append( marker );
+            aMarkers->push_back( marker );
         }
 
         return false;
@@ -21,7 +21,9 @@
 #ifndef _CONNECTION_GRAPH_H
 #define _CONNECTION_GRAPH_H
 
+#include <map>
 #include <mutex>
+#include <tuple>
 #include <vector>
 
 #include <common.h>
@@ -38,7 +40,9 @@
 
 class SCH_EDIT_FRAME;
 class SCH_HIERLABEL;
+class SCH_MARKER;
 class SCH_PIN;
+class SCH_SCREEN;
 class SCH_SHEET_PIN;
 
 
@@ -80,10 +84,10 @@ public:
      * If multiple possible drivers exist, picks one according to the priority.
      * If multiple "winners" exist, returns false and sets m_driver to nullptr.
      *
-     * @param aCreateMarkers controls whether ERC markers should be added for conflicts
+     * @param aMarkers if not null, receives the ERC markers created for conflicts
      * @return true if m_driver was set, or false if a conflict occurred
      */
-    bool ResolveDrivers( bool aCreateMarkers = false );
+    bool ResolveDrivers( std::vector<SCH_MARKER*>* aMarkers = nullptr );
 
     /**
      * Returns the fully-qualified net name for this subgraph (if one exists)
@@ -191,13 +195,32 @@ public:
 };
 
 
+/**
+ * Result of one of the connectivity ERC rules, summed over all the subgraphs
+ */
+struct ERC_RULE_STATS
+{
+    wxString m_name;
+
+    int m_error_count;
+
+    /// Time spent in the rule, summed over all the threads
+    double m_msecs;
+};
+
+
 /**
  * Calculates the connectivity of a schematic and generates netlists
  */
 class CONNECTION_GRAPH
 {
 public:
+    /**
+     * @param aFrame is the schematic editor, only used for the units of the ERC messages.
+     *               It can be null to use the graph without a GUI, e.g. in the qa tools.
+     */
     CONNECTION_GRAPH( SCH_EDIT_FRAME* aFrame) :
+        m_verify_incremental( false ),
         m_frame( aFrame )
     {}
 
@@ -206,11 +229,28 @@ public:
     /**
      * Updates the connection graph for the given list of sheets.
      *
-     * @param aSheetList is the list of possibly modified sheets
+     * Unless aUnconditional is set, the graphical connectivity of the items is only updated
+     * on the sheets that changed since the last recalculation (new sheets, sheets with dirty
+     * items, or with added, removed or moved items).  The other sheets keep their item
+     * connectivity and only have their connections reset.  The subgraphs are then rebuilt
+     * from the item connectivity, but the net names are only propagated through the
+     * hierarchy for the subgraphs reachable from the changed sheets (by hierarchical pins,
+     * bus members or net names).  The other subgraphs get their previous net names back.
+     *
+     * @param aSheetList is the list of all the sheets of the hierarchy
      * @param aUnconditional is true if an unconditional full recalculation should be done
      */
     void Recalculate( SCH_SHEET_LIST aSheetList, bool aUnconditional = false );
 
+    /**
+     * Enables the verification of incremental recalculations.
+     *
+     * When enabled, each incremental Recalculate() is followed by a full recalculation, and
+     * any difference between the net names found by both is reported (trace "CONN").
+     * The full recalculation result is kept.  This is a debugging aid, and is slow.
+     */
+    void SetVerifyIncremental( bool aVerify ) { m_verify_incremental = aVerify; }
+
     /**
      * Returns a bus alias pointer for the given name if it exists (from cache)
      *
@@ -233,11 +273,17 @@ public:
      *
      * Precondition: graph is up-to-date
      *
+     * Subgraphs are checked in parallel; the markers are added to the screens
+     * afterwards, in the same order as a serial run would add them.
+     *
      * @param aSettings is used to control which tests to run
      * @param aCreateMarkers controls whether error markers are created
+     * @param aStats if not null, receives the error count and time spent for each rule
+     *               (reported by the sch_erc tool of qa_eeschema_tools)
      * @return the number of errors found
      */
-    int RunERC( const ERC_SETTINGS& aSettings, bool aCreateMarkers = true );
+    int RunERC( const ERC_SETTINGS& aSettings, bool aCreateMarkers = true,
+                std::vector<ERC_RULE_STATS>* aStats = nullptr );
 
     // TODO(JE) Remove this when pressure valve is removed
     static bool m_allowRealTime;
@@ -283,9 +329,61 @@ private:
 
     std::mutex m_item_mutex;
 
+    /**
+     * A connection point of a connectable item or of a sheet pin, or of a component pin.
+     * Component pins are rebuilt by SCH_COMPONENT::UpdatePins(), so they are given by their
+     * component and pin number rather than by their address.
+     */
+    typedef std::tuple<SCH_ITEM*, wxString, wxPoint> CONNECTION_POINT;
+
+    /// Connection points of each sheet at the last recalculation, to find unchanged sheets
+    std::unordered_map<SCH_SHEET_PATH, std::vector<CONNECTION_POINT>> m_sheet_connection_points;
+
+    /// Net names of a driven subgraph at the last recalculation
+    struct SUBGRAPH_NAMES
+    {
+        /// Name after the processing on its own sheet, before the hierarchical propagation
+        wxString m_local_name;
+
+        /// Final driver connection, after the propagation.  A deep copy: it shares no bus
+        /// member with the connections of the items.
+        std::shared_ptr<SCH_CONNECTION> m_connection;
+    };
+
+    /// Names of the driven subgraphs at the last recalculation, by driver and sheet path
+    std::map<std::pair<SCH_ITEM*, wxString>, SUBGRAPH_NAMES> m_subgraph_names;
+
+    bool m_verify_incremental;
+
     // Needed for m_userUnits for now; maybe refactor later
     SCH_EDIT_FRAME* m_frame;
 
+    /**
+     * Resets the connections of the items of aItemList (and of their pins) for aSheet, and
+     * loads them into m_items, without changing their graphical connectivity.
+     *
+     * This is the first phase of updateItemConnectivity(), and is used alone on the sheets
+     * that have not changed since the last recalculation.
+     *
+     * @param aSheet is the path to the sheet of all items in the list
+     * @param aItemList is a list of items to consider
+     */
+    void resetItemConnections( const SCH_SHEET_PATH& aSheet,
+                               const std::vector<SCH_ITEM*>& aItemList );
+
+    /**
+     * Collects the connection points of aItemList, including component and sheet pins,
+     * in a form that can be compared between two recalculations.
+     */
+    static std::vector<CONNECTION_POINT> getConnectionPoints(
+            const std::vector<SCH_ITEM*>& aItemList );
+
+    /**
+     * Returns the connection name of each item of the graph, by item and sheet path.
+     * Used to compare an incremental recalculation with a full one.
+     */
+    std::map<std::pair<SCH_ITEM*, wxString>, wxString> getConnectionNames() const;
+
     /**
      * Updates the graphical connectivity between items (i.e. where they touch)
      * The items passed in must be on the same sheet.
@@ -328,8 +426,31 @@ private:
      * the driver is first selected by CONNECTION_SUBGRAPH::ResolveDrivers(),
      * and then the connection for the chosen driver is propagated to all the
      * other items in the subgraph.
+     *
+     * In the last phase, the net names are propagated through the hierarchy.
+     *
+     * @param aDirtyScreens if not null, are the screens changed since the last recalculation.
+     *                      Only the subgraphs reachable from them are propagated again, the
+     *                      other ones get their names from the last recalculation.
+     */
+    void buildConnectionGraph( const std::unordered_set<SCH_SCREEN*>* aDirtyScreens = nullptr );
+
+    /**
+     * Finds the driven subgraphs whose net names may differ from the last recalculation.
+     *
+     * These are the subgraphs on the dirty screens (or holding a pin of them), the new
+     * subgraphs and the ones whose local name changed, and then everything reachable from
+     * them: subgraphs linked by hierarchical pins and ports, bus neighbors and parents, and
+     * subgraphs sharing a net name (old or new, including the names of secondary drivers
+     * and bus members) with them or with a removed subgraph.
+     *
+     * @param aSeeds are subgraphs known to be affected, in addition to the ones found here
+     * @param aLocalNames is the name of each driven subgraph before the propagation
      */
-    void buildConnectionGraph();
+    std::unordered_set<CONNECTION_SUBGRAPH*> findAffectedSubgraphs(
+            const std::unordered_set<SCH_SCREEN*>& aDirtyScreens,
+            const std::unordered_set<CONNECTION_SUBGRAPH*>& aSeeds,
+            const std::unordered_map<CONNECTION_SUBGRAPH*, wxString>& aLocalNames ) const;
 
     /**
      * Helper to assign a new net code to a connection
@@ -373,11 +494,11 @@ private:
      * For example, a net wire connected to a bus port/pin, or vice versa
      *
      * @param  aSubgraph      is the subgraph to examine
-     * @param  aCreateMarkers controls whether error markers are created
+     * @param  aMarkers       if not null, receives the error markers
      * @return                true for no errors, false for errors
      */
     bool ercCheckBusToNetConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
-                                    bool aCreateMarkers );
+                                    std::vector<SCH_MARKER*>* aMarkers );
 
     /**
      * Checks one subgraph for conflicting connections between two bus items
@@ -387,11 +508,11 @@ private:
      * sheet pin
      *
      * @param  aSubgraph      is the subgraph to examine
-     * @param  aCreateMarkers controls whether error markers are created
+     * @param  aMarkers       if not null, receives the error markers
      * @return                true for no errors, false for errors
      */
     bool ercCheckBusToBusConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
-                                    bool aCreateMarkers );
+                                    std::vector<SCH_MARKER*>* aMarkers );
 
     /**
      * Checks one subgraph for conflicting bus entry to bus connections
@@ -403,11 +524,11 @@ private:
      * "USB.DP" but someone might accidentally just enter "DP"
      *
      * @param  aSubgraph      is the subgraph to examine
-     * @param  aCreateMarkers controls whether error markers are created
+     * @param  aMarkers       if not null, receives the error markers
      * @return                true for no errors, false for errors
      */
     bool ercCheckBusToBusEntryConflicts( const CONNECTION_SUBGRAPH* aSubgraph,
-                                         bool aCreateMarkers );
+                                         std::vector<SCH_MARKER*>* aMarkers );
 
     /**
      * Checks one subgraph for proper presence or absence of no-connect symbols
@@ -416,11 +537,11 @@ private:
      * A pin without a no-connect symbol should have at least one connection
      *
      * @param  aSubgraph      is the subgraph to examine
-     * @param  aCreateMarkers controls whether error markers are created
+     * @param  aMarkers       if not null, receives the error markers
      * @return                true for no errors, false for errors
      */
     bool ercCheckNoConnects( const CONNECTION_SUBGRAPH* aSubgraph,
-                             bool aCreateMarkers );
+                             std::vector<SCH_MARKER*>* aMarkers );
 
     /**
      * Checks one subgraph for proper connection of labels
@@ -428,12 +549,12 @@ private:
      * Labels should be connected to something
      *
      * @param  aSubgraph      is the subgraph to examine
-     * @param  aCreateMarkers controls whether error markers are created
+     * @param  aMarkers       if not null, receives the error markers
      * @param  aCheckGlobalLabels is true if global labels should be checked for loneliness
      * @return                true for no errors, false for errors
      */
-    bool ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph, bool aCreateMarkers,
-                         bool aCheckGlobalLabels );
+    bool ercCheckLabels( const CONNECTION_SUBGRAPH* aSubgraph,
+                         std::vector<SCH_MARKER*>* aMarkers, bool aCheckGlobalLabels );
 
 };
 
@@ -63,6 +63,7 @@ DIALOG_CHOOSE_COMPONENT::DIALOG_CHOOSE_COMPONENT( SCH_BASE_FRAME* aParent, const
           m_fp_sel_ctrl( nullptr ),
           m_fp_preview( nullptr ),
           m_tree( nullptr ),
+          m_adapter( aAdapter ),
           m_details( nullptr ),
           m_parent( aParent ),
           m_deMorganConvert( aDeMorganConvert >= 0 ? aDeMorganConvert : 0 ),
@@ -122,6 +123,7 @@ DIALOG_CHOOSE_COMPONENT::DIALOG_CHOOSE_COMPONENT( SCH_BASE_FRAME* aParent, const
     m_hsplitter->SplitVertically( m_tree,  ConstructRightPanel( m_hsplitter ) );
 
     m_dbl_click_timer = new wxTimer( this );
+    m_preload_timer = new wxTimer( this );
 
     auto buttonsSizer = new wxBoxSizer( wxHORIZONTAL );
 
@@ -161,6 +163,7 @@ DIALOG_CHOOSE_COMPONENT::DIALOG_CHOOSE_COMPONENT( SCH_BASE_FRAME* aParent, const
 
     Bind( wxEVT_INIT_DIALOG, &DIALOG_CHOOSE_COMPONENT::OnInitDialog, this );
     Bind( wxEVT_TIMER, &DIALOG_CHOOSE_COMPONENT::OnCloseTimer, this, m_dbl_click_timer->GetId() );
+    Bind( wxEVT_TIMER, &DIALOG_CHOOSE_COMPONENT::OnPreloadTimer, this, m_preload_timer->GetId() );
     Bind( COMPONENT_PRESELECTED, &DIALOG_CHOOSE_COMPONENT::OnComponentPreselected, this );
     Bind( COMPONENT_SELECTED, &DIALOG_CHOOSE_COMPONENT::OnComponentSelected, this );
 
@@ -176,6 +179,10 @@ DIALOG_CHOOSE_COMPONENT::DIALOG_CHOOSE_COMPONENT( SCH_BASE_FRAME* aParent, const
         m_details->Connect( wxEVT_CHAR_HOOK,
                             wxKeyEventHandler( DIALOG_CHOOSE_COMPONENT::OnCharHook ),
                                                NULL, this );
+
+    // The libraries still being loaded in the background are added to the tree when ready.
+    if( static_cast<SYMBOL_TREE_MODEL_ADAPTER*>( m_adapter.get() )->HasPendingLibraries() )
+        m_preload_timer->Start( PreloadPollDelay );
 }
 
 
@@ -183,6 +190,8 @@ DIALOG_CHOOSE_COMPONENT::~DIALOG_CHOOSE_COMPONENT()
 {
     Unbind( wxEVT_INIT_DIALOG, &DIALOG_CHOOSE_COMPONENT::OnInitDialog, this );
     Unbind( wxEVT_TIMER, &DIALOG_CHOOSE_COMPONENT::OnCloseTimer, this );
+    Unbind( wxEVT_TIMER, &DIALOG_CHOOSE_COMPONENT::OnPreloadTimer, this,
+            m_preload_timer->GetId() );
     Unbind( COMPONENT_PRESELECTED, &DIALOG_CHOOSE_COMPONENT::OnComponentPreselected, this );
     Unbind( COMPONENT_SELECTED, &DIALOG_CHOOSE_COMPONENT::OnComponentSelected, this );
 
@@ -202,6 +211,8 @@ DIALOG_CHOOSE_COMPONENT::~DIALOG_CHOOSE_COMPONENT()
     // I am not sure the following two lines are necessary, but they will not hurt anyone
     m_dbl_click_timer->Stop();
     delete m_dbl_click_timer;
+    m_preload_timer->Stop();
+    delete m_preload_timer;
 
     m_config->Write( SYM_CHOOSER_WIDTH_KEY, GetSize().x );
     m_config->Write( SYM_CHOOSER_HEIGHT_KEY, GetSize().y );
@@ -322,6 +333,18 @@ void DIALOG_CHOOSE_COMPONENT::OnCloseTimer( wxTimerEvent& aEvent )
 }
 
 
+void DIALOG_CHOOSE_COMPONENT::OnPreloadTimer( wxTimerEvent& aEvent )
+{
+    auto adapter = static_cast<SYMBOL_TREE_MODEL_ADAPTER*>( m_adapter.get() );
+
+    if( adapter->AddPreloadedLibraries() )
+        m_tree->Regenerate( true );
+
+    if( !adapter->HasPendingLibraries() )
+        m_preload_timer->Stop();
+}
+
+
 void DIALOG_CHOOSE_COMPONENT::ShowFootprintFor( LIB_ID const& aLibId )
 {
     if( !m_fp_preview || !m_fp_preview->IsInitialized() )
@@ -145,12 +145,19 @@ public:
 
 protected:
     static constexpr int DblClickDelay = 100; // milliseconds
+    static constexpr int PreloadPollDelay = 250; // milliseconds
 
     wxPanel* ConstructRightPanel( wxWindow* aParent );
 
     void OnInitDialog( wxInitDialogEvent& aEvent );
     void OnCharHook( wxKeyEvent& aEvt );
     void OnCloseTimer( wxTimerEvent& aEvent );
+
+    /**
+     * Add to the tree the libraries whose background preload has finished since the
+     * dialog was opened.
+     */
+    void OnPreloadTimer( wxTimerEvent& aEvent );
     void OnUseBrowser( wxCommandEvent& aEvent );
 
     void OnFootprintSelected( wxCommandEvent& aEvent );
@@ -184,6 +191,7 @@ protected:
     wxConfigBase*             m_config;
 
     wxTimer*                  m_dbl_click_timer;
+    wxTimer*                  m_preload_timer;
     SYMBOL_PREVIEW_WIDGET*    m_symbol_preview;
     wxButton*                 m_browser_button;
     wxSplitterWindow*         m_hsplitter;
@@ -192,6 +200,7 @@ protected:
     FOOTPRINT_SELECT_WIDGET*  m_fp_sel_ctrl;
     FOOTPRINT_PREVIEW_WIDGET* m_fp_preview;
     LIB_TREE*                 m_tree;
+    SYMBOL_TREE_MODEL_ADAPTER::PTR m_adapter;
     wxHtmlWindow*             m_details;
 
     SCH_BASE_FRAME*           m_parent;
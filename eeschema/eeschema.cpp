@@ -38,6 +38,7 @@
 #include <transform.h>
 #include <wildcards_and_files_ext.h>
 #include <symbol_lib_table.h>
+#include <sch_legacy_plugin.h>
 #include <dialogs/dialog_global_sym_lib_table_config.h>
 #include <dialogs/panel_sym_lib_table.h>
 #include <kiway.h>
@@ -288,6 +289,10 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
 
 void IFACE::OnKifaceEnd()
 {
+    // The preloader workers must be joined while wx is still there, not by a static
+    // destructor.
+    SCH_LEGACY_PLUGIN::CancelSymbolLibPreloads();
+
     wxConfigSaveSetups( KifaceSettings(), cfg_params() );
     end_common();
 }
@@ -267,9 +267,15 @@ bool SCH_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
 
     LoadProjectFile();
 
+    // Drop the libraries preloaded for the previous project before loading the new table.
+    SCH_LEGACY_PLUGIN::CancelSymbolLibPreloads();
+
     // Load the symbol library table, this will be used forever more.
     Prj().SetElem( PROJECT::ELEM_SYMBOL_LIB_TABLE, NULL );
-    Prj().SchSymbolLibTable();
+
+    // Parse the libraries in the background while the schematic is loaded, so the symbol
+    // chooser does not have to when it is first opened.
+    Prj().SchSymbolLibTable()->PreloadSymbolLibs();
 
     if( is_new )
     {
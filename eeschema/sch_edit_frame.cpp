@@ -39,6 +39,7 @@
 #include <class_library.h>
 #include <sch_edit_frame.h>
 #include <symbol_lib_table.h>
+#include <sch_legacy_plugin.h>
 #include <reporter.h>
 #include <lib_edit_frame.h>
 #include <viewlib_frame.h>
@@ -231,6 +232,8 @@ SCH_EDIT_FRAME::SCH_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ):
 {
     g_CurrentSheet = new SCH_SHEET_PATH();
     g_ConnectionGraph = new CONNECTION_GRAPH( this );
+    g_ConnectionGraph->SetVerifyIncremental(
+            ADVANCED_CFG::GetCfg().m_verifyIncrementalConnectivity );
 
     m_showBorderAndTitleBlock = true;   // true to show sheet references
     m_DefaultSchematicFileName = NAMELESS_PROJECT;
@@ -571,6 +574,9 @@ void SCH_EDIT_FRAME::OnCloseWindow( wxCloseEvent& aEvent )
     // all sub sheets are deleted, only the main sheet is usable
     g_CurrentSheet->clear();
 
+    // The libraries preloaded for this project are not needed anymore.
+    SCH_LEGACY_PLUGIN::CancelSymbolLibPreloads();
+
     Destroy();
 }
 
@@ -1072,7 +1078,9 @@ void SCH_EDIT_FRAME::RecalculateConnections( bool aDoCleanup )
     timer.Stop();
     wxLogTrace( "CONN_PROFILE", "SchematicCleanUp() %0.4f ms", timer.msecs() );
 
-    g_ConnectionGraph->Recalculate( list, true );
+    // Only the sheets changed since the last recalculation need their item connectivity
+    // updated.  Loading a new schematic resets the graph, so the first pass is a full one.
+    g_ConnectionGraph->Recalculate( list, false );
 }
 
 
@@ -357,9 +357,11 @@ public:
      *
      * @param aPoint Test this point for an intersection.
      * @param aScreen is the screen to examine, or nullptr to examine the current screen
+     * @param aChangedArea if not null, is merged with the bounding boxes of the broken segments.
      * @return True if any wires or buses were broken.
      */
-    bool BreakSegments( const wxPoint& aPoint, SCH_SCREEN* aScreen = nullptr );
+    bool BreakSegments( const wxPoint& aPoint, SCH_SCREEN* aScreen = nullptr,
+                        EDA_RECT* aChangedArea = nullptr );
 
     /**
      * Tests all junctions and bus entries in the schematic for intersections with wires and
@@ -368,9 +370,11 @@ public:
      * NOTE: always appends to the existing undo state.
      *
      * @param aScreen is the screen to examine, or nullptr to examine the current screen
+     * @param aChangedArea if not null, is merged with the bounding boxes of the broken segments.
      * @return True if any wires or buses were broken.
      */
-    bool BreakSegmentsOnJunctions( SCH_SCREEN* aScreen = nullptr );
+    bool BreakSegmentsOnJunctions( SCH_SCREEN* aScreen = nullptr,
+                                   EDA_RECT* aChangedArea = nullptr );
 
     /**
      * Test all of the connectable objects in the schematic for unused connection points.
@@ -378,6 +382,15 @@ public:
      */
     bool TestDanglingEnds();
 
+    /**
+     * Test the connectable objects of the current screen connected to geometry changed inside
+     * \a aChangedArea for unused connection points.
+     *
+     * @param aChangedArea must contain the old and the new position of the changed items.
+     * @return True if any connection state changes were made.
+     */
+    bool TestDanglingEnds( const EDA_RECT& aChangedArea );
+
     /**
      * Send a message to Pcbnew via a socket connection.
      *
@@ -641,9 +654,11 @@ public:
      * NOTE: always appends to the existing undo state.
      *
      * @param aScreen is the screen to examine, or nullptr to examine the current screen
+     * @param aChangedArea if not null, is merged with the bounding boxes of the wires and buses
+     *                     broken, merged or removed, so their dangling ends can be tested again.
      * @return True if any schematic clean up was performed.
      */
-    bool SchematicCleanUp( SCH_SCREEN* aScreen = nullptr );
+    bool SchematicCleanUp( SCH_SCREEN* aScreen = nullptr, EDA_RECT* aChangedArea = nullptr );
 
     /**
      * If any single wire passes through _both points_, remove the portion between the two points,
@@ -311,6 +311,45 @@ public:
                                      const wxString&   aLibraryPath,
                                      const PROPERTIES* aProperties = NULL );
 
+    /**
+     * Start loading the library \a aLibraryPath in the background, so a later call to
+     * #EnumerateSymbolLib() or #LoadSymbol() does not have to parse it.
+     *
+     * This is only a hint: it returns immediately and does nothing in plugins without
+     * a library cache.  Errors are not reported here but by the next call loading the
+     * library.
+     *
+     * @param aLibraryPath is a locator for the "library", usually a directory, file,
+     *                     or URL containing one or more #LIB_PART objects.
+     *
+     * @param aProperties is an associative array that can be used to tell the plugin anything
+     *                    needed about how to perform with respect to \a aLibraryPath.  The
+     *                    caller continues to own this object (plugin may not delete it), and
+     *                    plugins should expect it to be optionally NULL.
+     */
+    virtual void PreloadSymbolLib( const wxString&   aLibraryPath,
+                                   const PROPERTIES* aProperties = NULL );
+
+    /**
+     * Tell if \a aLibraryPath is still being loaded in the background after a call to
+     * #PreloadSymbolLib().
+     *
+     * This does not wait for the library, so a caller can use the libraries already loaded
+     * first and come back for the others later.
+     *
+     * @param aLibraryPath is a locator for the "library", usually a directory, file,
+     *                     or URL containing one or more #LIB_PART objects.
+     *
+     * @param aProperties is an associative array that can be used to tell the plugin anything
+     *                    needed about how to perform with respect to \a aLibraryPath.  The
+     *                    caller continues to own this object (plugin may not delete it), and
+     *                    plugins should expect it to be optionally NULL.
+     *
+     * @return true if loading \a aLibraryPath now would wait for its preload to finish.
+     */
+    virtual bool IsSymbolLibPreloading( const wxString&   aLibraryPath,
+                                        const PROPERTIES* aProperties = NULL );
+
     /**
      * Load a #LIB_ALIAS object having \a aAliasName from the \a aLibraryPath containing
      * a library format that this #SCH_PLUGIN knows about.  The #LIB_PART should be accessed
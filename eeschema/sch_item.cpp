@@ -36,6 +36,9 @@
 #include <sch_sheet.h>
 #include <sch_pin.h>
 #include <general.h>
+#include <trigo.h>
+
+#include <algorithm>
 
 
 /* Constructor and destructor for SCH_ITEM */
@@ -179,3 +182,144 @@ void SCH_ITEM::Plot( PLOTTER* aPlotter )
 {
     wxFAIL_MSG( wxT( "Plot() method not implemented for class " ) + GetClass() );
 }
+
+
+// Size of the DANGLING_END_INDEX grid cells, in internal units
+#define DANGLING_END_CELL_SIZE 500
+
+// Segments crossing more cells than this are not stored in the grid, but always tested
+#define DANGLING_END_MAX_SEGMENT_CELLS 64
+
+
+DANGLING_END_INDEX::DANGLING_END_INDEX( const std::vector<DANGLING_END_ITEM>& aItemList ) :
+    m_items( aItemList )
+{
+    for( size_t ii = 0; ii < m_items.size(); ++ii )
+    {
+        m_endPoints[ m_items[ii].GetPosition() ].push_back( ii );
+
+        if( !isSegmentStart( ii ) )
+            continue;
+
+        wxPoint start = cellOf( m_items[ii].GetPosition() );
+        wxPoint end = cellOf( m_items[ii + 1].GetPosition() );
+        wxPoint cellMin( std::min( start.x, end.x ), std::min( start.y, end.y ) );
+        wxPoint cellMax( std::max( start.x, end.x ), std::max( start.y, end.y ) );
+
+        long long cellCount = (long long) ( cellMax.x - cellMin.x + 1 )
+                                          * ( cellMax.y - cellMin.y + 1 );
+
+        if( cellCount > DANGLING_END_MAX_SEGMENT_CELLS )
+        {
+            m_largeSegments.push_back( ii );
+            continue;
+        }
+
+        for( int x = cellMin.x; x <= cellMax.x; ++x )
+        {
+            for( int y = cellMin.y; y <= cellMax.y; ++y )
+                m_segments[ wxPoint( x, y ) ].push_back( ii );
+        }
+    }
+}
+
+
+bool DANGLING_END_INDEX::isSegmentStart( size_t aIndex ) const
+{
+    if( aIndex + 1 >= m_items.size() )
+        return false;
+
+    const DANGLING_END_ITEM& start = m_items[aIndex];
+    const DANGLING_END_ITEM& end = m_items[aIndex + 1];
+
+    if( start.GetItem() != end.GetItem() )
+        return false;
+
+    return ( start.GetType() == WIRE_START_END && end.GetType() == WIRE_END_END )
+            || ( start.GetType() == BUS_START_END && end.GetType() == BUS_END_END );
+}
+
+
+wxPoint DANGLING_END_INDEX::cellOf( const wxPoint& aPoint )
+{
+    // Round toward minus infinity, to have the same cell size on both sides of the origin
+    auto floorDiv = []( int aValue ) -> int
+    {
+        int cell = aValue / DANGLING_END_CELL_SIZE;
+
+        if( aValue % DANGLING_END_CELL_SIZE < 0 )
+            cell--;
+
+        return cell;
+    };
+
+    return wxPoint( floorDiv( aPoint.x ), floorDiv( aPoint.y ) );
+}
+
+
+void DANGLING_END_INDEX::Query( const std::vector<wxPoint>& aPoints,
+                                std::vector<DANGLING_END_ITEM>& aCandidates ) const
+{
+    std::vector<size_t> found;
+
+    auto addSegmentsOnPoint = [&]( const std::vector<size_t>& aSegments, const wxPoint& aPoint )
+    {
+        for( size_t start : aSegments )
+        {
+            if( IsPointOnSegment( m_items[start].GetPosition(), m_items[start + 1].GetPosition(),
+                                  aPoint ) )
+            {
+                found.push_back( start );
+                found.push_back( start + 1 );
+            }
+        }
+    };
+
+    for( const wxPoint& point : aPoints )
+    {
+        auto endPoints = m_endPoints.find( point );
+
+        if( endPoints != m_endPoints.end() )
+        {
+            for( size_t ii : endPoints->second )
+            {
+                found.push_back( ii );
+
+                // Keep the wire and bus start/end pairs complete
+                if( isSegmentStart( ii ) )
+                    found.push_back( ii + 1 );
+                else if( ii > 0 && isSegmentStart( ii - 1 ) )
+                    found.push_back( ii - 1 );
+            }
+        }
+
+        auto segments = m_segments.find( cellOf( point ) );
+
+        if( segments != m_segments.end() )
+            addSegmentsOnPoint( segments->second, point );
+
+        addSegmentsOnPoint( m_largeSegments, point );
+    }
+
+    // Restore the order of the indexed list
+    std::sort( found.begin(), found.end() );
+    found.erase( std::unique( found.begin(), found.end() ), found.end() );
+
+    aCandidates.clear();
+    aCandidates.reserve( found.size() );
+
+    for( size_t ii : found )
+        aCandidates.push_back( m_items[ii] );
+}
+
+
+bool DANGLING_END_INDEX::UpdateDanglingState( SCH_ITEM* aItem ) const
+{
+    std::vector<wxPoint>           points;
+    std::vector<DANGLING_END_ITEM> candidates;
+
+    aItem->GetConnectionPoints( points );
+    Query( points, candidates );
+
+    return aItem->UpdateDanglingState( candidates );
+}
@@ -104,6 +104,61 @@ public:
 };
 
 
+/**
+ * Class DANGLING_END_INDEX
+ * is a spatial index (hash grid) of a list of #DANGLING_END_ITEM.
+ *
+ * Testing the dangling state of each item of a sheet against the full end point list is
+ * quadratic in the number of items.  The index gives, for the connection points of an item,
+ * the short list of end points that can be connected to them.  The candidates keep the order
+ * of the indexed list (and wires and buses keep their start/end pairs), so the existing
+ * UpdateDanglingState() implementations give the same result on the candidates as on the
+ * full list.
+ *
+ * The indexed list is not copied: it must outlive the index and must not be modified.
+ */
+class DANGLING_END_INDEX
+{
+public:
+    DANGLING_END_INDEX( const std::vector<DANGLING_END_ITEM>& aItemList );
+
+    /**
+     * Function Query
+     * fills \a aCandidates with the end points located at one of \a aPoints, and with both
+     * ends of the wires and buses going through one of \a aPoints.
+     */
+    void Query( const std::vector<wxPoint>& aPoints,
+                std::vector<DANGLING_END_ITEM>& aCandidates ) const;
+
+    /**
+     * Function UpdateDanglingState
+     * updates the dangling state of \a aItem from the end points that can be connected to
+     * its connection points.
+     *
+     * @return True if the dangling state of \a aItem has changed.
+     */
+    bool UpdateDanglingState( SCH_ITEM* aItem ) const;
+
+private:
+    /// @return true if the end point at \a aIndex is the first end of a wire or a bus
+    bool isSegmentStart( size_t aIndex ) const;
+
+    /// @return the grid cell containing \a aPoint
+    static wxPoint cellOf( const wxPoint& aPoint );
+
+    const std::vector<DANGLING_END_ITEM>&                m_items;
+
+    /// Indexes of the end points, by position
+    std::unordered_map<wxPoint, std::vector<size_t>>     m_endPoints;
+
+    /// Indexes of the wire and bus start end points, by grid cell crossed by the segment
+    std::unordered_map<wxPoint, std::vector<size_t>>     m_segments;
+
+    /// Indexes of the wire and bus start end points of segments crossing too many cells
+    std::vector<size_t>                                  m_largeSegments;
+};
+
+
 /**
  * Class SCH_ITEM
  * is a base class for any item which can be embedded within the SCHEMATIC
@@ -22,8 +22,16 @@
 
 #include <ctype.h>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <boost/algorithm/string/join.hpp>
 
+#include <wx/ffile.h>
 #include <wx/mstream.h>
 #include <wx/filename.h>
 #include <wx/tokenzr.h>
@@ -461,6 +469,104 @@ static void parseQuotedString( wxString& aString, LINE_READER& aReader,
 }
 
 
+/**
+ * A LINE_READER over a library file read in a single block, instead of character by
+ * character.
+ *
+ * The file content is shared with the symbols loaded from it, which parse their DRAW
+ * sections from it when their drawing items are first used.  Lines are still copied to
+ * the line buffer, the parsers expect them to be nul terminated.
+ */
+class LIB_BUFFER_READER : public LINE_READER
+{
+public:
+    LIB_BUFFER_READER( const wxString& aFileName ) :
+            LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
+            m_ndx( 0 ),
+            m_lineOffset( 0 )
+    {
+        wxFFile file( aFileName, "rb" );
+
+        if( !file.IsOpened() )
+        {
+            THROW_IO_ERROR( wxString::Format( _( "Unable to open filename \"%s\" for reading" ),
+                                              aFileName ) );
+        }
+
+        auto buffer = std::make_shared<std::string>( std::max<wxFileOffset>( file.Length(), 0 ),
+                                                     '\0' );
+
+        if( !buffer->empty() && file.Read( &( *buffer )[0], buffer->size() ) != buffer->size() )
+        {
+            THROW_IO_ERROR( wxString::Format( _( "Error reading file \"%s\"" ), aFileName ) );
+        }
+
+        m_buffer = buffer;
+        m_end = m_buffer->size();
+        m_source = aFileName;
+    }
+
+    /**
+     * Read again a part of the file of another reader.
+     *
+     * @param aBegin is the offset of the first line to read.
+     * @param aEnd is the offset after the last line to read.
+     * @param aLineNumber is the line number of the first line, for the error messages.
+     */
+    LIB_BUFFER_READER( const std::shared_ptr<const std::string>& aBuffer, size_t aBegin,
+                       size_t aEnd, unsigned aLineNumber, const wxString& aSource ) :
+            LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
+            m_buffer( aBuffer ),
+            m_ndx( aBegin ),
+            m_end( aEnd ),
+            m_lineOffset( aBegin )
+    {
+        m_lineNum = aLineNumber - 1;
+        m_source = aSource;
+    }
+
+    char* ReadLine() override
+    {
+        const char* start = m_buffer->data() + m_ndx;
+        const char* eol = (const char*) memchr( start, '\n', m_end - m_ndx );
+
+        m_lineOffset = m_ndx;
+        m_length = eol ? eol - start + 1 : m_end - m_ndx;   // include the newline
+
+        if( m_length )
+        {
+            if( m_length >= m_maxLineLength )
+                THROW_IO_ERROR( _( "Line length exceeded" ) );
+
+            if( m_length + 1 > m_capacity )   // +1 for terminating nul
+                expandCapacity( m_length + 1 );
+
+            memcpy( m_line, start, m_length );
+            m_ndx += m_length;
+        }
+
+        ++m_lineNum;      // this gets incremented even if no bytes were read
+        m_line[m_length] = 0;
+
+        return m_length ? m_line : NULL;
+    }
+
+    const std::shared_ptr<const std::string>& GetBuffer() const { return m_buffer; }
+
+    /// @return the offset of the current line in the file.
+    size_t GetLineOffset() const { return m_lineOffset; }
+
+    /// @return the offset of the line following the current one in the file.
+    size_t GetNextLineOffset() const { return m_ndx; }
+
+private:
+    std::shared_ptr<const std::string> m_buffer;
+    size_t                             m_ndx;
+    size_t                             m_end;
+    size_t                             m_lineOffset;
+};
+
+
 /**
  * A cache assistant for the part library portion of the #SCH_PLUGIN API, and only for the
  * #SCH_LEGACY_PLUGIN, so therefore is private to this implementation file, i.e. not placed
@@ -468,7 +574,7 @@ static void parseQuotedString( wxString& aString, LINE_READER& aReader,
  */
 class SCH_LEGACY_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    static std::atomic<int> m_modHash;  // Keep track of the modification status of the library.
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
@@ -480,23 +586,25 @@ class SCH_LEGACY_PLUGIN_CACHE
     int             m_versionMinor;
     int             m_libType;      // Is this cache a component or symbol library.
 
-    void                  loadHeader( FILE_LINE_READER& aReader );
+    void                  loadHeader( LINE_READER& aReader );
     static void           loadAliases( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
     static void           loadField( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
-    static void           loadDrawEntries( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader,
+    static void           loadDrawEntries( LIB_PART* aPart, LINE_READER& aReader,
                                            int aMajorVersion, int aMinorVersion );
+    static void           skipDrawEntries( LIB_BUFFER_READER& aReader,
+                                           std::vector<std::pair<size_t, unsigned>>& aSections );
     static void           loadFootprintFilters( std::unique_ptr<LIB_PART>& aPart,
                                                 LINE_READER& aReader );
     void                  loadDocs();
-    static LIB_ARC*       loadArc( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
-    static LIB_CIRCLE*    loadCircle( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
-    static LIB_TEXT*      loadText( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader,
+    static LIB_ARC*       loadArc( LIB_PART* aPart, LINE_READER& aReader );
+    static LIB_CIRCLE*    loadCircle( LIB_PART* aPart, LINE_READER& aReader );
+    static LIB_TEXT*      loadText( LIB_PART* aPart, LINE_READER& aReader,
                                     int aMajorVersion, int aMinorVersion );
-    static LIB_RECTANGLE* loadRectangle( std::unique_ptr<LIB_PART>& aPart,
+    static LIB_RECTANGLE* loadRectangle( LIB_PART* aPart,
                                          LINE_READER& aReader );
-    static LIB_PIN*       loadPin( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
-    static LIB_POLYLINE*  loadPolyLine( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
-    static LIB_BEZIER*    loadBezier( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
+    static LIB_PIN*       loadPin( LIB_PART* aPart, LINE_READER& aReader );
+    static LIB_POLYLINE*  loadPolyLine( LIB_PART* aPart, LINE_READER& aReader );
+    static LIB_BEZIER*    loadBezier( LIB_PART* aPart, LINE_READER& aReader );
 
     static FILL_T   parseFillMode( LINE_READER& aReader, const char* aLine,
                                           const char** aOutput );
@@ -557,6 +665,68 @@ public:
 };
 
 
+/**
+ * Load #SCH_LEGACY_PLUGIN_CACHE objects on worker threads, for SCH_LEGACY_PLUGIN::PreloadSymbolLib().
+ *
+ * A preloaded cache is not shared: the first plugin asking for its library takes it over,
+ * so each plugin still owns its cache.  A library still waiting in the queue when a plugin
+ * asks for it is dropped from the queue and left to the plugin.
+ *
+ * Caches are loaded without switching the locale with a #LOCALE_IO, which is not thread
+ * safe; the library parser only reads integers.  Anything the parser calls which keeps
+ * static state, like TEMPLATE_FIELDNAME::GetDefaultFieldName(), must be thread safe.
+ */
+class SCH_LEGACY_PLUGIN_CACHE_PRELOADER
+{
+public:
+    static SCH_LEGACY_PLUGIN_CACHE_PRELOADER& Instance();
+
+    ~SCH_LEGACY_PLUGIN_CACHE_PRELOADER();
+
+    /// Queue \a aLibraryPath for loading, if it is not already queued or loaded.
+    void Enqueue( const wxString& aLibraryPath );
+
+    /**
+     * Take over the preloaded cache of \a aLibraryPath, waiting for it if it is being loaded.
+     *
+     * @return the cache, or nullptr if it was not preloaded or failed to load.
+     */
+    std::unique_ptr<SCH_LEGACY_PLUGIN_CACHE> Take( const wxString& aLibraryPath );
+
+    /// @return true if \a aLibraryPath is queued or being loaded, without waiting for it.
+    bool IsPending( const wxString& aLibraryPath );
+
+    /**
+     * Stop the workers and drop the caches which were not taken.
+     *
+     * The libraries being loaded are finished first, the queued ones are not loaded.
+     * The next Enqueue() starts the workers again.
+     */
+    void Shutdown();
+
+private:
+    SCH_LEGACY_PLUGIN_CACHE_PRELOADER();
+
+    void worker();
+
+    enum STATE { QUEUED, LOADING, LOADED };
+
+    struct ENTRY
+    {
+        STATE                                    state;
+        std::unique_ptr<SCH_LEGACY_PLUGIN_CACHE> cache;
+    };
+
+    std::mutex                  m_mutex;
+    std::condition_variable     m_queued;       ///< Notified when a library is queued
+    std::condition_variable     m_loaded;       ///< Notified when a library has been loaded
+    std::map<wxString, ENTRY>   m_entries;
+    std::deque<wxString>        m_queue;
+    std::vector<std::thread>    m_threads;      ///< Started on the first Enqueue()
+    bool                        m_cancelled;
+};
+
+
 SCH_LEGACY_PLUGIN::SCH_LEGACY_PLUGIN()
 {
     init( NULL );
@@ -2311,7 +2481,7 @@ void SCH_LEGACY_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias )
 }
 
 
-int SCH_LEGACY_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_LEGACY_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_LEGACY_PLUGIN_CACHE::SCH_LEGACY_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
@@ -2483,7 +2653,8 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
     wxLogTrace( traceSchLegacyPlugin, "Loading legacy symbol file \"%s\"",
                 m_libFileName.GetFullPath() );
 
-    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+    // The drawing items of the symbols are only parsed when first used
+    LIB_BUFFER_READER reader( m_libFileName.GetFullPath() );
 
     if( !reader.ReadLine() )
         THROW_IO_ERROR( _( "unexpected end of file" ) );
@@ -2614,7 +2785,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
         THROW_IO_ERROR( wxString::Format( _( "user does not have permission to read library "
                                              "document file \"%s\"" ), fn.GetFullPath() ) );
 
-    FILE_LINE_READER reader( fn.GetFullPath() );
+    LIB_BUFFER_READER reader( fn.GetFullPath() );
 
     line = reader.ReadLine();
 
@@ -2697,7 +2868,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
 }
 
 
-void SCH_LEGACY_PLUGIN_CACHE::loadHeader( FILE_LINE_READER& aReader )
+void SCH_LEGACY_PLUGIN_CACHE::loadHeader( LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
@@ -2868,6 +3039,11 @@ LIB_PART* SCH_LEGACY_PLUGIN_CACHE::LoadPart( LINE_READER& aReader, int aMajorVer
                                aReader.LineNumber(), pos );
     }
 
+    // When reading a whole library file, the DRAW sections are parsed on first use of the
+    // drawing items.  Their offsets and line numbers in the file are kept until then.
+    LIB_BUFFER_READER* bufferReader = dynamic_cast<LIB_BUFFER_READER*>( &aReader );
+    std::vector<std::pair<size_t, unsigned>> drawSections;
+
     line = aReader.ReadLine();
 
     // Read lines until "ENDDEF" is found.
@@ -2882,11 +3058,47 @@ LIB_PART* SCH_LEGACY_PLUGIN_CACHE::LoadPart( LINE_READER& aReader, int aMajorVer
         else if( *line == 'F' )                          // Fields
             loadField( part, aReader );
         else if( strCompare( "DRAW", line, &line ) )     // Drawing objects.
-            loadDrawEntries( part, aReader, aMajorVersion, aMinorVersion );
+        {
+            if( bufferReader )
+                skipDrawEntries( *bufferReader, drawSections );
+            else
+                loadDrawEntries( part.get(), aReader, aMajorVersion, aMinorVersion );
+        }
         else if( strCompare( "$FPLIST", line, &line ) )  // Footprint filter list
             loadFootprintFilters( part, aReader );
         else if( strCompare( "ENDDEF", line, &line ) )   // End of part description
         {
+            if( !drawSections.empty() )
+            {
+                std::shared_ptr<const std::string> buffer = bufferReader->GetBuffer();
+                wxString                           source = bufferReader->GetSource();
+
+                part->SetDrawItemsLoader(
+                        [=]( LIB_PART& aPart )
+                        {
+                            try
+                            {
+                                for( const std::pair<size_t, unsigned>& section : drawSections )
+                                {
+                                    LIB_BUFFER_READER reader( buffer, section.first,
+                                                              buffer->size(), section.second,
+                                                              source );
+
+                                    reader.ReadLine();
+                                    loadDrawEntries( &aPart, reader, aMajorVersion,
+                                                     aMinorVersion );
+                                }
+                            }
+                            catch( const IO_ERROR& ioe )
+                            {
+                                // The drawing items are needed long after the library was
+                                // loaded, by code which cannot handle a failure.
+                                wxLogError( _( "Error loading symbol \"%s\" drawing items.\n%s" ),
+                                            aPart.GetName(), ioe.What() );
+                            }
+                        } );
+            }
+
             return part.release();
         }
 
@@ -3093,10 +3305,10 @@ void SCH_LEGACY_PLUGIN_CACHE::loadField( std::unique_ptr<LIB_PART>& aPart,
 }
 
 
-void SCH_LEGACY_PLUGIN_CACHE::loadDrawEntries( std::unique_ptr<LIB_PART>& aPart,
-                                               LINE_READER&                 aReader,
-                                               int                          aMajorVersion,
-                                               int                          aMinorVersion )
+void SCH_LEGACY_PLUGIN_CACHE::loadDrawEntries( LIB_PART*    aPart,
+                                               LINE_READER& aReader,
+                                               int          aMajorVersion,
+                                               int          aMinorVersion )
 {
     const char* line = aReader.Line();
 
@@ -3156,6 +3368,29 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDrawEntries( std::unique_ptr<LIB_PART>& aPart,
 }
 
 
+void SCH_LEGACY_PLUGIN_CACHE::skipDrawEntries(
+        LIB_BUFFER_READER& aReader, std::vector<std::pair<size_t, unsigned>>& aSections )
+{
+    const char* line = aReader.Line();
+
+    wxCHECK_RET( strCompare( "DRAW", line, &line ), "Invalid DRAW section" );
+
+    aSections.emplace_back( aReader.GetLineOffset(), aReader.LineNumber() );
+
+    line = aReader.ReadLine();
+
+    while( line )
+    {
+        if( strCompare( "ENDDRAW", line, &line ) )
+            return;
+
+        line = aReader.ReadLine();
+    }
+
+    SCH_PARSE_ERROR( "file ended prematurely loading component draw element", aReader, line );
+}
+
+
 FILL_T SCH_LEGACY_PLUGIN_CACHE::parseFillMode( LINE_READER& aReader, const char* aLine,
                                                const char** aOutput )
 {
@@ -3169,14 +3404,14 @@ FILL_T SCH_LEGACY_PLUGIN_CACHE::parseFillMode( LINE_READER& aReader, const char*
 }
 
 
-LIB_ARC* SCH_LEGACY_PLUGIN_CACHE::loadArc( std::unique_ptr<LIB_PART>& aPart,
-                                           LINE_READER&                 aReader )
+LIB_ARC* SCH_LEGACY_PLUGIN_CACHE::loadArc( LIB_PART*    aPart,
+                                           LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "A", line, &line ), NULL, "Invalid LIB_ARC definition" );
 
-    LIB_ARC* arc = new LIB_ARC( aPart.get() );
+    LIB_ARC* arc = new LIB_ARC( aPart );
 
     wxPoint center;
 
@@ -3235,14 +3470,14 @@ LIB_ARC* SCH_LEGACY_PLUGIN_CACHE::loadArc( std::unique_ptr<LIB_PART>& aPart,
 }
 
 
-LIB_CIRCLE* SCH_LEGACY_PLUGIN_CACHE::loadCircle( std::unique_ptr<LIB_PART>& aPart,
-                                                 LINE_READER&                 aReader )
+LIB_CIRCLE* SCH_LEGACY_PLUGIN_CACHE::loadCircle( LIB_PART*    aPart,
+                                                 LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "C", line, &line ), NULL, "Invalid LIB_CIRCLE definition" );
 
-    LIB_CIRCLE* circle = new LIB_CIRCLE( aPart.get() );
+    LIB_CIRCLE* circle = new LIB_CIRCLE( aPart );
 
     wxPoint center;
 
@@ -3262,16 +3497,16 @@ LIB_CIRCLE* SCH_LEGACY_PLUGIN_CACHE::loadCircle( std::unique_ptr<LIB_PART>& aPar
 }
 
 
-LIB_TEXT* SCH_LEGACY_PLUGIN_CACHE::loadText( std::unique_ptr<LIB_PART>& aPart,
-                                             LINE_READER&                 aReader,
-                                             int                          aMajorVersion,
-                                             int                          aMinorVersion )
+LIB_TEXT* SCH_LEGACY_PLUGIN_CACHE::loadText( LIB_PART*    aPart,
+                                             LINE_READER& aReader,
+                                             int          aMajorVersion,
+                                             int          aMinorVersion )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "T", line, &line ), NULL, "Invalid LIB_TEXT definition" );
 
-    LIB_TEXT* text = new LIB_TEXT( aPart.get() );
+    LIB_TEXT* text = new LIB_TEXT( aPart );
 
     text->SetTextAngle( (double) parseInt( aReader, line, &line ) );
 
@@ -3355,14 +3590,14 @@ LIB_TEXT* SCH_LEGACY_PLUGIN_CACHE::loadText( std::unique_ptr<LIB_PART>& aPart,
 }
 
 
-LIB_RECTANGLE* SCH_LEGACY_PLUGIN_CACHE::loadRectangle( std::unique_ptr<LIB_PART>& aPart,
-                                                       LINE_READER&                 aReader )
+LIB_RECTANGLE* SCH_LEGACY_PLUGIN_CACHE::loadRectangle( LIB_PART*    aPart,
+                                                       LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "S", line, &line ), NULL, "Invalid LIB_RECTANGLE definition" );
 
-    LIB_RECTANGLE* rectangle = new LIB_RECTANGLE( aPart.get() );
+    LIB_RECTANGLE* rectangle = new LIB_RECTANGLE( aPart );
 
     wxPoint pos;
 
@@ -3387,14 +3622,14 @@ LIB_RECTANGLE* SCH_LEGACY_PLUGIN_CACHE::loadRectangle( std::unique_ptr<LIB_PART>
 }
 
 
-LIB_PIN* SCH_LEGACY_PLUGIN_CACHE::loadPin( std::unique_ptr<LIB_PART>& aPart,
-                                           LINE_READER&                 aReader )
+LIB_PIN* SCH_LEGACY_PLUGIN_CACHE::loadPin( LIB_PART*    aPart,
+                                           LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "X", line, &line ), NULL, "Invalid LIB_PIN definition" );
 
-    LIB_PIN* pin = new LIB_PIN( aPart.get() );
+    LIB_PIN* pin = new LIB_PIN( aPart );
 
     size_t pos = 2;                               // "X" plus ' ' space character.
     wxString tmp;
@@ -3569,14 +3804,14 @@ LIB_PIN* SCH_LEGACY_PLUGIN_CACHE::loadPin( std::unique_ptr<LIB_PART>& aPart,
 }
 
 
-LIB_POLYLINE* SCH_LEGACY_PLUGIN_CACHE::loadPolyLine( std::unique_ptr<LIB_PART>& aPart,
-                                                     LINE_READER&                 aReader )
+LIB_POLYLINE* SCH_LEGACY_PLUGIN_CACHE::loadPolyLine( LIB_PART*    aPart,
+                                                     LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "P", line, &line ), NULL, "Invalid LIB_POLYLINE definition" );
 
-    LIB_POLYLINE* polyLine = new LIB_POLYLINE( aPart.get() );
+    LIB_POLYLINE* polyLine = new LIB_POLYLINE( aPart );
 
     int points = parseInt( aReader, line, &line );
     polyLine->SetUnit( parseInt( aReader, line, &line ) );
@@ -3600,14 +3835,14 @@ LIB_POLYLINE* SCH_LEGACY_PLUGIN_CACHE::loadPolyLine( std::unique_ptr<LIB_PART>&
 }
 
 
-LIB_BEZIER* SCH_LEGACY_PLUGIN_CACHE::loadBezier( std::unique_ptr<LIB_PART>& aPart,
-                                                 LINE_READER&                 aReader )
+LIB_BEZIER* SCH_LEGACY_PLUGIN_CACHE::loadBezier( LIB_PART*    aPart,
+                                                 LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
     wxCHECK_MSG( strCompare( "B", line, &line ), NULL, "Invalid LIB_BEZIER definition" );
 
-    LIB_BEZIER* bezier = new LIB_BEZIER( aPart.get() );
+    LIB_BEZIER* bezier = new LIB_BEZIER( aPart );
 
     int points = parseInt( aReader, line, &line );
     bezier->SetUnit( parseInt( aReader, line, &line ) );
@@ -4229,25 +4464,224 @@ void SCH_LEGACY_PLUGIN_CACHE::DeleteSymbol( const wxString& aAliasName )
 }
 
 
+SCH_LEGACY_PLUGIN_CACHE_PRELOADER::SCH_LEGACY_PLUGIN_CACHE_PRELOADER() :
+    m_cancelled( false )
+{
+}
+
+
+SCH_LEGACY_PLUGIN_CACHE_PRELOADER::~SCH_LEGACY_PLUGIN_CACHE_PRELOADER()
+{
+    // The kiface shuts the preloader down when it is unloaded, so there is nothing left
+    // to join here unless it was not.
+    Shutdown();
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE_PRELOADER::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        if( m_threads.empty() )
+            return;
+
+        m_cancelled = true;
+    }
+
+    m_queued.notify_all();
+
+    for( std::thread& thread : m_threads )
+        thread.join();
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    m_threads.clear();
+    m_queue.clear();
+    m_entries.clear();
+    m_cancelled = false;
+}
+
+
+SCH_LEGACY_PLUGIN_CACHE_PRELOADER& SCH_LEGACY_PLUGIN_CACHE_PRELOADER::Instance()
+{
+    static SCH_LEGACY_PLUGIN_CACHE_PRELOADER preloader;
+
+    return preloader;
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE_PRELOADER::Enqueue( const wxString& aLibraryPath )
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        if( m_cancelled || m_entries.count( aLibraryPath ) )
+            return;
+
+        m_entries[aLibraryPath].state = QUEUED;
+        m_queue.push_back( aLibraryPath );
+
+        if( m_threads.empty() )
+        {
+            // Fetch the translated default field names here, so the workers creating
+            // LIB_FIELDs do not look up translations unless the language is changed.
+            TEMPLATE_FIELDNAME::GetDefaultFieldName( VALUE );
+
+            size_t num_threads = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+
+            for( size_t ii = 0; ii < num_threads; ++ii )
+                m_threads.emplace_back( &SCH_LEGACY_PLUGIN_CACHE_PRELOADER::worker, this );
+        }
+    }
+
+    m_queued.notify_one();
+}
+
+
+std::unique_ptr<SCH_LEGACY_PLUGIN_CACHE>
+SCH_LEGACY_PLUGIN_CACHE_PRELOADER::Take( const wxString& aLibraryPath )
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    std::unique_ptr<SCH_LEGACY_PLUGIN_CACHE> cache;
+
+    auto it = m_entries.find( aLibraryPath );
+
+    while( it != m_entries.end() && it->second.state == LOADING )
+    {
+        m_loaded.wait( lock );
+        it = m_entries.find( aLibraryPath );
+    }
+
+    if( it == m_entries.end() )
+        return cache;
+
+    if( it->second.state == QUEUED )
+        m_queue.erase( std::find( m_queue.begin(), m_queue.end(), aLibraryPath ) );
+    else
+        cache = std::move( it->second.cache );
+
+    m_entries.erase( it );
+
+    return cache;
+}
+
+
+bool SCH_LEGACY_PLUGIN_CACHE_PRELOADER::IsPending( const wxString& aLibraryPath )
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    auto it = m_entries.find( aLibraryPath );
+
+    return it != m_entries.end() && it->second.state != LOADED;
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE_PRELOADER::worker()
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+
+    while( true )
+    {
+        m_queued.wait( lock, [this]() { return m_cancelled || !m_queue.empty(); } );
+
+        if( m_cancelled )
+            return;
+
+        wxString libraryPath = m_queue.front();
+        m_queue.pop_front();
+        m_entries[libraryPath].state = LOADING;
+
+        lock.unlock();
+
+        std::unique_ptr<SCH_LEGACY_PLUGIN_CACHE> cache(
+                new SCH_LEGACY_PLUGIN_CACHE( libraryPath ) );
+
+        try
+        {
+            cache->Load();
+        }
+        catch( ... )
+        {
+            // The error is reported by the plugin loading the library again.
+            cache.reset();
+        }
+
+        lock.lock();
+
+        if( cache )
+        {
+            ENTRY& entry = m_entries[libraryPath];
+            entry.state = LOADED;
+            entry.cache = std::move( cache );
+        }
+        else
+        {
+            m_entries.erase( libraryPath );
+        }
+
+        m_loaded.notify_all();
+    }
+}
+
+
 void SCH_LEGACY_PLUGIN::cacheLib( const wxString& aLibraryFileName )
 {
     if( !m_cache || !m_cache->IsFile( aLibraryFileName ) || m_cache->IsFileChanged() )
     {
+        std::unique_ptr<SCH_LEGACY_PLUGIN_CACHE> preloaded;
+
+        if( !isBuffering( m_props ) )
+        {
+            preloaded = SCH_LEGACY_PLUGIN_CACHE_PRELOADER::Instance().Take( aLibraryFileName );
+
+            if( preloaded && preloaded->IsFileChanged() )
+                preloaded.reset();
+        }
+
+        bool load = !preloaded && !isBuffering( m_props );
+
         // a spectacular episode in memory management:
         delete m_cache;
-        m_cache = new SCH_LEGACY_PLUGIN_CACHE( aLibraryFileName );
+        m_cache = preloaded ? preloaded.release() : new SCH_LEGACY_PLUGIN_CACHE( aLibraryFileName );
 
         // Because m_cache is rebuilt, increment PART_LIBS::s_modify_generation
         // to modify the hash value that indicate component to symbol links
         // must be updated.
         PART_LIBS::s_modify_generation++;
 
-        if( !isBuffering( m_props ) )
+        if( load )
             m_cache->Load();
     }
 }
 
 
+void SCH_LEGACY_PLUGIN::PreloadSymbolLib( const wxString&   aLibraryPath,
+                                          const PROPERTIES* aProperties )
+{
+    if( isBuffering( aProperties ) || ( m_cache && m_cache->IsFile( aLibraryPath ) ) )
+        return;
+
+    SCH_LEGACY_PLUGIN_CACHE_PRELOADER::Instance().Enqueue( aLibraryPath );
+}
+
+
+bool SCH_LEGACY_PLUGIN::IsSymbolLibPreloading( const wxString&   aLibraryPath,
+                                               const PROPERTIES* aProperties )
+{
+    if( isBuffering( aProperties ) || ( m_cache && m_cache->IsFile( aLibraryPath ) ) )
+        return false;
+
+    return SCH_LEGACY_PLUGIN_CACHE_PRELOADER::Instance().IsPending( aLibraryPath );
+}
+
+
+void SCH_LEGACY_PLUGIN::CancelSymbolLibPreloads()
+{
+    SCH_LEGACY_PLUGIN_CACHE_PRELOADER::Instance().Shutdown();
+}
+
+
 bool SCH_LEGACY_PLUGIN::writeDocFile( const PROPERTIES* aProperties )
 {
     std::string propName( SCH_LEGACY_PLUGIN::PropNoDocFile );
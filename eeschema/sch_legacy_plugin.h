@@ -117,6 +117,10 @@ public:
     void EnumerateSymbolLib( std::vector<LIB_ALIAS*>& aAliasList,
                              const wxString&   aLibraryPath,
                              const PROPERTIES* aProperties = nullptr ) override;
+    void PreloadSymbolLib( const wxString&   aLibraryPath,
+                           const PROPERTIES* aProperties = nullptr ) override;
+    bool IsSymbolLibPreloading( const wxString&   aLibraryPath,
+                                const PROPERTIES* aProperties = nullptr ) override;
     LIB_ALIAS* LoadSymbol( const wxString& aLibraryPath, const wxString& aAliasName,
                            const PROPERTIES* aProperties = nullptr ) override;
     void SaveSymbol( const wxString& aLibraryPath, const LIB_PART* aSymbol,
@@ -140,6 +144,15 @@ public:
     static LIB_PART* ParsePart( LINE_READER& aReader, int majorVersion = 0, int minorVersion = 0 );
     static void FormatPart( LIB_PART* aPart, OUTPUTFORMATTER& aFormatter );
 
+    /**
+     * Stop loading the libraries queued by #PreloadSymbolLib() and free the ones loaded
+     * but not used yet.
+     *
+     * This waits for the libraries being loaded, so it must be called before the project
+     * they belong to is closed and before the kiface is unloaded.
+     */
+    static void CancelSymbolLibPreloads();
+
 private:
     void loadHierarchy( SCH_SHEET* aSheet );
     void loadHeader( LINE_READER& aReader, SCH_SCREEN* aScreen );
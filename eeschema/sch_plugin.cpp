@@ -81,6 +81,20 @@ void SCH_PLUGIN::EnumerateSymbolLib( std::vector<LIB_ALIAS*>& aAliasList,
 }
 
 
+void SCH_PLUGIN::PreloadSymbolLib( const wxString&   aLibraryPath,
+                                   const PROPERTIES* aProperties )
+{
+    // Only a hint, plugins without a library cache have nothing to do.
+}
+
+
+bool SCH_PLUGIN::IsSymbolLibPreloading( const wxString&   aLibraryPath,
+                                        const PROPERTIES* aProperties )
+{
+    return false;
+}
+
+
 LIB_ALIAS* SCH_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxString& aSymbolName,
                                    const PROPERTIES* aProperties )
 {
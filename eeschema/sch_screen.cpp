@@ -785,9 +785,11 @@ bool SCH_SCREEN::TestDanglingEnds()
     for( item = m_drawList.begin(); item; item = item->Next() )
         item->GetEndPoints( endPoints );
 
+    DANGLING_END_INDEX index( endPoints );
+
     for( item = m_drawList.begin(); item; item = item->Next() )
     {
-        if( item->UpdateDanglingState( endPoints ) )
+        if( index.UpdateDanglingState( item ) )
             hasStateChanged = true;
     }
 
@@ -795,6 +797,45 @@ bool SCH_SCREEN::TestDanglingEnds()
 }
 
 
+bool SCH_SCREEN::TestDanglingEnds( const EDA_RECT& aChangedArea,
+                                   std::vector<SCH_ITEM*>* aChangedItems )
+{
+    SCH_ITEM* item;
+    std::vector< DANGLING_END_ITEM > endPoints;
+    std::vector< wxPoint > points;
+    bool hasStateChanged = false;
+
+    for( item = m_drawList.begin(); item; item = item->Next() )
+        item->GetEndPoints( endPoints );
+
+    DANGLING_END_INDEX index( endPoints );
+
+    // Items on the border of the area are also connected to the changed geometry
+    EDA_RECT area = aChangedArea;
+    area.Normalize();
+    area.Inflate( 1 );
+
+    for( item = m_drawList.begin(); item; item = item->Next() )
+    {
+        points.clear();
+        item->GetConnectionPoints( points );
+
+        bool nearChange = std::any_of( points.begin(), points.end(),
+                                       [&]( const wxPoint& aPt ) { return area.Contains( aPt ); } );
+
+        if( nearChange && index.UpdateDanglingState( item ) )
+        {
+            if( aChangedItems )
+                aChangedItems->push_back( item );
+
+            hasStateChanged = true;
+        }
+    }
+
+    return hasStateChanged;
+}
+
+
 SCH_LINE* SCH_SCREEN::GetWireOrBus( const wxPoint& aPosition )
 {
     static KICAD_T types[] = { SCH_LINE_LOCATE_WIRE_T, SCH_LINE_LOCATE_BUS_T, EOT };
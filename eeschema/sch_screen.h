@@ -266,6 +266,19 @@ public:
      */
     bool TestDanglingEnds();
 
+    /**
+     * Test the connectable objects having a connection point inside \a aChangedArea for
+     * unused connection points.
+     *
+     * This is the incremental version of TestDanglingEnds(): only the items that can be
+     * connected to geometry changed inside \a aChangedArea (which must contain the old and the
+     * new position of the changed items) are tested.
+     * @param aChangedItems if not null, receives the items whose connection state changed.
+     * @return True if any connection state changes were made.
+     */
+    bool TestDanglingEnds( const EDA_RECT& aChangedArea,
+                           std::vector<SCH_ITEM*>* aChangedItems = nullptr );
+
     /**
      * Replace all of the wires, buses, and junctions in the screen with \a aWireList.
      *
@@ -365,9 +365,6 @@ bool SCH_TEXT::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList )
 
 
         case BUS_START_END:
-            m_connectionType = CONNECTION_BUS;
-            // fall through
-
         case WIRE_START_END:
         {
             // These schematic items have created 2 DANGLING_END_ITEM one per end.  But being
@@ -382,7 +379,11 @@ bool SCH_TEXT::UpdateDanglingState( std::vector<DANGLING_END_ITEM>& aItemList )
 
             if( !m_isDangling )
             {
-                if( m_connectionType != CONNECTION_BUS )
+                // Only the segment the label is on gives its connection type, so the result
+                // does not depend on the other items of aItemList
+                if( item.GetType() == BUS_START_END )
+                    m_connectionType = CONNECTION_BUS;
+                else
                     m_connectionType = CONNECTION_NET;
 
                 // Add the line to the connected items, since it won't be picked
@@ -334,6 +334,44 @@ void SYMBOL_LIB_TABLE::LoadSymbolLib( std::vector<LIB_ALIAS*>& aAliasList,
 }
 
 
+void SYMBOL_LIB_TABLE::PreloadSymbolLibs()
+{
+    for( const wxString& nickname : GetLogicalLibs() )
+    {
+        try
+        {
+            SYMBOL_LIB_TABLE_ROW* row = FindRow( nickname );
+
+            if( row && row->plugin )
+                row->plugin->PreloadSymbolLib( row->GetFullURI( true ), row->GetProperties() );
+        }
+        catch( const IO_ERROR& )
+        {
+            // Reported when the library is used.
+        }
+    }
+}
+
+
+bool SYMBOL_LIB_TABLE::IsSymbolLibPreloading( const wxString& aNickname )
+{
+    try
+    {
+        SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
+
+        if( row && row->plugin )
+            return row->plugin->IsSymbolLibPreloading( row->GetFullURI( true ),
+                                                       row->GetProperties() );
+    }
+    catch( const IO_ERROR& )
+    {
+        // Reported when the library is used.
+    }
+
+    return false;
+}
+
+
 LIB_ALIAS* SYMBOL_LIB_TABLE::LoadSymbol( const wxString& aNickname, const wxString& aAliasName )
 {
     const SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
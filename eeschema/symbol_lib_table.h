@@ -160,6 +160,24 @@ public:
     void LoadSymbolLib( std::vector<LIB_ALIAS*>& aAliasList, const wxString& aNickname,
                         bool aPowerSymbolsOnly = false );
 
+    /**
+     * Start loading all the enabled libraries, including the ones of the fall back table,
+     * on background threads.
+     *
+     * This returns immediately.  Later calls to #LoadSymbolLib() and #LoadSymbol() use the
+     * libraries already loaded and only wait for the ones being loaded.  Libraries which
+     * cannot be loaded are silently skipped, their errors are reported when they are used.
+     */
+    void PreloadSymbolLibs();
+
+    /**
+     * Tell if the library given by @a aNickname is still being loaded by
+     * #PreloadSymbolLibs(), in which case #LoadSymbolLib() would wait for it.
+     *
+     * This returns immediately.
+     */
+    bool IsSymbolLibPreloading( const wxString& aNickname );
+
     /**
      * Load a #LIB_ALIAS having @a aAliasName from the library given by @a aNickname.
      *
@@ -72,7 +72,13 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNick
             nextUpdate = wxGetUTCTimeMillis() + PROGRESS_INTERVAL_MILLIS;
         }
 
-        AddLibrary( nickname );
+        // Do not wait for the libraries still being preloaded, the tree shows the ones
+        // already loaded and gets the others from AddPreloadedLibraries().
+        if( m_libs->IsSymbolLibPreloading( nickname ) )
+            m_pendingLibs.push_back( nickname );
+        else
+            AddLibrary( nickname );
+
         ii++;
     }
 
@@ -112,6 +118,30 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname )
 }
 
 
+bool SYMBOL_TREE_MODEL_ADAPTER::AddPreloadedLibraries()
+{
+    bool added = false;
+
+    for( auto it = m_pendingLibs.begin(); it != m_pendingLibs.end(); )
+    {
+        if( m_libs->IsSymbolLibPreloading( *it ) )
+        {
+            ++it;
+            continue;
+        }
+
+        AddLibrary( *it );
+        it = m_pendingLibs.erase( it );
+        added = true;
+    }
+
+    if( added )
+        m_tree.AssignIntrinsicRanks();
+
+    return added;
+}
+
+
 wxString SYMBOL_TREE_MODEL_ADAPTER::GenerateInfo( LIB_ID const& aLibId, int aUnit )
 {
     return GenerateAliasInfo( m_libs, aLibId, aUnit );
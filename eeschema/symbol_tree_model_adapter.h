@@ -46,6 +46,9 @@ public:
      * Add all the libraries in a SYMBOL_LIB_TABLE to the model.
      * Displays a progress dialog attached to the parent frame the first time it is run.
      *
+     * The libraries still being preloaded in the background are not waited for but left
+     * for #AddPreloadedLibraries().
+     *
      * @param aNicknames is the list of library nicknames
      * @param aParent is the parent window to display the progress dialog
      */
@@ -53,6 +56,16 @@ public:
 
     void AddLibrary( wxString const& aLibNickname );
 
+    /**
+     * Add the libraries left by #AddLibraries() whose preload has finished since.
+     *
+     * @return true if a library was added, so the tree must be regenerated.
+     */
+    bool AddPreloadedLibraries();
+
+    /// @return true if #AddLibraries() left libraries still being preloaded.
+    bool HasPendingLibraries() const { return !m_pendingLibs.empty(); }
+
     wxString GenerateInfo( LIB_ID const& aLibId, int aUnit ) override;
 
 protected:
@@ -65,9 +78,12 @@ private:
     /**
      * Flag to only show the symbol library table load progress dialog the first time.
      */
-    static bool        m_show_progress;
+    static bool           m_show_progress;
+
+    SYMBOL_LIB_TABLE*     m_libs;
 
-    SYMBOL_LIB_TABLE*  m_libs;
+    /// Libraries still being preloaded when #AddLibraries() was called
+    std::vector<wxString> m_pendingLibs;
 };
 
 #endif // SYMBOL_TREE_MODEL_ADAPTER_H
@@ -22,6 +22,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <mutex>
+
 #include <template_fieldnames.h>
 #include <dsnlexer.h>
 #include <fctsys.h>
@@ -33,6 +35,7 @@ using namespace TFIELD_T;
 
 const wxString TEMPLATE_FIELDNAME::GetDefaultFieldName( int aFieldNdx )
 {
+    static std::mutex mutex;
     static void* locale = nullptr;
     static wxString referenceDefault;
     static wxString valueDefault;
@@ -40,6 +43,10 @@ const wxString TEMPLATE_FIELDNAME::GetDefaultFieldName( int aFieldNdx )
     static wxString datasheetDefault;
     static wxString fieldDefault;
 
+    // Symbol libraries are loaded on worker threads (see SCH_LEGACY_PLUGIN_CACHE_PRELOADER),
+    // and the names are returned as copies made under the lock.
+    std::lock_guard<std::mutex> lock( mutex );
+
     // Fetching translations can take a surprising amount of time when loading libraries,
     // so only do it when necessary.
     if( Pgm().GetLocale() != locale )
@@ -119,6 +119,7 @@ struct TEMPLATE_FIELDNAME
      * Function GetDefaultFieldName
      * returns a default symbol field name for field \a aFieldNdx for all components.
      * These fieldnames are not modifiable, but template fieldnames are.
+     * This function is thread safe.
      * @param aFieldNdx The field number index, > 0
      */
     static const wxString GetDefaultFieldName( int aFieldNdx );
@@ -149,6 +149,9 @@ int SCH_MOVE_TOOL::Main( const TOOL_EVENT& aEvent )
     // Keep an original copy of the starting points for cleanup after the move
     std::vector<DANGLING_END_ITEM> internalPoints;
 
+    // Area of the items before and after the move, for the dangling ends test
+    EDA_RECT changedArea;
+
     if( selection.Empty() )
         return 0;
 
@@ -258,6 +261,7 @@ int SCH_MOVE_TOOL::Main( const TOOL_EVENT& aEvent )
 
                     SCH_ITEM* schItem = (SCH_ITEM*) item;
                     schItem->SetStoredPos( schItem->GetPosition() );
+                    changedArea.Merge( schItem->GetBoundingBox() );
                 }
 
                 // Set up the starting position and move/drag offset
@@ -447,8 +451,13 @@ int SCH_MOVE_TOOL::Main( const TOOL_EVENT& aEvent )
 
         m_toolMgr->RunAction( EE_ACTIONS::addNeededJunctions, true, &selection );
 
-        m_frame->SchematicCleanUp();
-        m_frame->TestDanglingEnds();
+        for( EDA_ITEM* item : selection )
+            changedArea.Merge( item->GetBoundingBox() );
+
+        // Lines merged by the cleanup can end far from the moved items
+        m_frame->SchematicCleanUp( nullptr, &changedArea );
+
+        m_frame->TestDanglingEnds( changedArea );
 
         m_frame->OnModify();
     }
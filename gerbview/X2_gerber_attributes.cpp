@@ -43,6 +43,7 @@
 
 #include <wx/log.h>
 #include <X2_gerber_attributes.h>
+#include <gerber_file_buffer.h>
 
 /*
  * class X2_ATTRIBUTE
@@ -89,7 +90,7 @@ void X2_ATTRIBUTE::DbgListPrms()
         wxLogMessage( m_Prms.Item( ii ) );
 }
 
-bool X2_ATTRIBUTE::ParseAttribCmd( FILE* aFile, char *aBuffer, int aBuffSize, char* &aText,
+bool X2_ATTRIBUTE::ParseAttribCmd( GERBER_FILE_BUFFER* aFile, char *aBuffer, int aBuffSize, char* &aText,
                                    int& aLineNum )
 {
     // parse a TF command and fill m_Prms by the parameters found.
@@ -135,7 +136,7 @@ bool X2_ATTRIBUTE::ParseAttribCmd( FILE* aFile, char *aBuffer, int aBuffSize, ch
         // end of current line, read another one.
         if( aBuffer && aFile )
         {
-            if( fgets( aBuffer, aBuffSize, aFile ) == NULL )
+            if( aFile->ReadLine( aBuffer, aBuffSize ) == NULL )
             {
                 // end of file
                 ok = false;
@@ -46,6 +46,8 @@
 
 #include <wx/arrstr.h>
 
+class GERBER_FILE_BUFFER;
+
 /**
  * class X2_ATTRIBUTE
  * The attribute value consists of a number of substrings separated by a comma
@@ -90,7 +92,7 @@ public:
     /**
      * parse a TF command terminated with a % and fill m_Prms
      * by the parameters found.
-     * @param aFile = a FILE* ptr to the current Gerber file.
+     * @param aFile = the current Gerber file.
      * @param aBuffer = the buffer containing current Gerber data (can be null)
      * @param aBuffSize = the size of the buffer
      * @param aText = a pointer to the first char to read from Gerber data stored in aBuffer
@@ -99,7 +101,8 @@ public:
      * @param aLineNum = a point to the current line number of aFile
      * @return true if no error.
      */
-    bool ParseAttribCmd( FILE* aFile, char *aBuffer, int aBuffSize, char* &aText, int& aLineNum );
+    bool ParseAttribCmd( GERBER_FILE_BUFFER* aFile, char *aBuffer, int aBuffSize, char* &aText,
+                         int& aLineNum );
 
     /**
      * Debug function: pring using wxLogMessage le list of parameters
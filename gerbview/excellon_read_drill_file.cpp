@@ -69,6 +69,7 @@
 #include <gerbview.h>
 #include <gerbview_frame.h>
 #include <gerber_file_image.h>
+#include <gerber_file_buffer.h>
 #include <gerber_file_image_list.h>
 #include <excellon_image.h>
 #include <kicad_string.h>
@@ -241,7 +242,8 @@ static EXCELLON_CMD excellon_G_CmdList[] =
 };
 
 
-bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
+bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName,
+                                         EXCELLON_IMAGE* aImage )
 {
     wxString msg;
     int layerId = GetActiveLayer();      // current layer used in GerbView
@@ -252,17 +254,28 @@ bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
     if( gerber_layer )
         Erase_Current_DrawLayer( false );
 
-    EXCELLON_IMAGE* drill_layer = new EXCELLON_IMAGE( layerId );
+    EXCELLON_IMAGE* drill_layer = aImage;
+    bool            success = true;
 
-    // Read the Excellon drill file:
-    bool success = drill_layer->LoadFile( aFullFileName );
-
-    if( !success )
+    if( drill_layer )
     {
-        delete drill_layer;
-        msg.Printf( _( "File %s not found" ), aFullFileName );
-        DisplayError( this, msg );
-        return false;
+        // The file is already read: only move it to the active layer
+        drill_layer->m_GraphicLayer = layerId;
+    }
+    else
+    {
+        drill_layer = new EXCELLON_IMAGE( layerId );
+
+        // Read the Excellon drill file:
+        success = drill_layer->LoadFile( aFullFileName );
+
+        if( !success )
+        {
+            delete drill_layer;
+            msg.Printf( _( "File %s not found" ), aFullFileName );
+            DisplayError( this, msg );
+            return false;
+        }
     }
 
     layerId = images->AddGbrImage( drill_layer, layerId );
@@ -310,9 +323,10 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     ResetDefaultValues();
     ClearMessageList();
 
-    m_Current_File = wxFopen( aFullFileName, "rt" );
+    // Read the whole drill file at once
+    GERBER_FILE_BUFFER file;
 
-    if( m_Current_File == NULL )
+    if( !file.Load( aFullFileName ) )
         return false;
 
     wxString msg;
@@ -320,8 +334,7 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
 
     LOCALE_IO toggleIo;
 
-    // FILE_LINE_READER will close the file.
-    FILE_LINE_READER excellonReader( m_Current_File, m_FileName );
+    STRING_LINE_READER excellonReader( file.GetData(), m_FileName );
 
     while( true )
     {
@@ -387,6 +400,8 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     delete m_FileFunction;
     m_FileFunction = new X2_ATTRIBUTE_FILEFUNCTION( dummy );
 
+    BuildItemsIndex();
+
     m_InUse = true;
 
     return true;
@@ -664,8 +679,7 @@ bool EXCELLON_IMAGE::Execute_Drill_Command( char*& text )
                     return false;
                 }
 
-                gbritem = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem = AddNewItem();
 
                 if( m_SlotOn )  // Oblong hole
                 {
@@ -898,7 +912,7 @@ void EXCELLON_IMAGE::FinishRouteCommand()
 
     for( size_t ii = 1; ii < m_RoutePositions.size(); ii++ )
     {
-        GERBER_DRAW_ITEM* gbritem = new GERBER_DRAW_ITEM( this );
+        GERBER_DRAW_ITEM* gbritem = AddNewItem();
 
         if( m_RoutePositions[ii].m_rmode == 0 )     // linear routing
         {
@@ -925,8 +939,6 @@ void EXCELLON_IMAGE::FinishRouteCommand()
                          false );
         }
 
-        m_Drawings.Append( gbritem );
-
         StepAndRepeatItem( *gbritem );
     }
 
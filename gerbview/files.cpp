@@ -38,6 +38,9 @@
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
+#include <atomic>
+#include <thread>
+
 // HTML Messages used more than one time:
 #define MSG_NO_MORE_LAYER\
     _( "<b>No more available free graphic layer</b> in Gerbview to load files" )
@@ -254,6 +257,91 @@ bool GERBVIEW_FRAME::LoadGerberFiles( const wxString& aFullFileName )
 }
 
 
+/**
+ * Read the Gerber and NC drill files of \a aFiles, on several threads.
+ *
+ * Each file is read in its own image, which is not attached to a layer nor to the view:
+ * this is left to the caller, on the main thread.
+ * @param aFiles is the list of full file names.  Empty names are skipped.
+ * @param aIsDrill tells which files are NC drill files.
+ * @param aProgress is an optional progress reporter, advanced once per file.
+ * @return the images, or nullptr for the files which cannot be read.
+ */
+static std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> readFiles(
+        const std::vector<wxString>& aFiles, const std::vector<bool>& aIsDrill,
+        PROGRESS_REPORTER* aProgress )
+{
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> images( aFiles.size() );
+    std::atomic<size_t>                             nextFile( 0 );
+    std::atomic<size_t>                             filesDone( 0 );
+
+    // The locale is GLOBAL: it is only threadsafe to switch it here, before the threads are
+    // created, and to restore it after they finish.  The LOCALE_IO of the readers do nothing.
+    LOCALE_IO toggle_locale;
+
+    auto reader = [&]()
+    {
+        for( size_t ii = nextFile.fetch_add( 1 ); ii < aFiles.size(); ii = nextFile.fetch_add( 1 ) )
+        {
+            if( !aFiles[ii].IsEmpty() )
+            {
+                bool success = false;
+
+                try
+                {
+                    if( aIsDrill[ii] )
+                    {
+                        EXCELLON_IMAGE* drill = new EXCELLON_IMAGE( 0 );
+                        images[ii].reset( drill );
+                        success = drill->LoadFile( aFiles[ii] );
+                    }
+                    else
+                    {
+                        images[ii] = std::make_unique<GERBER_FILE_IMAGE>( 0 );
+                        success = images[ii]->LoadGerberFile( aFiles[ii] );
+                    }
+                }
+                catch( const IO_ERROR& )
+                {
+                }
+                catch( const std::exception& )
+                {
+                }
+
+                // Files which cannot be read are read again by the caller, which reports
+                // the errors.
+                if( !success )
+                    images[ii].reset();
+            }
+
+            if( aProgress )
+                aProgress->AdvanceProgress();
+
+            filesDone.fetch_add( 1 );
+        }
+    };
+
+    size_t                   threadCount = std::max( std::thread::hardware_concurrency(), 1u );
+    std::vector<std::thread> threads;
+
+    for( size_t ii = 0; ii < std::min( threadCount, aFiles.size() ); ++ii )
+        threads.push_back( std::thread( reader ) );
+
+    while( filesDone.load() < aFiles.size() )
+    {
+        if( aProgress )
+            aProgress->KeepRefreshing();
+
+        wxMilliSleep( 30 );
+    }
+
+    for( auto& thread : threads )
+        thread.join();
+
+    return images;
+}
+
+
 bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
                                             const wxArrayString& aFilenameList,
                                             const std::vector<int>* aFileType )
@@ -269,8 +357,8 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
-    // Create progress dialog (only used if more than 1 file to load
-    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+    std::vector<wxString> fullFileNames( aFilenameList.GetCount() );
+    std::vector<bool>     isDrill( aFilenameList.GetCount(), false );
 
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
@@ -291,62 +379,82 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
             continue;
         }
 
-        m_lastFileName = filename.GetFullPath();
+        fullFileNames[ii] = filename.GetFullPath();
+        isDrill[ii] = aFileType && (*aFileType)[ii] == 1;
+    }
+
+    // Read the files in parallel.  Their images are attached to the layers and the view
+    // below, in the order of the list.
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> images;
 
-        if( !progress && ( aFilenameList.GetCount() > 1 ) )
+    {
+        // Create progress dialog (only used if more than 1 file to load
+        std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+
+        if( aFilenameList.GetCount() > 1 )
         {
             progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
                             _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( wxString::Format( _("Loading %d/%d %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
-        }
-        else if( progress )
-        {
-            progress->Report( wxString::Format( _("Loading %d/%d %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
-            progress->KeepRefreshing();
+            progress->SetMaxProgress( aFilenameList.GetCount() );
+            progress->Report( wxString::Format( _( "Loading %d files" ),
+                                                (int) aFilenameList.GetCount() ) );
         }
 
+        images = readFiles( fullFileNames, isDrill, progress.get() );
+    }
+
+    for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
+    {
+        if( fullFileNames[ii].IsEmpty() )
+            continue;
+
+        m_lastFileName = fullFileNames[ii];
+
         SetActiveLayer( layer, false );
 
         visibility[ layer ] = true;
 
-        if( aFileType && (*aFileType)[ii] == 1 )
+        bool loaded;
+
+        if( isDrill[ii] )
         {
-            LoadExcellonFiles( filename.GetFullPath() );
-            layer = GetActiveLayer();   // Loading NC drill file changes the active layer
+            loaded = Read_EXCELLON_File( m_lastFileName,
+                                         static_cast<EXCELLON_IMAGE*>( images[ii].release() ) );
+
+            // Update the list of recent drill files.
+            if( loaded )
+                UpdateFileHistory( m_lastFileName, &m_drillFileHistory );
         }
         else
         {
-            if( Read_GERBER_File( filename.GetFullPath() ) )
-            {
+            loaded = Read_GERBER_File( m_lastFileName, images[ii].release() );
+
+            if( loaded )
                 UpdateFileHistory( m_lastFileName );
+        }
 
-                layer = getNextAvailableLayer( layer );
+        if( loaded )
+        {
+            layer = getNextAvailableLayer( layer );
 
-                if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
-                {
-                    success = false;
-                    reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
+            if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
+            {
+                success = false;
+                reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
 
-                    // Report the name of not loaded files:
-                    ii += 1;
-                    while( ii < aFilenameList.GetCount() )
-                    {
-                        filename = aFilenameList[ii++];
-                        wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
-                        reporter.Report( txt, REPORTER::RPT_ERROR );
-                    }
-                    break;
+                // Report the name of not loaded files:
+                ii += 1;
+                while( ii < aFilenameList.GetCount() )
+                {
+                    filename = aFilenameList[ii++];
+                    wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
+                    reporter.Report( txt, REPORTER::RPT_ERROR );
                 }
-
-                SetActiveLayer( layer, false );
+                break;
             }
-        }
 
-        if( progress )
-            progress->AdvanceProgress();
+            SetActiveLayer( layer, false );
+        }
     }
 
     if( !success )
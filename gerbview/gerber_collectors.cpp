@@ -18,6 +18,9 @@
  */
 
 #include "gerber_collectors.h"
+#include <gbr_layout.h>
+#include <gerber_file_image.h>
+#include <gerber_file_image_list.h>
 
 const KICAD_T GERBER_COLLECTOR::AllItems[] = {
     GERBER_IMAGE_LIST_T,
@@ -60,7 +63,27 @@ void GERBER_COLLECTOR::Collect( EDA_ITEM* aItem, const KICAD_T aScanList[],
     // the Inspect() function.
     SetRefPos( aRefPos );
 
-    aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    if( aItem->Type() == GERBER_LAYOUT_T && aScanList == AllItems )
+    {
+        // Only inspect the items near aRefPos, found by the spatial index of each image,
+        // in the same order as GBR_LAYOUT::Visit()
+        GERBER_FILE_IMAGE_LIST* images = static_cast<GBR_LAYOUT*>( aItem )->GetImagesList();
+
+        for( unsigned layer = 0; layer < images->ImagesMaxCount(); ++layer )
+        {
+            GERBER_FILE_IMAGE* gerber = images->GetGbrImage( layer );
+
+            if( gerber == NULL )    // Graphic layer not yet used
+                continue;
+
+            for( GERBER_DRAW_ITEM* item : gerber->GetItemsAt( aRefPos ) )
+                Inspect( item, NULL );
+        }
+    }
+    else
+    {
+        aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    }
 
     SetTimeNow();               // when snapshot was taken
 
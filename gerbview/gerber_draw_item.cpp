@@ -35,6 +35,13 @@
 #include <gerber_file_image_list.h>
 #include <kicad_string.h>
 
+// The net attributes of the items which have none
+static const GBR_NETLIST_METADATA noNetAttributes;
+
+// In case the item has a very tiny width defined, allow it to be selected
+static const int MIN_HIT_TEST_RADIUS = Millimeter2iu( 0.01 );
+
+
 GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberImageFile ) :
     EDA_ITEM( (EDA_ITEM*)NULL, GERBER_DRAW_ITEM_T )
 {
@@ -49,6 +56,7 @@ GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberImageFile ) :
     m_mirrorB       = false;
     m_drawScale.x   = m_drawScale.y = 1.0;
     m_lyrRotation   = 0;
+    m_netAttributes = &noNetAttributes;
 
     if( m_GerberImageFile )
         SetLayerParameters();
@@ -62,14 +70,8 @@ GERBER_DRAW_ITEM::~GERBER_DRAW_ITEM()
 
 void GERBER_DRAW_ITEM::SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes )
 {
-    m_netAttributes = aNetAttributes;
-
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) ||
-        ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
-        m_GerberImageFile->m_ComponentsList.insert( std::make_pair( m_netAttributes.m_Cmpref, 0 ) );
-
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
-        m_GerberImageFile->m_NetnamesList.insert( std::make_pair( m_netAttributes.m_Netname, 0 ) );
+    // The image also updates its lists of components and net names
+    m_netAttributes = m_GerberImageFile->InternNetAttributes( aNetAttributes );
 }
 
 
@@ -711,35 +713,35 @@ void GERBER_DRAW_ITEM::GetMsgPanelInfo( EDA_UNITS_T aUnits, std::vector< MSG_PAN
     aList.push_back( MSG_PANEL_ITEM( _( "AB axis" ), msg, DARKRED ) );
 
     // Display net info, if exists
-    if( m_netAttributes.m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
+    if( m_netAttributes->m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
         return;
 
     // Build full net info:
     wxString net_msg;
     wxString cmp_pad_msg;
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+    if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
     {
         net_msg = _( "Net:" );
         net_msg << " ";
 
-        if( m_netAttributes.m_Netname.IsEmpty() )
+        if( m_netAttributes->m_Netname.IsEmpty() )
             net_msg << "<no net>";
         else
-            net_msg << UnescapeString( m_netAttributes.m_Netname );
+            net_msg << UnescapeString( m_netAttributes->m_Netname );
     }
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+    if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
     {
         cmp_pad_msg.Printf( _( "Cmp: %s;  Pad: %s" ),
-                                m_netAttributes.m_Cmpref,
-                                m_netAttributes.m_Padname );
+                                m_netAttributes->m_Cmpref,
+                                m_netAttributes->m_Padname );
     }
 
-    else if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
+    else if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
     {
         cmp_pad_msg = _( "Cmp:" );
-        cmp_pad_msg << " " << m_netAttributes.m_Cmpref;
+        cmp_pad_msg << " " << m_netAttributes->m_Cmpref;
     }
 
     aList.push_back( MSG_PANEL_ITEM( net_msg, cmp_pad_msg, DARKCYAN ) );
@@ -776,24 +778,19 @@ BITMAP_DEF GERBER_DRAW_ITEM::GetMenuImage() const
 
 bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos, int aAccuracy ) const
 {
-    // In case the item has a very tiny width defined, allow it to be selected
-    const int MIN_HIT_TEST_RADIUS = Millimeter2iu( 0.01 );
-
     // calculate aRefPos in XY gerber axis:
     wxPoint ref_pos = GetXYPosition( aRefPos );
 
-    SHAPE_POLY_SET poly;
-
     switch( m_Shape )
     {
     case GBR_POLYGON:
-        poly = m_Polygon;
-        return poly.Contains( VECTOR2I( ref_pos ), 0, aAccuracy );
+        return m_Polygon.Contains( VECTOR2I( ref_pos ), 0, aAccuracy );
 
     case GBR_SPOT_POLY:
-        poly = GetDcodeDescr()->m_Polygon;
-        poly.Move( m_Start );
-        return poly.Contains( VECTOR2I( ref_pos ), 0, aAccuracy );
+        // Test the position relative to the item against the D_CODE polygon, instead of
+        // moving a copy of the polygon to the item position
+        return GetDcodeDescr()->m_Polygon.Contains( VECTOR2I( ref_pos - m_Start ), 0,
+                                                    aAccuracy );
 
     case GBR_SPOT_RECT:
         return GetBoundingBox().Contains( aRefPos );
@@ -839,8 +836,16 @@ bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos, int aAccuracy ) const
 
     case GBR_SPOT_MACRO:
         // Aperture macro polygons are already in absolute coordinates
-        auto p = GetDcodeDescr()->GetMacro()->GetApertureMacroShape( this, m_Start );
-        return p->Contains( VECTOR2I( aRefPos ), -1, aAccuracy );
+        if( m_GerberImageFile )
+        {
+            const SHAPE_POLY_SET& shape = m_GerberImageFile->GetMacroShape( this );
+            return shape.Contains( VECTOR2I( aRefPos ), -1, aAccuracy, true );
+        }
+        else
+        {
+            auto p = GetDcodeDescr()->GetMacro()->GetApertureMacroShape( this, m_Start );
+            return p->Contains( VECTOR2I( aRefPos ), -1, aAccuracy );
+        }
     }
 
     // TODO: a better analyze of the shape (perhaps create a D_CODE::HitTest for flashed items)
@@ -902,6 +907,68 @@ void GERBER_DRAW_ITEM::ViewGetLayers( int aLayers[], int& aCount ) const
 }
 
 
+const EDA_RECT GERBER_DRAW_ITEM::GetHitTestBoundingBox() const
+{
+    EDA_RECT bbox = GetBoundingBox();
+    D_CODE*  code = GetDcodeDescr();
+
+    // HitTest() works in XY gerber axis, around the ends of segments and flashed items, and
+    // around the radius of arcs, using a radius which can be larger than the item size.
+    int radius = std::max( std::max( m_Size.x, m_Size.y ), MIN_HIT_TEST_RADIUS );
+
+    if( m_Flashed && code )
+    {
+        radius = std::max( radius, std::max( code->m_Size.x, code->m_Size.y ) );
+
+        if( m_Shape == GBR_SPOT_POLY )
+        {
+            BOX2I bb = code->m_Polygon.BBox();
+
+            radius = std::max( radius, std::max( std::max( std::abs( bb.GetX() ),
+                                                           std::abs( bb.GetRight() ) ),
+                                                 std::max( std::abs( bb.GetY() ),
+                                                           std::abs( bb.GetBottom() ) ) ) );
+        }
+    }
+
+    EDA_RECT xyArea( m_Start, wxSize( 0, 0 ) );
+    xyArea.Merge( m_End );
+    xyArea.Inflate( radius );
+
+    if( m_Shape == GBR_ARC )
+    {
+        EDA_RECT arcArea( m_ArcCentre, wxSize( 0, 0 ) );
+        arcArea.Inflate( KiROUND( GetLineLength( m_Start, m_ArcCentre ) ) + radius );
+        xyArea.Merge( arcArea );
+    }
+
+    if( m_Polygon.OutlineCount() > 0 )
+    {
+        BOX2I bb = m_Polygon.BBox();
+        xyArea.Merge( EDA_RECT( wxPoint( bb.GetX(), bb.GetY() ),
+                                wxSize( bb.GetWidth(), bb.GetHeight() ) ) );
+    }
+
+    // All the corners are needed, the image can have any rotation
+    bbox.Merge( GetABPosition( xyArea.GetOrigin() ) );
+    bbox.Merge( GetABPosition( xyArea.GetEnd() ) );
+    bbox.Merge( GetABPosition( wxPoint( xyArea.GetX(), xyArea.GetBottom() ) ) );
+    bbox.Merge( GetABPosition( wxPoint( xyArea.GetRight(), xyArea.GetY() ) ) );
+
+    // Aperture macro shapes are already in AB plotter axis
+    if( m_Shape == GBR_SPOT_MACRO && code && code->GetMacro() )
+    {
+        BOX2I bb = code->GetMacro()->GetApertureMacroShape( this, m_Start )->BBox();
+        bbox.Merge( EDA_RECT( wxPoint( bb.GetX(), bb.GetY() ),
+                              wxSize( bb.GetWidth(), bb.GetHeight() ) ) );
+    }
+
+    bbox.Inflate( 1 );
+
+    return bbox;
+}
+
+
 const BOX2I GERBER_DRAW_ITEM::ViewBBox() const
 {
     EDA_RECT bbox = GetBoundingBox();
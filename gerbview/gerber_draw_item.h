@@ -116,9 +116,11 @@ private:
     wxRealPoint m_drawScale;                // A and B scaling factor
     wxPoint     m_layerOffset;              // Offset for A and B axis, from OF parameter
     double      m_lyrRotation;              // Fine rotation, from OR parameter, in degrees
-    GBR_NETLIST_METADATA m_netAttributes;   ///< the string given by a %TO attribute set in aperture
-                                            ///< (dcode). Stored in each item, because %TO is
-                                            ///< a dynamic object attribute
+    const GBR_NETLIST_METADATA* m_netAttributes;    ///< the string given by a %TO attribute set in
+                                                    ///< aperture (dcode). Given to each item,
+                                                    ///< because %TO is a dynamic object attribute.
+                                                    ///< Shared by the items of the image with the
+                                                    ///< same attributes.
 
 public:
     GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberparams );
@@ -128,7 +130,7 @@ public:
     GERBER_DRAW_ITEM* Back() const { return static_cast<GERBER_DRAW_ITEM*>( Pback ); }
 
     void SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
-    const GBR_NETLIST_METADATA& GetNetAttributes() const { return m_netAttributes; }
+    const GBR_NETLIST_METADATA& GetNetAttributes() const { return *m_netAttributes; }
 
     /**
      * Function GetLayer
@@ -237,6 +239,13 @@ public:
 
     const EDA_RECT GetBoundingBox() const override;
 
+    /**
+     * Function GetHitTestBoundingBox
+     * @return a rectangle containing all the positions for which HitTest() can be true.
+     * It can be larger than GetBoundingBox(), because of the minimal hit test radius.
+     */
+    const EDA_RECT GetHitTestBoundingBox() const;
+
     void Print( wxDC* aDC, const wxPoint& aOffset, GBR_DISPLAY_OPTIONS* aOptions );
 
     /**
@@ -299,16 +308,6 @@ public:
         if( list )
             list->Remove( this );
     }
-
-    /**
-     * Function DeleteStructure
-     * deletes this object after UnLink()ing it from its owner.
-     */
-    void DeleteStructure()
-    {
-        UnLink();
-        delete this;
-    }
 #if defined(DEBUG)
     void Show( int nestLevel, std::ostream& os ) const override;
 #endif
@@ -0,0 +1,75 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <gerber_file_buffer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <wx/ffile.h>
+
+
+bool GERBER_FILE_BUFFER::Load( const wxString& aFullFileName )
+{
+    wxFFile file( aFullFileName, wxT( "rb" ) );
+
+    m_data.clear();
+    m_offset = 0;
+
+    if( !file.IsOpened() )
+        return false;
+
+    wxFileOffset length = file.Length();
+
+    if( length > 0 )
+    {
+        m_data.resize( length );
+
+        if( file.Read( &m_data[0], length ) != (size_t) length )
+        {
+            m_data.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+char* GERBER_FILE_BUFFER::ReadLine( char* aBuffer, int aBufferSize )
+{
+    if( m_offset >= m_data.size() || aBufferSize < 2 )
+        return NULL;
+
+    const char* start = m_data.data() + m_offset;
+    size_t      length = std::min( m_data.size() - m_offset, size_t( aBufferSize - 1 ) );
+    const char* eol = static_cast<const char*>( memchr( start, '\n', length ) );
+
+    if( eol )
+        length = eol - start + 1;
+
+    memcpy( aBuffer, start, length );
+    aBuffer[length] = 0;
+    m_offset += length;
+
+    return aBuffer;
+}
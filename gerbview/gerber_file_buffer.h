@@ -0,0 +1,69 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef GERBER_FILE_BUFFER_H
+#define GERBER_FILE_BUFFER_H
+
+#include <string>
+#include <wx/string.h>
+
+/**
+ * A Gerber or drill file read in memory with a single read, and handed out line by line.
+ *
+ * This replaces the many small reads of fgets() on the file, and does not use any shared
+ * state, so files can be parsed on several threads.
+ */
+class GERBER_FILE_BUFFER
+{
+public:
+    GERBER_FILE_BUFFER() :
+        m_offset( 0 )
+    {
+    }
+
+    /**
+     * Read the whole file \a aFullFileName.
+     *
+     * @return false if the file cannot be read.
+     */
+    bool Load( const wxString& aFullFileName );
+
+    /**
+     * Copy the next line of the file, with its line terminator, to \a aBuffer.
+     *
+     * Like fgets(), at most \a aBufferSize - 1 chars are copied and the rest of a longer line
+     * is given by the next call.
+     *
+     * @return aBuffer, or NULL at the end of the file.
+     */
+    char* ReadLine( char* aBuffer, int aBufferSize );
+
+    /// @return the content of the whole file.
+    const std::string& GetData() const { return m_data; }
+
+private:
+    std::string m_data;
+    size_t      m_offset;       ///< Start of the next line in m_data
+};
+
+#endif  // GERBER_FILE_BUFFER_H
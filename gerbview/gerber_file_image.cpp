@@ -96,6 +96,11 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
     m_Selected_Tool = 0;
     m_FileFunction = NULL;          // file function parameters
 
+    m_lastNetAttributes = NULL;
+
+    // Items are owned by m_itemPool
+    m_Drawings.SetOwnership( false );
+
     ResetDefaultValues();
 
     for( unsigned ii = 0; ii < arrayDim( m_Aperture_List ); ii++ )
@@ -105,7 +110,7 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
 
 GERBER_FILE_IMAGE::~GERBER_FILE_IMAGE()
 {
-    m_Drawings.DeleteAll();
+    m_itemPool.Clear();
 
     for( unsigned ii = 0; ii < arrayDim( m_Aperture_List ); ii++ )
     {
@@ -115,6 +120,135 @@ GERBER_FILE_IMAGE::~GERBER_FILE_IMAGE()
     delete m_FileFunction;
 }
 
+void GERBER_DRAW_ITEM_POOL::Clear()
+{
+    for( size_t ii = 0; ii < m_blocks.size(); ii++ )
+    {
+        size_t count = ( ii == m_blocks.size() - 1 ) ? m_blockUsage : ITEMS_PER_BLOCK;
+
+        for( size_t jj = 0; jj < count; jj++ )
+            reinterpret_cast<GERBER_DRAW_ITEM*>( &m_blocks[ii][jj] )->~GERBER_DRAW_ITEM();
+    }
+
+    m_blocks.clear();
+    m_blockUsage = ITEMS_PER_BLOCK;
+}
+
+
+static bool sameNetAttributes( const GBR_NETLIST_METADATA& aFirst,
+                               const GBR_NETLIST_METADATA& aSecond )
+{
+    return aFirst.m_NetAttribType == aSecond.m_NetAttribType
+            && aFirst.m_NotInNet == aSecond.m_NotInNet
+            && aFirst.m_TryKeepPreviousAttributes == aSecond.m_TryKeepPreviousAttributes
+            && aFirst.m_Padname == aSecond.m_Padname
+            && aFirst.m_Cmpref == aSecond.m_Cmpref
+            && aFirst.m_Netname == aSecond.m_Netname
+            && aFirst.m_ExtraData == aSecond.m_ExtraData;
+}
+
+
+const GBR_NETLIST_METADATA* GERBER_FILE_IMAGE::InternNetAttributes(
+        const GBR_NETLIST_METADATA& aNetAttributes )
+{
+    // Consecutive items of a file have most of time the same attributes
+    if( m_lastNetAttributes && sameNetAttributes( *m_lastNetAttributes, aNetAttributes ) )
+        return m_lastNetAttributes;
+
+    // Gerber strings cannot contain a new line, so it can be used as separator
+    wxString key;
+    key << aNetAttributes.m_NetAttribType << ' ' << (int) aNetAttributes.m_NotInNet << ' '
+        << (int) aNetAttributes.m_TryKeepPreviousAttributes << '\n'
+        << aNetAttributes.m_Padname << '\n' << aNetAttributes.m_Cmpref << '\n'
+        << aNetAttributes.m_Netname << '\n' << aNetAttributes.m_ExtraData;
+
+    auto inserted = m_netAttributesPool.emplace( key, aNetAttributes );
+    const GBR_NETLIST_METADATA& netAttributes = inserted.first->second;
+
+    if( inserted.second )
+    {
+        if( ( netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) ||
+            ( netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+            m_ComponentsList.insert( std::make_pair( netAttributes.m_Cmpref, 0 ) );
+
+        if( ( netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+            m_NetnamesList.insert( std::make_pair( netAttributes.m_Netname, 0 ) );
+    }
+
+    m_lastNetAttributes = &netAttributes;
+
+    return m_lastNetAttributes;
+}
+
+
+void GERBER_FILE_IMAGE::BuildItemsIndex()
+{
+    m_itemsIndex.RemoveAll();
+    m_indexedItems.clear();
+    m_macroShapes.clear();
+
+    m_indexedItems.reserve( m_Drawings.GetCount() );
+
+    for( GERBER_DRAW_ITEM* item = GetItemsList(); item; item = item->Next() )
+    {
+        const EDA_RECT bbox = item->GetHitTestBoundingBox();
+        const int      mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int      mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        m_itemsIndex.Insert( mmin, mmax, m_indexedItems.size() );
+        m_indexedItems.push_back( item );
+    }
+}
+
+
+std::vector<GERBER_DRAW_ITEM*> GERBER_FILE_IMAGE::GetItemsAt( const wxPoint& aPosition )
+{
+    if( m_indexedItems.size() != m_Drawings.GetCount() )
+        BuildItemsIndex();
+
+    std::vector<size_t> found;
+    const int           pos[2] = { aPosition.x, aPosition.y };
+
+    m_itemsIndex.Search( pos, pos, [&found]( const size_t& aIndex )
+                                   {
+                                       found.push_back( aIndex );
+                                       return true;
+                                   } );
+
+    std::sort( found.begin(), found.end() );
+
+    std::vector<GERBER_DRAW_ITEM*> items;
+    items.reserve( found.size() );
+
+    for( size_t index : found )
+        items.push_back( m_indexedItems[index] );
+
+    return items;
+}
+
+
+const SHAPE_POLY_SET& GERBER_FILE_IMAGE::GetMacroShape( const GERBER_DRAW_ITEM* aItem )
+{
+    auto it = m_macroShapes.find( aItem );
+
+    if( it == m_macroShapes.end() )
+    {
+        SHAPE_POLY_SET& shape = m_macroShapes[aItem];
+        D_CODE*         code = aItem->GetDcodeDescr();
+
+        if( code && code->GetMacro() )
+        {
+            shape = *code->GetMacro()->GetApertureMacroShape( aItem, aItem->m_Start );
+            shape.BuildBBoxCaches();
+        }
+
+        return shape;
+    }
+
+    return it->second;
+}
+
+
 /*
  * Function GetItemsList
  * returns the first GERBER_DRAW_ITEM * item of the items list
@@ -312,14 +446,13 @@ void GERBER_FILE_IMAGE::StepAndRepeatItem( const GERBER_DRAW_ITEM& aItem )
             // create duplicate only if ii or jj > 0
             if( jj == 0 && ii == 0 )
                 continue;
-            GERBER_DRAW_ITEM* dupItem = new GERBER_DRAW_ITEM( aItem );
+            GERBER_DRAW_ITEM* dupItem = AddItemCopy( aItem );
             wxPoint           move_vector;
             move_vector.x = scaletoIU( ii * GetLayerParams().m_StepForRepeat.x,
                                    GetLayerParams().m_StepForRepeatMetric );
             move_vector.y = scaletoIU( jj * GetLayerParams().m_StepForRepeat.y,
                                    GetLayerParams().m_StepForRepeatMetric );
             dupItem->MoveXY( move_vector );
-            m_Drawings.Append( dupItem );
         }
     }
 }
@@ -27,6 +27,11 @@
 
 #include <vector>
 #include <set>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+
+#include <geometry/rtree.h>
 
 #include <dcode.h>
 #include <gerber_draw_item.h>
@@ -39,6 +44,7 @@
 
 class GERBVIEW_FRAME;
 class D_CODE;
+class GERBER_FILE_BUFFER;
 
 /* gerber files have different parameters to define units and how items must be plotted.
  *  some are for the entire file, and other can change along a file.
@@ -99,6 +105,59 @@ private:
     void ResetDefaultValues();
 };
 
+/**
+ * Storage of the GERBER_DRAW_ITEMs of an image.
+ *
+ * Items are built in large blocks instead of being allocated one by one, which keeps them
+ * contiguous in memory and saves the allocation overhead of each of the (many) items.
+ * Items are never deleted one by one: they all live as long as the pool.
+ */
+class GERBER_DRAW_ITEM_POOL
+{
+public:
+    GERBER_DRAW_ITEM_POOL() :
+        m_blockUsage( ITEMS_PER_BLOCK )
+    {
+    }
+
+    ~GERBER_DRAW_ITEM_POOL() { Clear(); }
+
+    /**
+     * Build a new item in the pool.
+     * @param aArgs are the arguments of the GERBER_DRAW_ITEM constructor.
+     */
+    template <typename... Args>
+    GERBER_DRAW_ITEM* Create( Args&&... aArgs )
+    {
+        if( m_blockUsage == ITEMS_PER_BLOCK )
+        {
+            m_blocks.emplace_back( new STORAGE[ITEMS_PER_BLOCK] );
+            m_blockUsage = 0;
+        }
+
+        GERBER_DRAW_ITEM* item = new( &m_blocks.back()[m_blockUsage] )
+                                        GERBER_DRAW_ITEM( std::forward<Args>( aArgs )... );
+        m_blockUsage++;
+
+        return item;
+    }
+
+    /**
+     * Destroy all the items of the pool.
+     */
+    void Clear();
+
+private:
+    static const size_t ITEMS_PER_BLOCK = 1024;
+
+    typedef std::aligned_storage<sizeof( GERBER_DRAW_ITEM ),
+                                 alignof( GERBER_DRAW_ITEM )>::type STORAGE;
+
+    std::vector<std::unique_ptr<STORAGE[]>> m_blocks;
+    size_t                                  m_blockUsage;   ///< Items built in the last block
+};
+
+
 /**
  * Class GERBER_FILE_IMAGE
  * holds the Image data and parameters for one gerber file
@@ -114,6 +173,7 @@ class GERBER_FILE_IMAGE : public EDA_ITEM
 
 public:
     DLIST<GERBER_DRAW_ITEM> m_Drawings;                         // linked list of Gerber Items to draw
+                                                                // (the items are owned by m_itemPool)
 
     bool               m_InUse;                                 // true if this image is currently in use
                                                                 // (a file is loaded in it)
@@ -158,7 +218,7 @@ public:
     bool               m_LastCoordIsIJPos;                      // true if a IJ coord was read (for arcs & circles )
     int                m_ArcRadius;                             // A value ( = radius in circular routing in Excellon files )
     LAST_EXTRA_ARC_DATA_TYPE m_LastArcDataType;                 // Identifier for arc data type (IJ (center) or A## (radius))
-    FILE*              m_Current_File;                          // Current file to read
+    GERBER_FILE_BUFFER* m_Current_File;                         // Current file to read
 
     int                m_Selected_Tool;                         // For highlight: current selected Dcode
     bool               m_Has_DCode;                             // true = DCodes in file
@@ -178,6 +238,15 @@ public:
     std::map<wxString, int> m_NetnamesList;                     // list of net names
 
 private:
+    GERBER_DRAW_ITEM_POOL m_itemPool;                           // storage of the items of m_Drawings
+    std::unordered_map<wxString, GBR_NETLIST_METADATA> m_netAttributesPool;
+                                                                // net attributes shared by the items
+    const GBR_NETLIST_METADATA* m_lastNetAttributes;            // last net attributes given to an item
+    RTree<size_t, int, 2, double> m_itemsIndex;                 // spatial index of the hit test areas
+                                                                // of the items (indices in m_indexedItems)
+    std::vector<GERBER_DRAW_ITEM*> m_indexedItems;              // the items of m_itemsIndex, in list order
+    std::unordered_map<const GERBER_DRAW_ITEM*, SHAPE_POLY_SET> m_macroShapes;
+                                                                // aperture macro shapes of the hit tested items
     wxArrayString      m_messagesList;                          // A list of messages created when reading a file
     int                m_hasNegativeItems;                      // true if the image is negative or has some negative items
                                                                 // Used to optimize drawing, because when there are no
@@ -197,9 +266,10 @@ private:
      * @param aFile = the opened GERBER file to read
      * @return a pointer to the beginning of the next line or NULL if end of file
     */
-    char* GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText, FILE* aFile );
+    char* GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText, GERBER_FILE_BUFFER* aFile );
 
-    bool GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText, FILE* aGerberFile );
+    bool GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText,
+                        GERBER_FILE_BUFFER* aGerberFile );
 
     /**
       * reads a single RS274X command terminated with a %
@@ -233,7 +303,7 @@ private:
      * @return bool - true if a macro was read in successfully, else false.
      */
     bool ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
-                            char* & text, FILE * gerber_file );
+                            char* & text, GERBER_FILE_BUFFER* gerber_file );
 
     // functions to execute G commands or D basic commands:
     bool    Execute_G_Command( char*& text, int G_command );
@@ -276,6 +346,61 @@ public:
      */
     GERBER_DRAW_ITEM * GetItemsList();
 
+    /**
+     * Function AddNewItem
+     * creates a new item of this image and appends it to the items list.
+     * The item is owned by the image.
+     */
+    GERBER_DRAW_ITEM* AddNewItem()
+    {
+        GERBER_DRAW_ITEM* item = m_itemPool.Create( this );
+        m_Drawings.Append( item );
+        return item;
+    }
+
+    /**
+     * Function AddItemCopy
+     * creates a copy of \a aItem and appends it to the items list.
+     * The copy is owned by the image.
+     */
+    GERBER_DRAW_ITEM* AddItemCopy( const GERBER_DRAW_ITEM& aItem )
+    {
+        GERBER_DRAW_ITEM* item = m_itemPool.Create( aItem );
+        m_Drawings.Append( item );
+        return item;
+    }
+
+    /**
+     * Function BuildItemsIndex
+     * builds the spatial index of the items, used by GetItemsAt().
+     * Called when the file is read: the index is rebuilt by GetItemsAt() if items are added
+     * later.
+     */
+    void BuildItemsIndex();
+
+    /**
+     * Function GetItemsAt
+     * @return the items which can be hit at \a aPosition, in the order of the items list.
+     * They are only candidates: their HitTest() tells if they are actually hit.
+     */
+    std::vector<GERBER_DRAW_ITEM*> GetItemsAt( const wxPoint& aPosition );
+
+    /**
+     * Function GetMacroShape
+     * @return the aperture macro shape of the flashed item \a aItem, with its bounding box
+     * caches built, to test if a position is inside.  The shape is kept for next calls.
+     */
+    const SHAPE_POLY_SET& GetMacroShape( const GERBER_DRAW_ITEM* aItem );
+
+    /**
+     * Function InternNetAttributes
+     * gives the net attributes of an item.  Items with the same net attributes share
+     * the same copy, stored in the image, instead of having their own copy.
+     * @param aNetAttributes are the attributes to store.
+     * @return the stored copy of \a aNetAttributes.
+     */
+    const GBR_NETLIST_METADATA* InternNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
+
     /**
      * Function GetLayerParams
      * @return the current layers params
@@ -45,6 +45,7 @@ class GBR_LAYER_BOX_SELECTOR;
 class GERBER_DRAW_ITEM;
 class GERBER_FILE_IMAGE;
 class GERBER_FILE_IMAGE_LIST;
+class EXCELLON_IMAGE;
 class REPORTER;
 
 
@@ -508,7 +509,16 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadGerberFiles( const wxString& aFileName );
-    bool Read_GERBER_File( const wxString&   GERBER_FullFileName );
+
+    /**
+     * Load a Gerber file on the active layer.
+     * @param GERBER_FullFileName is the file to load.
+     * @param aImage is the image of the file if it has already been read (the frame takes
+     *               ownership of it), or nullptr to read the file.
+     * @return true if file was loaded successfully.
+     */
+    bool Read_GERBER_File( const wxString& GERBER_FullFileName,
+                           GERBER_FILE_IMAGE* aImage = nullptr );
 
     /**
      * function LoadExcellonFiles
@@ -519,7 +529,15 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadExcellonFiles( const wxString& aFileName );
-    bool Read_EXCELLON_File( const wxString& aFullFileName );
+
+    /**
+     * Load a drill (EXCELLON) file on the active layer.
+     * @param aFullFileName is the file to load.
+     * @param aImage is the image of the file if it has already been read (the frame takes
+     *               ownership of it), or nullptr to read the file.
+     * @return true if file was loaded successfully.
+     */
+    bool Read_EXCELLON_File( const wxString& aFullFileName, EXCELLON_IMAGE* aImage = nullptr );
 
     /**
      * function LoadZipArchiveFileLoadZipArchiveFile
@@ -57,7 +57,7 @@ GERBER_DRAW_ITEM* GERBVIEW_FRAME::Locate( const wxPoint& aPosition, int aTypeloc
     // A not used graphic layer can be selected. So gerber can be NULL
     if( gerber && gerber->m_IsVisible )
     {
-        for( auto item = gerber->GetItemsList(); item; item = item->Next() )
+        for( auto item : gerber->GetItemsAt( ref ) )
         {
             if( item->HitTest( ref ) )
             {
@@ -82,7 +82,7 @@ GERBER_DRAW_ITEM* GERBVIEW_FRAME::Locate( const wxPoint& aPosition, int aTypeloc
             if( layer == GetActiveLayer() )
                 continue;
 
-            for( auto item = gerber->GetItemsList(); item; item = item->Next() )
+            for( auto item : gerber->GetItemsAt( ref ) )
             {
                 if( item->HitTest( ref ) )
                 {
@@ -29,6 +29,7 @@
 #include <gerbview.h>
 #include <gerbview_frame.h>
 #include <gerber_file_image.h>
+#include <gerber_file_buffer.h>
 #include <gerber_file_image_list.h>
 #include <view/view.h>
 
@@ -37,7 +38,8 @@
 
 /* Read a gerber file, RS274D, RS274X or RS274X2 format.
  */
-bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
+bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName,
+                                       GERBER_FILE_IMAGE* aImage )
 {
     wxString msg;
 
@@ -50,18 +52,27 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         Erase_Current_DrawLayer( false );
     }
 
-    gerber = new GERBER_FILE_IMAGE( layer );
+    if( aImage )
+    {
+        // The file is already read: only move it to the active layer
+        gerber = aImage;
+        gerber->m_GraphicLayer = layer;
+    }
+    else
+    {
+        gerber = new GERBER_FILE_IMAGE( layer );
 
-    // Read the gerber file. The image will be added only if it can be read
-    // to avoid broken data.
-    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
+        // Read the gerber file. The image will be added only if it can be read
+        // to avoid broken data.
+        bool success = gerber->LoadGerberFile( GERBER_FullFileName );
 
-    if( !success )
-    {
-        delete gerber;
-        msg.Printf( _( "File \"%s\" not found" ), GERBER_FullFileName );
-        DisplayError( this, msg, 10 );
-        return false;
+        if( !success )
+        {
+            delete gerber;
+            msg.Printf( _( "File \"%s\" not found" ), GERBER_FullFileName );
+            DisplayError( this, msg, 10 );
+            return false;
+        }
     }
 
     images->AddGbrImage( gerber, layer );
@@ -105,8 +116,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -117,21 +126,27 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     ClearMessageList( );
     ResetDefaultValues();
 
-    // Read the gerber file */
-    m_Current_File = wxFopen( aFullFileName, wxT( "rt" ) );
+    // Read the whole gerber file at once
+    GERBER_FILE_BUFFER file;
 
-    if( m_Current_File == 0 )
+    if( !file.Load( aFullFileName ) )
         return false;
 
+    m_Current_File = &file;
     m_FileName = aFullFileName;
 
     LOCALE_IO toggleIo;
 
     wxString msg;
 
+    // A large buffer to store one line.  It is not shared, so files can be read
+    // by several threads.
+    std::vector<char> buffer( GERBER_BUFZ + 1 );
+    char*             lineBuffer = buffer.data();
+
     while( true )
     {
-        if( fgets( lineBuffer, GERBER_BUFZ, m_Current_File ) == NULL )
+        if( file.ReadLine( lineBuffer, GERBER_BUFZ ) == NULL )
             break;
 
         m_LineNum++;
@@ -211,7 +226,9 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
         }
     }
 
-    fclose( m_Current_File );
+    m_Current_File = NULL;
+
+    BuildItemsIndex();
 
     m_InUse = true;
 
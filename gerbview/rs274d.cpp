@@ -340,7 +340,7 @@ static void fillArcPOLY(  GERBER_DRAW_ITEM* aGbrItem,
     /* in order to calculate arc parameters, we use fillArcGBRITEM
      * so we muse create a dummy track and use its geometric parameters
      */
-    static GERBER_DRAW_ITEM dummyGbrItem( NULL );
+    GERBER_DRAW_ITEM dummyGbrItem( NULL );
 
     aGbrItem->SetLayerPolarity( aLayerNegative );
 
@@ -615,8 +615,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             if( !m_Exposure )   // Start a new polygon outline:
             {
                 m_Exposure = true;
-                gbritem    = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem = AddNewItem();
                 gbritem->m_Shape = GBR_POLYGON;
                 gbritem->m_Flashed = false;
                 gbritem->m_DCode = 0;   // No DCode for a Polygon (Region in Gerber dialect)
@@ -695,8 +694,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             switch( m_Iterpolation )
             {
             case GERB_INTERPOL_LINEAR_1X:
-                gbritem = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem = AddNewItem();
 
                 fillLineGBRITEM( gbritem, dcode, m_PreviousPos,
                                  m_CurrentPos, size, GetLayerParams().m_LayerNegative );
@@ -705,8 +703,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
 
             case GERB_INTERPOL_ARC_NEG:
             case GERB_INTERPOL_ARC_POS:
-                gbritem = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem = AddNewItem();
 
                 if( m_LastCoordIsIJPos )
                 {
@@ -750,8 +747,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
                 aperture = tool->m_Shape;
             }
 
-            gbritem = new GERBER_DRAW_ITEM( this );
-            m_Drawings.Append( gbritem );
+            gbritem = AddNewItem();
             fillFlashedGBRITEM( gbritem, aperture, dcode, m_CurrentPos,
                                 size, GetLayerParams().m_LayerNegative );
             StepAndRepeatItem( *gbritem );
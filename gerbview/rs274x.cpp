@@ -33,6 +33,7 @@
 
 #include <gerbview.h>
 #include <gerber_file_image.h>
+#include <gerber_file_buffer.h>
 #include <X2_gerber_attributes.h>
 
 extern int ReadInt( char*& text, bool aSkipSeparator = true );
@@ -221,7 +222,7 @@ bool GERBER_FILE_IMAGE::ReadRS274XCommand( char *aBuff, unsigned int aBuffSize,
         }
 
         // end of current line, read another one.
-        if( fgets( aBuff, aBuffSize, m_Current_File ) == NULL )
+        if( m_Current_File->ReadLine( aBuff, aBuffSize ) == NULL )
         {
             // end of file
             ok = false;
@@ -897,7 +898,8 @@ bool GERBER_FILE_IMAGE::ExecuteRS274XCommand( int aCommand, char* aBuff,
 }
 
 
-bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText, FILE* gerber_file )
+bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char*& aText,
+                                       GERBER_FILE_BUFFER* gerber_file )
 {
     for( ; ; )
     {
@@ -912,7 +914,7 @@ bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char
             aText++;
         }
 
-        if( fgets( aBuff, aBuffSize, gerber_file ) == NULL )
+        if( gerber_file->ReadLine( aBuff, aBuffSize ) == NULL )
             break;
 
         m_LineNum++;
@@ -923,7 +925,8 @@ bool GERBER_FILE_IMAGE::GetEndOfBlock( char* aBuff, unsigned int aBuffSize, char
 }
 
 
-char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText, FILE* aFile )
+char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char* aText,
+                                      GERBER_FILE_BUFFER* aFile )
 {
     for( ; ; )
     {
@@ -936,7 +939,7 @@ char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char*
                 break;
 
             case 0:    // End of text found in aBuff: Read a new string
-                if( fgets( aBuff, aBuffSize, aFile ) == NULL )
+                if( aFile->ReadLine( aBuff, aBuffSize ) == NULL )
                     return NULL;
 
                 m_LineNum++;
@@ -953,7 +956,7 @@ char* GERBER_FILE_IMAGE::GetNextLine( char *aBuff, unsigned int aBuffSize, char*
 
 bool GERBER_FILE_IMAGE::ReadApertureMacro( char *aBuff, unsigned int aBuffSize,
                                 char*&    aText,
-                                FILE*     gerber_file )
+                                GERBER_FILE_BUFFER* gerber_file )
 {
     wxString       msg;
     APERTURE_MACRO am;
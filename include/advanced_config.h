@@ -78,11 +78,26 @@ public:
      */
     bool m_realTimeConnectivity;
 
+    /**
+     * Check each incremental connectivity recalculation against a full one
+     */
+    bool m_verifyIncrementalConnectivity;
+
     /**
      * Set the stack size for coroutines
      */
     int m_coroutineStackSize;
 
+    /**
+     * Memory budget for the 3D models kept in memory, in MB (0 for no limit)
+     */
+    int m_3DModelCacheBudget;
+
+    /**
+     * Use the coarse to fine search of the footprint positions in the autoplacer
+     */
+    bool m_autoplaceCoarseToFine;
+
     /**
      * Helper to determine if legacy canvas is allowed (according to platform
      * and config)
@@ -75,10 +75,17 @@ protected:
 
     static int getNextNumberInSequence( const std::set<int>& aSeq, bool aFillSequenceGaps );
 
+private:
+    friend class BOARD;
+
+    /// Position in the list of the board when it was last looked for, only a hint checked
+    /// against the list (see BOARD::GetItemIndex())
+    mutable int     m_listIndex;
+
 public:
 
     BOARD_ITEM( BOARD_ITEM* aParent, KICAD_T idtype ) :
-        EDA_ITEM( aParent, idtype ), m_Layer( F_Cu )
+        EDA_ITEM( aParent, idtype ), m_Layer( F_Cu ), m_listIndex( -1 )
     {
     }
 
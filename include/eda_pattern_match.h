@@ -170,12 +170,19 @@ public:
 
     wxString const& GetPattern() const;
 
+    /**
+     * @return true if the pattern has no regular expression, wildcard nor relational
+     * syntax, so every matcher finds it where it appears as a substring, and only there.
+     */
+    bool IsLiteral() const { return m_literal; }
+
 private:
     // Add matcher if it can compile the pattern.
     void AddMatcher( const wxString &aPattern, std::unique_ptr<EDA_PATTERN_MATCH> aMatcher );
 
     std::vector<std::unique_ptr<EDA_PATTERN_MATCH>> m_matchers;
     wxString m_pattern;
+    bool     m_literal;
 };
 
 #endif  // EDA_PATTERN_MATCH_H
@@ -0,0 +1,63 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CAIRO_IMAGE_H_
+#define _CAIRO_IMAGE_H_
+
+#include <gal/cairo/cairo_gal.h>
+
+class wxImage;
+
+namespace KIGFX
+{
+/**
+ * CAIRO_IMAGE_GAL draws to an in-memory Cairo image surface.
+ * It does not need a window nor a GPU, so it can be used to render snapshots
+ * from command line tools or from worker threads (one GAL per thread).
+ */
+class CAIRO_IMAGE_GAL : public CAIRO_GAL_BASE
+{
+public:
+    /**
+     * @param aDisplayOptions are the display options. Note they keep a list of the GALs
+     * observing them, so a GAL should be created and destroyed from a single thread.
+     * @param aWidth is the image width in pixels.
+     * @param aHeight is the image height in pixels.
+     */
+    CAIRO_IMAGE_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions, int aWidth, int aHeight );
+
+    /// @copydoc GAL::ResizeScreen()
+    void ResizeScreen( int aWidth, int aHeight ) override;
+
+    cairo_surface_t* GetSurface() const
+    {
+        return surface;
+    }
+
+    /**
+     * Copy the drawn pixels to a wxImage.
+     * @param aImage is the destination image, it must be already allocated. Pixels falling
+     * outside of the image are skipped.
+     * @param aOrigin is the position in aImage of the top left pixel of the GAL screen.
+     */
+    void CopyToImage( wxImage& aImage, const VECTOR2I& aOrigin = VECTOR2I( 0, 0 ) );
+};
+} // namespace KIGFX
+
+#endif /* _CAIRO_IMAGE_H_ */
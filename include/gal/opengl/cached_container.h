@@ -26,8 +26,10 @@
 #define CACHED_CONTAINER_H_
 
 #include <gal/opengl/vertex_container.h>
-#include <map>
-#include <set>
+#include <array>
+#include <functional>
+#include <unordered_map>
+#include <vector>
 
 namespace KIGFX
 {
@@ -38,6 +40,12 @@ class SHADER;
  * @brief Class to store VERTEX instances with caching. It associates VERTEX
  * objects and with VERTEX_ITEMs. Caching vertices data in the memory and a
  * enables fast reuse of that data.
+ *
+ * Memory is handed out in chunks rounded up to a size class (four classes per power of two),
+ * so a freed chunk can be reused by any item of the same class. Allocating and freeing a chunk
+ * costs O(1): chunks are taken from the free list of their class or from the end of the used
+ * area. Free chunks left in the middle are reclaimed a few at a time by moving the chunks found
+ * at the end of the used area into them.
  */
 
 class CACHED_CONTAINER : public VERTEX_CONTAINER
@@ -57,7 +65,13 @@ public:
     ///> @copydoc VERTEX_CONTAINER::FinishItem()
     virtual void FinishItem() override;
 
-    ///> @copydoc VERTEX_CONTAINER::Allocate()
+    /**
+     * @copydoc VERTEX_CONTAINER::Allocate()
+     *
+     * The vertices are stored in a staging buffer until FinishItem() is called, then they are
+     * copied to the container in a single chunk. This way an item made of many primitives does
+     * not have to be moved each time it grows.
+     */
     virtual VERTEX* Allocate( unsigned int aSize ) override;
 
     ///> @copydoc VERTEX_CONTAINER::Delete()
@@ -82,86 +96,137 @@ public:
     ///> @copydoc VERTEX_CONTAINER::Unmap()
     virtual void Unmap() override = 0;
 
+    ///> Allocator counters, for profiling
+    struct STATS
+    {
+        unsigned int m_allocations;         ///< Chunks allocated
+        unsigned int m_reuses;              ///< Chunks taken from a free list
+        unsigned int m_reallocations;       ///< Items moved to a larger chunk
+        unsigned int m_compactionMoves;     ///< Items moved by the incremental compaction
+        unsigned int m_defragmentations;    ///< Full defragmentations, with or without resizing
+    };
+
+    const STATS& GetStats() const
+    {
+        return m_stats;
+    }
+
+    /**
+     * Returns the number of vertices held by free chunks placed between the used ones.
+     */
+    unsigned int GetFragmentedSpace() const
+    {
+        return m_fragmentedSpace;
+    }
+
+    /**
+     * Returns the number of vertices reserved by the chunks but not used by their items.
+     */
+    unsigned int GetWastedSpace() const
+    {
+        return m_wastedSpace;
+    }
+
 protected:
-    ///> Maps size of free memory chunks to their offsets
-    typedef std::pair<unsigned int, unsigned int> CHUNK;
-    typedef std::multimap<unsigned int, unsigned int> FREE_CHUNK_MAP;
+    ///> Number of size classes, enough for any 32 bit chunk size
+    static constexpr unsigned int SIZE_CLASSES = 128;
+
+    ///> Maximal number of chunks moved by a single incremental compaction step
+    static constexpr unsigned int COMPACTION_STEP = 32;
+
+    ///> Describes a chunk, stored under the offset of its end
+    struct CHUNK
+    {
+        VERTEX_ITEM* m_item;        ///< Owner of the chunk, NULL for a free chunk
+        unsigned int m_sizeClass;
+    };
 
-    /// List of all the stored items
-    typedef std::set<VERTEX_ITEM*> ITEMS;
+    typedef std::unordered_map<unsigned int, CHUNK> CHUNK_MAP;
 
-    ///> Stores size & offset of free chunks.
-    FREE_CHUNK_MAP  m_freeChunks;
+    ///> All the chunks placed below m_maxIndex, indexed by their end offset
+    CHUNK_MAP m_chunks;
 
-    ///> Stored VERTEX_ITEMs
-    ITEMS m_items;
+    ///> Offsets of free chunks for each size class. Entries are checked against m_chunks
+    ///> when they are taken, as chunks trimmed from the end of the used area stay listed.
+    std::array<std::vector<unsigned int>, SIZE_CLASSES> m_freeLists;
 
     ///> Currently modified item
     VERTEX_ITEM* m_item;
 
-    ///> Properties of currently modified chunk & item
-    unsigned int m_chunkSize;
-    unsigned int m_chunkOffset;
-
-    ///> Maximal vertex index number stored in the container
+    ///> End of the used area, everything above is free
     unsigned int m_maxIndex;
 
+    ///> Vertices of the currently modified item, not yet stored in the container
+    std::vector<VERTEX> m_staging;
+
+    ///> Size of the free chunks below m_maxIndex
+    unsigned int m_fragmentedSpace;
+
+    ///> Difference between the chunk sizes and the item sizes
+    unsigned int m_wastedSpace;
+
+    STATS m_stats;
+
     /**
-     * Resizes the chunk that stores the current item to the given size. The current item has
-     * its offset adjusted after the call, and the new chunk parameters are stored
-     * in m_chunkOffset and m_chunkSize.
-     *
-     * @param aSize is the requested chunk size.
-     * @return true in case of success, false otherwise
+     * Returns the size class for a number of vertices.
      */
-    bool reallocate( unsigned int aSize );
+    static unsigned int sizeClass( unsigned int aSize );
 
     /**
-     * Removes empty spaces between chunks and optionally resizes the container.
-     * After the operation there is continous space for storing vertices at the end of the container.
+     * Returns the chunk size (expressed in vertices) for a size class.
+     */
+    static unsigned int classSize( unsigned int aSizeClass )
+    {
+        return ( 4 + aSizeClass % 4 ) << ( aSizeClass / 4 );
+    }
+
+    /**
+     * Allocates a chunk large enough to store the given number of vertices, growing the
+     * container if needed. Other chunks (including the ones owned by the current item) may be
+     * moved during the call.
      *
-     * @param aNewSize is the new size of container, expressed in number of vertices
-     * @return false in case of failure (e.g. memory shortage)
+     * @param aSize is the requested number of vertices.
+     * @param aOffset receives the offset of the chunk.
+     * @return true in case of success, false otherwise
      */
-    virtual bool defragmentResize( unsigned int aNewSize ) = 0;
+    bool allocateChunk( unsigned int aSize, unsigned int& aOffset );
 
     /**
-     * Transfers all stored data to a new buffer, removing empty spaces between the data chunks
-     * in the container.
-     * @param aTarget is the destination for the defragmented data.
+     * Returns the chunk storing an item to the free space pool.
      */
-    void defragment( VERTEX* aTarget );
+    void freeChunk( unsigned int aOffset, unsigned int aSize );
 
     /**
-     * Looks for consecutive free memory chunks and merges them, decreasing fragmentation of
-     * memory.
+     * Moves the chunks found at the end of the used area to the free chunks of the same size
+     * class, so the free space is gathered at the end of the container.
+     * Does nothing until there is enough fragmented space to be worth the work.
      */
-    void mergeFreeChunks();
+    void compactStep();
 
     /**
-     * Returns the size of a chunk.
+     * Places all the used chunks one after another and updates the item offsets. Free chunk
+     * lists are emptied, so all the free space is left at the end of the used area.
      *
-     * @param aChunk is the chunk.
+     * @param aCopy moves the vertices of an item; called with the source offset,
+     * the destination offset and the number of vertices.
      */
-    inline int getChunkSize( const CHUNK& aChunk ) const
-    {
-        return aChunk.first;
-    }
+    void relocateChunks( std::function<void( unsigned int, unsigned int, unsigned int )> aCopy );
 
     /**
-     * Returns the offset of a chunk.
+     * Removes empty spaces between chunks and optionally resizes the container.
+     * After the operation there is continous space for storing vertices at the end of the container.
      *
-     * @param aChunk is the chunk.
+     * @param aNewSize is the new size of container, expressed in number of vertices
+     * @return false in case of failure (e.g. memory shortage)
      */
-    inline unsigned int getChunkOffset( const CHUNK& aChunk ) const
-    {
-        return aChunk.second;
-    }
+    virtual bool defragmentResize( unsigned int aNewSize ) = 0;
 
     /**
-     * Adds a chunk marked as a free space.
+     * Transfers all stored data to a new buffer, removing empty spaces between the data chunks
+     * in the container.
+     * @param aTarget is the destination for the defragmented data.
      */
-    void addFreeChunk( unsigned int aOffset, unsigned int aSize );
+    void defragment( VERTEX* aTarget );
 
 private:
     /// Debug & test functions
@@ -31,6 +31,7 @@
 
 #include <deque>
 #include <algorithm>
+#include <memory>
 
 #include <utf8.h>
 
@@ -49,6 +50,10 @@ typedef std::vector<GLYPH>                 GLYPH_LIST;
  * @brief Class STROKE_FONT implements stroke font drawing.
  *
  * A stroke font is composed of lines.
+ *
+ * The glyphs are shared by all the fonts loaded from the same data, together with a cache of
+ * the strokes computed for the recently drawn lines of text, so the GAL canvases and the
+ * plotters reuse the geometry of texts drawn with the same size, thickness and style.
  */
 class STROKE_FONT
 {
@@ -115,9 +120,14 @@ public:
 
 
 private:
+    ///> Glyphs and cached text geometry, shared by the fonts loaded from the same data
+    struct FONT_DATA;
+
+    ///> Strokes of a single line of text, ready to be drawn
+    struct LINE_GEOMETRY;
+
     GAL*                m_gal;                  ///< Pointer to the GAL
-    GLYPH_LIST          m_glyphs;               ///< Glyph list
-    std::vector<BOX2D>  m_glyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+    FONT_DATA*          m_font;                 ///< Glyphs and cache, owned by the font registry
 
     /**
      * @brief Compute the X and Y size of a given text. The text is expected to be
@@ -152,6 +162,14 @@ private:
      */
     void drawSingleLineText( const UTF8& aText );
 
+    /**
+     * @brief Returns the strokes of a single line of text drawn with the current GAL text
+     * attributes, from the cache if they were computed before.
+     *
+     * @param aText is the text (one line).
+     */
+    std::shared_ptr<const LINE_GEOMETRY> getLineGeometry( const UTF8& aText ) const;
+
     /**
      * @brief Returns number of lines for a given text.
      *
@@ -182,6 +200,9 @@ private:
 
     ///> Factor that determines the pitch between 2 lines.
     static const double INTERLINE_PITCH_RATIO;
+
+    ///> Maximal number of lines of text kept in the geometry cache
+    static const size_t MAX_CACHED_LINES;
 };
 } // namespace KIGFX
 
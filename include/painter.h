@@ -359,6 +359,16 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function PrepareDraw
+     * Computes the data needed to draw an item that does not depend on the GAL state (e.g.
+     * polygon triangulations), so the following Draw() calls have less work to do.
+     * VIEW calls it from several threads at once for different items, so it must not modify
+     * anything but the given item.
+     * @param aItem is an item that is going to be drawn.
+     */
+    virtual void PrepareDraw( VIEW_ITEM* aItem ) {}
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
@@ -33,6 +33,7 @@
 #define PLOT_COMMON_H_
 
 #include <vector>
+#include <unordered_map>
 #include <math/box2.h>
 #include <gr_text.h>
 #include <page_info.h>
@@ -1305,6 +1306,13 @@ protected:
      */
     void emitDcode( const DPOINT& pt, int dcode );
 
+    /**
+     * Emit the D01 records drawing from the current position to the corners of aCornerList,
+     * from aCornerList[1] to the last one, and back to aCornerList[0] if aClose is true.
+     * The records are formatted in a buffer written to the file at once.
+     */
+    void emitPolyline( const std::vector<wxPoint>& aCornerList, bool aClose );
+
     /**
      * print a Gerber net attribute object record.
      * In a gerber file, a net attribute is owned by a graphic object
@@ -1357,6 +1365,38 @@ protected:
     std::vector<APERTURE>           apertures;
     std::vector<APERTURE>::iterator currentAperture;
 
+    /// Key of the aperture hash table: the type, size and attribute of an aperture
+    struct APERTURE_KEY
+    {
+        int m_Type;
+        int m_SizeX;
+        int m_SizeY;
+        int m_ApertureAttribute;
+
+        bool operator==( const APERTURE_KEY& aOther ) const
+        {
+            return m_Type == aOther.m_Type && m_SizeX == aOther.m_SizeX
+                   && m_SizeY == aOther.m_SizeY
+                   && m_ApertureAttribute == aOther.m_ApertureAttribute;
+        }
+    };
+
+    struct APERTURE_KEY_HASH
+    {
+        size_t operator()( const APERTURE_KEY& aKey ) const
+        {
+            size_t hash = std::hash<int>()( aKey.m_Type );
+
+            for( int value : { aKey.m_SizeX, aKey.m_SizeY, aKey.m_ApertureAttribute } )
+                hash = hash * 31 + std::hash<int>()( value );
+
+            return hash;
+        }
+    };
+
+    /// Index in apertures of each aperture, to find them without searching the whole list
+    std::unordered_map<APERTURE_KEY, size_t, APERTURE_KEY_HASH> m_apertureIndex;
+
     bool     m_gerberUnitInch;  // true if the gerber units are inches, false for mm
     int      m_gerberUnitFmt;   // number of digits in mantissa.
                                 // usually 6 in Inches and 5 or 6  in mm
@@ -107,6 +107,16 @@ public:
      */
     virtual int Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) const;
 
+    /**
+     * Function QueryAll()
+     * Finds all items that touch or are within the rectangle aRect, on the visible and hidden
+     * layers. Items placed on several layers are reported once for each of them.
+     * Display only layers are not searched.
+     * @param aRect area to search for items
+     * @param aResult result of the search.
+     */
+    void QueryAll( const BOX2I& aRect, std::vector<VIEW_ITEM*>& aResult ) const;
+
     /**
      * Sets the item visibility.
      *
@@ -677,6 +687,27 @@ public:
         m_reverseDrawOrder = aFlag;
     }
 
+    /**
+     * Function SetAggregationThreshold()
+     * Sets the size below which groups of items are drawn as a single item. Groups are formed
+     * by the spatial index, so all the items of a group fall within the same pixel or so.
+     * The picture is close to the one with all the items drawn, but not the same: items
+     * drawn with a translucent color do not add up anymore, and the pixel takes the color
+     * of the item standing for the group. Selected, brightened and highlighted items are
+     * still drawn, and grouping is disabled when a net is highlighted and in the printing
+     * mode.
+     * @param aPixels is the size expressed in pixels, 0 disables grouping.
+     */
+    void SetAggregationThreshold( double aPixels )
+    {
+        m_aggregationThreshold = aPixels;
+    }
+
+    double GetAggregationThreshold() const
+    {
+        return m_aggregationThreshold;
+    }
+
     std::shared_ptr<VIEW_OVERLAY> MakeOverlay();
 
     /**
@@ -790,6 +821,13 @@ protected:
     /// Updates all informations needed to draw an item
     void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
 
+    /**
+     * Lets the painter prepare in parallel the items that are going to be drawn
+     * to cached layers.
+     * @param aItems are the items to be updated.
+     */
+    void prepareItems( const std::vector<VIEW_ITEM*>& aItems );
+
     /// Updates bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
 
@@ -867,6 +905,9 @@ protected:
     /// Flag to reverse the draw order when using draw priority
     bool m_reverseDrawOrder;
 
+    /// Size (in pixels) below which groups of items are drawn as a single item
+    double m_aggregationThreshold;
+
     /// A control for printing: m_printMode <= 0 means no printing mode (normal draw mode
     /// m_printMode > 0 is a printing mode (currently means "we are in printing mode")
     int m_printMode;
@@ -98,7 +98,80 @@ public:
         VIEW_RTREE_BASE::Search( mmin, mmax, aVisitor );
     }
 
+    /**
+     * Function QueryAggregated()
+     * Same as Query(), but the subtrees whose bounding box is smaller than aMinSize
+     * in both directions are not searched. Instead, all their items are passed to
+     * aVisitor.drawAggregate( item, standInDrawn ), where standInDrawn tells whether an
+     * item of the subtree was already drawn to stand for the others. It returns true when
+     * it draws such an item, so the visitor can still draw the items it must not skip.
+     */
+    template <class Visitor>
+    void QueryAggregated( const BOX2I& aBounds, double aMinSize, Visitor& aVisitor )
+    {
+        Rect rect;
+
+        rect.m_min[0] = aBounds.GetX();
+        rect.m_min[1] = aBounds.GetY();
+        rect.m_max[0] = aBounds.GetRight();
+        rect.m_max[1] = aBounds.GetBottom();
+
+        BOX2I max_box;
+        max_box.SetMaximum();
+
+        if( aBounds == max_box )
+        {
+            rect.m_min[0] = rect.m_min[1] = INT_MIN;
+            rect.m_max[0] = rect.m_max[1] = INT_MAX;
+        }
+
+        queryAggregated( m_root, &rect, aMinSize, aVisitor );
+    }
+
 private:
+    template <class Visitor>
+    bool queryAggregated( Node* aNode, Rect* aRect, double aMinSize, Visitor& aVisitor )
+    {
+        for( int i = 0; i < aNode->m_count; ++i )
+        {
+            Branch& branch = aNode->m_branch[i];
+
+            if( !Overlap( aRect, &branch.m_rect ) )
+                continue;
+
+            if( aNode->IsLeaf() )
+            {
+                if( !aVisitor( branch.m_data ) )
+                    return false;
+            }
+            else if( (double) branch.m_rect.m_max[0] - branch.m_rect.m_min[0] < aMinSize
+                     && (double) branch.m_rect.m_max[1] - branch.m_rect.m_min[1] < aMinSize )
+            {
+                bool standInDrawn = false;
+                drawAggregate( branch.m_child, aVisitor, standInDrawn );
+            }
+            else if( !queryAggregated( branch.m_child, aRect, aMinSize, aVisitor ) )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template <class Visitor>
+    void drawAggregate( Node* aNode, Visitor& aVisitor, bool& aStandInDrawn )
+    {
+        for( int i = 0; i < aNode->m_count; ++i )
+        {
+            Branch& branch = aNode->m_branch[i];
+
+            if( !aNode->IsLeaf() )
+                drawAggregate( branch.m_child, aVisitor, aStandInDrawn );
+            else if( aVisitor.drawAggregate( branch.m_data, aStandInDrawn ) )
+                aStandInDrawn = true;
+        }
+    }
 };
 } // namespace KIGFX
 
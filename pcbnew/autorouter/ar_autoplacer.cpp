@@ -25,6 +25,10 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <atomic>
+#include <future>
+#include <thread>
+
 #include <fctsys.h>
 #include <confirm.h>
 #include <pcbnew.h>
@@ -41,6 +45,7 @@
 #include <connectivity/connectivity_data.h>
 #include <ratsnest_data.h>
 #include <widgets/progress_reporter.h>
+#include <profile.h>
 #include "ar_matrix.h"
 #include "ar_cell.h"
 #include "ar_autoplacer.h"
@@ -51,6 +56,9 @@
 
 #define STEP_AR_MM 1.0
 
+// Grid step multiplier used by the coarse pass of the coarse to fine placement search
+#define AR_COARSE_GRID_FACTOR 4
+
 /* Penalty (cost) for CntRot90 and CntRot180:
  * CntRot90 and CntRot180 are from 0 (rotation allowed) to 10 (rotation not allowed)
  */
@@ -82,6 +90,10 @@ AR_AUTOPLACER::AR_AUTOPLACER( BOARD* aBoard )
     m_progressReporter = nullptr;
     m_refreshCallback = nullptr;
     m_minCost = 0.0;
+    m_coarseToFineSearch = false;
+    m_threadCount = 0;
+    m_scoredPositions = 0;
+    m_scoringTime = 0.0;
 }
 
 
@@ -556,6 +568,8 @@ unsigned int AR_AUTOPLACER::calculateKeepOutArea( const EDA_RECT& aRect, int sid
 /* Test if the module can be placed on the board.
  * Returns the value TstRectangle().
  * Module is known by its bounding box
+ * This function only reads the matrix and aModule, so it can be called from several
+ * threads at once.
  */
 int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const wxPoint& aOffset )
 {
@@ -570,8 +584,6 @@ int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const
     EDA_RECT    fpBBox = aModule->GetFootprintRect();
     fpBBox.Move( -aOffset );
 
-    buildFpAreas( aModule, 0 );
-
     int diag = //testModuleByPolygon( aModule, side, aOffset );
         testRectangle( fpBBox, side );
 //printf("test %p diag %d\n", aModule, diag);fflush(0);
@@ -594,16 +606,128 @@ int AR_AUTOPLACER::testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const
 }
 
 
+int AR_AUTOPLACER::scorePlacementCandidates( MODULE* aModule, bool aTstOtherSide,
+                                             const wxPoint& aOrigin, int aColMin, int aColMax,
+                                             int aRowMin, int aRowMax, int aStride,
+                                             AR_CANDIDATE& aBest )
+{
+    const int     step = m_matrix.m_GridRouting;
+    const wxPoint mod_pos = aModule->GetPosition();
+
+    aBest = AR_CANDIDATE();
+
+    if( aColMax < aColMin || aRowMax < aRowMin )
+        return 0;
+
+    std::vector<int> columns;
+
+    for( int col = aColMin; col <= aColMax; col += aStride )
+        columns.push_back( col );
+
+    // Each candidate position only reads the placement matrix and the footprints already
+    // on the board, so the columns can be scored concurrently.
+    // The comparison keeps the historical serial behavior: on equal scores, the candidate
+    // found last in the column by column scan wins.
+    auto isBetter = []( const AR_CANDIDATE& aCandidate, const AR_CANDIDATE& aRef ) -> bool
+    {
+        if( !aRef.IsValid() )
+            return true;
+
+        if( aCandidate.m_score != aRef.m_score )
+            return aCandidate.m_score < aRef.m_score;
+
+        if( aCandidate.m_col != aRef.m_col )
+            return aCandidate.m_col > aRef.m_col;
+
+        return aCandidate.m_row > aRef.m_row;
+    };
+
+    std::atomic<size_t> nextColumn( 0 );
+    std::atomic<int>    scoredCount( 0 );
+    size_t              parallelThreadCount = m_threadCount > 0 ?
+            m_threadCount : std::thread::hardware_concurrency();
+
+    parallelThreadCount = std::min<size_t>( parallelThreadCount, columns.size() );
+    parallelThreadCount = std::max<size_t>( parallelThreadCount, 1 );
+
+    std::vector<AR_CANDIDATE>         bestByThread( parallelThreadCount );
+    std::vector<std::future<size_t>>  returns( parallelThreadCount );
+
+    auto score_lambda = [&]( AR_CANDIDATE* aThreadBest ) -> size_t
+    {
+        size_t num = 0;
+
+        for( size_t i = nextColumn++; i < columns.size(); i = nextColumn++ )
+        {
+            int col = columns[i];
+
+            for( int row = aRowMin; row <= aRowMax; row += aStride )
+            {
+                AR_CANDIDATE candidate;
+                candidate.m_col = col;
+                candidate.m_row = row;
+                candidate.m_pos = aOrigin + wxPoint( col * step, row * step );
+
+                wxPoint offset = mod_pos - candidate.m_pos;
+                int keepOutCost = testModuleOnBoard( aModule, aTstOtherSide, offset );
+
+                num++;
+
+                if( keepOutCost < 0 )    // i.e. if the module cannot be put here
+                    continue;
+
+                candidate.m_score = computePlacementRatsnestCost( aModule, offset ) + keepOutCost;
+
+                if( isBetter( candidate, *aThreadBest ) )
+                    *aThreadBest = candidate;
+            }
+        }
+
+        scoredCount += num;
+        return num;
+    };
+
+    if( parallelThreadCount <= 1 )
+        score_lambda( &bestByThread[0] );
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, score_lambda, &bestByThread[ii] );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        {
+            // Here we balance returns with a 100ms timeout to allow UI updating
+            std::future_status status;
+            do
+            {
+                if( m_progressReporter )
+                    m_progressReporter->KeepRefreshing();
+
+                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
+            } while( status != std::future_status::ready );
+        }
+    }
+
+    // Merge the per thread results.  The order of the threads does not matter, because
+    // the comparison is a strict total order on the candidates.
+    for( const AR_CANDIDATE& candidate : bestByThread )
+    {
+        if( candidate.IsValid() && isBetter( candidate, aBest ) )
+            aBest = candidate;
+    }
+
+    return scoredCount;
+}
+
+
 int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
 {
     int     error = 1;
-    wxPoint LastPosOK;
-    double  min_cost, curr_cost, Score;
     bool    TstOtherSide;
 
-    aModule->CalculateBoundingBox();
+    PROF_COUNTER timer;
 
-    LastPosOK = m_matrix.m_BrdBox.GetOrigin();
+    aModule->CalculateBoundingBox();
 
     wxPoint     mod_pos = aModule->GetPosition();
     EDA_RECT    fpBBox  = aModule->GetFootprintRect();
@@ -622,9 +746,6 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
     initialPos.x    -= initialPos.x % m_matrix.m_GridRouting;
     initialPos.y    -= initialPos.y % m_matrix.m_GridRouting;
 
-    m_curPosition = initialPos;
-    auto moduleOffset = mod_pos - m_curPosition;
-
     /* Examine pads, and set TstOtherSide to true if a footprint
      * has at least 1 pad through.
      */
@@ -644,49 +765,57 @@ int AR_AUTOPLACER::getOptimalModulePlacement(MODULE* aModule)
         }
     }
 
-    fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
+    // The footprint areas do not depend on the candidate position: build them once,
+    // before the (multithreaded) scan.
+    buildFpAreas( aModule, 0 );
 
-    min_cost = -1.0;
-//    m_frame->SetStatusText( wxT( "Score ??, pos ??" ) );
+    // Number of grid positions to examine, in each direction
+    int step  = m_matrix.m_GridRouting;
+    int nCols = xylimit.x > initialPos.x ? ( xylimit.x - initialPos.x + step - 1 ) / step : 0;
+    int nRows = xylimit.y > initialPos.y ? ( xylimit.y - initialPos.y + step - 1 ) / step : 0;
 
+    AR_CANDIDATE best;
+    int          scored = 0;
 
-    for( ; m_curPosition.x < xylimit.x; m_curPosition.x += m_matrix.m_GridRouting )
+    if( m_coarseToFineSearch && nCols > AR_COARSE_GRID_FACTOR && nRows > AR_COARSE_GRID_FACTOR )
     {
-        m_curPosition.y = initialPos.y;
+        // Coarse pass on a sparse grid, then fine pass around the best coarse position.
+        scored += scorePlacementCandidates( aModule, TstOtherSide, initialPos, 0, nCols - 1,
+                                            0, nRows - 1, AR_COARSE_GRID_FACTOR, best );
 
-        for( ; m_curPosition.y < xylimit.y; m_curPosition.y += m_matrix.m_GridRouting )
+        if( best.IsValid() )
         {
+            int colMin = std::max( best.m_col - AR_COARSE_GRID_FACTOR + 1, 0 );
+            int colMax = std::min( best.m_col + AR_COARSE_GRID_FACTOR - 1, nCols - 1 );
+            int rowMin = std::max( best.m_row - AR_COARSE_GRID_FACTOR + 1, 0 );
+            int rowMax = std::min( best.m_row + AR_COARSE_GRID_FACTOR - 1, nRows - 1 );
 
-            fpBBox.SetOrigin( fpBBoxOrg + m_curPosition );
-            moduleOffset = mod_pos - m_curPosition;
-            int keepOutCost = testModuleOnBoard( aModule, TstOtherSide, moduleOffset );
-
-            if( keepOutCost >= 0 )    // i.e. if the module can be put here
-            {
-                error = 0;
-                // m_frame->build_ratsnest_module( aModule ); // fixme
-                curr_cost   = computePlacementRatsnestCost( aModule, moduleOffset );
-                Score       = curr_cost + keepOutCost;
-
-                if( (min_cost >= Score ) || (min_cost < 0 ) )
-                {
-                    LastPosOK   = m_curPosition;
-                    min_cost    = Score;
-                    wxString msg;
-/*                    msg.Printf( wxT( "Score %g, pos %s, %s" ),
-                                min_cost,
-                                GetChars( ::CoordinateToString( LastPosOK.x ) ),
-                                GetChars( ::CoordinateToString( LastPosOK.y ) ) );
-                    m_frame->SetStatusText( msg );*/
-                }
-            }
+            scored += scorePlacementCandidates( aModule, TstOtherSide, initialPos, colMin, colMax,
+                                                rowMin, rowMax, 1, best );
         }
     }
 
-    // Regeneration of the modified variable.
-    m_curPosition = LastPosOK;
+    // Exhaustive search.  Also used when the coarse grid did not find any free position,
+    // because a narrow free area can be missed by the coarse grid.
+    if( !best.IsValid() )
+        scored += scorePlacementCandidates( aModule, TstOtherSide, initialPos, 0, nCols - 1,
+                                            0, nRows - 1, 1, best );
+
+    if( best.IsValid() )
+    {
+        error = 0;
+        m_curPosition = best.m_pos;
+        m_minCost = best.m_score;
+    }
+    else
+    {
+        m_curPosition = m_matrix.m_BrdBox.GetOrigin();
+        m_minCost = -1.0;
+    }
+
+    m_scoredPositions += scored;
+    m_scoringTime += timer.msecs();
 
-    m_minCost = min_cost;
     return error;
 }
 
@@ -980,6 +1109,9 @@ AR_RESULT AR_AUTOPLACER::AutoplaceModules( std::vector<MODULE*> aModules,
 
         double initialOrient = module->GetOrientation();
 
+        m_scoredPositions = 0;
+        m_scoringTime = 0.0;
+
         error = getOptimalModulePlacement( module );
         double bestScore = m_minCost;
         double bestRotation = 0.0;
@@ -1090,6 +1222,9 @@ end_of_tst:
 
         if( m_progressReporter )
         {
+            m_progressReporter->Report( wxString::Format(
+                    _( "%s placed: %d positions scored in %.1f ms" ),
+                    module->GetReference(), m_scoredPositions, m_scoringTime ) );
             m_progressReporter->AdvanceProgress();
 
             if ( !m_progressReporter->KeepRefreshing( false ) )
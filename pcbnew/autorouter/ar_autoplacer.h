@@ -92,7 +92,40 @@ public:
         m_progressReporter = aReporter;
     }
 
+    /**
+     * Enable a coarse to fine search of the footprint positions: candidate positions
+     * are first scored on a sparse grid, then only around the best sparse position.
+     * Much faster on large boards, but can miss the absolute best position.
+     * Default is the exhaustive search.
+     */
+    void SetCoarseToFineSearch( bool aEnable )
+    {
+        m_coarseToFineSearch = aEnable;
+    }
+
+    /**
+     * Set the number of threads scoring the candidate positions.
+     * 0 (the default) uses one thread per core.  The placement does not depend on it.
+     */
+    void SetThreadCount( int aCount )
+    {
+        m_threadCount = aCount;
+    }
+
 private:
+    /// A scored candidate position of the footprint to place
+    struct AR_CANDIDATE
+    {
+        AR_CANDIDATE() : m_col( -1 ), m_row( -1 ), m_score( -1.0 ) {}
+
+        bool IsValid() const { return m_col >= 0; }
+
+        int     m_col;          // grid column index of the position (-1 if none)
+        int     m_row;          // grid row index of the position
+        wxPoint m_pos;          // footprint position
+        double  m_score;        // keepout + ratsnest cost of the position
+    };
+
     void         drawPlacementRoutingMatrix();  // draw the working area (shows free and occupied areas)
     void         rotateModule( MODULE* module, double angle, bool incremental );
     int          genPlacementRoutingMatrix();
@@ -108,6 +141,18 @@ private:
     unsigned int calculateKeepOutArea( const EDA_RECT& aRect, int side );
     int          testModuleOnBoard( MODULE* aModule, bool TstOtherSide, const wxPoint& aOffset );
     int          getOptimalModulePlacement( MODULE* aModule );
+
+    /**
+     * Score the candidate positions of aModule on the grid window [aColMin..aColMax] x
+     * [aRowMin..aRowMax] (in grid cells from aOrigin), every aStride cells.
+     * Positions are scored in parallel, and aBest is set to the lowest score position.
+     * Ties are resolved deterministically, like the serial scan (the last position wins).
+     * @return the number of scored positions
+     */
+    int          scorePlacementCandidates( MODULE* aModule, bool aTstOtherSide,
+                                           const wxPoint& aOrigin, int aColMin, int aColMax,
+                                           int aRowMin, int aRowMax, int aStride,
+                                           AR_CANDIDATE& aBest );
     double       computePlacementRatsnestCost( MODULE* aModule, const wxPoint& aOffset );
 
     /**
@@ -143,6 +188,10 @@ private:
     wxPoint m_moduleOffset;
     double  m_minCost;
     int     m_gridSize;
+    bool    m_coarseToFineSearch;
+    int     m_threadCount;          // threads scoring the positions, 0 for one per core
+    int     m_scoredPositions;      // candidate positions scored for the current footprint
+    double  m_scoringTime;          // time spent to score them, in ms
 
     std::shared_ptr<KIGFX::VIEW_OVERLAY>    m_overlay;
     std::unique_ptr<CONNECTIVITY_DATA>      m_connectivity;
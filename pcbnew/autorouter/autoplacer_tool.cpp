@@ -22,6 +22,7 @@
  */
 
 
+#include <advanced_config.h>
 #include <board_commit.h>
 #include <class_draw_panel_gal.h>
 #include <confirm.h>
@@ -96,6 +97,7 @@ int AUTOPLACE_TOOL::autoplace( std::vector<MODULE*>& aModules, bool aPlaceOffboa
             new WX_PROGRESS_REPORTER( frame(), _( "Autoplace Components" ), 1 ) );
 
     autoplacer.SetProgressReporter( progressReporter.get() );
+    autoplacer.SetCoarseToFineSearch( ADVANCED_CFG::GetCfg().m_autoplaceCoarseToFine );
     auto result = autoplacer.AutoplaceModules( aModules, &commit, aPlaceOffboard );
 
     if( result == AR_COMPLETED )
@@ -0,0 +1,246 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <board_snapshot.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <colors_design_settings.h>
+#include <common.h>
+#include <convert_to_biu.h>
+#include <gal/cairo/cairo_image.h>
+#include <pcb_painter.h>
+#include <pcb_view.h>
+
+
+///> Cairo cannot create image surfaces larger than this size
+static const int MAX_IMAGE_SIZE = 32767;
+
+///> Minimal height of the strips drawn by each thread
+static const int MIN_STRIP_HEIGHT = 64;
+
+
+BOARD_SNAPSHOT_SETTINGS::BOARD_SNAPSHOT_SETTINGS() :
+        m_layers( LSET::AllLayersMask() ),
+        m_dpi( 300.0 ),
+        m_mirror( false ),
+        m_threads( 0 ),
+        m_colors( nullptr )
+{
+}
+
+
+BOARD_SNAPSHOT::BOARD_SNAPSHOT( BOARD* aBoard ) :
+        m_board( aBoard ),
+        m_view( new KIGFX::PCB_VIEW( false ) )
+{
+    // Nothing is cached by the Cairo GAL
+    m_view->SetDefaultLayerOrder();
+    m_view->SetDefaultLayerDeps( false );
+
+    for( auto drawing : m_board->Drawings() )
+        m_items.push_back( drawing );
+
+    for( auto track : m_board->Tracks() )
+        m_items.push_back( track );
+
+    for( auto module : m_board->Modules() )
+        m_items.push_back( module );
+
+    for( auto zone : m_board->Zones() )
+        m_items.push_back( zone );
+
+    for( auto item : m_items )
+        m_view->Add( item );
+}
+
+
+BOARD_SNAPSHOT::~BOARD_SNAPSHOT()
+{
+    // The items keep a reference to the view, clear it before the view is gone.
+    // The reverse order of addition is the fast path of VIEW::Remove().
+    for( auto it = m_items.rbegin(); it != m_items.rend(); ++it )
+        m_view->Remove( *it );
+}
+
+
+/**
+ * Show the board layers of the snapshot and the items drawn on them, like a printout
+ * with holes.
+ */
+static void setupViewLayers( KIGFX::VIEW* aView, const LSET& aLayers )
+{
+    for( int i = 0; i < KIGFX::VIEW::VIEW_MAX_LAYERS; ++i )
+        aView->SetLayerVisible( i, false );
+
+    for( LSEQ seq = aLayers.Seq(); seq; ++seq )
+        aView->SetLayerVisible( *seq, true );
+
+    if( aLayers.test( F_Cu ) )
+        aView->SetLayerVisible( LAYER_PAD_FR, true );
+
+    if( aLayers.test( B_Cu ) )
+        aView->SetLayerVisible( LAYER_PAD_BK, true );
+
+    if( ( aLayers & LSET::AllCuMask() ).any() )
+    {
+        for( auto layer : { LAYER_PADS_TH, LAYER_VIA_MICROVIA, LAYER_VIA_BBLIND,
+                            LAYER_VIA_THROUGH, LAYER_PADS_PLATEDHOLES, LAYER_NON_PLATEDHOLES,
+                            LAYER_VIAS_HOLES } )
+        {
+            aView->SetLayerVisible( layer, true );
+        }
+    }
+
+    // Rely on the board layers visibility for these ones
+    for( auto layer : { LAYER_MOD_TEXT_FR, LAYER_MOD_TEXT_BK, LAYER_MOD_FR, LAYER_MOD_BK,
+                        LAYER_MOD_VALUES, LAYER_MOD_REFERENCES, LAYER_TRACKS } )
+    {
+        aView->SetLayerVisible( layer, true );
+    }
+}
+
+
+wxImage BOARD_SNAPSHOT::Render( const BOARD_SNAPSHOT_SETTINGS& aSettings ) const
+{
+    BOX2I area = aSettings.m_area;
+
+    if( area.GetWidth() <= 0 || area.GetHeight() <= 0 )
+    {
+        EDA_RECT bbox = m_board->ComputeBoundingBox();
+        area = BOX2I( bbox.GetOrigin(), bbox.GetSize() );
+    }
+
+    // Image pixels per board internal unit
+    const double scale = aSettings.m_dpi / ( IU_PER_MILS * 1000.0 );
+
+    if( scale <= 0.0 || area.GetWidth() * scale > MAX_IMAGE_SIZE
+            || area.GetHeight() * scale > MAX_IMAGE_SIZE )
+    {
+        return wxImage();
+    }
+
+    const int width = std::max( 1, KiROUND( area.GetWidth() * scale ) );
+    const int height = std::max( 1, KiROUND( area.GetHeight() * scale ) );
+
+    const COLORS_DESIGN_SETTINGS* colors = aSettings.m_colors;
+
+    if( !colors )
+        colors = &m_board->Colors();
+
+    size_t threadCount = aSettings.m_threads > 0 ? aSettings.m_threads
+                                                 : std::thread::hardware_concurrency();
+    size_t stripCount = ( height + MIN_STRIP_HEIGHT - 1 ) / MIN_STRIP_HEIGHT;
+    stripCount = std::max<size_t>( 1, std::min( stripCount, threadCount ) );
+    const int stripHeight = ( height + (int) stripCount - 1 ) / (int) stripCount;
+
+    struct STRIP
+    {
+        int                                     m_top;
+        std::unique_ptr<KIGFX::CAIRO_IMAGE_GAL> m_gal;
+        std::unique_ptr<KIGFX::PCB_PAINTER>     m_painter;
+        std::unique_ptr<KIGFX::VIEW>            m_view;
+    };
+
+    // The GALs subscribe to the display options, so they are created and destroyed here,
+    // and the threads only draw
+    KIGFX::GAL_DISPLAY_OPTIONS options;
+    std::vector<STRIP>         strips( stripCount );
+    const VECTOR2D             center( area.GetX() + area.GetWidth() / 2.0,
+                                       area.GetY() + area.GetHeight() / 2.0 );
+
+    for( size_t ii = 0; ii < stripCount; ++ii )
+    {
+        STRIP& strip = strips[ii];
+        strip.m_top = (int) ii * stripHeight;
+
+        const int h = std::min( stripHeight, height - strip.m_top );
+
+        if( h <= 0 )
+            continue;
+
+        strip.m_gal.reset( new KIGFX::CAIRO_IMAGE_GAL( options, width, h ) );
+        strip.m_painter.reset( new KIGFX::PCB_PAINTER( strip.m_gal.get() ) );
+
+        auto settings = static_cast<KIGFX::PCB_RENDER_SETTINGS*>( strip.m_painter->GetSettings() );
+        settings->ImportLegacyColors( colors );
+        settings->EnableZoneOutlines( false );
+
+        KIGFX::CAIRO_IMAGE_GAL* gal = strip.m_gal.get();
+        gal->SetClearColor( settings->GetBackgroundColor() );
+        gal->SetScreenDPI( aSettings.m_dpi );
+        gal->SetWorldUnitLength( 1e-9 /* 1 nm */ / 0.0254 /* 1 inch in meters */ );
+
+        strip.m_view = m_view->DataReference();
+        KIGFX::VIEW* view = strip.m_view.get();
+        view->SetGAL( gal );
+        view->SetPainter( strip.m_painter.get() );
+        view->SetPrintMode( 1 );
+        view->SetScaleLimits( 10e9, 0.0001 );
+        view->SetScale( 1.0 );
+        view->SetMirror( aSettings.m_mirror, false );
+        setupViewLayers( view, aSettings.m_layers );
+
+        // Strips span the whole image width, so only the vertical position changes
+        view->SetCenter( VECTOR2D( center.x,
+                center.y + ( strip.m_top + h / 2.0 - height / 2.0 ) / scale ) );
+    }
+
+    wxImage              image( width, height, false );
+    std::atomic<size_t>  nextStrip( 0 );
+    std::atomic<size_t>  threadsFinished( 0 );
+
+    for( size_t ii = 0; ii < stripCount; ++ii )
+    {
+        std::thread t = std::thread( [&]()
+        {
+            for( size_t i = nextStrip.fetch_add( 1 ); i < stripCount; i = nextStrip.fetch_add( 1 ) )
+            {
+                STRIP& strip = strips[i];
+
+                if( !strip.m_gal )
+                    continue;
+
+                {
+                    KIGFX::GAL_DRAWING_CONTEXT ctx( strip.m_gal.get() );
+                    strip.m_view->Redraw();
+                }
+
+                // Each strip writes its own rows of the image
+                strip.m_gal->CopyToImage( image, VECTOR2I( 0, strip.m_top ) );
+            }
+
+            threadsFinished++;
+        } );
+
+        t.detach();
+    }
+
+    while( threadsFinished < stripCount )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+
+    return image;
+}
@@ -0,0 +1,86 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOARD_SNAPSHOT_H
+#define BOARD_SNAPSHOT_H
+
+#include <memory>
+#include <vector>
+
+#include <layers_id_colors_and_visibility.h>
+#include <math/box2.h>
+#include <wx/image.h>
+
+class BOARD;
+class BOARD_ITEM;
+class COLORS_DESIGN_SETTINGS;
+
+namespace KIGFX
+{
+class PCB_VIEW;
+}
+
+
+struct BOARD_SNAPSHOT_SETTINGS
+{
+    BOARD_SNAPSHOT_SETTINGS();
+
+    LSET   m_layers;        ///< Board layers to draw
+    BOX2I  m_area;          ///< Board area to draw, the board bounding box if empty
+    double m_dpi;           ///< Image resolution, in pixels per inch
+    bool   m_mirror;        ///< Mirror the image horizontally, to show the bottom side
+    int    m_threads;       ///< Number of render threads, 0 to use all the cores
+
+    ///> Colors of the layers and the background, the board colors if null
+    const COLORS_DESIGN_SETTINGS* m_colors;
+};
+
+
+/**
+ * BOARD_SNAPSHOT renders a board to an image with the GAL painter, without any window.
+ *
+ * The image is split in horizontal strips drawn in parallel, each one by its own view,
+ * Cairo image GAL and painter. The views share the board items indexed once by the
+ * BOARD_SNAPSHOT, so several snapshots (e.g. one per layer) are cheap to render.
+ *
+ * A board item can be displayed by a single view, so the board items must not be
+ * displayed in another view while a BOARD_SNAPSHOT exists.
+ */
+class BOARD_SNAPSHOT
+{
+public:
+    BOARD_SNAPSHOT( BOARD* aBoard );
+    ~BOARD_SNAPSHOT();
+
+    /**
+     * Render the board.
+     * @return the image, or an invalid image if the requested size cannot be drawn.
+     */
+    wxImage Render( const BOARD_SNAPSHOT_SETTINGS& aSettings ) const;
+
+private:
+    BOARD* m_board;
+
+    std::unique_ptr<KIGFX::PCB_VIEW> m_view;
+
+    ///> Items added to m_view, to remove them before the view is destroyed
+    std::vector<BOARD_ITEM*> m_items;
+};
+
+#endif /* BOARD_SNAPSHOT_H */
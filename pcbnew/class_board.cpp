@@ -1757,6 +1757,50 @@ const std::vector<BOARD_CONNECTED_ITEM*> BOARD::AllConnectedItems()
 }
 
 
+template <class LIST>
+int BOARD::findItemIndex( const LIST& aList, const BOARD_ITEM* aItem )
+{
+    int index = aItem->m_listIndex;
+
+    if( index >= 0 && index < (int) aList.size() && aList[index] == aItem )
+        return index;
+
+    // The list changed since the positions were cached
+    for( int ii = 0; ii < (int) aList.size(); ++ii )
+        aList[ii]->m_listIndex = ii;
+
+    index = aItem->m_listIndex;
+
+    return ( index >= 0 && index < (int) aList.size() && aList[index] == aItem ) ? index : -1;
+}
+
+
+int BOARD::GetItemIndex( const BOARD_ITEM* aItem ) const
+{
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+        return findItemIndex( m_modules, aItem );
+
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+        return findItemIndex( m_tracks, aItem );
+
+    case PCB_ZONE_AREA_T:
+        return findItemIndex( m_ZoneDescriptorList, aItem );
+
+    case PCB_LINE_T:
+    case PCB_TEXT_T:
+    case PCB_DIMENSION_T:
+    case PCB_TARGET_T:
+        return findItemIndex( m_drawings, aItem );
+
+    default:
+        return -1;
+    }
+}
+
+
 void BOARD::ClearAllNetCodes()
 {
     for ( BOARD_CONNECTED_ITEM* item : AllConnectedItems() )
@@ -214,6 +214,10 @@ private:
         return *this;       // just to mute warning
     }
 
+    /// Helper for GetItemIndex(), finds aItem in aList and caches the positions
+    template <class LIST>
+    static int findItemIndex( const LIST& aList, const BOARD_ITEM* aItem );
+
 public:
     static inline bool ClassOf( const EDA_ITEM* aItem )
     {
@@ -254,6 +258,17 @@ public:
 
     const std::vector<BOARD_CONNECTED_ITEM*> AllConnectedItems();
 
+    /**
+     * Function GetItemIndex
+     * returns the position of a track, module, drawing or zone in its list, so items of the
+     * same list can be sorted in the order Visit() finds them.  The positions are cached
+     * in the items, and checked against the list: it is scanned again only after it was
+     * changed.
+     * @param aItem is the item to find.
+     * @return the position of aItem, or -1 if it is not in the lists of the board.
+     */
+    int GetItemIndex( const BOARD_ITEM* aItem ) const;
+
     /// zone contour currently in progress
     ZONE_CONTAINER*             m_CurrentZoneContour;
 
@@ -25,12 +25,16 @@
 #include <collectors.h>
 #include <class_board_item.h>             // class BOARD_ITEM
 
+#include <class_board.h>
 #include <class_module.h>
 #include <class_pad.h>
 #include <class_track.h>
 #include <class_marker_pcb.h>
 #include <class_zone.h>
 
+#include <algorithm>
+#include <unordered_set>
+
 
 /* This module contains out of line member functions for classes given in
  * collectors.h.  Those classes augment the functionality of class PCB_EDIT_FRAME.
@@ -471,8 +475,156 @@ exit:
 }
 
 
+void GENERAL_COLLECTOR::visitNearItems( BOARD* aBoard, const KIGFX::VIEW* aView )
+{
+    // Zone corners and edges are hit from a few pixels away (see Inspect()),
+    // other items only within their bounding box
+    BOX2I area( m_RefPos, VECTOR2I( 0, 0 ) );
+    area.Inflate( KiROUND( 10 * m_Guide->OnePixelInIU() ) + 1 );
+
+    std::vector<KIGFX::VIEW_ITEM*> nearItems;
+    aView->QueryAll( area, nearItems );
+
+    std::unordered_set<KIGFX::VIEW_ITEM*> candidates( nearItems.begin(), nearItems.end() );
+
+    // The board level items near the point, or owning an item near it (modules)
+    std::unordered_set<BOARD_ITEM*> parents;
+
+    for( KIGFX::VIEW_ITEM* viewItem : candidates )
+    {
+        BOARD_ITEM* item = dynamic_cast<BOARD_ITEM*>( viewItem );
+
+        if( !item )
+            continue;
+
+        switch( item->Type() )
+        {
+        case PCB_PAD_T:
+        case PCB_MODULE_TEXT_T:
+        case PCB_MODULE_EDGE_T:
+            if( item->GetParent() )
+                parents.insert( item->GetParent() );
+
+            break;
+
+        default:
+            parents.insert( item );
+            break;
+        }
+    }
+
+    // Sort them in the order of their list, to collect the items in the same order
+    // as BOARD::Visit()
+    typedef std::vector<std::pair<int, BOARD_ITEM*>> SORTED_ITEMS;
+
+    SORTED_ITEMS modules;
+    SORTED_ITEMS drawings;
+    SORTED_ITEMS tracks;
+    SORTED_ITEMS zones;
+
+    for( BOARD_ITEM* item : parents )
+    {
+        int index = aBoard->GetItemIndex( item );
+
+        if( index < 0 )     // not a board item, or not on this board
+            continue;
+
+        switch( item->Type() )
+        {
+        case PCB_MODULE_T:      modules.emplace_back( index, item );   break;
+        case PCB_TRACE_T:
+        case PCB_VIA_T:         tracks.emplace_back( index, item );    break;
+        case PCB_ZONE_AREA_T:   zones.emplace_back( index, item );     break;
+        default:                drawings.emplace_back( index, item );  break;
+        }
+    }
+
+    for( SORTED_ITEMS* list : { &modules, &drawings, &tracks, &zones } )
+        std::sort( list->begin(), list->end() );
+
+    // Module items which are not near the point are not inspected
+    INSPECTOR_FUNC inspector = [&]( EDA_ITEM* aTestItem, void* aTestData )
+    {
+        if( candidates.count( aTestItem ) == 0 )
+            return SEARCH_CONTINUE;
+
+        return Inspect( aTestItem, aTestData );
+    };
+
+    auto visitList = [&]( const SORTED_ITEMS& aList, const KICAD_T* aScanTypes )
+    {
+        for( const auto& entry : aList )
+            entry.second->Visit( inspector, NULL, aScanTypes );
+    };
+
+    auto skipTypes = []( const KICAD_T* aScanTypes, std::initializer_list<KICAD_T> aTypes )
+    {
+        while( std::find( aTypes.begin(), aTypes.end(), *aScanTypes ) != aTypes.end() )
+            ++aScanTypes;
+
+        return aScanTypes;
+    };
+
+    // Walk the scan list as BOARD::Visit() does, but over the sorted lists
+    const KICAD_T* p = m_ScanTypes;
+    bool           done = false;
+
+    while( !done )
+    {
+        switch( *p )
+        {
+        case PCB_T:
+            // The board itself is not in the view
+            ++p;
+            break;
+
+        case PCB_MODULE_T:
+        case PCB_PAD_T:
+        case PCB_MODULE_TEXT_T:
+        case PCB_MODULE_EDGE_T:
+            visitList( modules, p );
+            p = skipTypes( p, { PCB_MODULE_T, PCB_PAD_T, PCB_MODULE_TEXT_T, PCB_MODULE_EDGE_T } );
+            break;
+
+        case PCB_LINE_T:
+        case PCB_TEXT_T:
+        case PCB_DIMENSION_T:
+        case PCB_TARGET_T:
+            visitList( drawings, p );
+            p = skipTypes( p, { PCB_LINE_T, PCB_TEXT_T, PCB_DIMENSION_T, PCB_TARGET_T } );
+            break;
+
+        case PCB_VIA_T:
+        case PCB_TRACE_T:
+            visitList( tracks, p );
+            ++p;
+            break;
+
+        case PCB_MARKER_T:
+            // Markers are on LAYER_DRC, a display only layer QueryAll() does not search,
+            // so they are always inspected (there are only a few of them)
+            for( int ii = 0; ii < aBoard->GetMARKERCount(); ++ii )
+                aBoard->GetMARKER( ii )->Visit( m_inspector, NULL, p );
+
+            ++p;
+            break;
+
+        case PCB_ZONE_AREA_T:
+            visitList( zones, p );
+            ++p;
+            break;
+
+        default:        // EOT or a type the board does not hold
+            done = true;
+            break;
+        }
+    }
+}
+
+
 void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
-                                 const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide )
+                                 const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide,
+                                 const KIGFX::VIEW* aView )
 {
     Empty();        // empty the collection, primary criteria list
     Empty2nd();     // empty the collection, secondary criteria list
@@ -486,7 +638,14 @@ void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
     // the Inspect() function.
     SetRefPos( aRefPos );
 
-    aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    if( aView && aItem->Type() == PCB_T )
+    {
+        visitNearItems( static_cast<BOARD*>( aItem ), aView );
+    }
+    else
+    {
+        aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    }
 
     SetTimeNow();               // when snapshot was taken
 
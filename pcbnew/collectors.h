@@ -36,6 +36,7 @@
 #include <view/view.h>
 #include <class_board_item.h>
 
+class BOARD;
 
 
 /**
@@ -259,6 +260,12 @@ protected:
      */
     int                         m_PrimaryLength;
 
+    /**
+     * Inspects the items of aBoard which aView places near m_RefPos, in the order of
+     * BOARD::Visit(), without visiting the other items.
+     */
+    void visitNearItems( BOARD* aBoard, const KIGFX::VIEW* aView );
+
 public:
 
     /**
@@ -372,9 +379,14 @@ public:
      *  collection in "m_List".
      * @param aRefPos A wxPoint to use in hit-testing.
      * @param aGuide The COLLECTORS_GUIDE to use in collecting items.
+     * @param aView A VIEW holding the scanned items, used to find the items placed near
+     *  aRefPos, so only them are visited and hit-tested. The collection is the same as
+     *  without it, provided all the items are in the view. It is used only when aItem is
+     *  a BOARD. If NULL, all the items are hit-tested.
      */
     void Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
-                 const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide );
+                 const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide,
+                 const KIGFX::VIEW* aView = NULL );
 };
 
 
@@ -39,6 +39,10 @@
 #include <convert_basic_shapes_to_polygon.h>
 #include <geometry/shape_poly_set.h>
 #include <geometry/geometry_utils.h>
+#include <geometry/rtree.h>
+
+#include <algorithm>
+#include <unordered_map>
 
 
 /**
@@ -94,83 +98,178 @@ inline bool close_st( const wxPoint& aReference, const wxPoint& aFirst, const wx
 
 
 /**
- * Searches for a DRAWSEGMENT matching a given end point or start point in a list, and
- * if found, removes it from the TYPE_COLLECTOR and returns it, else returns NULL.
- * @param aPoint The starting or ending point to search for.
- * @param aList The list to remove from.
- * @param aLimit is the distance from \a aPoint that still constitutes a valid find.
- * @return DRAWSEGMENT* - The first DRAWSEGMENT that has a start or end point matching
- *   aPoint, otherwise NULL if none.
+ * Spatial hash of the end points of a DRAWSEGMENT list, used to chain the segments of an
+ * outline without scanning the whole list for each of them.
+ *
+ * The cells are larger than the connection tolerance, so all the end points close enough
+ * to a given point are in the 3x3 cells around it.  Segments are flagged when used instead
+ * of being removed, so the list order still decides between equivalent candidates.
  */
-static DRAWSEGMENT* findPoint( const wxPoint& aPoint, std::vector< DRAWSEGMENT* >& aList, unsigned aLimit )
+class SEGMENT_ENDS_INDEX
 {
-    unsigned min_d = INT_MAX;
-    int      ndx_min = 0;
+public:
+    SEGMENT_ENDS_INDEX( const std::vector<DRAWSEGMENT*>& aList, unsigned aLimit );
+
+    /**
+     * Searches for a DRAWSEGMENT matching a given end point or start point, and if found,
+     * removes it from the index and returns it, else returns NULL.
+     * @param aPoint The starting or ending point to search for.
+     * @return DRAWSEGMENT* - The first DRAWSEGMENT that has a start or end point matching
+     *   aPoint, otherwise the closest one within the index limit, otherwise NULL if none.
+     */
+    DRAWSEGMENT* FindPoint( const wxPoint& aPoint );
+
+    /**
+     * Removes the first DRAWSEGMENT left in the list order and returns it.
+     */
+    DRAWSEGMENT* PopFirst();
+
+    void Remove( size_t aIndex );
 
-    // find the point closest to aPoint and perhaps exactly matching aPoint.
-    for( size_t i = 0; i < aList.size(); ++i )
+    bool Empty() const { return m_count == 0; }
+
+private:
+    struct END
     {
-        DRAWSEGMENT*    graphic = aList[i];
-        unsigned        d;
+        wxPoint m_point;
+        size_t  m_index;
+    };
 
-        switch( graphic->GetShape() )
+    int64_t cellCoord( int aCoord ) const
+    {
+        // Rounded down, so the cells do not change size around 0
+        return aCoord >= 0 ? aCoord / m_cellSize : ( aCoord + 1 ) / m_cellSize - 1;
+    }
+
+    uint64_t cellKey( int64_t aX, int64_t aY ) const
+    {
+        return ( uint64_t( uint32_t( aX ) ) << 32 ) | uint32_t( aY );
+    }
+
+    std::vector<DRAWSEGMENT*> m_list;
+    std::vector<bool>         m_used;
+    size_t                    m_first;      ///< First unused segment of the list
+    size_t                    m_count;      ///< Number of unused segments
+    unsigned                  m_limit;
+    int64_t                   m_cellSize;
+
+    std::unordered_map<uint64_t, std::vector<END>> m_cells;
+};
+
+
+SEGMENT_ENDS_INDEX::SEGMENT_ENDS_INDEX( const std::vector<DRAWSEGMENT*>& aList, unsigned aLimit ) :
+        m_list( aList ),
+        m_used( aList.size(), false ),
+        m_first( 0 ),
+        m_count( aList.size() ),
+        m_limit( aLimit ),
+        m_cellSize( int64_t( aLimit ) + 1 )
+{
+    for( size_t i = 0; i < m_list.size(); ++i )
+    {
+        DRAWSEGMENT* graphic = m_list[i];
+        wxPoint      ends[2];
+
+        if( graphic->GetShape() == S_ARC )
         {
-        case S_ARC:
-            if( aPoint == graphic->GetArcStart() || aPoint == graphic->GetArcEnd() )
-            {
-                aList.erase( aList.begin() + i );
-                return graphic;
-            }
+            ends[0] = graphic->GetArcStart();
+            ends[1] = graphic->GetArcEnd();
+        }
+        else
+        {
+            ends[0] = graphic->GetStart();
+            ends[1] = graphic->GetEnd();
+        }
 
-            d = close_ness( aPoint, graphic->GetArcStart() );
-            if( d < min_d )
-            {
-                min_d = d;
-                ndx_min = i;
-            }
+        // Ends are stored in the list order in each cell
+        for( const wxPoint& end : ends )
+            m_cells[cellKey( cellCoord( end.x ), cellCoord( end.y ) )].push_back( { end, i } );
+    }
+}
 
-            d = close_ness( aPoint, graphic->GetArcEnd() );
-            if( d < min_d )
-            {
-                min_d = d;
-                ndx_min = i;
-            }
-            break;
 
-        default:
-            if( aPoint == graphic->GetStart() || aPoint == graphic->GetEnd() )
-            {
-                aList.erase( aList.begin() + i );
-                return graphic;
-            }
+DRAWSEGMENT* SEGMENT_ENDS_INDEX::FindPoint( const wxPoint& aPoint )
+{
+    int64_t cx = cellCoord( aPoint.x );
+    int64_t cy = cellCoord( aPoint.y );
+
+    // An exact match is always preferred, and can only be in the cell of aPoint
+    auto cell = m_cells.find( cellKey( cx, cy ) );
 
-            d = close_ness( aPoint, graphic->GetStart() );
-            if( d < min_d )
+    if( cell != m_cells.end() )
+    {
+        for( const END& end : cell->second )
+        {
+            if( !m_used[end.m_index] && end.m_point == aPoint )
             {
-                min_d = d;
-                ndx_min = i;
+                Remove( end.m_index );
+                return m_list[end.m_index];
             }
+        }
+    }
+
+    // Else find the point closest to aPoint, the first one in the list order if several
+    // points are at the same distance
+    unsigned min_d = INT_MAX;
+    size_t   ndx_min = m_list.size();
 
-            d = close_ness( aPoint, graphic->GetEnd() );
-            if( d < min_d )
+    for( int64_t x = cx - 1; x <= cx + 1; ++x )
+    {
+        for( int64_t y = cy - 1; y <= cy + 1; ++y )
+        {
+            cell = m_cells.find( cellKey( x, y ) );
+
+            if( cell == m_cells.end() )
+                continue;
+
+            for( const END& end : cell->second )
             {
-                min_d = d;
-                ndx_min = i;
+                if( m_used[end.m_index] )
+                    continue;
+
+                unsigned d = close_ness( aPoint, end.m_point );
+
+                if( d < min_d || ( d == min_d && end.m_index < ndx_min ) )
+                {
+                    min_d = d;
+                    ndx_min = end.m_index;
+                }
             }
         }
     }
 
-    if( min_d <= aLimit )
+    if( ndx_min < m_list.size() && min_d <= m_limit )
     {
-        DRAWSEGMENT* graphic = aList[ndx_min];
-        aList.erase( aList.begin() + ndx_min );
-        return graphic;
+        Remove( ndx_min );
+        return m_list[ndx_min];
     }
 
     return NULL;
 }
 
 
+DRAWSEGMENT* SEGMENT_ENDS_INDEX::PopFirst()
+{
+    DRAWSEGMENT* graphic = m_list[m_first];
+
+    Remove( m_first );
+
+    return graphic;
+}
+
+
+void SEGMENT_ENDS_INDEX::Remove( size_t aIndex )
+{
+    wxASSERT( !m_used[aIndex] );
+
+    m_used[aIndex] = true;
+    m_count--;
+
+    while( m_first < m_list.size() && m_used[m_first] )
+        m_first++;
+}
+
+
 /**
  * Function ConvertOutlineToPolygon
  * build a polygon (with holes) from a DRAWSEGMENT list, which is expected to be
@@ -190,9 +289,6 @@ bool ConvertOutlineToPolygon( std::vector<DRAWSEGMENT*>& aSegList, SHAPE_POLY_SE
 
     wxString msg;
 
-    // Make a working copy of aSegList, because the list is modified during calculations
-    std::vector< DRAWSEGMENT* > segList = aSegList;
-
     DRAWSEGMENT* graphic;
     wxPoint prevPt;
 
@@ -201,9 +297,9 @@ bool ConvertOutlineToPolygon( std::vector<DRAWSEGMENT*>& aSegList, SHAPE_POLY_SE
     wxPoint xmin    = wxPoint( INT_MAX, 0 );
     int     xmini   = 0;
 
-    for( size_t i = 0; i < segList.size(); i++ )
+    for( size_t i = 0; i < aSegList.size(); i++ )
     {
-        graphic = (DRAWSEGMENT*) segList[i];
+        graphic = aSegList[i];
 
         switch( graphic->GetShape() )
         {
@@ -316,10 +412,13 @@ bool ConvertOutlineToPolygon( std::vector<DRAWSEGMENT*>& aSegList, SHAPE_POLY_SE
     // can put enough graphics together by matching endpoints to formulate a cohesive
     // polygon.
 
-    graphic = (DRAWSEGMENT*) segList[xmini];
+    // The segments left to chain, found by their ends
+    SEGMENT_ENDS_INDEX segIndex( aSegList, aTolerance );
+
+    graphic = aSegList[xmini];
 
     // The first DRAWSEGMENT is in 'graphic', ok to remove it from 'items'
-    segList.erase( segList.begin() + xmini );
+    segIndex.Remove( xmini );
 
     // Output the outline perimeter as polygon.
     if( graphic->GetShape() == S_CIRCLE )
@@ -464,7 +563,7 @@ bool ConvertOutlineToPolygon( std::vector<DRAWSEGMENT*>& aSegList, SHAPE_POLY_SE
 
             // Get next closest segment.
 
-            graphic = findPoint( prevPt, segList, aTolerance );
+            graphic = segIndex.FindPoint( prevPt );
 
             // If there are no more close segments, check if the board
             // outline polygon can be closed.
@@ -497,13 +596,12 @@ bool ConvertOutlineToPolygon( std::vector<DRAWSEGMENT*>& aSegList, SHAPE_POLY_SE
         }
     }
 
-    while( segList.size() )
+    while( !segIndex.Empty() )
     {
         // emit a signal layers keepout for every interior polygon left...
         int hole = aPolygons.NewHole();
 
-        graphic = (DRAWSEGMENT*) segList[0];
-        segList.erase( segList.begin() );
+        graphic = segIndex.PopFirst();
 
         // Both circles and polygons on the edge cuts layer are closed items that
         // do not connect to other elements, so we process them independently
@@ -666,7 +764,7 @@ bool ConvertOutlineToPolygon( std::vector<DRAWSEGMENT*>& aSegList, SHAPE_POLY_SE
 
                 // Get next closest segment.
 
-                graphic = findPoint( prevPt, segList, aTolerance );
+                graphic = segIndex.FindPoint( prevPt );
 
                 // If there are no more close segments, check if polygon
                 // can be closed.
@@ -700,30 +798,70 @@ bool ConvertOutlineToPolygon( std::vector<DRAWSEGMENT*>& aSegList, SHAPE_POLY_SE
         }
     }
 
-    // All of the silliness that follows is to work around the segment iterator
-    // while checking for collisions.
-    // TODO: Implement proper segment and point iterators that follow std
-    for( auto seg1 = aPolygons.IterateSegmentsWithHoles(); seg1; seg1++ )
+    // Only segments with overlapping bounding boxes can collide, so the segments are
+    // indexed in an R-tree and each one is only tested against its neighbours.  They are
+    // still tested in the outline order, so the same collision is reported as when testing
+    // all the pairs.
+    std::vector<SEG>           segments;
+    RTree<int, int, 2, double> segTree;
+
+    for( auto seg = aPolygons.IterateSegmentsWithHoles(); seg; seg++ )
+        segments.push_back( *seg );
+
+    auto bounds = []( const SEG& aSeg, int aMin[2], int aMax[2] )
+    {
+        aMin[0] = std::min( aSeg.A.x, aSeg.B.x );
+        aMin[1] = std::min( aSeg.A.y, aSeg.B.y );
+        aMax[0] = std::max( aSeg.A.x, aSeg.B.x );
+        aMax[1] = std::max( aSeg.A.y, aSeg.B.y );
+    };
+
+    for( size_t i = 0; i < segments.size(); i++ )
+    {
+        int mmin[2], mmax[2];
+
+        bounds( segments[i], mmin, mmax );
+        segTree.Insert( mmin, mmax, (int) i );
+    }
+
+    std::vector<int> candidates;
+
+    for( size_t i = 0; i < segments.size(); i++ )
     {
-        auto seg2 = seg1;
+        const SEG& seg1 = segments[i];
+        int        mmin[2], mmax[2];
 
-        for( ++seg2; seg2; seg2++ )
+        bounds( seg1, mmin, mmax );
+        candidates.clear();
+
+        segTree.Search( mmin, mmax, [&]( const int& aIndex )
+                                    {
+                                        if( aIndex > (int) i )
+                                            candidates.push_back( aIndex );
+
+                                        return true;
+                                    } );
+
+        std::sort( candidates.begin(), candidates.end() );
+
+        for( int j : candidates )
         {
+            const SEG& seg2 = segments[j];
+
             // Check for exact overlapping segments.  This is not viewed
             // as an intersection below
-            if( *seg1 == *seg2 ||
-                    ( ( *seg1 ).A == ( *seg2 ).B && ( *seg1 ).B == ( *seg2 ).A ) )
+            if( seg1 == seg2 || ( seg1.A == seg2.B && seg1.B == seg2.A ) )
             {
                 if( aErrorLocation )
                 {
-                    aErrorLocation->x = ( *seg1 ).A.x;
-                    aErrorLocation->y = ( *seg1 ).A.y;
+                    aErrorLocation->x = seg1.A.x;
+                    aErrorLocation->y = seg1.A.y;
                 }
 
                 return false;
             }
 
-            if( auto pt = seg1.Get().Intersect( seg2.Get(), true ) )
+            if( auto pt = seg1.Intersect( seg2, true ) )
             {
                 if( aErrorLocation )
                 {
@@ -45,63 +45,6 @@
 #include <thread>
 using namespace std::placeholders;
 
-const LAYER_NUM GAL_LAYER_ORDER[] =
-{
-    LAYER_GP_OVERLAY,
-    LAYER_SELECT_OVERLAY,
-    LAYER_DRC,
-    LAYER_PADS_NETNAMES, LAYER_VIAS_NETNAMES,
-    Dwgs_User, Cmts_User, Eco1_User, Eco2_User, Edge_Cuts,
-
-    LAYER_MOD_TEXT_FR,
-    LAYER_MOD_REFERENCES, LAYER_MOD_VALUES,
-
-    LAYER_RATSNEST, LAYER_ANCHOR,
-    LAYER_VIAS_HOLES, LAYER_PADS_PLATEDHOLES, LAYER_NON_PLATEDHOLES,
-    LAYER_VIA_THROUGH, LAYER_VIA_BBLIND,
-    LAYER_VIA_MICROVIA, LAYER_PADS_TH,
-
-    LAYER_PAD_FR_NETNAMES, LAYER_PAD_FR,
-    NETNAMES_LAYER_INDEX( F_Cu ), F_Cu, F_Mask, F_SilkS, F_Paste, F_Adhes, F_CrtYd, F_Fab,
-
-    NETNAMES_LAYER_INDEX( In1_Cu ),   In1_Cu,
-    NETNAMES_LAYER_INDEX( In2_Cu ),   In2_Cu,
-    NETNAMES_LAYER_INDEX( In3_Cu ),   In3_Cu,
-    NETNAMES_LAYER_INDEX( In4_Cu ),   In4_Cu,
-    NETNAMES_LAYER_INDEX( In5_Cu ),   In5_Cu,
-    NETNAMES_LAYER_INDEX( In6_Cu ),   In6_Cu,
-    NETNAMES_LAYER_INDEX( In7_Cu ),   In7_Cu,
-    NETNAMES_LAYER_INDEX( In8_Cu ),   In8_Cu,
-    NETNAMES_LAYER_INDEX( In9_Cu ),   In9_Cu,
-    NETNAMES_LAYER_INDEX( In10_Cu ),  In10_Cu,
-    NETNAMES_LAYER_INDEX( In11_Cu ),  In11_Cu,
-    NETNAMES_LAYER_INDEX( In12_Cu ),  In12_Cu,
-    NETNAMES_LAYER_INDEX( In13_Cu ),  In13_Cu,
-    NETNAMES_LAYER_INDEX( In14_Cu ),  In14_Cu,
-    NETNAMES_LAYER_INDEX( In15_Cu ),  In15_Cu,
-    NETNAMES_LAYER_INDEX( In16_Cu ),  In16_Cu,
-    NETNAMES_LAYER_INDEX( In17_Cu ),  In17_Cu,
-    NETNAMES_LAYER_INDEX( In18_Cu ),  In18_Cu,
-    NETNAMES_LAYER_INDEX( In19_Cu ),  In19_Cu,
-    NETNAMES_LAYER_INDEX( In20_Cu ),  In20_Cu,
-    NETNAMES_LAYER_INDEX( In21_Cu ),  In21_Cu,
-    NETNAMES_LAYER_INDEX( In22_Cu ),  In22_Cu,
-    NETNAMES_LAYER_INDEX( In23_Cu ),  In23_Cu,
-    NETNAMES_LAYER_INDEX( In24_Cu ),  In24_Cu,
-    NETNAMES_LAYER_INDEX( In25_Cu ),  In25_Cu,
-    NETNAMES_LAYER_INDEX( In26_Cu ),  In26_Cu,
-    NETNAMES_LAYER_INDEX( In27_Cu ),  In27_Cu,
-    NETNAMES_LAYER_INDEX( In28_Cu ),  In28_Cu,
-    NETNAMES_LAYER_INDEX( In29_Cu ),  In29_Cu,
-    NETNAMES_LAYER_INDEX( In30_Cu ),  In30_Cu,
-
-    LAYER_PAD_BK_NETNAMES, LAYER_PAD_BK,
-    NETNAMES_LAYER_INDEX( B_Cu ), B_Cu, B_Mask, B_Adhes, B_Paste, B_SilkS, B_CrtYd, B_Fab,
-
-    LAYER_MOD_TEXT_BK,
-    LAYER_WORKSHEET
-};
-
 
 PCB_DRAW_PANEL_GAL::PCB_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWindowId,
                                         const wxPoint& aPosition, const wxSize& aSize,
@@ -302,7 +245,7 @@ void PCB_DRAW_PANEL_GAL::SetTopLayer( PCB_LAYER_ID aLayer )
 
         // Move the active layer to the top
         if( !IsCopperLayer( aLayer ) )
-            m_view->SetLayerOrder( aLayer, m_view->GetLayerOrder( GAL_LAYER_ORDER[0] ) );
+            m_view->SetLayerOrder( aLayer, m_view->GetLayerOrder( LAYER_GP_OVERLAY ) );
     }
     else if( IsCopperLayer( aLayer ) )
     {
@@ -404,13 +347,7 @@ void PCB_DRAW_PANEL_GAL::OnShow()
 
 void PCB_DRAW_PANEL_GAL::setDefaultLayerOrder()
 {
-    for( LAYER_NUM i = 0; (unsigned) i < sizeof( GAL_LAYER_ORDER ) / sizeof( LAYER_NUM ); ++i )
-    {
-        LAYER_NUM layer = GAL_LAYER_ORDER[i];
-        wxASSERT( layer < KIGFX::VIEW::VIEW_MAX_LAYERS );
-
-        m_view->SetLayerOrder( layer, i );
-    }
+    GetView()->SetDefaultLayerOrder();
 }
 
 
@@ -442,54 +379,7 @@ BOX2I PCB_DRAW_PANEL_GAL::GetDefaultViewBBox() const
 void PCB_DRAW_PANEL_GAL::setDefaultLayerDeps()
 {
     // caching makes no sense for Cairo and other software renderers
-    auto target = m_backend == GAL_TYPE_OPENGL ? KIGFX::TARGET_CACHED : KIGFX::TARGET_NONCACHED;
-
-    for( int i = 0; i < KIGFX::VIEW::VIEW_MAX_LAYERS; i++ )
-        m_view->SetLayerTarget( i, target );
-
-    for( LAYER_NUM i = 0; (unsigned) i < sizeof( GAL_LAYER_ORDER ) / sizeof( LAYER_NUM ); ++i )
-    {
-        LAYER_NUM layer = GAL_LAYER_ORDER[i];
-        wxASSERT( layer < KIGFX::VIEW::VIEW_MAX_LAYERS );
-
-        // Set layer display dependencies & targets
-        if( IsCopperLayer( layer ) )
-            m_view->SetRequired( GetNetnameLayer( layer ), layer );
-        else if( IsNetnameLayer( layer ) )
-            m_view->SetLayerDisplayOnly( layer );
-    }
-
-    m_view->SetLayerTarget( LAYER_ANCHOR, KIGFX::TARGET_NONCACHED );
-    m_view->SetLayerDisplayOnly( LAYER_ANCHOR );
-
-    // Some more required layers settings
-    m_view->SetRequired( LAYER_VIAS_HOLES, LAYER_VIA_THROUGH );
-    m_view->SetRequired( LAYER_VIAS_NETNAMES, LAYER_VIA_THROUGH );
-    m_view->SetRequired( LAYER_PADS_PLATEDHOLES, LAYER_PADS_TH );
-    m_view->SetRequired( LAYER_NON_PLATEDHOLES, LAYER_PADS_TH );
-    m_view->SetRequired( LAYER_PADS_NETNAMES, LAYER_PADS_TH );
-
-    // Front modules
-    m_view->SetRequired( LAYER_PAD_FR, F_Cu );
-    m_view->SetRequired( LAYER_MOD_TEXT_FR, LAYER_MOD_FR );
-    m_view->SetRequired( LAYER_PAD_FR_NETNAMES, LAYER_PAD_FR );
-
-    // Back modules
-    m_view->SetRequired( LAYER_PAD_BK, B_Cu );
-    m_view->SetRequired( LAYER_MOD_TEXT_BK, LAYER_MOD_BK );
-    m_view->SetRequired( LAYER_PAD_BK_NETNAMES, LAYER_PAD_BK );
-
-    m_view->SetLayerTarget( LAYER_SELECT_OVERLAY , KIGFX::TARGET_OVERLAY );
-    m_view->SetLayerDisplayOnly( LAYER_SELECT_OVERLAY ) ;
-    m_view->SetLayerTarget( LAYER_GP_OVERLAY , KIGFX::TARGET_OVERLAY );
-    m_view->SetLayerDisplayOnly( LAYER_GP_OVERLAY ) ;
-    m_view->SetLayerTarget( LAYER_RATSNEST, KIGFX::TARGET_OVERLAY );
-    m_view->SetLayerDisplayOnly( LAYER_RATSNEST );
-
-    m_view->SetLayerTarget( LAYER_WORKSHEET, KIGFX::TARGET_NONCACHED );
-    m_view->SetLayerDisplayOnly( LAYER_WORKSHEET ) ;
-    m_view->SetLayerDisplayOnly( LAYER_GRID );
-    m_view->SetLayerDisplayOnly( LAYER_DRC );
+    GetView()->SetDefaultLayerDeps( m_backend == GAL_TYPE_OPENGL );
 }
 
 
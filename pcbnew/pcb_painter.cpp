@@ -375,6 +375,46 @@ bool PCB_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
 }
 
 
+void PCB_PAINTER::PrepareDraw( VIEW_ITEM* aItem )
+{
+    // Only OpenGL draws the polygons with triangles
+    if( !m_gal->IsOpenGlEngine() )
+        return;
+
+    EDA_ITEM* item = dynamic_cast<EDA_ITEM*>( aItem );
+
+    if( !item )
+        return;
+
+    switch( item->Type() )
+    {
+    case PCB_LINE_T:
+    case PCB_MODULE_EDGE_T:
+    {
+        DRAWSEGMENT* segment = static_cast<DRAWSEGMENT*>( item );
+
+        if( segment->GetShape() == S_POLYGON && !segment->GetPolyShape().IsTriangulationUpToDate() )
+            segment->GetPolyShape().CacheTriangulation();
+
+        break;
+    }
+
+    case PCB_ZONE_AREA_T:
+    {
+        ZONE_CONTAINER* zone = static_cast<ZONE_CONTAINER*>( item );
+
+        if( !zone->GetFilledPolysList().IsTriangulationUpToDate() )
+            zone->CacheTriangulation();
+
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+
 void PCB_PAINTER::draw( const TRACK* aTrack, int aLayer )
 {
     VECTOR2D start( aTrack->GetStart() );
@@ -52,6 +52,16 @@ public:
     virtual void Update( VIEW_ITEM* aItem ) override;
 
     void UpdateDisplayOptions( PCB_DISPLAY_OPTIONS* aOptions );
+
+    ///> Reassigns layer order to the initial settings.
+    void SetDefaultLayerOrder();
+
+    /**
+     * Sets rendering targets & dependencies for layers.
+     * @param aCachedTargets selects cached targets for the board layers, only useful
+     * with a GAL able to cache the drawn items (i.e. OpenGL).
+     */
+    void SetDefaultLayerDeps( bool aCachedTargets );
 };
 
 }
@@ -395,9 +395,10 @@ bool SELECTION_TOOL::selectPoint( const VECTOR2I& aWhere, bool aOnDrag,
 
     guide.SetIgnoreZoneFills( displayOpts->m_DisplayZonesMode != 0 );
 
+    // The view is used as a spatial index, so only the items under the cursor are hit-tested
     collector.Collect( board(),
         m_editModules ? GENERAL_COLLECTOR::ModuleItems : GENERAL_COLLECTOR::AllBoardItems,
-        wxPoint( aWhere.x, aWhere.y ), guide );
+        wxPoint( aWhere.x, aWhere.y ), guide, view() );
 
     // Remove unselectable items
     for( int i = collector.GetCount() - 1; i >= 0; --i )
@@ -38,6 +38,10 @@
 #include <tools/global_edit_tool.h>
 #include <tracks_cleaner.h>
 
+#include <algorithm>
+#include <tuple>
+#include <unordered_map>
+
 
 /* Install the cleanup dialog frame to know what should be cleaned
 */
@@ -51,6 +55,69 @@ int GLOBAL_EDIT_TOOL::CleanupTracksAndVias( const TOOL_EVENT& aEvent )
 }
 
 
+namespace
+{
+
+inline void hashCombine( size_t& aSeed, int aValue )
+{
+    aSeed ^= std::hash<int>()( aValue ) + 0x9e3779b9 + ( aSeed << 6 ) + ( aSeed >> 2 );
+}
+
+
+struct POINT_HASH
+{
+    size_t operator()( const wxPoint& aPoint ) const
+    {
+        size_t seed = 0;
+        hashCombine( seed, aPoint.x );
+        hashCombine( seed, aPoint.y );
+        return seed;
+    }
+};
+
+
+/// Identifies the segments having the same ends (in any order), width and layer
+struct SEGMENT_KEY
+{
+    SEGMENT_KEY( const wxPoint& aStart, const wxPoint& aEnd, int aWidth, PCB_LAYER_ID aLayer ) :
+            m_width( aWidth ),
+            m_layer( aLayer )
+    {
+        bool ordered = std::tie( aStart.x, aStart.y ) <= std::tie( aEnd.x, aEnd.y );
+
+        m_a = ordered ? aStart : aEnd;
+        m_b = ordered ? aEnd : aStart;
+    }
+
+    bool operator==( const SEGMENT_KEY& aOther ) const
+    {
+        return m_a == aOther.m_a && m_b == aOther.m_b && m_width == aOther.m_width
+               && m_layer == aOther.m_layer;
+    }
+
+    wxPoint      m_a;
+    wxPoint      m_b;
+    int          m_width;
+    PCB_LAYER_ID m_layer;
+};
+
+
+struct SEGMENT_KEY_HASH
+{
+    size_t operator()( const SEGMENT_KEY& aKey ) const
+    {
+        size_t seed = POINT_HASH()( aKey.m_a );
+        hashCombine( seed, aKey.m_b.x );
+        hashCombine( seed, aKey.m_b.y );
+        hashCombine( seed, aKey.m_width );
+        hashCombine( seed, aKey.m_layer );
+        return seed;
+    }
+};
+
+} // namespace
+
+
 TRACKS_CLEANER::TRACKS_CLEANER( EDA_UNITS_T aUnits, BOARD* aPcb, BOARD_COMMIT& aCommit ) :
         m_units( aUnits ),
         m_brd( aPcb ),
@@ -172,9 +239,15 @@ bool TRACKS_CLEANER::cleanupVias()
             vias.push_back( via );
     }
 
-    for( auto via1_it = vias.begin(); via1_it != vias.end(); via1_it++ )
+    // Vias sharing the same position, in the board order
+    std::unordered_map<wxPoint, std::vector<size_t>, POINT_HASH> viasByPosition;
+
+    for( size_t i = 0; i < vias.size(); ++i )
+        viasByPosition[vias[i]->GetPosition()].push_back( i );
+
+    for( size_t i = 0; i < vias.size(); ++i )
     {
-        auto via1 = *via1_it;
+        auto via1 = vias[i];
 
         if( via1->IsLocked() )
             continue;
@@ -205,11 +278,14 @@ bool TRACKS_CLEANER::cleanupVias()
             }
         }
 
-        for( auto via2_it = via1_it + 1; via2_it != vias.end(); via2_it++ )
+        const std::vector<size_t>& sameposition = viasByPosition[via1->GetPosition()];
+
+        for( auto it = std::upper_bound( sameposition.begin(), sameposition.end(), i );
+                it != sameposition.end(); ++it )
         {
-            auto via2 = *via2_it;
+            auto via2 = vias[*it];
 
-            if( via1->GetPosition() != via2->GetPosition() || via2->IsLocked() )
+            if( via2->IsLocked() )
                 continue;
 
             if( via1->GetViaType() == via2->GetViaType() )
@@ -403,35 +479,68 @@ bool TRACKS_CLEANER::cleanupSegments()
 
     std::set<BOARD_ITEM*> toRemove;
 
-    // Remove duplicate segments (2 superimposed identical segments):
-    for( auto it = m_brd->Tracks().begin(); it != m_brd->Tracks().end(); it++ )
+    // Remove duplicate segments (2 superimposed identical segments).
+    // Segments are indexed by their ends, so a segment is only compared to the ones it
+    // may be a duplicate of, instead of all the tracks
+    std::vector<TRACK*> tracks( m_brd->Tracks().begin(), m_brd->Tracks().end() );
+    std::unordered_map<SEGMENT_KEY, std::vector<size_t>, SEGMENT_KEY_HASH> tracksByEnds;
+
+    for( size_t i = 0; i < tracks.size(); ++i )
     {
-        auto track1 = *it;
+        TRACK* track = tracks[i];
+        tracksByEnds[SEGMENT_KEY( track->GetStart(), track->GetEnd(), track->GetWidth(),
+                                  track->GetLayer() )].push_back( i );
+    }
+
+    for( size_t i = 0; i < tracks.size(); ++i )
+    {
+        auto track1 = tracks[i];
 
         if( track1->Type() != PCB_TRACE_T || track1->HasFlag( IS_DELETED ) || track1->IsLocked() )
             continue;
 
-        for( auto it2 = it + 1; it2 != m_brd->Tracks().end(); it2++ )
+        // Both ends of a duplicate are on the ends of track1, so it either has the same
+        // ends or is a null segment on one of them. Candidates are tested in the board order.
+        std::vector<size_t> candidates;
+
+        auto addCandidates = [&]( const wxPoint& aStart, const wxPoint& aEnd )
+        {
+            auto it = tracksByEnds.find( SEGMENT_KEY( aStart, aEnd, track1->GetWidth(),
+                                                      track1->GetLayer() ) );
+
+            if( it != tracksByEnds.end() )
+            {
+                candidates.insert( candidates.end(),
+                                   std::upper_bound( it->second.begin(), it->second.end(), i ),
+                                   it->second.end() );
+            }
+        };
+
+        addCandidates( track1->GetStart(), track1->GetEnd() );
+
+        if( track1->GetStart() != track1->GetEnd() )
+        {
+            addCandidates( track1->GetStart(), track1->GetStart() );
+            addCandidates( track1->GetEnd(), track1->GetEnd() );
+        }
+
+        std::sort( candidates.begin(), candidates.end() );
+
+        for( size_t candidate : candidates )
         {
-            auto track2 = *it2;
+            auto track2 = tracks[candidate];
 
             if( track2->HasFlag( IS_DELETED ) )
                 continue;
 
-            if( track1->IsPointOnEnds( track2->GetStart() )
-                    && track1->IsPointOnEnds( track2->GetEnd() )
-                    && ( track1->GetWidth() == track2->GetWidth() )
-                    && ( track1->GetLayer() == track2->GetLayer() ) )
+            if( m_itemsList )
             {
-                if( m_itemsList )
-                {
-                    m_itemsList->emplace_back( new DRC_ITEM( m_units, DRCE_DUPLICATE_TRACK, track2,
-                            track2->GetPosition(), nullptr, wxPoint() ) );
-                }
-
-                track2->SetFlags( IS_DELETED );
-                toRemove.insert( track2 );
+                m_itemsList->emplace_back( new DRC_ITEM( m_units, DRCE_DUPLICATE_TRACK, track2,
+                        track2->GetPosition(), nullptr, wxPoint() ) );
             }
+
+            track2->SetFlags( IS_DELETED );
+            toRemove.insert( track2 );
         }
     }
 
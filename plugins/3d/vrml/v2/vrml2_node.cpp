@@ -24,6 +24,7 @@
 
 #include <set>
 #include <map>
+#include <mutex>
 #include <utility>
 #include <iterator>
 #include <cctype>
@@ -40,6 +41,7 @@ static std::set< std::string > badNames;
 typedef std::pair< std::string, WRL2NODES > NODEITEM;
 typedef std::map< std::string, WRL2NODES > NODEMAP;
 static NODEMAP nodenames;
+static std::once_flag namesInit;
 
 
 WRL2NODE::WRL2NODE()
@@ -48,7 +50,8 @@ WRL2NODE::WRL2NODE()
     m_Parent = NULL;
     m_Type = WRL2_END;
 
-    if( badNames.empty() )
+    // filled once for all threads, S3D_CACHE::PreloadModels() reads models concurrently
+    std::call_once( namesInit, []()
     {
         badNames.insert( "DEF" );
         badNames.insert( "EXTERNPROTO" );
@@ -64,10 +67,7 @@ WRL2NODE::WRL2NODE()
         badNames.insert( "eventOut" );
         badNames.insert( "exposedField" );
         badNames.insert( "field" );
-    }
 
-    if( nodenames.empty() )
-    {
         nodenames.insert( NODEITEM( "Anchor", WRL2_ANCHOR ) );
         nodenames.insert( NODEITEM( "Appearance", WRL2_APPEARANCE ) );
         nodenames.insert( NODEITEM( "Audioclip", WRL2_AUDIOCLIP ) );
@@ -122,7 +122,7 @@ WRL2NODE::WRL2NODE()
         nodenames.insert( NODEITEM( "ViewPoint", WRL2_VIEWPOINT ) );
         nodenames.insert( NODEITEM( "VisibilitySensor", WRL2_VISIBILITYSENSOR ) );
         nodenames.insert( NODEITEM( "WorldInfo", WRL2_WORLDINFO ) );
-    }
+    } );
 
     return;
 }
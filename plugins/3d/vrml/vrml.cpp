@@ -285,15 +285,21 @@ SCENEGRAPH* Load( char const* aFileName )
     if( !wxFileName::FileExists( fname ) )
         return NULL;
 
-    LOCALESWITCH switcher;
-
     SCENEGRAPH* scene = NULL;
     wxString ext = wxFileName( fname ).GetExt();
 
     if( ext == "x3d" || ext == "X3D" )
+    {
+        // X3D numbers are read by wxString::ToDouble(), which follows LC_NUMERIC
+        LOCALESWITCH switcher;
         scene = LoadX3D( fname );
+    }
     else
+    {
+        // WRLPROC reads numbers regardless of the locale, so VRML files do not change
+        // the process wide locale and can be read by several threads at once
         scene = LoadVRML( fname, true );
+    }
 
     return scene;
 }
@@ -21,8 +21,21 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <cfloat>
+#include <climits>
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <string>
+
+#if defined( __APPLE__ ) || defined( __FreeBSD__ )
+#include <xlocale.h>
+#endif
+
 #include <wx/filename.h>
 #include <wx/string.h>
 #include <wx/log.h>
@@ -46,6 +59,181 @@
     } } while( 0 )
 
 
+// Parsing of a float with strtof() in the "C" locale, whatever the locale of the process
+static float strtofC( const char* aNumber )
+{
+#ifdef _WIN32
+    static _locale_t cLocale = _create_locale( LC_NUMERIC, "C" );
+
+    return _strtof_l( aNumber, NULL, cLocale );
+#else
+    static locale_t cLocale = newlocale( LC_NUMERIC_MASK, "C", (locale_t) 0 );
+
+    return strtof_l( aNumber, NULL, cLocale );
+#endif
+}
+
+
+// True if a positive double in the range of the normal floats is halfway between two floats
+static bool isFloatHalfway( double aValue )
+{
+    uint64_t bits;
+    memcpy( &bits, &aValue, sizeof( bits ) );
+
+    // a double has 29 more significand bits than a float
+    return ( bits & ( ( 1ULL << 29 ) - 1 ) ) == ( 1ULL << 28 );
+}
+
+
+// Locale independent parsing of a float from a glob; fails unless the whole
+// glob is a number, like reading it with an istringstream does.  The value is
+// the float nearest to the number, as strtof() gives.
+static bool parseFloat( const char* aStart, const char* aEnd, float& aValue )
+{
+    // powers of 10 which are exact in a double
+    static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+                                    1e20, 1e21, 1e22 };
+
+    const char* cp = aStart;
+    bool negative = false;
+
+    if( cp < aEnd && ( '-' == *cp || '+' == *cp ) )
+        negative = ( '-' == *cp++ );
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int digits = 0;
+    bool truncated = false;     // set if non zero digits did not fit in the mantissa
+
+    for( ; cp < aEnd && *cp >= '0' && *cp <= '9'; ++cp, ++digits )
+    {
+        if( mantissa < 100000000000000000ULL )
+        {
+            mantissa = mantissa * 10 + ( *cp - '0' );
+        }
+        else
+        {
+            truncated = truncated || *cp != '0';
+            ++exponent;
+        }
+    }
+
+    if( cp < aEnd && '.' == *cp )
+    {
+        for( ++cp; cp < aEnd && *cp >= '0' && *cp <= '9'; ++cp, ++digits )
+        {
+            if( mantissa < 100000000000000000ULL )
+            {
+                mantissa = mantissa * 10 + ( *cp - '0' );
+                --exponent;
+            }
+            else
+            {
+                truncated = truncated || *cp != '0';
+            }
+        }
+    }
+
+    if( 0 == digits )
+        return false;
+
+    if( cp < aEnd && ( 'e' == *cp || 'E' == *cp ) )
+    {
+        bool expNegative = false;
+        int expValue = 0;
+
+        if( ++cp < aEnd && ( '-' == *cp || '+' == *cp ) )
+            expNegative = ( '-' == *cp++ );
+
+        if( cp == aEnd )
+            return false;
+
+        for( ; cp < aEnd && *cp >= '0' && *cp <= '9'; ++cp )
+        {
+            if( expValue < 10000 )
+                expValue = expValue * 10 + ( *cp - '0' );
+        }
+
+        exponent += expNegative ? -expValue : expValue;
+    }
+
+    if( cp != aEnd )
+        return false;
+
+    if( 0 == mantissa )
+    {
+        aValue = negative ? -0.0f : 0.0f;
+        return true;
+    }
+
+    // The mantissa and the power of 10 are exact, so one operation gives the double
+    // nearest to the number.  Rounding that double to a float gives the nearest float
+    // too, except when it is halfway between two floats or out of the normal floats.
+    if( !truncated && mantissa <= ( 1ULL << 53 ) && exponent >= -22 && exponent <= 22 )
+    {
+        double value = (double) mantissa;
+
+        if( exponent < 0 )
+            value /= pow10[-exponent];
+        else
+            value *= pow10[exponent];
+
+        if( value >= FLT_MIN && value <= FLT_MAX && !isFloatHalfway( value ) )
+        {
+            aValue = (float) ( negative ? -value : value );
+            return true;
+        }
+    }
+
+    // Long mantissas, large exponents, denormals and halfway cases
+    std::string number( aStart, aEnd );
+    float value = strtofC( number.c_str() );
+
+    if( std::isinf( value ) )
+        return false;
+
+    aValue = value;
+    return true;
+}
+
+
+// Parsing of a decimal int from a glob; fails unless the whole glob is a number
+static bool parseInt( const char* aStart, const char* aEnd, int& aValue )
+{
+    const char* cp = aStart;
+    bool negative = false;
+
+    if( cp < aEnd && ( '-' == *cp || '+' == *cp ) )
+        negative = ( '-' == *cp++ );
+
+    if( cp == aEnd )
+        return false;
+
+    int64_t value = 0;
+
+    for( ; cp < aEnd; ++cp )
+    {
+        if( *cp < '0' || *cp > '9' )
+            return false;
+
+        value = value * 10 + ( *cp - '0' );
+
+        if( value > (int64_t) INT_MAX + 1 )
+            return false;
+    }
+
+    if( negative )
+        value = -value;
+
+    if( value > INT_MAX )
+        return false;
+
+    aValue = (int) value;
+    return true;
+}
+
+
 WRLPROC::WRLPROC( LINE_READER* aLineReader )
 {
     m_fileVersion = VRML_INVALID;
@@ -237,6 +425,21 @@ bool WRLPROC::ReadGlob( std::string& aGlob )
 {
     aGlob.clear();
 
+    size_t start;
+    size_t end;
+
+    if( !readGlobRange( start, end ) )
+        return false;
+
+    aGlob.assign( m_buf, start, end - start );
+    return true;
+}
+
+
+bool WRLPROC::readGlobRange( size_t& aStart, size_t& aEnd )
+{
+    aStart = aEnd = m_bufpos;
+
     if( !m_file )
     {
         m_error = "no open file";
@@ -256,6 +459,7 @@ bool WRLPROC::ReadGlob( std::string& aGlob )
     }
 
     size_t ssize = m_buf.size();
+    aStart = aEnd = m_bufpos;
 
     while( m_bufpos < ssize && m_buf[m_bufpos] > 0x20 )
     {
@@ -270,7 +474,7 @@ bool WRLPROC::ReadGlob( std::string& aGlob )
             || '[' == m_buf[m_bufpos] || ']' == m_buf[m_bufpos] )
             return true;
 
-        aGlob.append( 1, m_buf[m_bufpos++] );
+        aEnd = ++m_bufpos;
     }
 
     return true;
@@ -811,9 +1015,10 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
             break;
     }
 
-    std::string tmp;
+    size_t start;
+    size_t end;
 
-    if( !ReadGlob( tmp ) )
+    if( !readGlobRange( start, end ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -826,11 +1031,7 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
         return false;
     }
 
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFFloat;
-
-    if( istr.fail() || !istr.eof() )
+    if( !parseFloat( m_buf.data() + start, m_buf.data() + end, aSFFloat ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -871,9 +1072,10 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
             break;
     }
 
-    std::string tmp;
+    size_t start;
+    size_t end;
 
-    if( !ReadGlob( tmp ) )
+    if( !readGlobRange( start, end ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -886,21 +1088,24 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
         return false;
     }
 
-    if( std::string::npos != tmp.find( "0x" ) )
+    // Only look at the token itself: searching the rest of the buffer for "0x" would make
+    // reading an array written on a single line quadratic
+    size_t digits = start;
+
+    if( digits < end && ( m_buf[digits] == '-' || m_buf[digits] == '+' ) )
+        ++digits;
+
+    if( digits + 2 <= end && m_buf.compare( digits, 2, "0x" ) == 0 )
     {
         // Rules: "0x" + "0-9, A-F" - VRML is case sensitive but in
         // this instance we do no enforce case.
         std::stringstream sstr;
-        sstr << std::hex << tmp;
+        sstr << std::hex << m_buf.substr( start, end - start );
         sstr >> aSFInt32;
         return true;
     }
 
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFInt32;
-
-    if( istr.fail() || !istr.eof() )
+    if( !parseInt( m_buf.data() + start, m_buf.data() + end, aSFInt32 ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -945,12 +1150,13 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
             break;
     }
 
-    std::string tmp;
+    size_t start;
+    size_t end;
     float trot[4];
 
     for( int i = 0; i < 4; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        if( !readGlobRange( start, end ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -963,11 +1169,7 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
             return false;
         }
 
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> trot[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !parseFloat( m_buf.data() + start, m_buf.data() + end, trot[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1017,13 +1219,14 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
             break;
     }
 
-    std::string tmp;
+    size_t start;
+    size_t end;
 
     float tcol[2];
 
     for( int i = 0; i < 2; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        if( !readGlobRange( start, end ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1036,11 +1239,7 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
             return false;
         }
 
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !parseFloat( m_buf.data() + start, m_buf.data() + end, tcol[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1089,13 +1288,14 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             break;
     }
 
-    std::string tmp;
+    size_t start;
+    size_t end;
 
     float tcol[3];
 
     for( int i = 0; i < 3; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        if( !readGlobRange( start, end ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1108,18 +1308,8 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             return false;
         }
 
-        // ignore any commas
-        if( !EatSpace() )
-            return false;
-
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
-
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
+        // the glob must be parsed before reading on, which may load the next line
+        if( !parseFloat( m_buf.data() + start, m_buf.data() + end, tcol[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1132,6 +1322,12 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             return false;
         }
 
+        // ignore any commas
+        if( !EatSpace() )
+            return false;
+
+        if( ',' == m_buf[m_bufpos] )
+            Pop();
     }
 
     aSFVec3f.x = tcol[0];
@@ -58,6 +58,10 @@ private:
     // parameters are updated as appropriate.
     bool getRawLine( void );
 
+    // readGlobRange does the same as ReadGlob() but returns the position of the
+    // glob in m_buf instead of a copy; the range is valid until the next read.
+    bool readGlobRange( size_t& aStart, size_t& aEnd );
+
 public:
     WRLPROC( LINE_READER* aLineReader );
     ~WRLPROC();
@@ -30,6 +30,8 @@
 #ifndef PLUGINLDR3D_H
 #define PLUGINLDR3D_H
 
+#include <mutex>
+
 #include "../pluginldr.h"
 
 class SCENEGRAPH;
@@ -59,6 +61,10 @@ private:
     PLUGIN_3D_CAN_RENDER            m_canRender;
     PLUGIN_3D_LOAD                  m_load;
 
+    // guards the loader state in CanRender() and Load(), which may be called by several
+    // threads; the plugin itself is called without it
+    std::mutex                      m_lock;
+
 public:
     KICAD_PLUGIN_LDR_3D();
     virtual ~KICAD_PLUGIN_LDR_3D();
@@ -84,6 +90,11 @@ public:
 
     bool CanRender( void );
 
+    /**
+     * Function Load
+     * reads a model with the plugin.  Several threads may call it at once, but then
+     * the plugin itself must be able to read several models concurrently.
+     */
     SCENEGRAPH* Load( char const* aFileName );
 };
 
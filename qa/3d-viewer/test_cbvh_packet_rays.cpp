@@ -0,0 +1,359 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the ray packet tests of the BVH packet traversal
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <3d_rendering/3d_render_raytracing/accelerators/cbvh_packet_rays.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+
+
+/**
+ * A packet of rays, their closest hits and a box, to check the box tests of PACKET_RAYS
+ * against CBBOX::Intersect()
+ */
+class PACKET_RAYS_FIXTURE
+{
+public:
+    PACKET_RAYS_FIXTURE() :
+            m_rng( 1234 ),
+            m_unit( 0.0f, 1.0f ),
+            m_hitCount( 0 ),
+            m_rayCount( 0 ),
+            m_grazingCount( 0 )
+    {
+        for( HITINFO_PACKET& hit : m_hits )
+        {
+            hit.m_hitresult = false;
+            hit.m_HitInfo.m_tHit = FLT_MAX;
+        }
+    }
+
+    /// A random number in [aMin, aMax)
+    float Random( float aMin, float aMax )
+    {
+        return aMin + ( aMax - aMin ) * m_unit( m_rng );
+    }
+
+    /// Sets m_box to a random box in the [-1, 1] cube
+    void RandomBox()
+    {
+        SFVEC3F min( Random( -1.0f, 0.9f ), Random( -1.0f, 0.9f ), Random( -1.0f, 0.9f ) );
+        SFVEC3F max( Random( min.x + 0.05f, 1.0f ), Random( min.y + 0.05f, 1.0f ),
+                     Random( min.z + 0.05f, 1.0f ) );
+
+        m_box = CBBOX( min, max );
+    }
+
+    /// A random point strictly inside m_box
+    SFVEC3F PointInBox()
+    {
+        const SFVEC3F& min = m_box.Min();
+        const SFVEC3F& max = m_box.Max();
+
+        return SFVEC3F( Random( 0.01f, 0.99f ) * ( max.x - min.x ) + min.x,
+                        Random( 0.01f, 0.99f ) * ( max.y - min.y ) + min.y,
+                        Random( 0.01f, 0.99f ) * ( max.z - min.z ) + min.z );
+    }
+
+    /// A random point in the [-3, 3] cube, mostly outside m_box
+    SFVEC3F PointAround()
+    {
+        return SFVEC3F( Random( -3.0f, 3.0f ), Random( -3.0f, 3.0f ), Random( -3.0f, 3.0f ) );
+    }
+
+    /**
+     * A random direction: towards m_box, away from it, or parallel to one or two axes.
+     * Zero components are set as -0.0f or 0.0f.
+     */
+    SFVEC3F Direction( const SFVEC3F& aOrigin, int aKind )
+    {
+        SFVEC3F dir( Random( -1.0f, 1.0f ), Random( -1.0f, 1.0f ), Random( -1.0f, 1.0f ) );
+
+        if( aKind == 0 )
+            dir = PointInBox() - aOrigin;
+
+        // Parallel to the axis aKind - 1, or orthogonal to the axis aKind - 4
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            if( ( aKind >= 1 && aKind <= 3 && axis != aKind - 1 ) || aKind - 4 == axis )
+                dir[axis] = ( m_rng() % 2 ) ? -0.0f : 0.0f;
+        }
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            // A direction too close to 0 would make the rounding errors meaningless
+            if( dir[axis] != 0.0f && std::fabs( dir[axis] ) < 1e-3f )
+                dir[axis] = 1e-3f;
+        }
+
+        if( dir.x == 0.0f && dir.y == 0.0f && dir.z == 0.0f )
+            dir.x = 1.0f;
+
+        return dir;
+    }
+
+    /**
+     * True if the ray grazes m_box, or enters it at about its closest hit.  The tests in
+     * float may then disagree, so the distances are computed in double.
+     */
+    bool IsGrazing( const RAY& aRay, float aHitT ) const
+    {
+        const double tolerance = 1e-4;
+
+        double tNear = -DBL_MAX;
+        double tFar = DBL_MAX;
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            const double origin = aRay.m_Origin[axis];
+            const double dir = aRay.m_Dir[axis];
+            const double min = m_box.Min()[axis];
+            const double max = m_box.Max()[axis];
+
+            if( dir == 0.0 )
+            {
+                if( origin < min - tolerance || origin > max + tolerance )
+                    return false;
+
+                if( origin < min + tolerance || origin > max - tolerance )
+                    return true;
+
+                continue;
+            }
+
+            double t0 = ( min - origin ) / dir;
+            double t1 = ( max - origin ) / dir;
+
+            if( t0 > t1 )
+                std::swap( t0, t1 );
+
+            tNear = std::max( tNear, t0 );
+            tFar = std::min( tFar, t1 );
+        }
+
+        const double scale = std::max( { 1.0, std::fabs( tNear ), std::fabs( tFar ) } );
+
+        return std::fabs( tFar - tNear ) <= tolerance * scale
+               || std::fabs( tFar ) <= tolerance * scale
+               || std::fabs( tNear - aHitT ) <= tolerance * scale;
+    }
+
+    /**
+     * Checks each group test of the packet finds the rays hitting m_box before their
+     * closest hit as CBBOX::Intersect() does, and at the same distance.  They may only
+     * disagree on grazing rays, as they do not round the distances the same way.
+     */
+    void CheckPacket()
+    {
+        PACKET_RAYS packet( m_rays, m_frustum, m_hits );
+
+        for( unsigned int group = 0; group < RAYPACKET_RAYS_PER_PACKET; group += BVH_SIMD_WIDTH )
+        {
+            float              tNear[BVH_SIMD_WIDTH];
+            const unsigned int mask = packet.GroupHits( m_box, group, tNear );
+
+            BOOST_CHECK_EQUAL( packet.GroupHits( m_box, group ), mask );
+
+            for( unsigned int ii = 0; ii < BVH_SIMD_WIDTH; ++ii )
+            {
+                const RAY&  ray = m_rays[group + ii];
+                const float hitT = m_hits[group + ii].m_HitInfo.m_tHit;
+                float       t;
+                const bool  expected = m_box.Intersect( ray, &t ) && t < hitT;
+                const bool  hit = ( mask >> ii ) & 1;
+
+                ++m_rayCount;
+
+                if( hit != expected )
+                {
+                    ++m_grazingCount;
+
+                    BOOST_CHECK_MESSAGE( IsGrazing( ray, hitT ),
+                                         "Ray " << group + ii << ( hit ? " hits" : " misses" )
+                                                << " the box, CBBOX::Intersect() tells the "
+                                                   "opposite" );
+                }
+                else if( hit )
+                {
+                    ++m_hitCount;
+
+                    BOOST_CHECK_MESSAGE(
+                            std::fabs( tNear[ii] - t ) <= 1e-5f * std::max( 1.0f, std::fabs( t ) ),
+                            "Ray " << group + ii << " enters the box at " << tNear[ii]
+                                   << ", CBBOX::Intersect() tells " << t );
+                }
+            }
+        }
+    }
+
+    /// Checks many rays were tested, with hits and misses, and few grazing ones
+    void CheckCounts()
+    {
+        BOOST_CHECK( m_hitCount > m_rayCount / 10 );
+        BOOST_CHECK( m_hitCount < m_rayCount );
+        BOOST_CHECK( m_grazingCount <= m_rayCount / 1000 );
+    }
+
+    std::mt19937                          m_rng;
+    std::uniform_real_distribution<float> m_unit;
+
+    CBBOX          m_box;
+    RAY            m_rays[RAYPACKET_RAYS_PER_PACKET];
+    CFRUSTUM       m_frustum;   ///< Not used by the group tests
+    HITINFO_PACKET m_hits[RAYPACKET_RAYS_PER_PACKET];
+
+    unsigned int m_hitCount;
+    unsigned int m_rayCount;
+    unsigned int m_grazingCount;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PacketRays, PACKET_RAYS_FIXTURE )
+
+
+#ifdef BVH_SIMD_WIDTH
+
+/**
+ * Rays from around the box, towards it or in random directions
+ */
+BOOST_AUTO_TEST_CASE( RandomRays )
+{
+    for( int packet = 0; packet < 2000; ++packet )
+    {
+        RandomBox();
+
+        for( RAY& ray : m_rays )
+        {
+            SFVEC3F origin = PointAround();
+            ray.Init( origin, Direction( origin, m_rng() % 2 ? 0 : -1 ) );
+        }
+
+        CheckPacket();
+    }
+
+    CheckCounts();
+}
+
+
+/**
+ * Rays parallel to one or two axes, with their origin in the slabs of the box or not
+ */
+BOOST_AUTO_TEST_CASE( AxisParallelRays )
+{
+    for( int packet = 0; packet < 2000; ++packet )
+    {
+        RandomBox();
+
+        for( RAY& ray : m_rays )
+        {
+            SFVEC3F origin = PointAround();
+
+            // Most rays start in the slabs of the box, so they hit it
+            if( m_rng() % 4 )
+            {
+                SFVEC3F inside = PointInBox();
+                int     axis = m_rng() % 3;
+
+                origin[( axis + 1 ) % 3] = inside[( axis + 1 ) % 3];
+                origin[( axis + 2 ) % 3] = inside[( axis + 2 ) % 3];
+            }
+
+            ray.Init( origin, Direction( origin, 1 + m_rng() % 6 ) );
+        }
+
+        CheckPacket();
+    }
+
+    CheckCounts();
+}
+
+
+/**
+ * Rays starting inside the box, which enter it at a negative distance
+ */
+BOOST_AUTO_TEST_CASE( OriginsInside )
+{
+    for( int packet = 0; packet < 2000; ++packet )
+    {
+        RandomBox();
+
+        for( RAY& ray : m_rays )
+        {
+            SFVEC3F origin = PointInBox();
+            ray.Init( origin, Direction( origin, -1 + (int) ( m_rng() % 8 ) ) );
+        }
+
+        CheckPacket();
+    }
+
+    // All the rays hit the box
+    BOOST_CHECK_EQUAL( m_hitCount + m_grazingCount, m_rayCount );
+    BOOST_CHECK( m_grazingCount <= m_rayCount / 1000 );
+}
+
+
+/**
+ * Rays with a closest hit before, inside or after the box
+ */
+BOOST_AUTO_TEST_CASE( ClosestHits )
+{
+    for( int packet = 0; packet < 2000; ++packet )
+    {
+        RandomBox();
+
+        for( unsigned int ii = 0; ii < RAYPACKET_RAYS_PER_PACKET; ++ii )
+        {
+            SFVEC3F origin = PointAround();
+            m_rays[ii].Init( origin, Direction( origin, 0 ) );
+            m_hits[ii].m_HitInfo.m_tHit = Random( 0.0f, 2.0f );
+        }
+
+        CheckPacket();
+    }
+
+    CheckCounts();
+}
+
+#else
+
+/**
+ * Without SIMD instructions, the packet tests are made with CBBOX::Intersect() itself
+ */
+BOOST_AUTO_TEST_CASE( NoSimd )
+{
+    BOOST_TEST_MESSAGE( "No SIMD group tests to check on this target" );
+}
+
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,471 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the chunk allocator of CACHED_CONTAINER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <gal/opengl/cached_container.h>
+
+#include <gal/opengl/vertex_item.h>
+#include <gal/opengl/vertex_manager.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+
+using namespace KIGFX;
+
+
+/**
+ * A cached container storing the vertices in the main memory only, like
+ * CACHED_CONTAINER_RAM without the vertex buffer, so it does not need an OpenGL context
+ */
+class TEST_CACHED_CONTAINER : public CACHED_CONTAINER
+{
+public:
+    TEST_CACHED_CONTAINER( unsigned int aSize ) : CACHED_CONTAINER( aSize )
+    {
+        m_vertices = static_cast<VERTEX*>( malloc( aSize * VERTEX_SIZE ) );
+    }
+
+    ~TEST_CACHED_CONTAINER()
+    {
+        free( m_vertices );
+    }
+
+    unsigned int GetBufferHandle() const override
+    {
+        return 0;
+    }
+
+    bool IsMapped() const override
+    {
+        return true;
+    }
+
+    void Map() override {}
+
+    void Unmap() override {}
+
+    /// Number of vertices reserved for an item of the given size
+    static unsigned int ChunkSize( unsigned int aItemSize )
+    {
+        return classSize( sizeClass( aItemSize ) );
+    }
+
+    /**
+     * Checks the chunks of the items do not overlap, lie in the used area, and match the
+     * space counters
+     * @param aItems are all the items stored in the container
+     */
+    void CheckLayout( const std::vector<const VERTEX_ITEM*>& aItems ) const
+    {
+        std::vector<const VERTEX_ITEM*> items( aItems );
+
+        std::sort( items.begin(), items.end(),
+                []( const VERTEX_ITEM* aA, const VERTEX_ITEM* aB ) {
+                    return aA->GetOffset() < aB->GetOffset();
+                } );
+
+        unsigned int chunkSpace = 0;
+        unsigned int wastedSpace = 0;
+        unsigned int previousEnd = 0;
+
+        for( const VERTEX_ITEM* item : items )
+        {
+            const unsigned int chunkSize = ChunkSize( item->GetSize() );
+
+            BOOST_REQUIRE( item->GetSize() > 0 );
+            BOOST_REQUIRE_MESSAGE( item->GetOffset() >= previousEnd,
+                    "Chunk at " << item->GetOffset() << " overlaps the previous one ending at "
+                                << previousEnd );
+
+            previousEnd = item->GetOffset() + chunkSize;
+            chunkSpace += chunkSize;
+            wastedSpace += chunkSize - item->GetSize();
+        }
+
+        BOOST_REQUIRE( previousEnd <= m_maxIndex );
+        BOOST_REQUIRE( m_maxIndex <= m_currentSize );
+
+        // The used area is made of the item chunks and the free chunks between them
+        BOOST_CHECK_EQUAL( chunkSpace + m_fragmentedSpace, m_maxIndex );
+        BOOST_CHECK_EQUAL( chunkSpace, usedSpace() );
+        BOOST_CHECK_EQUAL( wastedSpace, GetWastedSpace() );
+    }
+
+protected:
+    bool defragmentResize( unsigned int aNewSize ) override
+    {
+        if( usedSpace() > aNewSize )
+            return false;
+
+        VERTEX* newVertices = static_cast<VERTEX*>( malloc( aNewSize * VERTEX_SIZE ) );
+
+        defragment( newVertices );
+
+        free( m_vertices );
+        m_vertices = newVertices;
+        m_freeSpace += aNewSize - m_currentSize;
+        m_currentSize = aNewSize;
+
+        return true;
+    }
+};
+
+
+/**
+ * Items stored in a TEST_CACHED_CONTAINER.  Each vertex holds the id of its item and its
+ * index in the item, so moving an item without updating its offset is noticed.
+ */
+class CACHED_CONTAINER_FIXTURE
+{
+public:
+    CACHED_CONTAINER_FIXTURE() :
+            m_manager( false ),
+            m_container( INITIAL_SIZE ),
+            m_nextId( 0 ),
+            m_expectedAllocations( 0 ),
+            m_expectedReallocations( 0 )
+    {}
+
+    /// Stores a new item of aSize vertices
+    void Add( unsigned int aSize )
+    {
+        m_items.push_back( ENTRY{ std::unique_ptr<VERTEX_ITEM>( new VERTEX_ITEM( m_manager ) ),
+                                  m_nextId++ } );
+        Grow( m_items.size() - 1, aSize );
+    }
+
+    /// Adds aSize vertices to the item aIndex, as adding primitives to a drawn item does
+    void Grow( size_t aIndex, unsigned int aSize )
+    {
+        ENTRY&       entry = m_items[aIndex];
+        unsigned int oldSize = entry.m_item->GetSize();
+        unsigned int newSize = oldSize + aSize;
+
+        if( oldSize == 0 || newSize > TEST_CACHED_CONTAINER::ChunkSize( oldSize ) )
+        {
+            ++m_expectedAllocations;
+
+            if( oldSize > 0 )
+                ++m_expectedReallocations;
+        }
+
+        m_container.SetItem( entry.m_item.get() );
+
+        // Allocate the vertices in two calls, as an item made of two primitives
+        unsigned int first = aSize / 2;
+        fill( m_container.Allocate( first ), entry.m_id, oldSize, first );
+        fill( m_container.Allocate( aSize - first ), entry.m_id, oldSize + first, aSize - first );
+
+        m_container.FinishItem();
+
+        BOOST_REQUIRE_EQUAL( entry.m_item->GetSize(), newSize );
+    }
+
+    /// Frees the item aIndex
+    void Remove( size_t aIndex )
+    {
+        m_container.Delete( m_items[aIndex].m_item.get() );
+        BOOST_REQUIRE_EQUAL( m_items[aIndex].m_item->GetSize(), 0u );
+
+        std::swap( m_items[aIndex], m_items.back() );
+        m_items.pop_back();
+    }
+
+    /**
+     * Checks the chunk layout and the content of every item
+     * @param aContent also checks every vertex of the items, which is much slower
+     */
+    void Check( bool aContent = true )
+    {
+        std::vector<const VERTEX_ITEM*> items;
+
+        for( const auto& entry : m_items )
+            items.push_back( entry.m_item.get() );
+
+        m_container.CheckLayout( items );
+
+        if( !aContent )
+            return;
+
+        for( const auto& entry : m_items )
+        {
+            const VERTEX* vertex = m_container.GetVertices( entry.m_item->GetOffset() );
+
+            for( unsigned int ii = 0; ii < entry.m_item->GetSize(); ++ii, ++vertex )
+            {
+                if( vertex->x != entry.m_id || vertex->y != ii )
+                {
+                    BOOST_ERROR( "Vertex " << ii << " of item " << entry.m_id << " holds vertex "
+                                           << vertex->y << " of item " << vertex->x );
+                    return;
+                }
+            }
+        }
+    }
+
+    /// Checks the allocator counters match the allocations done
+    void CheckStats()
+    {
+        const CACHED_CONTAINER::STATS& stats = m_container.GetStats();
+
+        BOOST_CHECK_EQUAL( stats.m_allocations, m_expectedAllocations );
+        BOOST_CHECK_EQUAL( stats.m_reallocations, m_expectedReallocations );
+        BOOST_CHECK( stats.m_reuses <= stats.m_allocations );
+    }
+
+    ///> Small, so the container is resized and defragmented during the tests
+    static constexpr unsigned int INITIAL_SIZE = 1024;
+
+    struct ENTRY
+    {
+        std::unique_ptr<VERTEX_ITEM> m_item;
+        unsigned int                 m_id;
+    };
+
+    VERTEX_MANAGER        m_manager;    ///< Owner of the items, not the container under test
+    TEST_CACHED_CONTAINER m_container;
+    std::vector<ENTRY>    m_items;
+    unsigned int          m_nextId;
+    unsigned int          m_expectedAllocations;
+    unsigned int          m_expectedReallocations;
+
+private:
+    static void fill( VERTEX* aVertex, unsigned int aId, unsigned int aFirst, unsigned int aCount )
+    {
+        BOOST_REQUIRE( aCount == 0 || aVertex );
+
+        for( unsigned int ii = 0; ii < aCount; ++ii, ++aVertex )
+        {
+            aVertex->x = aId;
+            aVertex->y = aFirst + ii;
+        }
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( CachedContainer, CACHED_CONTAINER_FIXTURE )
+
+
+/**
+ * Check the size classes: four per power of two, each one large enough for its sizes
+ */
+BOOST_AUTO_TEST_CASE( ChunkSizes )
+{
+    unsigned int previous = TEST_CACHED_CONTAINER::ChunkSize( 1 );
+
+    BOOST_CHECK_EQUAL( previous, 4u );
+
+    for( unsigned int size = 2; size < 100000; ++size )
+    {
+        unsigned int chunkSize = TEST_CACHED_CONTAINER::ChunkSize( size );
+
+        BOOST_REQUIRE( chunkSize >= size );
+        BOOST_REQUIRE( chunkSize >= previous );
+
+        // No more than a quarter of the chunk is wasted, for the larger sizes
+        if( size > 8 )
+            BOOST_REQUIRE( chunkSize - size < chunkSize / 4 );
+
+        previous = chunkSize;
+    }
+}
+
+
+/**
+ * Freed chunks are reused by the items of the same size class
+ */
+BOOST_AUTO_TEST_CASE( Reuse )
+{
+    for( int ii = 0; ii < 20; ++ii )
+        Add( 10 );
+
+    // Free the first four items, so their chunks are left in the middle.  That is not
+    // enough free space to start the compaction.
+    for( size_t ii = 0; ii < 4; ++ii )
+        Remove( ii );
+
+    Check();
+    BOOST_CHECK_EQUAL( m_container.GetFragmentedSpace(),
+                       4 * TEST_CACHED_CONTAINER::ChunkSize( 10 ) );
+
+    // 9 and 10 vertices are in the same size class
+    for( int ii = 0; ii < 4; ++ii )
+        Add( 9 );
+
+    Check();
+    CheckStats();
+    BOOST_CHECK_EQUAL( m_container.GetStats().m_reuses, 4u );
+    BOOST_CHECK_EQUAL( m_container.GetStats().m_compactionMoves, 0u );
+    BOOST_CHECK_EQUAL( m_container.GetFragmentedSpace(), 0u );
+}
+
+
+/**
+ * Freeing the items found at the end of the used area gives their space back, together
+ * with the free chunks placed before them
+ */
+BOOST_AUTO_TEST_CASE( TrimEnd )
+{
+    for( int ii = 0; ii < 6; ++ii )
+        Add( 20 );
+
+    Remove( 3 );
+    Remove( 4 );
+    Check();
+
+    // The items are now 0, 1, 2 and 5: freeing 5 releases the chunks of 3 and 4 too
+    Remove( 3 );
+    Check();
+    BOOST_CHECK_EQUAL( m_container.GetFragmentedSpace(), 0u );
+
+    // Freeing from the end leaves an empty used area
+    for( size_t index : { 2, 1, 0 } )
+        Remove( index );
+
+    Check();
+    BOOST_CHECK_EQUAL( m_container.GetFragmentedSpace(), 0u );
+}
+
+
+/**
+ * Items growing out of their chunk are moved, the ones growing inside it are not
+ */
+BOOST_AUTO_TEST_CASE( GrowItems )
+{
+    Add( 9 );
+    Add( 5 );
+
+    unsigned int offset = m_items[0].m_item->GetOffset();
+
+    // 9 vertices are stored in a chunk of 10, so there is room for one more
+    Grow( 0, 1 );
+    BOOST_CHECK_EQUAL( m_items[0].m_item->GetOffset(), offset );
+    Check();
+
+    // but not for two more
+    Grow( 0, 1 );
+    BOOST_CHECK( m_items[0].m_item->GetOffset() != offset );
+    Check();
+
+    CheckStats();
+    BOOST_CHECK_EQUAL( m_container.GetStats().m_allocations, 3u );
+    BOOST_CHECK_EQUAL( m_container.GetStats().m_reallocations, 1u );
+}
+
+
+/**
+ * Leaving many free chunks in the middle moves the chunks from the end of the used area
+ * into them, with the offsets of the moved items updated
+ */
+BOOST_AUTO_TEST_CASE( Compaction )
+{
+    for( int ii = 0; ii < 64; ++ii )
+        Add( 16 + ii % 4 );
+
+    // Free the first half, so the free chunks are of the size classes of the items at the end
+    for( size_t ii = 0; ii < 32; ++ii )
+        Remove( ii );
+
+    Check();
+    BOOST_CHECK_EQUAL( m_container.GetStats().m_compactionMoves, 0u );
+
+    unsigned int fragmentedBefore = m_container.GetFragmentedSpace();
+
+    // Compaction steps are done when an item is finished
+    for( int ii = 0; ii < 4; ++ii )
+    {
+        Add( 16 );
+        Check();
+    }
+
+    CheckStats();
+    BOOST_CHECK( m_container.GetStats().m_compactionMoves > 0 );
+    BOOST_CHECK( m_container.GetFragmentedSpace() < fragmentedBefore );
+}
+
+
+/**
+ * Random allocation, growth and freeing of items, with the layout checked after each step,
+ * and the content of every item checked from time to time
+ */
+BOOST_AUTO_TEST_CASE( Random )
+{
+    std::mt19937                          rng( 42 );
+    std::uniform_int_distribution<int>    opDist( 0, 9 );
+    std::uniform_int_distribution<int>    smallDist( 1, 40 );
+    std::uniform_int_distribution<int>    largeDist( 41, 3000 );
+    std::uniform_int_distribution<size_t> indexDist;
+
+    auto randomSize = [&]() -> unsigned int
+    {
+        return opDist( rng ) == 0 ? largeDist( rng ) : smallDist( rng );
+    };
+
+    for( int step = 0; step < 20000; ++step )
+    {
+        int op = opDist( rng );
+
+        // Keep a few hundreds items, but go through an almost empty container at times
+        size_t target = ( step / 2500 ) % 2 ? 40 : 400;
+
+        if( m_items.empty() || ( op < 4 && m_items.size() < target ) )
+            Add( randomSize() );
+        else if( op < 6 )
+            Grow( indexDist( rng ) % m_items.size(), randomSize() );
+        else
+            Remove( indexDist( rng ) % m_items.size() );
+
+        Check( step % 50 == 0 );
+    }
+
+    CheckStats();
+
+    const CACHED_CONTAINER::STATS& stats = m_container.GetStats();
+
+    BOOST_CHECK( stats.m_reuses > 0 );
+    BOOST_CHECK( stats.m_compactionMoves > 0 );
+    BOOST_CHECK( stats.m_defragmentations > 0 );
+    BOOST_CHECK( m_container.GetSize() > INITIAL_SIZE );
+
+    // Clearing gives back all the space
+    m_container.Clear();
+
+    for( const auto& entry : m_items )
+        BOOST_CHECK_EQUAL( entry.m_item->GetSize(), 0u );
+
+    m_items.clear();
+    Check();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,189 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for GERBER_PLOTTER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <plotter.h>
+
+#include <gbr_metadata.h>
+
+#include <wx/filename.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+/**
+ * Plots flashes of many sizes and shapes, some of them sharing an aperture, polylines and
+ * regions, in Pcbnew units (1 decimil = 2540 IU)
+ */
+static void plotSample( GERBER_PLOTTER& aPlotter )
+{
+    GBR_METADATA smdPad;
+    smdPad.SetApertureAttrib( GBR_APERTURE_METADATA::GBR_APERTURE_ATTRIB_SMDPAD_CUDEF );
+
+    GBR_METADATA conductor;
+    conductor.SetApertureAttrib( GBR_APERTURE_METADATA::GBR_APERTURE_ATTRIB_CONDUCTOR );
+
+    // Five round sizes, each flashed twice
+    for( int ii = 0; ii < 10; ii++ )
+    {
+        aPlotter.FlashPadCircle( wxPoint( ii * 2540000, 0 ), 300000 + 100000 * ( ii % 5 ),
+                                 FILLED, nullptr );
+    }
+
+    // Four rect sizes, every other one rotated by 90 degrees
+    for( int ii = 0; ii < 8; ii++ )
+    {
+        aPlotter.FlashPadRect( wxPoint( ii * 2540000, 2540000 ),
+                               wxSize( 1000000 + 250000 * ( ii % 4 ), 600000 ),
+                               ( ii % 2 ) ? 900.0 : 0.0, FILLED, &smdPad );
+    }
+
+    // The same round sizes as above, but with an aperture attribute
+    for( int ii = 0; ii < 5; ii++ )
+    {
+        aPlotter.FlashPadCircle( wxPoint( ii * 2540000, 5080000 ), 300000 + 100000 * ii,
+                                 FILLED, &smdPad );
+    }
+
+    for( int ii = 0; ii < 6; ii++ )
+    {
+        aPlotter.FlashPadOval( wxPoint( ii * 2540000, 7620000 ),
+                               wxSize( 1200000, 800000 + 200000 * ( ii % 3 ) ),
+                               ( ii % 2 ) ? 900.0 : 0.0, FILLED, nullptr );
+    }
+
+    // Regular polygons from 3 to 8 vertices
+    for( int ii = 0; ii < 6; ii++ )
+    {
+        aPlotter.FlashRegularPolygon( wxPoint( ii * 2540000, 10160000 ),
+                                      1000000 + 200000 * ( ii % 2 ), 3 + ii,
+                                      ( ii % 2 ) ? 300.0 : 0.0, FILLED, nullptr );
+    }
+
+    // Polylines
+    std::vector<wxPoint> line = { wxPoint( 0, 12700000 ), wxPoint( 2540000, 13970000 ),
+                                  wxPoint( 5080000, 12700000 ), wxPoint( 7620000, 13970000 ),
+                                  wxPoint( 10160000, 12700000 ) };
+
+    aPlotter.PlotPoly( line, NO_FILL, 150000 );
+    aPlotter.PlotPoly( line, NO_FILL, 250000, &conductor );
+    aPlotter.Rect( wxPoint( 0, 15240000 ), wxPoint( 5080000, 17780000 ), NO_FILL, 150000 );
+
+    // A filled polygon with an outline, not closed
+    std::vector<wxPoint> triangle = { wxPoint( 7620000, 15240000 ), wxPoint( 10160000, 15240000 ),
+                                      wxPoint( 8890000, 17780000 ) };
+
+    aPlotter.PlotPoly( triangle, FILLED_SHAPE, 100000 );
+
+    // Regions: not closed, too small to be plotted, and a closed one with many corners
+    std::vector<wxPoint> quad = { wxPoint( 0, 20320000 ), wxPoint( 2540000, 19050000 ),
+                                  wxPoint( 5080000, 20320000 ), wxPoint( 2540000, 21590000 ) };
+
+    aPlotter.PlotGerberRegion( quad, &conductor );
+
+    quad.resize( 2 );
+    aPlotter.PlotGerberRegion( quad, &conductor );
+
+    std::vector<wxPoint> stairs;
+
+    for( int ii = 0; ii < 50; ii++ )
+    {
+        stairs.emplace_back( ii * 200000, 22860000 + ii * 100000 );
+        stairs.emplace_back( ( ii + 1 ) * 200000, 22860000 + ii * 100000 );
+    }
+
+    stairs.emplace_back( 10000000, 21000000 );
+    stairs.emplace_back( 0, 21000000 );
+    stairs.push_back( stairs[0] );
+
+    aPlotter.PlotGerberRegion( stairs, nullptr );
+
+    // Back to the first aperture
+    aPlotter.FlashPadCircle( wxPoint( 0, 30480000 ), 300000, FILLED, nullptr );
+}
+
+
+/**
+ * Reads the lines of a Gerber file, but the "G04 Created by" comment, holding the version
+ * and the date
+ */
+static std::vector<std::string> readGerberLines( const wxString& aFileName )
+{
+    std::ifstream            file( aFileName.ToStdString() );
+    std::vector<std::string> lines;
+    std::string              line;
+
+    while( std::getline( file, line ) )
+    {
+        if( line.compare( 0, 14, "G04 Created by" ) != 0 )
+            lines.push_back( line );
+    }
+
+    return lines;
+}
+
+
+BOOST_AUTO_TEST_SUITE( GerberPlotter )
+
+
+/**
+ * Check the plotted file is the same as the one from the plotter before the aperture hash
+ * table and the buffered region writing
+ */
+BOOST_AUTO_TEST_CASE( SampleMatchesBaseline )
+{
+    wxString       fileName = wxFileName::CreateTempFileName( "qa_gerber" );
+    GERBER_PLOTTER plotter;
+
+    plotter.SetViewport( wxPoint( 0, 0 ), 2540.0, 1.0, false );
+    plotter.SetGerberCoordinatesFormat( 6, false );
+
+    BOOST_REQUIRE( plotter.OpenFile( fileName ) );
+    BOOST_REQUIRE( plotter.StartPlot() );
+
+    plotSample( plotter );
+
+    plotter.EndPlot();
+
+    wxFileName golden( QA_COMMON_DATA_LOCATION, "gerber_plotter_sample.gbr" );
+    golden.AppendDir( "plotters" );
+
+    const std::vector<std::string> expected = readGerberLines( golden.GetFullPath() );
+    const std::vector<std::string> plotted = readGerberLines( fileName );
+
+    BOOST_REQUIRE( !expected.empty() );
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+            plotted.begin(), plotted.end(), expected.begin(), expected.end() );
+
+    wxRemoveFile( fileName );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
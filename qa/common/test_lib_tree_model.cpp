@@ -0,0 +1,309 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the scoring of LIB_TREE_NODEs against search terms
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <lib_tree_model.h>
+
+#include <eda_pattern_match.h>
+#include <lib_id.h>
+#include <lib_tree_item.h>
+
+#include <wx/tokenzr.h>
+
+#include <map>
+#include <memory>
+#include <random>
+
+
+class TEST_LIB_TREE_ITEM : public LIB_TREE_ITEM
+{
+public:
+    TEST_LIB_TREE_ITEM( const wxString& aLib, const wxString& aName, const wxString& aSearchText ) :
+        m_lib( aLib ),
+        m_name( aName ),
+        m_searchText( aSearchText )
+    {
+    }
+
+    LIB_ID GetLibId() const override { return LIB_ID( m_lib, m_name ); }
+    const wxString& GetName() const override { return m_name; }
+    wxString GetLibNickname() const override { return m_lib; }
+    const wxString& GetDescription() override { return m_searchText; }
+    wxString GetSearchText() override { return m_searchText; }
+
+private:
+    wxString m_lib;
+    wxString m_name;
+    wxString m_searchText;
+};
+
+
+/**
+ * Libraries of random items, scored against the search terms by the tree and by a plain
+ * implementation running all the matchers on all the items
+ */
+class TEST_LIB_TREE_MODEL_FIXTURE
+{
+public:
+    TEST_LIB_TREE_MODEL_FIXTURE() :
+        m_rng( 42 )
+    {
+        for( const wxString& libName : { "Device", "Amplifier_Operational", "Connector" } )
+        {
+            LIB_TREE_NODE_LIB& lib = m_root.AddLib( libName, wxEmptyString );
+
+            for( int ii = 0; ii < 200; ++ii )
+                AddRandomItem( lib );
+        }
+    }
+
+    wxString RandomWords( int aCount )
+    {
+        static const char* words[] = { "LM", "358", "Amp", "op", "R", "C", "10k", "100n",
+                                       "dual", "Conn", "01x02", "resistor", "capacitor",
+                                       "r=4.7k", "c=100n", "Pin", "ampli", "µA741" };
+        std::uniform_int_distribution<> word( 0, sizeof( words ) / sizeof( words[0] ) - 1 );
+        wxString text;
+
+        for( int ii = 0; ii < aCount; ++ii )
+            text += wxString::FromUTF8( words[word( m_rng )] ) + ( m_rng() % 3 ? "" : " " );
+
+        return text;
+    }
+
+    void AddRandomItem( LIB_TREE_NODE_LIB& aLib )
+    {
+        TEST_LIB_TREE_ITEM item( aLib.Name, RandomWords( 3 ), RandomWords( 8 ) );
+        LIB_TREE_NODE_LIB_ID& node = aLib.AddItem( &item );
+
+        m_expected[&node] = 0;
+    }
+
+    /// Score the tree against aSearch, as LIB_TREE_MODEL_ADAPTER::UpdateSearchString() does
+    void Search( const wxString& aSearch )
+    {
+        m_root.ResetScore();
+
+        for( auto& score : m_expected )
+            score.second = 1;
+
+        wxStringTokenizer tokenizer( aSearch );
+
+        while( tokenizer.HasMoreTokens() )
+        {
+            const wxString term = tokenizer.GetNextToken().Lower();
+            EDA_COMBINED_MATCHER matcher( term );
+
+            m_root.UpdateScore( matcher );
+
+            for( auto& score : m_expected )
+                score.second = ExpectedScore( *score.first, term, score.second );
+        }
+
+        m_root.SortNodes();
+    }
+
+    /// Run all the matchers which can handle aPattern on aText
+    static bool FindAll( const wxString& aPattern, const wxString& aText, int& aFired, int& aPos )
+    {
+        std::vector<std::unique_ptr<EDA_PATTERN_MATCH>> matchers;
+
+        matchers.push_back( std::make_unique<EDA_PATTERN_MATCH_REGEX>() );
+        matchers.push_back( std::make_unique<EDA_PATTERN_MATCH_WILDCARD>() );
+        matchers.push_back( std::make_unique<EDA_PATTERN_MATCH_RELATIONAL>() );
+        matchers.push_back( std::make_unique<EDA_PATTERN_MATCH_SUBSTR>() );
+
+        aFired = 0;
+        aPos = EDA_PATTERN_NOT_FOUND;
+
+        for( auto& matcher : matchers )
+        {
+            if( !matcher->SetPattern( aPattern ) )
+                continue;
+
+            int pos = matcher->Find( aText );
+
+            if( pos != EDA_PATTERN_NOT_FOUND )
+            {
+                aFired++;
+
+                if( aPos == EDA_PATTERN_NOT_FOUND || pos < aPos )
+                    aPos = pos;
+            }
+        }
+
+        return aPos != EDA_PATTERN_NOT_FOUND;
+    }
+
+    /// The score of LIB_TREE_NODE_LIB_ID::UpdateScore() for aTerm
+    static int ExpectedScore( const LIB_TREE_NODE& aNode, const wxString& aTerm, int aScore )
+    {
+        if( aScore <= 0 )
+            return aScore;
+
+        const wxString name = aNode.Name.Lower();
+        const wxString searchText = aNode.SearchText.Lower();
+        int            fired = 0;
+        int            pos = EDA_PATTERN_NOT_FOUND;
+
+        if( aTerm == name )
+            aScore += 1000;
+        else if( FindAll( aTerm, name, fired, pos ) )
+            aScore += std::max( 20 - pos, 0 ) + 20;
+        else if( FindAll( aTerm, aNode.Parent->MatchName, fired, pos ) )
+            aScore += 19;
+        else if( FindAll( aTerm, searchText, fired, pos ) )
+            aScore += aTerm.length() >= 2 ? std::max( 17 - pos, 0 ) + 1 : 0;
+        else
+            aScore = 0;
+
+        return aScore + 2 * fired;
+    }
+
+    void CheckScores()
+    {
+        int matches = 0;
+
+        for( const auto& score : m_expected )
+        {
+            BOOST_CHECK_EQUAL( score.first->Score, score.second );
+
+            if( score.second > 1 )
+                matches++;
+        }
+
+        // Make sure the search is not trivial
+        BOOST_CHECK( matches > 0 );
+    }
+
+    std::mt19937                   m_rng;
+    LIB_TREE_NODE_ROOT             m_root;
+    std::map<LIB_TREE_NODE*, int>  m_expected;
+};
+
+
+static const wxString searches[] = { "amp", "lm358", "LM 358", "Amp dual", "ampli", "a741",
+                                     "r", "op", "10k", "lm*8", "^lm", "l.3", "r>4k", "c<1u",
+                                     "device", "operational amp", "conn 01x", "41 res" };
+
+
+BOOST_FIXTURE_TEST_SUITE( LibTreeModel, TEST_LIB_TREE_MODEL_FIXTURE )
+
+
+/**
+ * Check the scores are the ones given by all the matchers
+ */
+BOOST_AUTO_TEST_CASE( SameScores )
+{
+    for( const wxString& search : searches )
+    {
+        BOOST_TEST_CONTEXT( "Search: " << search )
+        {
+            Search( search );
+            CheckScores();
+        }
+    }
+}
+
+
+/**
+ * Check the scores are right when items are added, removed or updated between searches
+ */
+BOOST_AUTO_TEST_CASE( ModifiedLibraries )
+{
+    Search( "amp" );
+
+    for( auto& child : m_root.Children )
+    {
+        LIB_TREE_NODE_LIB& lib = static_cast<LIB_TREE_NODE_LIB&>( *child );
+
+        for( int ii = 0; ii < 20; ++ii )
+        {
+            m_expected.erase( lib.Children.back().get() );
+            lib.Children.pop_back();
+        }
+
+        for( int ii = 0; ii < 20; ++ii )
+        {
+            LIB_TREE_NODE_LIB_ID& node = static_cast<LIB_TREE_NODE_LIB_ID&>( *lib.Children[ii] );
+            TEST_LIB_TREE_ITEM    item( lib.Name, node.Name, "amplifier " + RandomWords( 4 ) );
+
+            node.Update( &item );
+        }
+
+        for( int ii = 0; ii < 20; ++ii )
+            AddRandomItem( lib );
+    }
+
+    for( const wxString& search : searches )
+    {
+        BOOST_TEST_CONTEXT( "Search: " << search )
+        {
+            Search( search );
+            CheckScores();
+        }
+    }
+}
+
+
+/**
+ * Check items updated after the index was built are found by a literal term, when a term
+ * scored without the index (too short, non literal or matching a library name) has been
+ * searched in between
+ */
+BOOST_AUTO_TEST_CASE( UpdatedThenShortTerm )
+{
+    Search( "amp" );    // builds the indexes
+
+    for( auto& child : m_root.Children )
+    {
+        LIB_TREE_NODE_LIB& lib = static_cast<LIB_TREE_NODE_LIB&>( *child );
+
+        for( int ii = 0; ii < 20; ++ii )
+        {
+            LIB_TREE_NODE_LIB_ID& node = static_cast<LIB_TREE_NODE_LIB_ID&>( *lib.Children[ii] );
+            TEST_LIB_TREE_ITEM    item( lib.Name, node.Name, "zebra " + RandomWords( 4 ) );
+
+            node.Update( &item );
+        }
+    }
+
+    for( const wxString& search : { "r", "lm*8", "device", "r zebra" } )
+    {
+        BOOST_TEST_CONTEXT( "Search: " << search )
+        {
+            Search( search );
+            Search( "zebra" );
+            CheckScores();
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
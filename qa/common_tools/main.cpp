@@ -24,8 +24,10 @@
 #include <qa_utils/utility_program.h>
 
 #include "tools/coroutines/coroutine_tools.h"
+#include "tools/gerber_plotter/gerber_plot_bench.h"
 #include "tools/io_benchmark/io_benchmark.h"
 #include "tools/sexpr_parser/sexpr_parse.h"
+#include "tools/vrml_parser/vrml_parse.h"
 
 /**
  * List of registered tools.
@@ -35,8 +37,10 @@
  */
 const static std::vector<KI_TEST::UTILITY_PROGRAM*> known_tools = {
     &coroutine_tool,
+    &gerber_plot_bench_tool,
     &io_benchmark_tool,
     &sexpr_parser_tool,
+    &vrml_parser_tool,
 };
 
 
@@ -0,0 +1,211 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file
+ * Utility tool for benchmarking GERBER_PLOTTER on the kind of items of the copper layers
+ * of a large board: many pad flashes of many sizes, and large regions, as zone fills.
+ */
+
+#include "gerber_plot_bench.h"
+
+#include <common.h>
+#include <plotter.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+
+/**
+ * Plots the same items as a board with aPadCount pads of aSizeCount different sizes and
+ * aRegionCount zone fills with aCornerCount corners each, and prints the time of each step.
+ */
+static void benchGerberPlotter( const wxString& aFileName, int aPadCount, int aSizeCount,
+                                int aRegionCount, int aCornerCount )
+{
+    // Pcbnew units: 1 decimil = 2540 IU
+    const int      pitch = 1270000;
+    GERBER_PLOTTER plotter;
+
+    plotter.SetViewport( wxPoint( 0, 0 ), 2540.0, 1.0, false );
+    plotter.SetGerberCoordinatesFormat( 6, false );
+
+    if( !plotter.OpenFile( aFileName ) || !plotter.StartPlot() )
+    {
+        std::cerr << "Cannot create " << aFileName << std::endl;
+        return;
+    }
+
+    PROF_COUNTER flashTimer;
+
+    for( int ii = 0; ii < aPadCount; ii++ )
+    {
+        wxPoint pos( ( ii % 1000 ) * pitch, ( ii / 1000 ) * pitch );
+        wxSize  size( 200000 + 1000 * ( ( ii / 2 ) % aSizeCount ), 600000 );
+
+        if( ii % 2 )
+            plotter.FlashPadCircle( pos, size.x, FILLED, nullptr );
+        else
+            plotter.FlashPadRect( pos, size, 0.0, FILLED, nullptr );
+    }
+
+    flashTimer.Stop();
+
+    PROF_COUNTER regionTimer;
+
+    std::vector<wxPoint> corners;
+    corners.reserve( aCornerCount );
+
+    for( int ii = 0; ii < aRegionCount; ii++ )
+    {
+        wxPoint center( ( ii % 10 ) * 60000000, ( ii / 10 ) * 60000000 );
+
+        corners.clear();
+
+        // A star shaped outline, as a zone fill around many pads
+        for( int jj = 0; jj < aCornerCount; jj++ )
+        {
+            double angle = 2 * M_PI * jj / aCornerCount;
+            double radius = ( jj % 2 ) ? 25000000.0 : 20000000.0;
+
+            corners.emplace_back( center.x + KiROUND( radius * cos( angle ) ),
+                                  center.y + KiROUND( radius * sin( angle ) ) );
+        }
+
+        plotter.PlotGerberRegion( corners, nullptr );
+    }
+
+    regionTimer.Stop();
+
+    PROF_COUNTER endTimer;
+    plotter.EndPlot();
+    endTimer.Stop();
+
+    std::cout << aPadCount << " round and rect flashes of " << aSizeCount << " sizes: "
+              << flashTimer.msecs() << "ms" << std::endl;
+    std::cout << aRegionCount << " regions of " << aCornerCount << " corners: "
+              << regionTimer.msecs() << "ms" << std::endl;
+    std::cout << "Aperture list and file copy: " << endTimer.msecs() << "ms" << std::endl;
+    std::cout << "File size: " << wxFileName::GetSize( aFileName ).ToString() << " bytes"
+              << std::endl;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "p",
+            "pads",
+            _( "number of pads to flash (default 100000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "sizes",
+            _( "number of different pad sizes (default 500)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "regions",
+            _( "number of regions (default 100)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "c",
+            "corners",
+            _( "number of corners of each region (default 10000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "output file (default: a temporary file, removed at the end)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+int gerber_plot_bench_func( int argc, char* argv[] )
+{
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "Benchmarks plotting pad flashes and regions to a Gerber file" ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long padCount = 100000;
+    long sizeCount = 500;
+    long regionCount = 100;
+    long cornerCount = 10000;
+
+    cl_parser.Found( "pads", &padCount );
+    cl_parser.Found( "sizes", &sizeCount );
+    cl_parser.Found( "regions", &regionCount );
+    cl_parser.Found( "corners", &cornerCount );
+
+    if( padCount < 0 || sizeCount < 1 || regionCount < 0 || cornerCount < 3 )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    const bool keepFile = cl_parser.GetParamCount() > 0;
+    wxString   fileName = keepFile ? cl_parser.GetParam( 0 )
+                                   : wxFileName::CreateTempFileName( "qa_gerber_bench" );
+
+    benchGerberPlotter( fileName, padCount, sizeCount, regionCount, cornerCount );
+
+    if( !keepFile )
+        wxRemoveFile( fileName );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+KI_TEST::UTILITY_PROGRAM gerber_plot_bench_tool = {
+    "gerber_plotter",
+    "Benchmark Gerber plotting of pad flashes and regions",
+    gerber_plot_bench_func,
+};
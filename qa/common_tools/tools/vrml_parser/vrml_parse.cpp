@@ -0,0 +1,214 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file
+ * Utility tool for benchmarking the reading of the number arrays of VRML
+ * files with WRLPROC, for example the models in the demos directory.
+ */
+
+#include "vrml_parse.h"
+
+#include <wrlproc.h>
+
+#include <common.h>
+#include <profile.h>
+#include <richio.h>
+
+#include <wx/cmdline.h>
+
+#include <iostream>
+
+
+/**
+ * Reads all the coordinate and index arrays of a VRML file, skipping anything
+ * else, so the time spent is mostly the number parsing of WRLPROC.
+ */
+class QA_VRML_PARSER
+{
+public:
+    QA_VRML_PARSER( bool aVerbose ) :
+        m_verbose( aVerbose ), m_vectors( 0 ), m_indices( 0 ), m_errors( 0 ), m_msecs( 0.0 )
+    {
+    }
+
+    bool Parse( const wxString& aFileName )
+    {
+        // Read the file once first, so the disk IO is not measured
+        {
+            FILE_LINE_READER warmup( aFileName, 0, 8388608 );
+
+            while( warmup.ReadLine() )
+                ;
+        }
+
+        FILE_LINE_READER reader( aFileName, 0, 8388608 );
+        WRLPROC          proc( &reader );
+
+        if( proc.GetVRMLType() == VRML_INVALID )
+            return false;
+
+        std::string              glob;
+        std::vector<WRLVEC3F>    vectors;
+        std::vector<int>         indices;
+        size_t                   vectorCount = 0;
+        size_t                   indexCount = 0;
+
+        PROF_COUNTER timer;
+
+        while( proc.ReadGlob( glob ) )
+        {
+            if( glob.empty() )
+            {
+                // a brace or a bracket
+                proc.Pop();
+                continue;
+            }
+
+            if( glob == "point" || glob == "vector" )
+            {
+                if( proc.ReadMFVec3f( vectors ) )
+                    vectorCount += vectors.size();
+                else
+                    m_errors++;
+            }
+            else if( glob == "coordIndex" || glob == "normalIndex" || glob == "colorIndex" )
+            {
+                if( proc.ReadMFInt( indices ) )
+                    indexCount += indices.size();
+                else
+                    m_errors++;
+            }
+        }
+
+        double msecs = timer.msecs();
+
+        if( m_verbose )
+        {
+            std::cout << aFileName << ": " << vectorCount << " vectors, " << indexCount
+                      << " indices in " << msecs << "ms" << std::endl;
+        }
+
+        m_vectors += vectorCount;
+        m_indices += indexCount;
+        m_msecs += msecs;
+
+        return true;
+    }
+
+    void ShowTotals() const
+    {
+        std::cout << "Total: " << m_vectors << " vectors, " << m_indices << " indices, "
+                  << m_errors << " errors in " << m_msecs << "ms" << std::endl;
+    }
+
+private:
+    bool   m_verbose;
+    size_t m_vectors;
+    size_t m_indices;
+    size_t m_errors;
+    double m_msecs;
+};
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print parsing information for each file" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_MULTIPLE,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum PARSER_RET_CODES
+{
+    PARSE_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int vrml_parser_func( int argc, char* argv[] )
+{
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText( _( "Benchmarks reading the number arrays of VRML files" ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const auto file_count = cl_parser.GetParamCount();
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    QA_VRML_PARSER qa_parser( verbose );
+
+    bool ok = true;
+
+    for( unsigned i = 0; i < file_count; i++ )
+    {
+        try
+        {
+            ok = qa_parser.Parse( cl_parser.GetParam( i ) ) && ok;
+        }
+        catch( const IO_ERROR& e )
+        {
+            std::cerr << e.What() << std::endl;
+            ok = false;
+        }
+    }
+
+    qa_parser.ShowTotals();
+
+    if( !ok )
+        return PARSER_RET_CODES::PARSE_FAILED;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+KI_TEST::UTILITY_PROGRAM vrml_parser_tool = {
+    "vrml_parser",
+    "Benchmark VRML number array parsing",
+    vrml_parser_func,
+};
@@ -0,0 +1,375 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for CONNECTION_GRAPH: incremental recalculations against full ones
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <connection_graph.h>
+
+#include <class_library.h>
+#include <ee_collectors.h>
+#include <general.h>
+#include <kiway.h>
+#include <pgm_base.h>
+#include <sch_component.h>
+#include <sch_connection.h>
+#include <sch_io_mgr.h>
+#include <sch_line.h>
+#include <sch_screen.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+#include <sch_text.h>
+#include <symbol_lib_table.h>
+#include <wildcards_and_files_ext.h>
+
+#include "eeschema_test_utils.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+
+/**
+ * Loads the three sheets of the coldfire kit demo, with buses, hierarchical labels and
+ * power symbols, and builds their connectivity from scratch.
+ */
+class TEST_CONNECTION_GRAPH_FIXTURE
+{
+public:
+    TEST_CONNECTION_GRAPH_FIXTURE() :
+            m_kiway( &Pgm(), KFCTL_STANDALONE ),
+            m_graph( nullptr )
+    {
+        wxFileName fn = KI_TEST::GetEeschemaTestDataDir();
+        fn.AppendDir( "connectivity" );
+        fn.SetName( "kit-dev-coldfire-xilinx_5213" );
+
+        // Sub-sheets are found from the project path
+        fn.SetExt( ProjectFileExtension );
+        m_kiway.Prj().SetProjectFullName( fn.GetFullPath() );
+
+        fn.SetExt( SchematicFileExtension );
+
+        SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_LEGACY ) );
+        m_root.reset( pi->Load( fn.GetFullPath(), &m_kiway ) );
+
+        fn.SetName( fn.GetName() + "-cache" );
+        fn.SetExt( SchematicLibraryFileExtension );
+        m_cacheLib.reset( PART_LIB::LoadLibrary( fn.GetFullPath() ) );
+
+        g_RootSheet = m_root.get();
+        m_rootPath.push_back( g_RootSheet );
+        g_CurrentSheet = &m_rootPath;
+        g_ConnectionGraph = &m_graph;
+
+        // The symbols only come from the cache library, as in a project without its libraries
+        SYMBOL_LIB_TABLE noLibs;
+        SCH_SCREENS      screens;
+
+        for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
+        {
+            EE_TYPE_COLLECTOR components;
+            components.Collect( screen->GetDrawItems(), EE_COLLECTOR::ComponentsOnly );
+            SCH_COMPONENT::ResolveAll( components, noLibs, m_cacheLib.get() );
+        }
+
+        screens.TestDanglingEnds();
+
+        m_graph.Recalculate( SCH_SHEET_LIST( g_RootSheet ), true );
+    }
+
+    ~TEST_CONNECTION_GRAPH_FIXTURE()
+    {
+        g_ConnectionGraph = nullptr;
+        g_CurrentSheet = nullptr;
+        g_RootSheet = nullptr;
+    }
+
+    /// Net of an item on a sheet
+    struct NET
+    {
+        wxString name;
+        int      code;      ///< Net code, or bus code of a bus
+        bool     bus;
+    };
+
+    typedef std::map<std::pair<const SCH_ITEM*, wxString>, NET> NETS;
+
+    /// @return the nets of all the connectable items and pins, by item and sheet path
+    NETS getNets() const
+    {
+        NETS nets;
+
+        auto add = [&]( const SCH_ITEM* aItem, const SCH_SHEET_PATH& aSheet ) {
+            SCH_CONNECTION* connection = aItem->Connection( aSheet );
+
+            if( !connection )
+                return;
+
+            NET& net = nets[ std::make_pair( aItem, aSheet.Path() ) ];
+
+            net.name = connection->Name();
+            net.bus = connection->IsBus();
+            net.code = net.bus ? connection->BusCode() : connection->NetCode();
+        };
+
+        for( const SCH_SHEET_PATH& sheet : SCH_SHEET_LIST( g_RootSheet ) )
+        {
+            for( SCH_ITEM* item = sheet.LastScreen()->GetDrawItems(); item; item = item->Next() )
+            {
+                if( item->Type() == SCH_COMPONENT_T )
+                {
+                    for( SCH_PIN& pin : static_cast<SCH_COMPONENT*>( item )->GetPins() )
+                        add( &pin, sheet );
+                }
+                else if( item->Type() == SCH_SHEET_T )
+                {
+                    for( SCH_SHEET_PIN& pin : static_cast<SCH_SHEET*>( item )->GetPins() )
+                        add( &pin, sheet );
+                }
+                else if( item->IsConnectable() )
+                {
+                    add( item, sheet );
+                }
+            }
+        }
+
+        return nets;
+    }
+
+    /**
+     * Run an incremental recalculation, then a full one, and check both give the same nets.
+     *
+     * The net codes are kept by name across incremental recalculations, so a renamed net
+     * gets a new code instead of the one a full recalculation gives it: the codes of both
+     * must only group the same items.
+     */
+    void checkIncrementalMatchesFull()
+    {
+        m_graph.Recalculate( SCH_SHEET_LIST( g_RootSheet ) );
+        const NETS incremental = getNets();
+
+        m_graph.Recalculate( SCH_SHEET_LIST( g_RootSheet ), true );
+        const NETS full = getNets();
+
+        BOOST_REQUIRE( !full.empty() );
+        BOOST_CHECK_EQUAL( incremental.size(), full.size() );
+
+        std::map<std::pair<bool, int>, int> incremental_to_full;
+        std::map<std::pair<bool, int>, int> full_to_incremental;
+
+        for( const auto& it : full )
+        {
+            auto other = incremental.find( it.first );
+
+            BOOST_REQUIRE( other != incremental.end() );
+
+            const NET& inc = other->second;
+            const NET& net = it.second;
+
+            BOOST_CHECK_EQUAL( inc.name, net.name );
+            BOOST_REQUIRE_EQUAL( inc.bus, net.bus );
+
+            auto to_full = incremental_to_full.emplace( std::make_pair( inc.bus, inc.code ),
+                                                        net.code );
+            BOOST_CHECK_EQUAL( to_full.first->second, net.code );
+
+            auto to_inc = full_to_incremental.emplace( std::make_pair( net.bus, net.code ),
+                                                       inc.code );
+            BOOST_CHECK_EQUAL( to_inc.first->second, inc.code );
+        }
+    }
+
+    /// @return the screen loaded from \a aFileName
+    SCH_SCREEN* getScreen( const wxString& aFileName ) const
+    {
+        SCH_SCREENS screens;
+
+        for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
+        {
+            if( wxFileName( screen->GetFileName() ).GetFullName() == aFileName )
+                return screen;
+        }
+
+        BOOST_FAIL( "No screen loaded from " + aFileName.ToStdString() );
+        return nullptr;
+    }
+
+    /// @return the first item of \a aScreen matching \a aPredicate
+    SCH_ITEM* findItem( SCH_SCREEN* aScreen,
+                        const std::function<bool( const SCH_ITEM* )>& aPredicate ) const
+    {
+        for( SCH_ITEM* item = aScreen->GetDrawItems(); item; item = item->Next() )
+        {
+            if( aPredicate( item ) )
+                return item;
+        }
+
+        BOOST_FAIL( "Item not found" );
+        return nullptr;
+    }
+
+    /// Remove \a aItem from \a aScreen, keeping it alive like the undo list does
+    void removeItem( SCH_SCREEN* aScreen, SCH_ITEM* aItem )
+    {
+        aScreen->Remove( aItem );
+        m_removed.emplace_back( aItem );
+    }
+
+    static bool isWire( const SCH_ITEM* aItem )
+    {
+        return aItem->Type() == SCH_LINE_T && aItem->GetLayer() == LAYER_WIRE;
+    }
+
+    static bool isBus( const SCH_ITEM* aItem )
+    {
+        return aItem->Type() == SCH_LINE_T && aItem->GetLayer() == LAYER_BUS;
+    }
+
+    static bool isPowerSymbol( const SCH_ITEM* aItem )
+    {
+        if( aItem->Type() != SCH_COMPONENT_T )
+            return false;
+
+        auto part = const_cast<SCH_COMPONENT*>( static_cast<const SCH_COMPONENT*>( aItem ) )
+                            ->GetPartRef().lock();
+
+        return part && part->IsPower();
+    }
+
+    void deleteWire()
+    {
+        SCH_SCREEN* screen = getScreen( "xilinx.sch" );
+        removeItem( screen, findItem( screen, isWire ) );
+    }
+
+    void renameLabel()
+    {
+        SCH_SCREEN* screen = getScreen( "kit-dev-coldfire-xilinx_5213.sch" );
+        SCH_ITEM*   label = findItem( screen, []( const SCH_ITEM* aItem ) {
+            return aItem->Type() == SCH_LABEL_T;
+        } );
+
+        static_cast<SCH_TEXT*>( label )->SetText( "RENAMED_NET" );
+        label->SetConnectivityDirty();
+    }
+
+    void movePowerSymbol()
+    {
+        SCH_ITEM* power = findItem( getScreen( "kit-dev-coldfire-xilinx_5213.sch" ),
+                                    isPowerSymbol );
+
+        power->Move( wxPoint( 0, 1000 ) );
+        power->SetConnectivityDirty();
+    }
+
+    KIWAY                                  m_kiway;
+    std::unique_ptr<PART_LIB>              m_cacheLib;
+    std::unique_ptr<SCH_SHEET>             m_root;
+    std::vector<std::unique_ptr<SCH_ITEM>> m_removed;
+    SCH_SHEET_PATH                         m_rootPath;
+    CONNECTION_GRAPH                       m_graph;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ConnectionGraph, TEST_CONNECTION_GRAPH_FIXTURE )
+
+
+/**
+ * Check an incremental recalculation without any change is a full one
+ */
+BOOST_AUTO_TEST_CASE( Unchanged )
+{
+    checkIncrementalMatchesFull();
+}
+
+
+BOOST_AUTO_TEST_CASE( DeleteWireInSubSheet )
+{
+    deleteWire();
+    checkIncrementalMatchesFull();
+}
+
+
+BOOST_AUTO_TEST_CASE( DeleteBus )
+{
+    SCH_SCREEN* screen = getScreen( "in_out_conn.sch" );
+    removeItem( screen, findItem( screen, isBus ) );
+
+    checkIncrementalMatchesFull();
+}
+
+
+BOOST_AUTO_TEST_CASE( RenameLabel )
+{
+    renameLabel();
+    checkIncrementalMatchesFull();
+}
+
+
+/**
+ * A hierarchical label no longer matching its sheet pin
+ */
+BOOST_AUTO_TEST_CASE( RenameHierarchicalLabel )
+{
+    SCH_ITEM* label = findItem( getScreen( "in_out_conn.sch" ), []( const SCH_ITEM* aItem ) {
+        return aItem->Type() == SCH_HIER_LABEL_T;
+    } );
+
+    static_cast<SCH_TEXT*>( label )->SetText( "UNMATCHED" );
+    label->SetConnectivityDirty();
+
+    checkIncrementalMatchesFull();
+}
+
+
+BOOST_AUTO_TEST_CASE( MovePowerSymbol )
+{
+    movePowerSymbol();
+    checkIncrementalMatchesFull();
+}
+
+
+/**
+ * Several incremental recalculations in a row, each starting from the names kept by the
+ * previous one
+ */
+BOOST_AUTO_TEST_CASE( ChainedEdits )
+{
+    deleteWire();
+    m_graph.Recalculate( SCH_SHEET_LIST( g_RootSheet ) );
+
+    renameLabel();
+    m_graph.Recalculate( SCH_SHEET_LIST( g_RootSheet ) );
+
+    movePowerSymbol();
+    checkIncrementalMatchesFull();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
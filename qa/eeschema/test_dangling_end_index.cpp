@@ -0,0 +1,283 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for DANGLING_END_INDEX
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <sch_item.h>
+
+#include <sch_line.h>
+#include <sch_screen.h>
+#include <sch_text.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+
+/**
+ * Random set of wires, buses and labels on a coarse grid, so many of them
+ * share end points or are placed on other segments.
+ */
+class TEST_DANGLING_END_INDEX_FIXTURE
+{
+public:
+    TEST_DANGLING_END_INDEX_FIXTURE()
+    {
+        std::mt19937                    rng( 42 );
+        std::uniform_int_distribution<> coord( -10, 10 );
+        std::uniform_int_distribution<> kind( 0, 9 );
+
+        auto randomPoint = [&]() {
+            return wxPoint( coord( rng ) * 50, coord( rng ) * 50 );
+        };
+
+        for( int ii = 0; ii < 300; ++ii )
+        {
+            int itemKind = kind( rng );
+
+            if( itemKind < 3 )
+            {
+                m_items.push_back( std::make_unique<SCH_LABEL>( randomPoint(), "label" ) );
+                continue;
+            }
+
+            auto line = std::make_unique<SCH_LINE>( randomPoint(),
+                                                    itemKind < 9 ? LAYER_WIRE : LAYER_BUS );
+            wxPoint end = randomPoint();
+
+            // Mostly horizontal and vertical segments, as usual in a schematic
+            if( itemKind % 3 == 0 )
+                end.x = line->GetStartPoint().x;
+            else if( itemKind % 3 == 1 )
+                end.y = line->GetStartPoint().y;
+
+            line->SetEndPoint( end );
+            m_items.push_back( std::move( line ) );
+        }
+
+        for( auto& item : m_items )
+            item->GetEndPoints( m_endPoints );
+    }
+
+    /// @return the dangling state of all the items, as a list of flags
+    std::vector<bool> GetStates() const
+    {
+        std::vector<bool> states;
+
+        for( const auto& item : m_items )
+        {
+            if( item->Type() == SCH_LINE_T )
+            {
+                auto line = static_cast<SCH_LINE*>( item.get() );
+                states.push_back( line->IsStartDangling() );
+                states.push_back( line->IsEndDangling() );
+            }
+            else
+            {
+                states.push_back( item->IsDangling() );
+            }
+        }
+
+        return states;
+    }
+
+    std::vector<std::unique_ptr<SCH_ITEM>> m_items;
+    std::vector<DANGLING_END_ITEM>         m_endPoints;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DanglingEndIndex, TEST_DANGLING_END_INDEX_FIXTURE )
+
+
+/**
+ * Check the indexed test gives the same states as the test against the full list
+ */
+BOOST_AUTO_TEST_CASE( SameAsFullList )
+{
+    for( auto& item : m_items )
+        item->UpdateDanglingState( m_endPoints );
+
+    const std::vector<bool> expected = GetStates();
+
+    DANGLING_END_INDEX index( m_endPoints );
+
+    for( auto& item : m_items )
+    {
+        // Nothing should change, as the states are already up to date
+        BOOST_CHECK( !index.UpdateDanglingState( item.get() ) );
+    }
+
+    const std::vector<bool> states = GetStates();
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( states.begin(), states.end(), expected.begin(), expected.end() );
+}
+
+
+/**
+ * Check the query keeps the order of the indexed list and the wire start/end pairs
+ */
+BOOST_AUTO_TEST_CASE( QueryOrder )
+{
+    DANGLING_END_INDEX             index( m_endPoints );
+    std::vector<DANGLING_END_ITEM> candidates;
+
+    for( auto& item : m_items )
+    {
+        std::vector<wxPoint> points;
+        item->GetConnectionPoints( points );
+        index.Query( points, candidates );
+
+        auto it = m_endPoints.begin();
+
+        for( size_t ii = 0; ii < candidates.size(); ++ii )
+        {
+            const DANGLING_END_ITEM& candidate = candidates[ii];
+
+            it = std::find_if( it, m_endPoints.end(), [&]( const DANGLING_END_ITEM& aEnd ) {
+                return aEnd.GetItem() == candidate.GetItem()
+                       && aEnd.GetType() == candidate.GetType();
+            } );
+
+            BOOST_REQUIRE( it != m_endPoints.end() );
+            ++it;
+
+            if( candidate.GetType() == WIRE_START_END || candidate.GetType() == BUS_START_END )
+            {
+                BOOST_REQUIRE( ii + 1 < candidates.size() );
+                BOOST_CHECK( candidates[ii + 1].GetItem() == candidate.GetItem() );
+            }
+        }
+    }
+}
+
+
+/**
+ * Check the test limited to a changed area gives the same states as the test of the whole
+ * screen, after moving some items
+ */
+BOOST_AUTO_TEST_CASE( ScreenChangedArea )
+{
+    SCH_SCREEN             screen( nullptr );
+    std::vector<SCH_ITEM*> items;
+
+    for( const auto& item : m_items )
+    {
+        items.push_back( static_cast<SCH_ITEM*>( item->Clone() ) );
+        screen.Append( items.back() );
+    }
+
+    screen.TestDanglingEnds();
+
+    for( int step = 1; step < 8; ++step )
+    {
+        EDA_RECT changedArea;
+
+        for( size_t ii = step; ii < items.size(); ii += 11 )
+        {
+            changedArea.Merge( items[ii]->GetBoundingBox() );
+            items[ii]->Move( wxPoint( 50 * step, -50 ) );
+            changedArea.Merge( items[ii]->GetBoundingBox() );
+        }
+
+        std::vector<SCH_ITEM*> changedItems;
+        bool                   changed = screen.TestDanglingEnds( changedArea, &changedItems );
+
+        BOOST_CHECK_EQUAL( changed, !changedItems.empty() );
+
+        // Everything outside the area was already up to date
+        BOOST_CHECK( !screen.TestDanglingEnds() );
+    }
+}
+
+
+/**
+ * Check a short wire dropped on the middle of a longer collinear wire, and merged with it as
+ * the schematic cleanup does, gets its dangling state tested again once the merged line is
+ * part of the changed area
+ */
+BOOST_AUTO_TEST_CASE( MergedWireChangedArea )
+{
+    SCH_SCREEN screen( nullptr );
+
+    // The start of the long wire is connected to a vertical wire, its end is dangling
+    SCH_LINE* longWire = new SCH_LINE( wxPoint( 0, 0 ), LAYER_WIRE );
+    longWire->SetEndPoint( wxPoint( 1000, 0 ) );
+
+    SCH_LINE* otherWire = new SCH_LINE( wxPoint( 0, 0 ), LAYER_WIRE );
+    otherWire->SetEndPoint( wxPoint( 0, 500 ) );
+
+    // Both ends of the short wire are dangling
+    SCH_LINE* shortWire = new SCH_LINE( wxPoint( 400, 1000 ), LAYER_WIRE );
+    shortWire->SetEndPoint( wxPoint( 600, 1000 ) );
+
+    screen.Append( shortWire );
+    screen.Append( longWire );
+    screen.Append( otherWire );
+    screen.TestDanglingEnds();
+
+    BOOST_CHECK( shortWire->IsStartDangling() && shortWire->IsEndDangling() );
+    BOOST_CHECK( !longWire->IsStartDangling() && longWire->IsEndDangling() );
+
+    EDA_RECT changedArea = shortWire->GetBoundingBox();
+    shortWire->Move( wxPoint( 0, -1000 ) );
+    changedArea.Merge( shortWire->GetBoundingBox() );
+
+    // The merged line is a copy of the short wire, with the ends of the long one
+    SCH_LINE* merged = static_cast<SCH_LINE*>( longWire->MergeOverlap( shortWire ) );
+
+    BOOST_REQUIRE( merged );
+    BOOST_CHECK( merged->GetStartPoint() == wxPoint( 0, 0 ) );
+    BOOST_CHECK( merged->GetEndPoint() == wxPoint( 1000, 0 ) );
+    BOOST_CHECK( merged->IsStartDangling() );
+
+    screen.Remove( shortWire );
+    screen.Remove( longWire );
+    delete shortWire;
+    delete longWire;
+    screen.Append( merged );
+
+    // The ends of the merged line are out of the area of the moved wire
+    BOOST_CHECK( !changedArea.Contains( merged->GetStartPoint() ) );
+    BOOST_CHECK( !changedArea.Contains( merged->GetEndPoint() ) );
+
+    changedArea.Merge( merged->GetBoundingBox() );
+
+    std::vector<SCH_ITEM*> changedItems;
+
+    BOOST_CHECK( screen.TestDanglingEnds( changedArea, &changedItems ) );
+    BOOST_CHECK( std::find( changedItems.begin(), changedItems.end(), merged )
+                 != changedItems.end() );
+    BOOST_CHECK( !merged->IsStartDangling() );
+    BOOST_CHECK( merged->IsEndDangling() );
+
+    // Everything outside the area was already up to date
+    BOOST_CHECK( !screen.TestDanglingEnds() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
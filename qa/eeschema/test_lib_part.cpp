@@ -31,6 +31,9 @@
 // Code under test
 #include <class_libentry.h>
 
+#include <lib_pin.h>
+#include <lib_rectangle.h>
+
 #include "lib_field_test_utils.h"
 
 class TEST_LIB_PART_FIXTURE
@@ -203,4 +206,44 @@ BOOST_AUTO_TEST_CASE( SubReference )
 }
 
 
+/**
+ * Check the deferred drawing items are loaded once, on their first use
+ */
+BOOST_AUTO_TEST_CASE( DeferredDrawings )
+{
+    int loads = 0;
+
+    m_part_no_data.SetDrawItemsLoader( [&]( LIB_PART& aPart )
+            {
+                ++loads;
+                aPart.AddDrawItem( new LIB_RECTANGLE( &aPart ) );
+                aPart.AddDrawItem( new LIB_PIN( &aPart ) );
+            } );
+
+    // Fields are not deferred
+    BOOST_CHECK_EQUAL( m_part_no_data.GetValueField().GetId(), VALUE );
+    BOOST_CHECK_EQUAL( loads, 0 );
+
+    LIB_PINS pins;
+    m_part_no_data.GetPins( pins );
+
+    BOOST_CHECK_EQUAL( loads, 1 );
+    BOOST_CHECK_EQUAL( pins.size(), 1 );
+    BOOST_CHECK_EQUAL( m_part_no_data.GetDrawItems().size(), 6 );
+    BOOST_CHECK_EQUAL( loads, 1 );
+
+    // A copy of a deferred part gets the drawing items
+    m_part_no_data.SetDrawItemsLoader( [&]( LIB_PART& aPart )
+            {
+                ++loads;
+                aPart.AddDrawItem( new LIB_PIN( &aPart ) );
+            } );
+
+    LIB_PART copy( m_part_no_data );
+
+    BOOST_CHECK_EQUAL( loads, 2 );
+    BOOST_CHECK_EQUAL( copy.GetDrawItems().size(), 7 );
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
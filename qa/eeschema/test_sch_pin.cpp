@@ -156,4 +156,46 @@ BOOST_AUTO_TEST_CASE( PinNumberingPower )
     BOOST_CHECK_EQUAL( pwr_name, "pinname" );
 }
 
+/**
+ * Check that rebuilding the pins of a component invalidates its connectivity, since the
+ * connection graph refers to the pins
+ */
+BOOST_AUTO_TEST_CASE( UpdatePinsDirtiesConnectivity )
+{
+    LIB_PART part( "part", nullptr );
+
+    for( const char* number : { "1", "2" } )
+    {
+        LIB_PIN* pin = new LIB_PIN( &part );
+        pin->SetNumber( number );
+        part.AddDrawItem( pin );
+    }
+
+    SCH_COMPONENT comp( part, LIB_ID(), nullptr, 1, 1, wxPoint( 0, 0 ) );
+
+    BOOST_CHECK_EQUAL( comp.GetPins().size(), 2 );
+
+    // Nothing to rebuild
+    comp.SetConnectivityDirty( false );
+    comp.UpdatePins();
+    BOOST_CHECK_EQUAL( comp.IsConnectivityDirty(), false );
+
+    // A pin added to the library symbol
+    LIB_PIN* added = new LIB_PIN( &part );
+    added->SetNumber( "3" );
+    part.AddDrawItem( added );
+
+    comp.UpdatePins();
+    BOOST_CHECK_EQUAL( comp.GetPins().size(), 3 );
+    BOOST_CHECK_EQUAL( comp.IsConnectivityDirty(), true );
+
+    // And removed again
+    comp.SetConnectivityDirty( false );
+    part.RemoveDrawItem( added );
+
+    comp.UpdatePins();
+    BOOST_CHECK_EQUAL( comp.GetPins().size(), 2 );
+    BOOST_CHECK_EQUAL( comp.IsConnectivityDirty(), true );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
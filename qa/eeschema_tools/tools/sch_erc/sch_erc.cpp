@@ -0,0 +1,247 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "sch_erc.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+#include <common.h>
+#include <kiway.h>
+#include <macros.h>
+#include <pgm_base.h>
+#include <profile.h>
+#include <wildcards_and_files_ext.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+
+#include <connection_graph.h>
+#include <erc_settings.h>
+#include <general.h>
+#include <sch_io_mgr.h>
+#include <sch_marker.h>
+#include <sch_screen.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print the connectivity time and the time of each ERC run" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "m",
+            "markers",
+            _( "print the ERC errors" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "number of times the ERC is run (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input schematic file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool=specific return codes
+ */
+enum SCH_ERC_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    ERC_ERRORS,
+};
+
+
+/**
+ * Load a legacy schematic and its sub-sheets.
+ * @return the root sheet, or nullptr if the schematic cannot be read
+ */
+static SCH_SHEET* loadSchematic( KIWAY& aKiway, const wxFileName& aFileName )
+{
+    SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_LEGACY ) );
+
+    try
+    {
+        return pi->Load( aFileName.GetFullPath(), &aKiway );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        std::cerr << ioe.What() << std::endl;
+    }
+
+    return nullptr;
+}
+
+
+/**
+ * Print the error messages of the ERC markers of all the sheets.
+ */
+static void printMarkers()
+{
+    SCH_SCREENS screens;
+    int         index = 0;
+
+    for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
+    {
+        for( SCH_ITEM* item = screen->GetDrawItems(); item; item = item->Next() )
+        {
+            if( item->Type() != SCH_MARKER_T )
+                continue;
+
+            SCH_MARKER* marker = static_cast<SCH_MARKER*>( item );
+
+            std::cout << index++ << ": " << marker->GetReporter().ShowReport( INCHES );
+        }
+    }
+}
+
+
+int sch_erc_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program runs the connectivity ERC rules of Eeschema on a schematic, "
+               "without any window, and reports the errors and time spent for each rule. "
+               "The return code is non zero if errors are found, for use in CI jobs." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+    const bool markers = cl_parser.Found( "markers" );
+    long       repeat = 1;
+
+    cl_parser.Found( "repeat", &repeat );
+    repeat = std::max( repeat, 1L );
+
+    wxFileName filename( cl_parser.GetParam( 0 ) );
+    filename.MakeAbsolute();
+
+    // Sub-sheets, the symbol library table and the cache library are found from the project
+    wxFileName projectFile( filename );
+    projectFile.SetExt( ProjectFileExtension );
+
+    KIWAY kiway( &Pgm(), KFCTL_STANDALONE );
+    kiway.Prj().SetProjectFullName( projectFile.GetFullPath() );
+
+    g_RootSheet = loadSchematic( kiway, filename );
+
+    if( !g_RootSheet )
+        return SCH_ERC_RET_CODES::LOAD_FAILED;
+
+    // The preparation SCH_EDIT_FRAME::OpenProjectFiles() does before the connectivity
+    SCH_SCREENS screens;
+    screens.UpdateSymbolLinks();
+    screens.TestDanglingEnds();
+
+    // No frame: the graph only uses it for the units of the ERC messages
+    CONNECTION_GRAPH graph( nullptr );
+    SCH_SHEET_PATH   rootPath;
+
+    rootPath.push_back( g_RootSheet );
+    g_ConnectionGraph = &graph;
+    g_CurrentSheet = &rootPath;
+
+    PROF_COUNTER connectivity_timer;
+    graph.Recalculate( SCH_SHEET_LIST( g_RootSheet ), true );
+    connectivity_timer.Stop();
+
+    if( verbose )
+        printf( "Connectivity: %.3f ms\n", connectivity_timer.msecs() );
+
+    ERC_SETTINGS settings;
+    settings.LoadDefaults();
+
+    std::vector<ERC_RULE_STATS> stats;
+    int                         error_count = 0;
+
+    for( long ii = 0; ii < repeat; ++ii )
+    {
+        // Markers are only created by the first run, they would pile up on the screens
+        PROF_COUNTER erc_timer;
+        error_count = graph.RunERC( settings, markers && ii == 0, &stats );
+        erc_timer.Stop();
+
+        if( verbose )
+            printf( "ERC %ld/%ld: %.3f ms\n", ii + 1, repeat, erc_timer.msecs() );
+    }
+
+    // Rule times are summed over the ERC threads
+    for( const ERC_RULE_STATS& rule : stats )
+    {
+        printf( "%-24s %6d errors %10.3f ms\n", TO_UTF8( rule.m_name ), rule.m_error_count,
+                rule.m_msecs );
+    }
+
+    printf( "Total: %d errors\n", error_count );
+
+    if( markers )
+        printMarkers();
+
+    graph.Reset();
+    g_ConnectionGraph = nullptr;
+    g_CurrentSheet = nullptr;
+
+    delete g_RootSheet;
+    g_RootSheet = nullptr;
+
+    return error_count ? SCH_ERC_RET_CODES::ERC_ERRORS : KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM sch_erc_tool = {
+    "sch_erc",
+    "Run the connectivity ERC of a schematic and report each rule",
+    sch_erc_main_func,
+};
@@ -0,0 +1,259 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for AR_AUTOPLACER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <autorouter/ar_autoplacer.h>
+
+#include <board_commit.h>
+#include <class_board.h>
+#include <class_drawsegment.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <tools/pcb_tool_base.h>
+#include <widgets/progress_reporter.h>
+
+#include <map>
+#include <memory>
+
+
+/**
+ * Progress reporter keeping the number of positions scored for each footprint, from
+ * the "<ref> placed: <n> positions scored in <t> ms" messages of the autoplacer
+ */
+class TEST_PROGRESS_REPORTER : public PROGRESS_REPORTER
+{
+public:
+    TEST_PROGRESS_REPORTER() : PROGRESS_REPORTER( 1 )
+    {}
+
+    int GetScoredPositions() const
+    {
+        int total = 0;
+
+        for( const auto& it : m_scored )
+            total += it.second;
+
+        return total;
+    }
+
+protected:
+    bool updateUI() override
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        long                        count;
+
+        if( m_rptMessage.AfterFirst( ':' ).Trim( false ).BeforeFirst( ' ' ).ToLong( &count ) )
+            m_scored[ m_rptMessage.BeforeFirst( ' ' ) ] = count;
+
+        return true;
+    }
+
+    std::map<wxString, long> m_scored;
+};
+
+
+/**
+ * A 60 x 40 mm board and a chain of two pad footprints, all of them off the board
+ */
+class TEST_AUTOPLACER_FIXTURE
+{
+public:
+    TEST_AUTOPLACER_FIXTURE() :
+        m_tool( "qa.autoplacer" )
+    {
+        const wxPoint corners[] = { wxPoint( 0, 0 ), wxPoint( Millimeter2iu( 60 ), 0 ),
+                                    wxPoint( Millimeter2iu( 60 ), Millimeter2iu( 40 ) ),
+                                    wxPoint( 0, Millimeter2iu( 40 ) ) };
+
+        for( int ii = 0; ii < 4; ++ii )
+        {
+            DRAWSEGMENT* edge = new DRAWSEGMENT( &m_board );
+            edge->SetShape( S_SEGMENT );
+            edge->SetStart( corners[ii] );
+            edge->SetEnd( corners[( ii + 1 ) % 4] );
+            edge->SetWidth( Millimeter2iu( 0.1 ) );
+            edge->SetLayer( Edge_Cuts );
+            m_board.Add( edge );
+        }
+
+        for( int ii = 0; ii < 13; ++ii )
+        {
+            NETINFO_ITEM* net = new NETINFO_ITEM( &m_board, wxString::Format( "N%d", ii + 1 ),
+                                                  ii + 1 );
+            m_board.Add( net );
+        }
+
+        for( int ii = 0; ii < 12; ++ii )
+        {
+            MODULE* module = new MODULE( &m_board );
+
+            for( int jj = 0; jj < 2; ++jj )
+            {
+                D_PAD*  pad = new D_PAD( module );
+                wxPoint pos( Millimeter2iu( 2.54 ) * jj, 0 );
+
+                pad->SetShape( PAD_SHAPE_RECT );
+                pad->SetSize( wxSize( Millimeter2iu( 1.5 ), Millimeter2iu( 1.5 ) ) );
+                pad->SetAttribute( PAD_ATTRIB_SMD );
+                pad->SetLayerSet( D_PAD::SMDMask() );
+                pad->SetPos0( pos );
+                pad->SetPosition( pos );
+                pad->SetNetCode( ii + jj + 1 );
+                module->Add( pad );
+            }
+
+            module->SetReference( wxString::Format( "R%d", ii + 1 ) );
+            module->SetPosition( wxPoint( Millimeter2iu( 100 ), Millimeter2iu( 5 ) * ii ) );
+            module->CalculateBoundingBox();
+            m_board.Add( module );
+        }
+    }
+
+    /**
+     * Autoplaces all the footprints
+     * @param aThreadCount is the number of threads scoring the positions, 0 for the default
+     * @return the number of positions scored
+     */
+    int Autoplace( bool aCoarseToFine, int aThreadCount = 0 )
+    {
+        AR_AUTOPLACER          autoplacer( &m_board );
+        BOARD_COMMIT           commit( &m_tool );
+        TEST_PROGRESS_REPORTER reporter;
+        std::vector<MODULE*>   modules;
+
+        for( auto module : m_board.Modules() )
+            modules.push_back( module );
+
+        autoplacer.SetProgressReporter( &reporter );
+        autoplacer.SetCoarseToFineSearch( aCoarseToFine );
+        autoplacer.SetThreadCount( aThreadCount );
+
+        BOOST_CHECK_EQUAL( autoplacer.AutoplaceModules( modules, &commit ), AR_COMPLETED );
+
+        return reporter.GetScoredPositions();
+    }
+
+    /// Checks every footprint was placed inside the board
+    void CheckPlaced()
+    {
+        EDA_RECT board = m_board.GetBoardEdgesBoundingBox();
+
+        for( auto module : m_board.Modules() )
+        {
+            BOOST_CHECK_MESSAGE( board.Contains( module->GetPosition() ),
+                                 "Footprint " << module->GetReference() << " off the board" );
+        }
+    }
+
+    /// Checks every footprint was placed as the same footprint of aOther
+    void CheckSamePlacement( TEST_AUTOPLACER_FIXTURE& aOther )
+    {
+        auto it = aOther.m_board.Modules().begin();
+
+        for( auto module : m_board.Modules() )
+        {
+            BOOST_REQUIRE( it != aOther.m_board.Modules().end() );
+
+            MODULE* other = *it++;
+
+            BOOST_TEST_CONTEXT( "Footprint " << module->GetReference() )
+            {
+                BOOST_CHECK_EQUAL( module->GetReference(), other->GetReference() );
+                BOOST_CHECK_EQUAL( module->GetPosition(), other->GetPosition() );
+                BOOST_CHECK_EQUAL( module->GetOrientation(), other->GetOrientation() );
+                BOOST_CHECK_EQUAL( module->GetLayer(), other->GetLayer() );
+            }
+        }
+    }
+
+    BOARD         m_board;
+    PCB_TOOL_BASE m_tool;    ///< Only to build the commit
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( Autoplacer, TEST_AUTOPLACER_FIXTURE )
+
+
+/**
+ * Check the exhaustive search places every footprint on the board
+ */
+BOOST_AUTO_TEST_CASE( Exhaustive )
+{
+    BOOST_CHECK( Autoplace( false ) > 0 );
+
+    CheckPlaced();
+}
+
+
+/**
+ * Check the coarse to fine search also places every footprint on the board, scoring
+ * fewer positions than the exhaustive search
+ */
+BOOST_AUTO_TEST_CASE( CoarseToFine )
+{
+    int scored = Autoplace( true );
+
+    CheckPlaced();
+
+    TEST_AUTOPLACER_FIXTURE exhaustive;
+
+    BOOST_CHECK( scored > 0 );
+    BOOST_CHECK( scored < exhaustive.Autoplace( false ) );
+}
+
+
+/**
+ * Check the positions are the same whatever the number of threads scoring them, with
+ * the exhaustive and the coarse to fine searches.  The footprints are all the same, so
+ * positions with the same score are common, and the tie breaking is checked too.
+ */
+BOOST_AUTO_TEST_CASE( SameWithAnyThreadCount )
+{
+    for( bool coarseToFine : { false, true } )
+    {
+        BOOST_TEST_CONTEXT( "Coarse to fine: " << coarseToFine )
+        {
+            TEST_AUTOPLACER_FIXTURE serial;
+            serial.Autoplace( coarseToFine, 1 );
+
+            for( int threadCount : { 2, 3, 8 } )
+            {
+                BOOST_TEST_CONTEXT( "Threads: " << threadCount )
+                {
+                    TEST_AUTOPLACER_FIXTURE parallel;
+                    parallel.Autoplace( coarseToFine, threadCount );
+
+                    parallel.CheckSamePlacement( serial );
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,337 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for GENERAL_COLLECTOR using a VIEW as a spatial index
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <collectors.h>
+
+#include <class_board.h>
+#include <class_drawsegment.h>
+#include <class_marker_pcb.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_pcb_text.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <pcb_view.h>
+#include <tools/drc.h>
+
+#include <random>
+
+
+/**
+ * A guide accepting items on any layer, without a view to compute the pixel size from
+ */
+class TEST_COLLECTORS_GUIDE : public COLLECTORS_GUIDE
+{
+public:
+    bool IsLayerLocked( PCB_LAYER_ID layer ) const override { return false; }
+    bool IsLayerVisible( PCB_LAYER_ID layer ) const override { return layer != B_SilkS; }
+    bool IgnoreLockedLayers() const override { return true; }
+    bool IgnoreNonVisibleLayers() const override { return true; }
+    PCB_LAYER_ID GetPreferredLayer() const override { return F_Cu; }
+    bool IgnorePreferredLayer() const override { return false; }
+    bool IgnoreLockedItems() const override { return false; }
+    bool IncludeSecondary() const override { return true; }
+    bool IgnoreMTextsMarkedNoShow() const override { return true; }
+    bool IgnoreMTextsOnBack() const override { return true; }
+    bool IgnoreMTextsOnFront() const override { return false; }
+    bool IgnoreModulesOnBack() const override { return false; }
+    bool IgnoreModulesOnFront() const override { return false; }
+    bool IgnorePadsOnBack() const override { return false; }
+    bool IgnorePadsOnFront() const override { return false; }
+    bool IgnoreThroughHolePads() const override { return false; }
+    bool IgnoreModulesVals() const override { return false; }
+    bool IgnoreModulesRefs() const override { return false; }
+    bool IgnoreThroughVias() const override { return false; }
+    bool IgnoreBlindBuriedVias() const override { return false; }
+    bool IgnoreMicroVias() const override { return false; }
+    bool IgnoreTracks() const override { return false; }
+    bool IgnoreZoneFills() const override { return true; }
+    double OnePixelInIU() const override { return 10000.0; }
+    bool UseHitTesting() const override { return true; }
+};
+
+
+/**
+ * Random board with overlapping items of most kinds, all of them added to a view
+ */
+class TEST_GENERAL_COLLECTOR_FIXTURE
+{
+public:
+    TEST_GENERAL_COLLECTOR_FIXTURE() :
+        m_view( false ),
+        m_rng( 42 )
+    {
+        // Same layer setup as the board editor, markers are on a display only layer
+        m_view.SetDefaultLayerDeps( false );
+
+        const PCB_LAYER_ID layers[] = { F_Cu, B_Cu, F_SilkS, B_SilkS, Edge_Cuts };
+
+        std::uniform_int_distribution<> layer( 0, 4 );
+        std::uniform_int_distribution<> width( Millimeter2iu( 0.1 ), Millimeter2iu( 1 ) );
+
+        for( int ii = 0; ii < 400; ++ii )
+        {
+            TRACK* track = new TRACK( &m_board );
+            track->SetStart( RandomPoint() );
+            track->SetEnd( RandomPoint() );
+            track->SetWidth( width( m_rng ) );
+            track->SetLayer( m_rng() % 2 ? F_Cu : B_Cu );
+            m_board.Add( track );
+            m_anchors.push_back( track->GetStart() );
+        }
+
+        for( int ii = 0; ii < 100; ++ii )
+        {
+            VIA* via = new VIA( &m_board );
+            via->SetPosition( RandomPoint() );
+            via->SetWidth( Millimeter2iu( 0.8 ) );
+            via->SetViaType( VIA_THROUGH );
+            via->SetLayerPair( F_Cu, B_Cu );
+            m_board.Add( via );
+            m_anchors.push_back( via->GetPosition() );
+        }
+
+        for( int ii = 0; ii < 100; ++ii )
+        {
+            DRAWSEGMENT* segment = new DRAWSEGMENT( &m_board );
+            segment->SetShape( m_rng() % 2 ? S_SEGMENT : S_CIRCLE );
+            segment->SetStart( RandomPoint() );
+            segment->SetEnd( segment->GetStart() + wxPoint( Millimeter2iu( 2 ), 0 ) );
+            segment->SetWidth( width( m_rng ) );
+            segment->SetLayer( layers[layer( m_rng )] );
+            m_board.Add( segment );
+            m_anchors.push_back( segment->GetEnd() );
+        }
+
+        for( int ii = 0; ii < 50; ++ii )
+        {
+            TEXTE_PCB* text = new TEXTE_PCB( &m_board );
+            text->SetText( "TEXT" );
+            text->SetTextPos( RandomPoint() );
+            text->SetLayer( layers[layer( m_rng )] );
+            m_board.Add( text );
+            m_anchors.push_back( text->GetTextPos() );
+        }
+
+        for( int ii = 0; ii < 50; ++ii )
+        {
+            MODULE* module = new MODULE( &m_board );
+
+            for( int jj = 0; jj < 4; ++jj )
+            {
+                D_PAD* pad = new D_PAD( module );
+                wxPoint pos( Millimeter2iu( 1.27 ) * jj, 0 );
+                bool smd = ii % 2;
+
+                pad->SetShape( PAD_SHAPE_RECT );
+                pad->SetSize( wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1.5 ) ) );
+                pad->SetAttribute( smd ? PAD_ATTRIB_SMD : PAD_ATTRIB_STANDARD );
+                pad->SetLayerSet( smd ? D_PAD::SMDMask() : D_PAD::StandardMask() );
+                pad->SetPos0( pos );
+                pad->SetPosition( pos );
+                module->Add( pad );
+            }
+
+            module->SetPosition( RandomPoint() );
+            module->CalculateBoundingBox();
+            m_board.Add( module );
+            m_anchors.push_back( module->GetPosition() );
+        }
+
+        for( int ii = 0; ii < 10; ++ii )
+        {
+            ZONE_CONTAINER* zone = new ZONE_CONTAINER( &m_board );
+            wxPoint         corner = RandomPoint();
+            int             size = Millimeter2iu( 5 );
+
+            zone->SetLayer( m_rng() % 2 ? F_Cu : B_Cu );
+            zone->Outline()->NewOutline();
+            zone->Outline()->Append( corner.x, corner.y );
+            zone->Outline()->Append( corner.x + size, corner.y );
+            zone->Outline()->Append( corner.x + size, corner.y + size );
+            zone->Outline()->Append( corner.x, corner.y + size );
+            m_board.Add( zone );
+            m_anchors.push_back( corner );
+        }
+
+        for( int ii = 0; ii < 20; ++ii )
+        {
+            wxPoint     pos = RandomPoint();
+            MARKER_PCB* marker = new MARKER_PCB( DRCE_TRACK_NEAR_PAD, pos, "A", pos );
+
+            m_board.Add( marker );
+            m_view.Add( marker );
+
+            // Inside the arrow shape of the marker, its position is the tip
+            wxPoint     inside = pos + wxPoint( Millimeter2iu( 0.4 ), Millimeter2iu( 0.4 ) );
+
+            m_anchors.push_back( inside );
+            m_markers.push_back( inside );
+        }
+
+        for( auto track : m_board.Tracks() )
+            m_view.Add( track );
+
+        for( auto module : m_board.Modules() )
+            m_view.Add( module );
+
+        for( auto drawing : m_board.Drawings() )
+            m_view.Add( drawing );
+
+        for( auto zone : m_board.Zones() )
+            m_view.Add( zone );
+    }
+
+    wxPoint RandomPoint()
+    {
+        std::uniform_int_distribution<> coord( -Millimeter2iu( 20 ), Millimeter2iu( 20 ) );
+
+        return wxPoint( coord( m_rng ), coord( m_rng ) );
+    }
+
+    // The view has to be destroyed after the board items, they remove themselves from it
+    KIGFX::PCB_VIEW       m_view;
+    BOARD                 m_board;
+    std::mt19937          m_rng;
+    std::vector<wxPoint>  m_anchors;    ///< Points placed on items, random points miss most
+    std::vector<wxPoint>  m_markers;    ///< Points inside the DRC markers
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( GeneralCollector, TEST_GENERAL_COLLECTOR_FIXTURE )
+
+
+/**
+ * Check the collection is the same with and without the view
+ */
+BOOST_AUTO_TEST_CASE( SameAsFullScan )
+{
+    TEST_COLLECTORS_GUIDE guide;
+    std::vector<wxPoint>  points = m_anchors;
+    int                   found = 0;
+
+    for( int ii = 0; ii < 500; ++ii )
+        points.push_back( RandomPoint() );
+
+    for( const KICAD_T* scanList : { GENERAL_COLLECTOR::AllBoardItems,
+                                     GENERAL_COLLECTOR::PadsOrTracks,
+                                     GENERAL_COLLECTOR::Zones } )
+    {
+        for( const wxPoint& point : points )
+        {
+            GENERAL_COLLECTOR expected;
+            GENERAL_COLLECTOR collector;
+
+            expected.Collect( &m_board, scanList, point, guide );
+            collector.Collect( &m_board, scanList, point, guide, &m_view );
+
+            BOOST_REQUIRE_EQUAL( collector.GetCount(), expected.GetCount() );
+            BOOST_CHECK_EQUAL( collector.GetPrimaryCount(), expected.GetPrimaryCount() );
+
+            for( int jj = 0; jj < expected.GetCount(); ++jj )
+                BOOST_CHECK( collector[jj] == expected[jj] );
+
+            found += expected.GetCount();
+        }
+    }
+
+    // Make sure the test is not trivial
+    BOOST_CHECK( found > 0 );
+}
+
+
+/**
+ * Check the collection keeps the order of a full scan after the lists of the board changed,
+ * as the positions of the items are cached
+ */
+BOOST_AUTO_TEST_CASE( SameAsFullScanAfterEdits )
+{
+    TEST_COLLECTORS_GUIDE guide;
+
+    for( int edit = 0; edit < 20; ++edit )
+    {
+        // Remove a track and a module, and insert a track before all the others
+        TRACK*  track = m_board.Tracks()[ m_rng() % m_board.Tracks().size() ];
+        MODULE* module = m_board.Modules()[ m_rng() % m_board.Modules().size() ];
+
+        m_board.Remove( track );
+        m_board.Remove( module );
+        delete track;
+        delete module;
+
+        track = new TRACK( &m_board );
+        track->SetStart( m_anchors[ m_rng() % m_anchors.size() ] );
+        track->SetEnd( RandomPoint() );
+        track->SetWidth( Millimeter2iu( 0.5 ) );
+        track->SetLayer( F_Cu );
+        m_board.Add( track, ADD_INSERT );
+        m_view.Add( track );
+
+        for( int ii = 0; ii < 50; ++ii )
+        {
+            wxPoint point = ii % 2 ? RandomPoint() : m_anchors[ m_rng() % m_anchors.size() ];
+
+            GENERAL_COLLECTOR expected;
+            GENERAL_COLLECTOR collector;
+
+            expected.Collect( &m_board, GENERAL_COLLECTOR::AllBoardItems, point, guide );
+            collector.Collect( &m_board, GENERAL_COLLECTOR::AllBoardItems, point, guide, &m_view );
+
+            BOOST_REQUIRE_EQUAL( collector.GetCount(), expected.GetCount() );
+
+            for( int jj = 0; jj < expected.GetCount(); ++jj )
+                BOOST_CHECK( collector[jj] == expected[jj] );
+        }
+    }
+}
+
+
+/**
+ * Check DRC markers are collected, although they are on a display only layer of the view
+ */
+BOOST_AUTO_TEST_CASE( Markers )
+{
+    TEST_COLLECTORS_GUIDE guide;
+
+    for( const wxPoint& point : m_markers )
+    {
+        GENERAL_COLLECTOR collector;
+        bool              found = false;
+
+        collector.Collect( &m_board, GENERAL_COLLECTOR::AllBoardItems, point, guide, &m_view );
+
+        for( int ii = 0; ii < collector.GetCount(); ++ii )
+            found = found || collector[ii]->Type() == PCB_MARKER_T;
+
+        BOOST_CHECK( found );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
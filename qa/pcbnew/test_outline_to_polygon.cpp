@@ -0,0 +1,179 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for ConvertOutlineToPolygon on outlines made of many small segments
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_drawsegment.h>
+#include <geometry/shape_poly_set.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+
+// Code under test
+extern bool ConvertOutlineToPolygon( std::vector<DRAWSEGMENT*>& aSegList, SHAPE_POLY_SET& aPolygons,
+                                     wxString* aErrorText, unsigned int aTolerance,
+                                     wxPoint* aErrorLocation );
+
+
+/**
+ * Builds outlines from segments given in a random order and direction, as they come from
+ * an imported DXF file
+ */
+class TEST_OUTLINE_TO_POLYGON_FIXTURE
+{
+public:
+    TEST_OUTLINE_TO_POLYGON_FIXTURE() :
+        m_rng( 42 )
+    {
+    }
+
+    /// Adds a closed polygon to the outline, each side split in aSteps segments
+    void AddPolygon( const std::vector<wxPoint>& aCorners, int aSteps )
+    {
+        for( size_t ii = 0; ii < aCorners.size(); ++ii )
+        {
+            wxPoint start = aCorners[ii];
+            wxPoint end = aCorners[( ii + 1 ) % aCorners.size()];
+
+            for( int jj = 0; jj < aSteps; ++jj )
+                AddSegment( Interpolate( start, end, jj, aSteps ),
+                            Interpolate( start, end, jj + 1, aSteps ) );
+        }
+    }
+
+    static wxPoint Interpolate( const wxPoint& aStart, const wxPoint& aEnd, int aStep, int aSteps )
+    {
+        return wxPoint( aStart.x + int( int64_t( aEnd.x - aStart.x ) * aStep / aSteps ),
+                        aStart.y + int( int64_t( aEnd.y - aStart.y ) * aStep / aSteps ) );
+    }
+
+    void AddSegment( const wxPoint& aStart, const wxPoint& aEnd )
+    {
+        auto segment = std::make_unique<DRAWSEGMENT>();
+
+        segment->SetShape( S_SEGMENT );
+        segment->SetLayer( Edge_Cuts );
+        segment->SetStart( m_rng() % 2 ? aStart : aEnd );
+        segment->SetEnd( segment->GetStart() == aStart ? aEnd : aStart );
+
+        m_segments.push_back( std::move( segment ) );
+    }
+
+    bool Convert( unsigned aTolerance = 0 )
+    {
+        std::vector<DRAWSEGMENT*> segList;
+
+        for( const auto& segment : m_segments )
+            segList.push_back( segment.get() );
+
+        std::shuffle( segList.begin(), segList.end(), m_rng );
+
+        return ConvertOutlineToPolygon( segList, m_polygons, &m_error, aTolerance,
+                                        &m_errorLocation );
+    }
+
+    std::mt19937                              m_rng;
+    std::vector<std::unique_ptr<DRAWSEGMENT>> m_segments;
+    SHAPE_POLY_SET                            m_polygons;
+    wxString                                  m_error;
+    wxPoint                                   m_errorLocation;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( OutlineToPolygon, TEST_OUTLINE_TO_POLYGON_FIXTURE )
+
+
+/**
+ * Check a fragmented board outline with fragmented holes is rebuilt
+ */
+BOOST_AUTO_TEST_CASE( FragmentedOutline )
+{
+    const int size = Millimeter2iu( 100 );
+
+    AddPolygon( { { 0, 0 }, { size, 0 }, { size, size }, { 0, size } }, 1000 );
+
+    for( int ii = 0; ii < 4; ++ii )
+    {
+        const int x = Millimeter2iu( 10 + 20 * ii );
+        const int y = Millimeter2iu( 40 );
+        const int hole = Millimeter2iu( 10 );
+
+        AddPolygon( { { x, y }, { x, y + hole }, { x + hole, y + hole }, { x + hole, y } }, 250 );
+    }
+
+    BOOST_REQUIRE( Convert() );
+    BOOST_REQUIRE_EQUAL( m_polygons.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( m_polygons.HoleCount( 0 ), 4 );
+
+    const BOX2I bbox = m_polygons.Outline( 0 ).BBox();
+
+    BOOST_CHECK_EQUAL( bbox.GetOrigin(), VECTOR2I( 0, 0 ) );
+    BOOST_CHECK_EQUAL( bbox.GetEnd(), VECTOR2I( size, size ) );
+    BOOST_CHECK_CLOSE( std::abs( m_polygons.Outline( 0 ).Area() ), double( size ) * size, 1e-6 );
+}
+
+
+/**
+ * Check segments are connected when their ends are within the tolerance
+ */
+BOOST_AUTO_TEST_CASE( EndsWithinTolerance )
+{
+    const int size = Millimeter2iu( 10 );
+    const int gap = 5;
+
+    AddSegment( { 0, 0 }, { size, 0 } );
+    AddSegment( { size, gap }, { size, size } );
+    AddSegment( { size - gap, size }, { 0, size } );
+    AddSegment( { 0, size - gap }, { 0, gap } );
+
+    BOOST_CHECK( !Convert( 0 ) );
+
+    m_polygons.RemoveAllContours();
+
+    BOOST_CHECK( Convert( 2 * gap ) );
+    BOOST_CHECK_EQUAL( m_polygons.OutlineCount(), 1 );
+}
+
+
+/**
+ * Check a crossing of two sides of a fragmented outline is found
+ */
+BOOST_AUTO_TEST_CASE( SelfIntersecting )
+{
+    const int size = Millimeter2iu( 10 );
+
+    // A bow tie, crossing at its center, which is not a segment end
+    AddPolygon( { { 0, 0 }, { size, size }, { size, 0 }, { 0, size } }, 99 );
+
+    BOOST_CHECK( !Convert() );
+    BOOST_CHECK_LE( std::abs( m_errorLocation.x - size / 2 ), 1 );
+    BOOST_CHECK_LE( std::abs( m_errorLocation.y - size / 2 ), 1 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
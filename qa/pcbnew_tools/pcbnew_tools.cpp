@@ -25,8 +25,10 @@
 
 #include "tools/drc_tool/drc_tool.h"
 #include "tools/pcb_parser/pcb_parser_tool.h"
+#include "tools/pcb_snapshot/pcb_snapshot.h"
 #include "tools/polygon_generator/polygon_generator.h"
 #include "tools/polygon_triangulation/polygon_triangulation.h"
+#include "tools/render_3d/render_3d.h"
 
 /**
  * List of registered tools.
@@ -37,8 +39,10 @@
 const static std::vector<KI_TEST::UTILITY_PROGRAM*> known_tools = {
     &drc_tool,
     &pcb_parser_tool,
+    &pcb_snapshot_tool,
     &polygon_generator_tool,
     &polygon_triangulation_tool,
+    &render_3d_tool,
 };
 
 
@@ -0,0 +1,282 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "pcb_snapshot.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include <common.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+#include <wx/image.h>
+#include <wx/tokenzr.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <board_snapshot.h>
+#include <class_board.h>
+#include <convert_to_biu.h>
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print the time of each render" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "d",
+            "dpi",
+            _( "image resolution in pixels per inch (default 300)" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "l",
+            "layers",
+            _( "comma separated list of the layers to draw, e.g. F.Cu,F.SilkS "
+               "(default all layers)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "a",
+            "area",
+            _( "area to draw as left,top,right,bottom in mm "
+               "(default the board bounding box)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "m",
+            "mirror",
+            _( "mirror the image, to show the bottom side" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "t",
+            "threads",
+            _( "number of render threads (default one per core)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "number of times the image is rendered (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output",
+            _( "PNG file to write the image to" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool=specific return codes
+ */
+enum SNAPSHOT_RET_CODES
+{
+    PARSE_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    RENDER_FAILED,
+};
+
+
+/**
+ * Parse a comma separated list of layer names.
+ * @return false if a name is not a layer of the board
+ */
+static bool parseLayers( const BOARD& aBoard, const wxString& aList, LSET& aLayers )
+{
+    aLayers.reset();
+
+    wxStringTokenizer tokenizer( aList, "," );
+
+    while( tokenizer.HasMoreTokens() )
+    {
+        wxString        name = tokenizer.GetNextToken().Trim().Trim( false );
+        PCB_LAYER_ID    layer = aBoard.GetLayerID( name );
+
+        if( layer == UNDEFINED_LAYER )
+        {
+            std::cerr << "Unknown layer " << name << std::endl;
+            return false;
+        }
+
+        aLayers.set( layer );
+    }
+
+    return true;
+}
+
+
+/**
+ * Parse an area given as left,top,right,bottom in mm.
+ */
+static bool parseArea( const wxString& aText, BOX2I& aArea )
+{
+    wxStringTokenizer tokenizer( aText, "," );
+    double            coords[4];
+
+    for( double& coord : coords )
+    {
+        if( !tokenizer.HasMoreTokens() || !tokenizer.GetNextToken().ToCDouble( &coord ) )
+            return false;
+    }
+
+    if( tokenizer.HasMoreTokens() )
+        return false;
+
+    const VECTOR2I topLeft( Millimeter2iu( coords[0] ), Millimeter2iu( coords[1] ) );
+    const VECTOR2I bottomRight( Millimeter2iu( coords[2] ), Millimeter2iu( coords[3] ) );
+
+    aArea = BOX2I( topLeft, bottomRight - topLeft );
+    aArea.Normalize();
+
+    return true;
+}
+
+
+int pcb_snapshot_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program renders PCB files to images with the Cairo GAL, the way "
+               "Pcbnew displays them, without any window nor OpenGL context. The image "
+               "is split in strips rendered in parallel." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    BOARD_SNAPSHOT_SETTINGS settings;
+    long                    threads = 0;
+    long                    repeat = 1;
+
+    cl_parser.Found( "dpi", &settings.m_dpi );
+    cl_parser.Found( "threads", &threads );
+    cl_parser.Found( "repeat", &repeat );
+    settings.m_mirror = cl_parser.Found( "mirror" );
+    settings.m_threads = std::max( threads, 0L );
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+    {
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+    }
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return SNAPSHOT_RET_CODES::PARSE_FAILED;
+
+    wxString layers;
+
+    if( cl_parser.Found( "layers", &layers ) && !parseLayers( *board, layers, settings.m_layers ) )
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+
+    wxString area;
+
+    if( cl_parser.Found( "area", &area ) && !parseArea( area, settings.m_area ) )
+    {
+        std::cerr << "Invalid area " << area << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    BOARD_SNAPSHOT snapshot( board.get() );
+    wxImage        image;
+
+    for( long ii = 0; ii < std::max( repeat, 1L ); ++ii )
+    {
+        PROF_COUNTER timer;
+        image = snapshot.Render( settings );
+        timer.Stop();
+
+        if( !image.IsOk() )
+        {
+            std::cerr << "Cannot render an image at " << settings.m_dpi << " DPI" << std::endl;
+            return SNAPSHOT_RET_CODES::RENDER_FAILED;
+        }
+
+        if( verbose )
+        {
+            printf( "Render %ld/%ld: %dx%d pixels, %.3f ms\n", ii + 1, std::max( repeat, 1L ),
+                    image.GetWidth(), image.GetHeight(), timer.msecs() );
+        }
+    }
+
+    wxString output;
+
+    if( cl_parser.Found( "output", &output ) )
+    {
+        wxInitAllImageHandlers();
+
+        if( !image.SaveFile( output, wxBITMAP_TYPE_PNG ) )
+            return SNAPSHOT_RET_CODES::RENDER_FAILED;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM pcb_snapshot_tool = {
+    "pcb_snapshot",
+    "Render a PCB to a PNG image with the Cairo GAL",
+    pcb_snapshot_main_func,
+};
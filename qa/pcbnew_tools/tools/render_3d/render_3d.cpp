@@ -0,0 +1,242 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "render_3d.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include <common.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+#include <wx/image.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+
+#include <3d_canvas/cinfo3d_visu.h>
+#include <3d_rendering/3d_render_raytracing/c3d_render_raytracing.h>
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print the times of each render step" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "W",
+            "width",
+            _( "width of the image in pixels (default 1024)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "H",
+            "height",
+            _( "height of the image in pixels (default 768)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "x",
+            "rotate-x",
+            _( "camera rotation around the X axis, in degrees" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "z",
+            "rotate-z",
+            _( "camera rotation around the Z axis, in degrees" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "number of times the image is rendered (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output",
+            _( "PNG file to write the image to" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_OPTIONAL,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool=specific return codes
+ */
+enum RENDER_RET_CODES
+{
+    PARSE_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    RENDER_FAILED,
+};
+
+
+static void printTime( const std::string& aStep, unsigned aMicroSecs )
+{
+    printf( "%-24s %10.3f ms\n", aStep.c_str(), aMicroSecs / 1000.0 );
+}
+
+
+int render_3d_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program renders PCB files with the 3D raytracer, without any OpenGL "
+               "context, and prints the time of the scene build, the BVH build and the "
+               "tracing. 3D models are not loaded. The same board and options always "
+               "give the same image." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    long   width = 1024;
+    long   height = 768;
+    long   repeat = 1;
+    double rotateX = 0.0;
+    double rotateZ = 0.0;
+
+    cl_parser.Found( "width", &width );
+    cl_parser.Found( "height", &height );
+    cl_parser.Found( "repeat", &repeat );
+    cl_parser.Found( "rotate-x", &rotateX );
+    cl_parser.Found( "rotate-z", &rotateZ );
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+    {
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+    }
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return RENDER_RET_CODES::PARSE_FAILED;
+
+    CINFO3D_VISU settings;
+    settings.SetBoard( board.get() );
+    settings.RenderEngineSet( RENDER_ENGINE_RAYTRACING );
+
+    // the render quality options of the 3D viewer
+    settings.SetFlag( FL_RENDER_RAYTRACING_SHADOWS, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_REFRACTIONS, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_REFLECTIONS, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING, true );
+    settings.SetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES, true );
+
+    settings.CameraGet().RotateX( glm::radians( (float) rotateX ) );
+    settings.CameraGet().RotateZ( glm::radians( (float) rotateZ ) );
+
+    C3D_RENDER_RAYTRACING renderer( settings );
+    wxImage               image;
+
+    for( long ii = 0; ii < std::max( repeat, 1L ); ++ii )
+    {
+        // the scene is built again each time, so all the steps are measured
+        renderer.ReloadRequest();
+        image = renderer.RenderToImage( wxSize( width, height ) );
+
+        if( !image.IsOk() )
+        {
+            std::cerr << "Cannot render an image of " << width << "x" << height << std::endl;
+            return RENDER_RET_CODES::RENDER_FAILED;
+        }
+
+        const RT_RENDER_STATS& stats = renderer.GetRenderStats();
+
+        if( verbose )
+        {
+            printf( "Render %ld/%ld\n", ii + 1, std::max( repeat, 1L ) );
+            printTime( "Board", stats.m_boardTime );
+            printTime( "Scene", stats.m_sceneTime );
+            printTime( "BVH", stats.m_acceleratorTime );
+            printTime( "Tracing", stats.m_tracingTime );
+            printTime( "Post processing", stats.m_postProcessTime );
+        }
+        else
+        {
+            printf( "%u %u %u %u %u\n", stats.m_boardTime, stats.m_sceneTime,
+                    stats.m_acceleratorTime, stats.m_tracingTime, stats.m_postProcessTime );
+        }
+    }
+
+    wxString output;
+
+    if( cl_parser.Found( "output", &output ) )
+    {
+        wxInitAllImageHandlers();
+
+        if( !image.SaveFile( output, wxBITMAP_TYPE_PNG ) )
+            return RENDER_RET_CODES::RENDER_FAILED;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM render_3d_tool = {
+    "render_3d",
+    "Render a PCB with the 3D raytracer and time the render steps",
+    render_3d_main_func,
+};
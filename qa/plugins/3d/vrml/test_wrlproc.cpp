@@ -0,0 +1,282 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the number parsing of WRLPROC
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <wrlproc.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+
+static uint32_t floatBits( float aValue )
+{
+    uint32_t bits;
+    memcpy( &bits, &aValue, sizeof( bits ) );
+    return bits;
+}
+
+
+/**
+ * Reads the given numbers from a VRML2 file with WRLPROC::ReadSFFloat() and checks each
+ * of them is read as the same float as strtof() gives, or is refused when strtof()
+ * overflows.
+ */
+static void checkReadAsStrtof( const std::vector<std::string>& aNumbers )
+{
+    for( const std::string& number : aNumbers )
+    {
+        BOOST_TEST_CONTEXT( "Number: " << number )
+        {
+            // A reader for each number, as a number refused leaves the reader in error
+            STRING_LINE_READER reader( "#VRML V2.0 utf8\n" + number + "\n", "test.wrl" );
+            WRLPROC            proc( &reader );
+
+            BOOST_REQUIRE( proc.GetVRMLType() == VRML_V2 );
+
+            const float expected = strtof( number.c_str(), nullptr );
+            float       value;
+
+            if( std::isinf( expected ) )
+            {
+                BOOST_CHECK( !proc.ReadSFFloat( value ) );
+            }
+            else
+            {
+                BOOST_REQUIRE( proc.ReadSFFloat( value ) );
+                BOOST_CHECK_EQUAL( floatBits( value ), floatBits( expected ) );
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE( WrlProc )
+
+
+/**
+ * Numbers with more digits than a 64 bits integer holds
+ */
+BOOST_AUTO_TEST_CASE( ManyDigits )
+{
+    checkReadAsStrtof( {
+            "3.14159265358979323846264338327950288",
+            "0.333333333333333333333333333333333333",
+            "123456789012345678901234567890",
+            "0.000000000000000000000000000000000000000123456789012345678901234567890",
+            "1.00000000000000000000000000000000000000000000000000000000000001",
+            "0.99999999999999999999999999999999999999999999999999999999999999",
+            "16777216.000000000000000000000000000001",
+            "100000000000000000000000000000000000000",
+    } );
+}
+
+
+/**
+ * Numbers halfway between two floats, and just away from it, which are rounded to the
+ * wrong float when rounded to a double first
+ */
+BOOST_AUTO_TEST_CASE( Halfway )
+{
+    checkReadAsStrtof( {
+            "16777217",
+            "16777219",
+            "1.000000059604644775390625",
+            "1.00000005960464477539062500",
+            "1.0000000596046447753906250000000001",
+            "1.0000000596046447753906249999999999",
+            "0.052366157993674278",
+            "2.8210984791754941e+37",
+    } );
+}
+
+
+/**
+ * Exponents beyond the powers of 10 exact in a double, up to the float limits
+ */
+BOOST_AUTO_TEST_CASE( LargeExponents )
+{
+    checkReadAsStrtof( {
+            "1e23",
+            "1e-23",
+            "8.5e25",
+            "3.4028234e38",
+            "3.40282346638528859811704183484516925e38",
+            "3.4028235677973366e38",
+            "3.4028236e38",
+            "1e39",
+            "-1e39",
+            "1.17549435e-38",
+            "123456789e-45",
+            "0.000001e44",
+            "1E30",
+            "1e+30",
+    } );
+}
+
+
+/**
+ * Numbers below the normal floats, down to underflowing to zero
+ */
+BOOST_AUTO_TEST_CASE( Denormals )
+{
+    checkReadAsStrtof( {
+            "1e-40",
+            "-1e-40",
+            "1.17549421e-38",
+            "1.4e-45",
+            "1.401298464324817e-45",
+            "7.006492321624086e-46",
+            "7.006492321624087e-46",
+            "7e-46",
+            "1e-50",
+            "-1e-50",
+    } );
+}
+
+
+/**
+ * Signs, and numbers starting or ending with the decimal point
+ */
+BOOST_AUTO_TEST_CASE( SignsAndPoints )
+{
+    checkReadAsStrtof( {
+            "+1",
+            "+.5",
+            "-.5",
+            ".5",
+            "5.",
+            "+0.1",
+            "-0",
+            "+0",
+            "0.0e10",
+            "0.1",
+            "-123.456",
+            "+7e-3",
+    } );
+}
+
+
+/**
+ * Globs which are not (only) numbers are refused
+ */
+BOOST_AUTO_TEST_CASE( NotANumber )
+{
+    for( const char* glob : { "abc", "1.2.3", "1e", "1e+", "-", "+.", ".", "1x", "0x10" } )
+    {
+        BOOST_TEST_CONTEXT( "Glob: " << glob )
+        {
+            STRING_LINE_READER reader( std::string( "#VRML V2.0 utf8\n" ) + glob + "\n",
+                                       "test.wrl" );
+            WRLPROC            proc( &reader );
+            float              value;
+
+            BOOST_CHECK( !proc.ReadSFFloat( value ) );
+        }
+    }
+}
+
+
+/**
+ * The shortest and the exact decimal forms of random floats, and random decimals, all
+ * read from one file as a model holds them
+ */
+BOOST_AUTO_TEST_CASE( Random )
+{
+    std::mt19937                            rng( 1234 );
+    std::uniform_int_distribution<uint32_t> bitsDist;
+    std::uniform_int_distribution<int>      digitsDist( 1, 25 );
+    std::uniform_int_distribution<int>      digitDist( 0, 9 );
+    std::uniform_int_distribution<int>      expDist( -45, 38 );
+
+    std::vector<std::string> numbers;
+    char                     buf[64];
+
+    for( int ii = 0; ii < 20000; ii++ )
+    {
+        uint32_t bits = bitsDist( rng );
+        float    value;
+        memcpy( &value, &bits, sizeof( value ) );
+
+        if( std::isfinite( value ) )
+        {
+            snprintf( buf, sizeof( buf ), "%.9g", value );
+            numbers.push_back( buf );
+
+            // halfway to the next float up, with enough digits to be exact in most cases
+            double halfway = ( (double) value + (double) nextafterf( value, INFINITY ) ) / 2;
+
+            if( std::isfinite( halfway ) )
+            {
+                snprintf( buf, sizeof( buf ), "%.40g", halfway );
+                numbers.push_back( buf );
+            }
+        }
+
+        std::string decimal = "-0.";
+
+        for( int jj = digitsDist( rng ); jj > 0; jj-- )
+            decimal += '0' + digitDist( rng );
+
+        decimal += "e" + std::to_string( expDist( rng ) );
+        numbers.push_back( decimal.substr( ii % 2 ) );
+    }
+
+    std::string file = "#VRML V2.0 utf8\n";
+
+    for( const std::string& number : numbers )
+        file += number + "\n";
+
+    STRING_LINE_READER reader( file, "test.wrl" );
+    WRLPROC            proc( &reader );
+    int                mismatches = 0;
+
+    for( const std::string& number : numbers )
+    {
+        float value;
+
+        BOOST_REQUIRE( proc.ReadSFFloat( value ) );
+
+        if( floatBits( value ) != floatBits( strtof( number.c_str(), nullptr ) ) )
+        {
+            BOOST_TEST_MESSAGE( "Mismatch on " << number );
+            ++mismatches;
+        }
+    }
+
+    BOOST_CHECK_EQUAL( mismatches, 0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()